@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief CRC32 computation using the ARMv8 CRC32 instructions
+ */
+
+#include <kernel.h>
+#include <sys/crc.h>
+#include <arm_acle.h>
+
+#ifndef __ARM_FEATURE_CRC32
+#error "CRC32 instructions not supported by the selected CPU"
+#endif
+
+u32_t arch_crc32_ieee_update(u32_t crc, const u8_t *data, size_t len)
+{
+	crc = ~crc;
+
+	/* Process bytes until data is aligned for doubleword loads */
+	for (; len > 0 && ((uintptr_t)data & 7); len--) {
+		crc = __crc32b(crc, *data++);
+	}
+
+	for (; len >= 8; len -= 8) {
+		crc = __crc32d(crc, *(const u64_t *)data);
+		data += 8;
+	}
+
+	for (; len > 0; len--) {
+		crc = __crc32b(crc, *data++);
+	}
+
+	return ~crc;
+}
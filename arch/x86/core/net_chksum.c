@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Internet checksum using add with carry chains
+ *
+ * x86 handles unaligned loads in hardware, so words are summed from
+ * wherever the data starts. Words are added in little endian order, which
+ * gives the byte swapped ones' complement sum (RFC 1071, 2.(B)).
+ */
+
+#include <kernel.h>
+#include <net/net_ip.h>
+
+#ifdef CONFIG_X86_64
+typedef u64_t chksum_word_t;
+#define ADD "addq"
+#define ADC "adcq"
+#else
+typedef u32_t chksum_word_t;
+#define ADD "addl"
+#define ADC "adcl"
+#endif
+
+#define W sizeof(chksum_word_t)
+
+u16_t arch_net_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	chksum_word_t acc = 0, tail = 0;
+	u16_t tmp;
+
+	for (; len >= 4 * W; len -= 4 * W) {
+		__asm__ volatile(ADD " 0*%c[w](%[p]), %[acc]\n\t"
+				 ADC " 1*%c[w](%[p]), %[acc]\n\t"
+				 ADC " 2*%c[w](%[p]), %[acc]\n\t"
+				 ADC " 3*%c[w](%[p]), %[acc]\n\t"
+				 ADC " $0, %[acc]"
+				 : [acc] "+r" (acc)
+				 : [p] "r" (data), [w] "i" (W)
+				 : "cc", "memory");
+		data += 4 * W;
+	}
+
+	for (; len >= W; len -= W) {
+		__asm__ volatile(ADD " (%[p]), %[acc]\n\t"
+				 ADC " $0, %[acc]"
+				 : [acc] "+r" (acc)
+				 : [p] "r" (data)
+				 : "cc", "memory");
+		data += W;
+	}
+
+	/* Remaining bytes form a zero padded little endian word */
+	for (size_t i = 0; i < len; i++) {
+		tail |= (chksum_word_t)data[i] << (8 * i);
+	}
+
+	__asm__ volatile(ADD " %[tail], %[acc]\n\t"
+			 ADC " $0, %[acc]"
+			 : [acc] "+r" (acc)
+			 : [tail] "r" (tail)
+			 : "cc");
+
+#ifdef CONFIG_X86_64
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+#endif
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	tmp = __builtin_bswap16((u16_t)acc);
+
+	sum += tmp;
+	if (sum < tmp) {
+		sum++;
+	}
+
+	return sum;
+}
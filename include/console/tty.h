@@ -23,12 +23,23 @@ struct tty_serial {
 	u32_t rx_ringbuf_sz;
 	u16_t rx_get, rx_put;
 	s32_t rx_timeout;
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	u8_t *rx_cur;
+	u32_t rx_cur_len;
+	u32_t rx_avail;
+	bool rx_req_pending;
+	bool rx_next_given;
+	bool rx_disabled;
+#endif
 
 	struct k_sem tx_sem;
 	u8_t *tx_ringbuf;
 	u32_t tx_ringbuf_sz;
 	u16_t tx_get, tx_put;
 	s32_t tx_timeout;
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	u16_t tx_len;
+#endif
 };
 
 /**
@@ -43,9 +54,13 @@ struct tty_serial {
  * they need using functions tty_set_rx_buf(), tty_set_tx_buf(),
  * tty_set_rx_timeout(), tty_set_tx_timeout().
  *
+ * With CONFIG_CONSOLE_TTY_ASYNC, buffered operation uses the asynchronous
+ * UART API instead, and data is received directly into the receive buffer.
+ *
  * @param tty tty device structure to initialize
  * @param uart_dev underlying UART device to use (should support
- *                 interrupt-driven operation)
+ *                 interrupt-driven operation, or asynchronous operation
+ *                 with CONFIG_CONSOLE_TTY_ASYNC)
  *
  * @return 0 on success, error code (<0) otherwise
  */
@@ -83,12 +98,15 @@ static inline void tty_set_tx_timeout(struct tty_serial *tty, s32_t timeout)
  * @brief Set receive buffer for tty device.
  *
  * Set receive buffer or switch to unbuffered operation for receive.
+ * With CONFIG_CONSOLE_TTY_ASYNC, the buffer is split into two halves used
+ * for double buffered reception, and can be set only once.
  *
  * @param tty tty device structure
  * @param buf buffer, or NULL for unbuffered operation
  * @param size buffer buffer size, 0 for unbuffered operation
  * @return 0 on success, error code (<0) otherwise:
  *    EINVAL: unsupported buffer (size)
+ *    EBUSY: receive buffer already set (asynchronous mode)
  */
 int tty_set_rx_buf(struct tty_serial *tty, void *buf, size_t size);
 
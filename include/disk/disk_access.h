@@ -53,6 +53,14 @@ struct disk_info {
 	/* Disk device associated to this disk.
 	 */
 	struct device *dev;
+#if defined(CONFIG_DISK_ACCESS_CACHE)
+	/* Sector size while the disk goes through the cache, 0 otherwise */
+	u32_t cache_sector_size;
+	/* Number of sectors, reading ahead stops at the end of the disk */
+	u32_t cache_sector_count;
+	/* Sector following the last one read, where a sequential read starts */
+	u32_t cache_next_read;
+#endif
 };
 
 struct disk_operations {
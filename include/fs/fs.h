@@ -62,6 +62,9 @@ enum fs_type {
  * @param storage_dev Pointer to backend storage device
  * @param mountp_len Length of Mount point string
  * @param fs Pointer to File system interface of the mount point
+ * @param trie_node Entry in the nested mount points of the parent
+ * @param trie_children Mount points nested directly below this one
+ * @param trie_parent Mount point this one is nested in, NULL if none
  */
 struct fs_mount_t {
 	sys_dnode_t node;
@@ -72,6 +75,9 @@ struct fs_mount_t {
 	/* fields filled by file system core */
 	size_t mountp_len;
 	const struct fs_file_system_t *fs;
+	sys_dnode_t trie_node;
+	sys_dlist_t trie_children;
+	struct fs_mount_t *trie_parent;
 };
 
 /**
@@ -185,6 +191,30 @@ struct fs_file_system_t {
  */
 int fs_open(struct fs_file_t *zfp, const char *file_name);
 
+/**
+ * @brief Buffered file open
+ *
+ * Opens an existing file or creates a new one like fs_open(), and gives it
+ * a buffer. Reads then fetch the data ahead of the file position in
+ * buffer sized chunks, and writes are collected in the buffer until it is
+ * full. Data written is passed to the file system when the buffer is
+ * full and on fs_seek(), fs_truncate(), fs_sync() or fs_close(), or
+ * when reading from the file.
+ *
+ * This suits files accessed with small records, such as logs and
+ * configuration files. The file is opened unbuffered if no buffer is
+ * available.
+ *
+ * @param zfp Pointer to file object
+ * @param file_name The name of file to open
+ * @param size Size hint of the buffer, 0 for the largest available.
+ *
+ * @retval 0 Success
+ * @retval -ERRNO errno code if error
+ */
+int fs_open_buffered(struct fs_file_t *zfp, const char *file_name,
+		     size_t size);
+
 /**
  * @brief File close
  *
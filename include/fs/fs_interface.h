@@ -24,10 +24,15 @@ struct fs_mount_t;
  *
  * @param Pointer to FATFS file object structure
  * @param mp Pointer to mount point structure
+ * @param bufp Pointer to the buffer of a file opened with
+ *	  fs_open_buffered(), NULL otherwise
  */
 struct fs_file_t {
 	void *filep;
 	const struct fs_mount_t *mp;
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	void *bufp;
+#endif
 };
 
 /**
@@ -4613,6 +4613,25 @@ extern void k_free(void *ptr);
  */
 extern void *k_calloc(size_t nmemb, size_t size);
 
+/**
+ * @brief Resize memory allocated from heap.
+ *
+ * This routine provides traditional realloc() semantics for memory
+ * allocated from the heap memory pool or k_mem_pool_malloc(). The
+ * contents are kept up to the lesser of the old and new sizes, and
+ * the memory may be moved, within the same pool, to grow it.
+ *
+ * If @a ptr is NULL, this is equivalent to k_malloc(). If @a size is
+ * zero, this is equivalent to k_free() and NULL is returned.
+ *
+ * @param ptr Pointer to previously allocated memory.
+ * @param size New size (in bytes).
+ *
+ * @return Address of the resized memory if successful; otherwise NULL,
+ *	   in which case @a ptr is left untouched.
+ */
+extern void *k_realloc(void *ptr, size_t size);
+
 /** @} */
 
 /* polling API - PRIVATE */
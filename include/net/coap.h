@@ -184,6 +184,8 @@ struct coap_resource {
 	void *user_data;
 	sys_slist_t observers;
 	int age;
+	/* Hash of path, computed by the CoAP lib on the first request */
+	u32_t path_hash;
 };
 
 /**
@@ -196,6 +198,16 @@ struct coap_observer {
 	u8_t tkl;
 };
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/**
+ * @brief Location of an option in a CoAP packet.
+ */
+struct coap_option_index {
+	u16_t code; /* Option number */
+	u16_t offset; /* Offset of the option header in the packet data */
+};
+#endif
+
 /**
  * @brief Representation of a CoAP Packet.
  */
@@ -206,6 +218,12 @@ struct coap_packet {
 	u8_t hdr_len; /* CoAP header length */
 	u16_t opt_len; /* Total options length (delta + len + value) */
 	u16_t delta; /* Used for delta calculation in CoAP packet */
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Options found while parsing or appending, in packet order */
+	struct coap_option_index opt_idx[CONFIG_COAP_OPTION_INDEX_SIZE];
+	u8_t opt_idx_num; /* Number of options in opt_idx */
+	bool opt_idx_overflow; /* Some options did not fit in opt_idx */
+#endif
 };
 
 struct coap_option {
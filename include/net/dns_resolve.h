@@ -330,6 +330,17 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 		     void *user_data,
 		     s32_t timeout);
 
+/**
+ * @brief Flush the DNS cache.
+ *
+ * @details Removes all the cached query results so that the next query for
+ * any name is sent to the DNS servers. The cache is also flushed
+ * automatically when a network interface goes up or down, or when DNS
+ * servers are added or removed. Only available if CONFIG_DNS_RESOLVER_CACHE
+ * is enabled.
+ */
+void dns_resolve_cache_flush(void);
+
 /**
  * @brief Get default DNS context.
  *
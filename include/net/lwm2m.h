@@ -521,6 +521,33 @@ int lwm2m_engine_set_float32(char *pathstr, float32_value_t *value);
  */
 int lwm2m_engine_set_float64(char *pathstr, float64_value_t *value);
 
+/**
+ * @brief Start a batch of resource changes in an object
+ *
+ * Changes to the resources of the object made until the matching
+ * lwm2m_engine_notify_batch_end() call are reported to the observers
+ * together: each observation gets a single Notify for all of them, instead
+ * of a Notify for the first change and another one for those made after
+ * it was sent. Changes to other objects are reported as usual. Batches
+ * may be nested, the changes are reported when the outermost one ends.
+ *
+ * @param[in] obj_id Object ID
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_notify_batch_begin(u16_t obj_id);
+
+/**
+ * @brief End a batch of resource changes in an object
+ *
+ * See lwm2m_engine_notify_batch_begin().
+ *
+ * @param[in] obj_id Object ID
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_notify_batch_end(u16_t obj_id);
+
 /**
  * @brief Get resource (instance) value (opaque buffer)
  *
@@ -27,6 +27,7 @@
 #include <net/net_linkaddr.h>
 #include <net/net_ip.h>
 #include <net/net_l2.h>
+#include <net/net_pkt_quota.h>
 #include <net/net_stats.h>
 #include <net/net_timeout.h>
 
@@ -402,6 +403,11 @@ struct net_traffic_class {
 
 	/** Traffic class value */
 	int tc;
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/** Share of the packet slab given to this traffic class */
+	struct net_pkt_quota pkt_quota;
+#endif
 };
 
 /**
@@ -469,6 +475,11 @@ struct net_if {
 
 	/** Network interface instance configuration */
 	struct net_if_config config;
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/** Shares of the TX and RX packet slabs given to this interface */
+	struct net_pkt_quota pkt_quota[2];
+#endif
 } __net_if_align;
 
 /**
@@ -230,6 +230,11 @@ struct msghdr {
 	int           msg_flags;      /* flags on received message */
 };
 
+struct mmsghdr {
+	struct msghdr msg_hdr;        /* message header */
+	unsigned int  msg_len;        /* number of bytes transferred */
+};
+
 struct cmsghdr {
 	socklen_t cmsg_len;    /* Number of bytes, including header */
 	int       cmsg_level;  /* Originating protocol */
@@ -1406,6 +1411,24 @@ static inline u8_t net_priority2vlan(enum net_priority priority)
  */
 const char *net_family2str(sa_family_t family);
 
+/**
+ * @brief Architecture specific Internet checksum computation.
+ *
+ * Provided by architectures selecting CONFIG_ARCH_HAS_NET_CHKSUM and used
+ * by the network stack when CONFIG_NET_CHKSUM_ARCH is enabled. Computes
+ * the 16 bit ones' complement sum of data, seen as a sequence of big
+ * endian 16 bit words, zero padded if len is odd. data may have any
+ * alignment.
+ *
+ * @param sum Ones' complement sum to add the sum of data to, in host
+ * byte order
+ * @param data Data to sum
+ * @param len Length of data in bytes
+ *
+ * @return Ones' complement sum, in host byte order, not complemented.
+ */
+u16_t arch_net_chksum(u16_t sum, const u8_t *data, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
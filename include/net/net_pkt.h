@@ -241,6 +241,12 @@ struct net_pkt {
 		struct canbus_isotp_rx_ctx *canbus_rx_ctx;
 	};
 #endif
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* Quotas this packet is charged to, one per owner type */
+	struct net_pkt_quota *quota[NET_PKT_QUOTA_OWNERS];
+	u8_t quota_reserved; /* Bit per owner served from its reservation */
+#endif
 	/* @endcond */
 };
 
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Network packet pool quotas
+ *
+ * The RX and TX packet slabs are shared by every network interface,
+ * traffic class and network context. A quota gives one of these
+ * owners a reserved minimum of packets that nobody else may take and
+ * a maximum it may hold at any one time, so that a flooded interface
+ * or an application that does not read its socket cannot starve the
+ * rest of the stack of packets.
+ *
+ * A packet is charged to the quota of an owner when it becomes known
+ * that the packet belongs to it: when it is allocated for a network
+ * interface, when it is queued to a traffic class and when it is
+ * handed to (RX) or allocated for (TX) a network context. The charges
+ * are released when the packet is freed. TCP data is never refused
+ * on RX, as the TCP receive window already limits it.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_NET_PKT_QUOTA_H_
+#define ZEPHYR_INCLUDE_NET_NET_PKT_QUOTA_H_
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Network packet pool quotas
+ * @defgroup net_pkt_quota Network Packet Pool Quotas
+ * @ingroup networking
+ * @{
+ */
+
+struct net_if;
+struct net_context;
+
+/** Owners a packet can be charged to, at most one quota of each */
+enum net_pkt_quota_owner {
+	/** Network interface the packet was allocated for */
+	NET_PKT_QUOTA_IFACE,
+	/** Traffic class the packet was queued to */
+	NET_PKT_QUOTA_TC,
+	/** Network context the packet belongs to */
+	NET_PKT_QUOTA_CONTEXT,
+
+	NET_PKT_QUOTA_OWNERS
+};
+
+/**
+ * @brief Share of the RX or TX packet slab given to one owner
+ *
+ * The counters are only updated with atomic operations so that
+ * charging a packet does not need a lock.
+ */
+struct net_pkt_quota {
+	/** Packets currently charged to this quota */
+	atomic_t used;
+
+	/** How many of those were served from the reservation */
+	atomic_t reserved_used;
+
+	/** Packets reserved for this owner */
+	u16_t reserved;
+
+	/** Maximum packets this owner may hold, 0 if unlimited */
+	u16_t max;
+
+	/** Quota of the RX packet slab rather than the TX one */
+	bool rx;
+};
+
+/**
+ * @brief Change the reservation and the cap of a quota
+ *
+ * Packets already charged keep their charge, a lowered cap only
+ * applies to new packets.
+ *
+ * @param quota Quota to change
+ * @param reserved Packets reserved for the owner
+ * @param max Maximum packets the owner may hold, 0 for no limit
+ *
+ * @return 0 if ok, -EINVAL if @a reserved is above a non-zero @a max,
+ * -ENOMEM if the reservations of the slab would exceed its size.
+ */
+int net_pkt_quota_set(struct net_pkt_quota *quota, u16_t reserved,
+		      u16_t max);
+
+/**
+ * @brief Get the packet quota of a network interface
+ *
+ * @param iface Network interface
+ * @param rx RX quota if true, TX quota otherwise
+ *
+ * @return Pointer to the quota
+ */
+struct net_pkt_quota *net_if_pkt_quota(struct net_if *iface, bool rx);
+
+/**
+ * @brief Get the packet quota of a traffic class
+ *
+ * @param tc Traffic class, see net_rx_priority2tc() and
+ * net_tx_priority2tc()
+ * @param rx RX traffic class if true, TX one otherwise
+ *
+ * @return Pointer to the quota, NULL if there is no such class
+ */
+struct net_pkt_quota *net_tc_pkt_quota(u8_t tc, bool rx);
+
+/**
+ * @brief Get the packet quota of a network context
+ *
+ * The quota is reset to the Kconfig defaults by net_context_get().
+ *
+ * @param context Network context
+ * @param rx RX quota if true, TX quota otherwise
+ *
+ * @return Pointer to the quota
+ */
+struct net_pkt_quota *net_context_pkt_quota(struct net_context *context,
+					    bool rx);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_NET_PKT_QUOTA_H_ */
@@ -202,6 +202,34 @@ struct net_stats_ipv6_mld {
 	net_stats_t drop;
 };
 
+/**
+ * @brief DNS resolver cache statistics
+ */
+struct net_stats_dns {
+	/** Number of name queries answered from the cache */
+	net_stats_t cache_hit;
+
+	/** Number of name queries not found in the cache */
+	net_stats_t cache_miss;
+
+	/** Number of cache entries evicted before they expired */
+	net_stats_t cache_evict;
+};
+
+/**
+ * @brief Network packet quota statistics
+ */
+struct net_stats_pkt_quota {
+	/** Number of packets charged to a reservation */
+	net_stats_t reserved;
+
+	/** Number of packets dropped as their owner was at its maximum */
+	net_stats_t cap_drop;
+
+	/** Number of packets dropped to keep reserved packets free */
+	net_stats_t reserve_drop;
+};
+
 /**
  * @brief Network packet transfer times for calculating average TX time
  */
@@ -288,6 +316,16 @@ struct net_stats {
 	struct net_stats_ipv6_mld ipv6_mld;
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_DNS)
+	/** DNS resolver cache statistics, only kept globally */
+	struct net_stats_dns dns;
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_QUOTA)
+	/** Network packet quota statistics */
+	struct net_stats_pkt_quota pkt_quota;
+#endif
+
 #if NET_TC_COUNT > 1
 	/** Traffic class statistics */
 	struct net_stats_tc tc;
@@ -432,6 +470,8 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_ETHERNET,
 	NET_REQUEST_STATS_CMD_GET_PPP,
+	NET_REQUEST_STATS_CMD_GET_DNS,
+	NET_REQUEST_STATS_CMD_GET_PKT_QUOTA,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -510,6 +550,20 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_ETHERNET);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PPP);
 #endif /* CONFIG_NET_STATISTICS_PPP */
 
+#if defined(CONFIG_NET_STATISTICS_DNS)
+#define NET_REQUEST_STATS_GET_DNS				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_DNS)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_DNS);
+#endif /* CONFIG_NET_STATISTICS_DNS */
+
+#if defined(CONFIG_NET_STATISTICS_PKT_QUOTA)
+#define NET_REQUEST_STATS_GET_PKT_QUOTA				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_PKT_QUOTA)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PKT_QUOTA);
+#endif /* CONFIG_NET_STATISTICS_PKT_QUOTA */
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 /**
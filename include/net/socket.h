@@ -54,6 +54,8 @@ struct zsock_pollfd {
 
 /** zsock_recv: Read data without removing it from socket input queue */
 #define ZSOCK_MSG_PEEK 0x02
+/** zsock_recvmmsg: Datagram was truncated (output msg_flags value only) */
+#define ZSOCK_MSG_TRUNC 0x20
 /** zsock_recv/zsock_send: Override operation to non-blocking */
 #define ZSOCK_MSG_DONTWAIT 0x40
 
@@ -310,6 +312,104 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Send multiple messages on a socket
+ *
+ * @details
+ * @rst
+ * Sends up to ``vlen`` messages with a single call, as Linux
+ * ``sendmmsg()`` does. The number of bytes sent for each message is
+ * stored in its ``msg_len`` field. Returns the number of messages
+ * sent, or -1 with errno set if the first message could not be sent.
+ * This function is also exposed as ``sendmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple messages from a socket
+ *
+ * @details
+ * @rst
+ * Receives up to ``vlen`` messages with a single call, as Linux
+ * ``recvmmsg()`` does. Data is scattered over the ``msg_iov`` buffers
+ * of each message, the source address is stored in ``msg_name`` and
+ * the number of bytes received in ``msg_len``. ``ZSOCK_MSG_TRUNC`` is
+ * set in ``msg_flags`` if a datagram did not fit.
+ *
+ * Only the first message is waited for (Linux ``MSG_WAITFORONE``
+ * behavior), the call then returns with the messages already queued.
+ * There is no timeout argument, use ``ZSOCK_MSG_DONTWAIT`` or
+ * :c:func:`zsock_poll` instead. Returns the number of messages
+ * received, or -1 with errno set if none could be received.
+ * This function is also exposed as ``recvmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Datagram loaned to the application by zsock_recv_loan()
+ *
+ * The payload starts @a offset bytes into the @a frag network buffer
+ * and continues over its fragments chain for @a len bytes in total.
+ */
+struct zsock_loan {
+	/** First network buffer fragment holding payload */
+	struct net_buf *frag;
+	/** Payload offset within the first fragment */
+	size_t offset;
+	/** Total payload length */
+	size_t len;
+	/** Owning packet, internal */
+	struct net_pkt *pkt;
+};
+
+/**
+ * @brief Receive a datagram without copying it
+ *
+ * @details
+ * Dequeues the next datagram of a native SOCK_DGRAM socket and lends
+ * its network buffers to the caller instead of copying the payload.
+ * The buffers remain owned by the network stack and must be handed
+ * back with zsock_loan_release() as soon as possible, as they count
+ * against the RX buffer pools. ZSOCK_MSG_PEEK is not supported. Only
+ * supervisor threads may call this function.
+ *
+ * @param sock Socket descriptor
+ * @param loan Filled in with the loaned datagram
+ * @param flags ZSOCK_MSG_DONTWAIT or 0
+ * @param src_addr Source address of the datagram, or NULL
+ * @param addrlen Size of @a src_addr, set to the actual address size
+ *
+ * @return Payload length, or -1 with errno set
+ */
+ssize_t zsock_recv_loan(int sock, struct zsock_loan *loan, int flags,
+			struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Describe a loaned datagram as an I/O vector
+ *
+ * @param loan Datagram received with zsock_recv_loan()
+ * @param iov Array filled in with the payload fragments
+ * @param iovcnt Number of elements in @a iov
+ *
+ * @return Number of elements used, the payload is only partially
+ *         described if it is @a iovcnt
+ */
+int zsock_loan_iov(const struct zsock_loan *loan, struct iovec *iov,
+		   int iovcnt);
+
+/**
+ * @brief Give loaned network buffers back to the network stack
+ *
+ * @param loan Datagram received with zsock_recv_loan()
+ */
+void zsock_loan_release(struct zsock_loan *loan);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -623,6 +723,18 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
 {
@@ -703,6 +815,7 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 
 #define MSG_PEEK ZSOCK_MSG_PEEK
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
+#define MSG_TRUNC ZSOCK_MSG_TRUNC
 
 #define SHUT_RD ZSOCK_SHUT_RD
 #define SHUT_WR ZSOCK_SHUT_WR
@@ -47,12 +47,17 @@ struct k_thread *z_priq_rb_best(struct _priq_rb *pq);
 /* Traditional/textbook "multi-queue" structure.  Separate lists for a
  * small number (max 32 here) of fixed priorities.  This corresponds
  * to the original Zephyr scheduler.  RAM requirements are
- * comparatively high, but performance is very fast.  Won't work with
- * features like deadline scheduling which need large priority spaces
- * to represent their requirements.
+ * comparatively high, but performance is very fast.  With deadline
+ * scheduling each priority level is instead a small tree sorted by
+ * deadline, whose cached minimum keeps the lookup of the best thread
+ * O(1).
  */
 struct _priq_mq {
+#ifdef CONFIG_SCHED_DEADLINE
+	struct _priq_rb queues[32];
+#else
 	sys_dlist_t queues[32];
+#endif
 	unsigned int bitmask; /* bit 1<<i set if queues[i] is non-empty */
 };
 
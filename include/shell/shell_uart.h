@@ -20,6 +20,16 @@ extern "C" {
 
 extern const struct shell_transport_api shell_uart_transport_api;
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+/** @brief Shell UART transport RX buffer used with the asynchronous API. */
+struct shell_uart_rx_buf {
+	u8_t data[CONFIG_SHELL_BACKEND_SERIAL_ASYNC_RX_BUF_SIZE];
+	u16_t len; /* Number of bytes received by the driver. */
+	u16_t rd; /* Number of bytes read by the shell. */
+	bool released; /* Buffer is no longer used by the driver. */
+};
+#endif /* CONFIG_SHELL_BACKEND_SERIAL_ASYNC */
+
 /** @brief Shell UART transport instance control block (RW data). */
 struct shell_uart_ctrl_blk {
 	struct device *dev;
@@ -27,12 +37,31 @@ struct shell_uart_ctrl_blk {
 	void *context;
 	atomic_t tx_busy;
 	bool blocking_tx;
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+	struct shell_uart_rx_buf rx_bufs[
+			CONFIG_SHELL_BACKEND_SERIAL_ASYNC_RX_BUF_COUNT];
+	u8_t rx_rd_idx; /* Buffer currently read by the shell. */
+	u8_t rx_alloc_idx; /* Next buffer to be passed to the driver. */
+	u8_t rx_free; /* Number of buffers not owned by driver or shell. */
+	bool rx_req_pending; /* Driver asked for a buffer when none was free. */
+	bool rx_disabled; /* Reception stopped because of lack of buffers. */
+#endif /* CONFIG_SHELL_BACKEND_SERIAL_ASYNC */
 #ifdef CONFIG_MCUMGR_SMP_SHELL
 	struct smp_shell_data smp;
 #endif /* CONFIG_MCUMGR_SMP_SHELL */
 };
 
-#ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+#define UART_SHELL_RX_RINGBUF_DECLARE(_name, _size) /* Empty */
+#define UART_SHELL_RX_RINGBUF_PTR(_name) NULL
+#else
+#define UART_SHELL_RX_RINGBUF_DECLARE(_name, _size) \
+	RING_BUF_DECLARE(_name##_rx_ringbuf, _size)
+#define UART_SHELL_RX_RINGBUF_PTR(_name) (&_name##_rx_ringbuf)
+#endif /* CONFIG_SHELL_BACKEND_SERIAL_ASYNC */
+
+#if defined(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) || \
+	defined(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)
 #define UART_SHELL_TX_RINGBUF_DECLARE(_name, _size) \
 	RING_BUF_DECLARE(_name##_tx_ringbuf, _size)
 
@@ -45,13 +74,13 @@ struct shell_uart_ctrl_blk {
 
 #define UART_SHELL_RX_TIMER_PTR(_name) NULL
 
-#else /* CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN */
+#else
 #define UART_SHELL_TX_RINGBUF_DECLARE(_name, _size) /* Empty */
 #define UART_SHELL_TX_BUF_DECLARE(_name) /* Empty */
 #define UART_SHELL_RX_TIMER_DECLARE(_name) static struct k_timer _name##_timer
 #define UART_SHELL_TX_RINGBUF_PTR(_name) NULL
 #define UART_SHELL_RX_TIMER_PTR(_name) (&_name##_timer)
-#endif /* CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN */
+#endif
 
 /** @brief Shell UART transport instance structure. */
 struct shell_uart {
@@ -66,12 +95,12 @@ struct shell_uart {
 	static struct shell_uart_ctrl_blk _name##_ctrl_blk;		\
 	UART_SHELL_RX_TIMER_DECLARE(_name);				\
 	UART_SHELL_TX_RINGBUF_DECLARE(_name, _tx_ringbuf_size);		\
-	RING_BUF_DECLARE(_name##_rx_ringbuf, _rx_ringbuf_size);		\
+	UART_SHELL_RX_RINGBUF_DECLARE(_name, _rx_ringbuf_size);		\
 	static const struct shell_uart _name##_shell_uart = {		\
 		.ctrl_blk = &_name##_ctrl_blk,				\
 		.timer = UART_SHELL_RX_TIMER_PTR(_name),		\
 		.tx_ringbuf = UART_SHELL_TX_RINGBUF_PTR(_name),		\
-		.rx_ringbuf = &_name##_rx_ringbuf,			\
+		.rx_ringbuf = UART_SHELL_RX_RINGBUF_PTR(_name),		\
 	};								\
 	struct shell_transport _name = {				\
 		.api = &shell_uart_transport_api,			\
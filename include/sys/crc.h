@@ -143,6 +143,22 @@ u32_t crc32_ieee(const u8_t *data, size_t len);
  */
 u32_t crc32_ieee_update(u32_t crc, const u8_t *data, size_t len);
 
+/**
+ * @brief Architecture specific CRC32 update.
+ *
+ * Hardware accelerated implementation of crc32_ieee_update(), provided by
+ * architectures or SoCs selecting CONFIG_ARCH_HAS_CRC32_IEEE. It is used
+ * in place of the software implementation when CONFIG_CRC32_IEEE_ARCH is
+ * enabled and must give identical results.
+ *
+ * @param crc   CRC32 checksum that needs to be updated.
+ * @param *data Pointer to data on which the CRC should be calculated.
+ * @param len   Data length.
+ *
+ * @return CRC32 value.
+ */
+u32_t arch_crc32_ieee_update(u32_t crc, const u8_t *data, size_t len);
+
 /**
  * @brief Compute CCITT variant of CRC 8
  *
@@ -38,6 +38,15 @@
  * structure of the tree being generated dynamically via a stack as
  * the tree is recursed.  So the overall memory overhead of a node is
  * just two pointers, identical with a doubly-linked list.
+ *
+ * With CONFIG_RBTREE_PARENT_POINTERS, nodes get a third pointer to
+ * their parent instead, and insert and remove walk up the tree
+ * through it rather than through a stack array sized for the deepest
+ * possible path.  This trades a pointer per node for a much smaller
+ * and constant stack footprint, e.g. for trees modified from ISRs.
+ *
+ * The tree tracks its lowest-sorted node as it is modified, so
+ * rb_get_min() is O(1).
  */
 
 #ifndef ZEPHYR_INCLUDE_SYS_RB_H_
@@ -47,6 +56,9 @@
 
 struct rbnode {
 	struct rbnode *children[2];
+#ifdef CONFIG_RBTREE_PARENT_POINTERS
+	struct rbnode *parent;
+#endif
 };
 
 /* Theoretical maximum depth of tree based on pointer size. If memory
@@ -77,6 +89,7 @@ struct rbtree {
 	struct rbnode *root;
 	rb_lessthan_t lessthan_fn;
 	int max_depth;
+	struct rbnode *min;
 #ifdef CONFIG_MISRA_SANE
 	struct rbnode *iter_stack[Z_MAX_RBTREE_DEPTH];
 	unsigned char iter_left[Z_MAX_RBTREE_DEPTH];
@@ -107,7 +120,7 @@ void rb_remove(struct rbtree *tree, struct rbnode *node);
  */
 static inline struct rbnode *rb_get_min(struct rbtree *tree)
 {
-	return z_rb_get_minmax(tree, 0);
+	return tree->min;
 }
 
 /**
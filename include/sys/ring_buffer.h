@@ -413,6 +413,308 @@ int ring_buf_get_finish(struct ring_buf *buf, u32_t size);
  */
 u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size);
 
+/**
+ * @brief A lock-free single producer, single consumer byte ring buffer
+ *
+ * The read and write indexes run freely and are masked with the power of
+ * two buffer size. Each index is only written by one side and published
+ * with an atomic store after the data, so one producer and one consumer,
+ * for instance an ISR and a thread possibly on different CPUs, can use
+ * the ring buffer concurrently without any locking. All bytes of the
+ * buffer can be used.
+ */
+struct ring_buf_spsc {
+	atomic_t head;	/**< Read index, only written by the consumer */
+	atomic_t tail;	/**< Write index, only written by the producer */
+	u32_t size;	/**< Size of buf in bytes, a power of 2 */
+	u8_t *buf;	/**< Memory region for stored bytes */
+};
+
+/**
+ * @brief Statically define and initialize a lock-free SPSC byte ring buffer.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct ring_buf_spsc <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent, the buffer holds 2^pow bytes.
+ */
+#define RING_BUF_SPSC_DECLARE_POW2(name, pow) \
+	static u8_t _ring_buffer_data_##name[BIT(pow)]; \
+	struct ring_buf_spsc name = { \
+		.size = BIT(pow), \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a lock-free SPSC byte ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is only
+ * used for ring buffers not defined using RING_BUF_SPSC_DECLARE_POW2.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size in bytes, must be a power of 2.
+ * @param data Ring buffer data area.
+ */
+static inline void ring_buf_spsc_init(struct ring_buf_spsc *rb, u32_t size,
+				      u8_t *data)
+{
+	__ASSERT(is_power_of_two(size), "size must be a power of 2");
+
+	atomic_set(&rb->head, 0);
+	atomic_set(&rb->tail, 0);
+	rb->size = size;
+	rb->buf = data;
+}
+
+/**
+ * @brief Determine the number of bytes stored in a SPSC ring buffer.
+ *
+ * The result is exact for the consumer, the producer may add data
+ * concurrently.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Number of bytes that can be read.
+ */
+static inline u32_t ring_buf_spsc_used_get(struct ring_buf_spsc *rb)
+{
+	return (u32_t)atomic_get(&rb->tail) - (u32_t)atomic_get(&rb->head);
+}
+
+/**
+ * @brief Determine free space in a SPSC ring buffer.
+ *
+ * The result is exact for the producer, the consumer may free space
+ * concurrently.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Number of bytes that can be written.
+ */
+static inline u32_t ring_buf_spsc_space_get(struct ring_buf_spsc *rb)
+{
+	return rb->size - ring_buf_spsc_used_get(rb);
+}
+
+/**
+ * @brief Claim space for writing data to a SPSC ring buffer.
+ *
+ * The claimed area is contiguous, so it may be smaller than requested
+ * when the free space wraps around the end of the buffer. It stays
+ * claimed until it is committed with @ref ring_buf_spsc_put_commit,
+ * claiming again before that returns the same area. Only the producer
+ * may call this routine.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Set to the claimed area within the ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Size of the claimed area (in bytes).
+ */
+u32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *rb, u8_t **data,
+			      u32_t size);
+
+/**
+ * @brief Make bytes written to a claimed area available to the consumer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of bytes written to the claimed area.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds free space in the ring buffer.
+ */
+int ring_buf_spsc_put_commit(struct ring_buf_spsc *rb, u32_t size);
+
+/**
+ * @brief Write (copy) data to a SPSC ring buffer.
+ *
+ * Only the producer may call this routine.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+u32_t ring_buf_spsc_put(struct ring_buf_spsc *rb, const u8_t *data,
+			u32_t size);
+
+/**
+ * @brief Claim data for reading from a SPSC ring buffer.
+ *
+ * The claimed area is contiguous, so it may be smaller than requested
+ * when the stored data wraps around the end of the buffer. It stays
+ * claimed until it is released with @ref ring_buf_spsc_get_commit,
+ * claiming again before that returns the same area. Only the consumer
+ * may call this routine.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Set to the claimed data within the ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Size of the claimed data (in bytes).
+ */
+u32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *rb, u8_t **data,
+			      u32_t size);
+
+/**
+ * @brief Release bytes read from a SPSC ring buffer to the producer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds data in the ring buffer.
+ */
+int ring_buf_spsc_get_commit(struct ring_buf_spsc *rb, u32_t size);
+
+/**
+ * @brief Read (copy) data from a SPSC ring buffer.
+ *
+ * Only the consumer may call this routine.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of the output buffer.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+u32_t ring_buf_spsc_get(struct ring_buf_spsc *rb, u8_t *data, u32_t size);
+
+/**
+ * @brief A lock-free multiple producer, single consumer record ring buffer
+ *
+ * The ring buffer holds a power of two number of fixed size records.
+ * Producers reserve a record with a compare and swap on the write index
+ * and publish it by updating the sequence number of its slot, so any
+ * number of threads and ISRs, on any CPU, can write records concurrently
+ * without locking, while a single consumer reads them.
+ *
+ * Records are read in the order they were reserved. A record reserved
+ * but not committed yet holds back the records after it.
+ */
+struct ring_buf_mpsc {
+	atomic_t put_pos;	/**< Next record to reserve */
+	u32_t get_pos;		/**< Next record to read, consumer only */
+	u32_t mask;		/**< Number of records minus one */
+	u32_t record_size;	/**< Size of a record in bytes */
+	atomic_t *seq;		/**< Lap state of each record slot */
+	u8_t *buf;		/**< Memory region for stored records */
+};
+
+/**
+ * @brief Statically define and initialize a lock-free MPSC record ring buffer.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct ring_buf_mpsc <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param size Size of a record in bytes, rounded up to a multiple of 4.
+ * @param pow Ring buffer size exponent, the buffer holds 2^pow records.
+ *	      Must be at least 1.
+ */
+#define RING_BUF_MPSC_DECLARE_POW2(name, size, pow) \
+	BUILD_ASSERT_MSG((pow) >= 1, "MPSC ring buffer needs 2 records"); \
+	static u32_t _ring_buffer_data_##name[BIT(pow) * \
+					      (ROUND_UP(size, 4) / 4)]; \
+	static atomic_t _ring_buffer_seq_##name[BIT(pow)]; \
+	struct ring_buf_mpsc name = { \
+		.mask = BIT(pow) - 1, \
+		.record_size = ROUND_UP(size, 4), \
+		.seq = _ring_buffer_seq_##name, \
+		.buf = (u8_t *)_ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a lock-free MPSC record ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is only
+ * used for ring buffers not defined using RING_BUF_MPSC_DECLARE_POW2.
+ *
+ * @param rb Address of ring buffer.
+ * @param record_size Size of a record in bytes, must be a multiple of 4.
+ * @param count Number of records, must be a power of 2 and at least 2.
+ * @param seq Array of @a count sequence numbers.
+ * @param data Ring buffer data area of @a count * @a record_size bytes,
+ *	       aligned on 4 bytes.
+ */
+void ring_buf_mpsc_init(struct ring_buf_mpsc *rb, u32_t record_size,
+			u32_t count, atomic_t *seq, void *data);
+
+/**
+ * @brief Reserve a record in a MPSC ring buffer.
+ *
+ * May be called concurrently by any number of producers, including
+ * from ISRs. The record must be filled and published with
+ * @ref ring_buf_mpsc_put_commit, without undue delay as the records
+ * reserved after it cannot be read before it is committed.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Address of the record within the ring buffer, NULL if the
+ *	   ring buffer is full.
+ */
+void *ring_buf_mpsc_put_claim(struct ring_buf_mpsc *rb);
+
+/**
+ * @brief Publish a record reserved in a MPSC ring buffer.
+ *
+ * @param rb     Address of ring buffer.
+ * @param record Record returned by @ref ring_buf_mpsc_put_claim.
+ */
+void ring_buf_mpsc_put_commit(struct ring_buf_mpsc *rb, void *record);
+
+/**
+ * @brief Write (copy) a record to a MPSC ring buffer.
+ *
+ * @param rb     Address of ring buffer.
+ * @param record Record data, record_size bytes.
+ *
+ * @retval 0 Record was written.
+ * @retval -ENOMEM Ring buffer is full.
+ */
+int ring_buf_mpsc_put(struct ring_buf_mpsc *rb, const void *record);
+
+/**
+ * @brief Get the oldest record of a MPSC ring buffer.
+ *
+ * The record stays in the ring buffer until it is released with
+ * @ref ring_buf_mpsc_get_commit, claiming again before that returns the
+ * same record. Only the consumer may call this routine.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Address of the record within the ring buffer, NULL if the
+ *	   ring buffer is empty or the oldest record is not committed yet.
+ */
+void *ring_buf_mpsc_get_claim(struct ring_buf_mpsc *rb);
+
+/**
+ * @brief Release the record returned by @ref ring_buf_mpsc_get_claim.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf_mpsc_get_commit(struct ring_buf_mpsc *rb);
+
+/**
+ * @brief Read (copy) the oldest record of a MPSC ring buffer.
+ *
+ * Only the consumer may call this routine.
+ *
+ * @param rb     Address of ring buffer.
+ * @param record Area to store the record, record_size bytes.
+ *
+ * @retval 0 Record was read.
+ * @retval -EAGAIN Ring buffer is empty or the oldest record is not
+ *	   committed yet.
+ */
+int ring_buf_mpsc_get(struct ring_buf_mpsc *rb, void *record);
+
 /**
  * @}
  */
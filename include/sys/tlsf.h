@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief Two-level segregated fit (TLSF) heap
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_TLSF_H_
+#define ZEPHYR_INCLUDE_SYS_TLSF_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup tlsf_apis TLSF heap APIs
+ * @ingroup memory_management
+ * @{
+ */
+
+/*
+ * The heap keeps its free blocks in segregated lists: a first level
+ * splits block sizes in powers of two, and a second level splits every
+ * power of two range in 2^CONFIG_SYS_TLSF_SL_LOG2 equal parts.  Two
+ * levels of bitmaps find a free block that is large enough in constant
+ * time, and freed blocks are immediately merged with their free
+ * physical neighbours.  Allocated blocks carry a two word header.
+ *
+ * The heap is not synchronized, callers must serialize access to it.
+ */
+
+struct z_tlsf;
+
+/** TLSF heap, its control data is kept at the start of its memory */
+struct sys_tlsf {
+	struct z_tlsf *tlsf;
+};
+
+/** TLSF heap usage statistics */
+struct sys_tlsf_stats {
+	/** Bytes available in free blocks, excluding block headers */
+	size_t free_bytes;
+	/** Bytes used by allocated blocks, including block headers */
+	size_t allocated_bytes;
+	/** Largest allocation that can currently succeed */
+	size_t max_free_block;
+};
+
+/**
+ * @brief Initialize a TLSF heap
+ *
+ * The heap control data is placed at the start of @a mem, so the memory
+ * available for allocations is somewhat less than @a bytes.  At most
+ * 2 GiB of memory is used.
+ *
+ * @param h Heap to initialize
+ * @param mem Memory managed by the heap
+ * @param bytes Size of @a mem in bytes
+ */
+void sys_tlsf_init(struct sys_tlsf *h, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate memory from a TLSF heap
+ *
+ * The memory is aligned on two words.
+ *
+ * @param h Heap to allocate from
+ * @param bytes Number of bytes requested
+ *
+ * @return Pointer to the allocated memory, NULL if @a bytes is zero or
+ *	   the heap has no free block large enough
+ */
+void *sys_tlsf_alloc(struct sys_tlsf *h, size_t bytes);
+
+/**
+ * @brief Free memory allocated from a TLSF heap
+ *
+ * @param h Heap the memory was allocated from
+ * @param mem Memory to free, may be NULL
+ */
+void sys_tlsf_free(struct sys_tlsf *h, void *mem);
+
+/**
+ * @brief Resize memory allocated from a TLSF heap
+ *
+ * Shrinking and growing into a free block that follows the allocation
+ * are done in place.  Otherwise a new block is allocated, the contents
+ * are copied and the old block is freed.  As with realloc(), a NULL
+ * @a mem allocates and a zero @a bytes frees.
+ *
+ * @param h Heap the memory was allocated from
+ * @param mem Memory to resize, may be NULL
+ * @param bytes New size in bytes
+ *
+ * @return Pointer to the resized memory, NULL on failure in which case
+ *	   @a mem is left untouched
+ */
+void *sys_tlsf_realloc(struct sys_tlsf *h, void *mem, size_t bytes);
+
+/**
+ * @brief Check if memory belongs to a TLSF heap
+ *
+ * @param h Heap to check
+ * @param mem Pointer to check
+ *
+ * @return true if @a mem points into the memory managed by @a h
+ */
+bool sys_tlsf_owns(struct sys_tlsf *h, void *mem);
+
+/**
+ * @brief Get TLSF heap usage statistics
+ *
+ * @param h Heap to query
+ * @param stats Filled in with the heap statistics
+ */
+void sys_tlsf_stats_get(struct sys_tlsf *h, struct sys_tlsf_stats *stats);
+
+/**
+ * @brief Validate the internal structure of a TLSF heap
+ *
+ * Walks all blocks of the heap and its free lists, checking their
+ * consistency.  Meant for tests, it takes time proportional to the
+ * number of blocks.
+ *
+ * @param h Heap to validate
+ *
+ * @return true if the heap is consistent
+ */
+bool sys_tlsf_validate(struct sys_tlsf *h);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_TLSF_H_ */
@@ -137,6 +137,11 @@ typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
 	sys_dnode_t node;
+#ifdef CONFIG_TIMEOUT_SCALABLE
+	struct _timeout *child;
+	u64_t expiry;
+	u32_t seq;
+#endif
 	s32_t dticks;
 	_timeout_func_t fn;
 };
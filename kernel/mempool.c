@@ -12,6 +12,7 @@
 #include <sys/__assert.h>
 #include <sys/math_extras.h>
 #include <stdbool.h>
+#include <sys/tlsf.h>
 
 static struct k_spinlock lock;
 
@@ -139,17 +140,6 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 	return (char *)block.data + WB_UP(sizeof(struct k_mem_block_id));
 }
 
-void k_free(void *ptr)
-{
-	if (ptr != NULL) {
-		/* point to hidden block descriptor at start of block */
-		ptr = (char *)ptr - WB_UP(sizeof(struct k_mem_block_id));
-
-		/* return block to the heap memory pool */
-		k_mem_pool_free_id(ptr);
-	}
-}
-
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 
 /*
@@ -159,6 +149,70 @@ void k_free(void *ptr)
  * that has the address of the associated memory pool struct.
  */
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+
+/*
+ * With the TLSF heap, _heap_mem_pool is never used to allocate: it only
+ * identifies the heap when assigned to threads as their resource pool.
+ */
+static struct k_mem_pool _heap_mem_pool;
+#define _HEAP_MEM_POOL (&_heap_mem_pool)
+
+static char __aligned(2 * sizeof(void *)) heap_mem[CONFIG_HEAP_MEM_POOL_SIZE];
+static struct sys_tlsf heap;
+static struct k_spinlock heap_lock;
+
+static int init_heap(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	sys_tlsf_init(&heap, heap_mem, sizeof(heap_mem));
+
+	return 0;
+}
+
+SYS_INIT(init_heap, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+void *k_malloc(size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&heap_lock);
+	void *ret = sys_tlsf_alloc(&heap, size);
+
+	k_spin_unlock(&heap_lock, key);
+
+	return ret;
+}
+
+static bool heap_free(void *ptr)
+{
+	k_spinlock_key_t key;
+
+	if (!sys_tlsf_owns(&heap, ptr)) {
+		return false;
+	}
+
+	key = k_spin_lock(&heap_lock);
+	sys_tlsf_free(&heap, ptr);
+	k_spin_unlock(&heap_lock, key);
+
+	return true;
+}
+
+static bool heap_realloc(void *ptr, size_t size, void **ret)
+{
+	k_spinlock_key_t key;
+
+	if (!sys_tlsf_owns(&heap, ptr)) {
+		return false;
+	}
+
+	key = k_spin_lock(&heap_lock);
+	*ret = sys_tlsf_realloc(&heap, ptr, size);
+	k_spin_unlock(&heap_lock, key);
+
+	return true;
+}
+#else
 K_MEM_POOL_DEFINE(_heap_mem_pool, CONFIG_HEAP_MEM_POOL_MIN_SIZE,
 		  CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 #define _HEAP_MEM_POOL (&_heap_mem_pool)
@@ -168,6 +222,17 @@ void *k_malloc(size_t size)
 	return k_mem_pool_malloc(_HEAP_MEM_POOL, size);
 }
 
+static inline bool heap_free(void *ptr)
+{
+	return false;
+}
+
+static inline bool heap_realloc(void *ptr, size_t size, void **ret)
+{
+	return false;
+}
+#endif /* CONFIG_HEAP_MEM_POOL_TLSF */
+
 void *k_calloc(size_t nmemb, size_t size)
 {
 	void *ret;
@@ -184,14 +249,83 @@ void *k_calloc(size_t nmemb, size_t size)
 	return ret;
 }
 
+/* Memory from k_mem_pool_malloc() grows by moving to a larger block of
+ * the same pool, unless its block already has room.
+ */
+static void *pool_realloc(void *ptr, size_t size)
+{
+	struct k_mem_block_id *id;
+	struct k_mem_pool *pool;
+	size_t block_size;
+	void *ret;
+
+	id = (struct k_mem_block_id *)
+		((char *)ptr - WB_UP(sizeof(struct k_mem_block_id)));
+	pool = get_pool(id->pool);
+
+	block_size = pool->base.max_sz;
+	for (int i = 0; i < id->level; i++) {
+		block_size = WB_DN(block_size / 4);
+	}
+	block_size -= WB_UP(sizeof(struct k_mem_block_id));
+
+	if (size <= block_size) {
+		return ptr;
+	}
+
+	ret = k_mem_pool_malloc(pool, size);
+	if (ret != NULL) {
+		(void)memcpy(ret, ptr, block_size);
+		k_free(ptr);
+	}
+
+	return ret;
+}
+
+void *k_realloc(void *ptr, size_t size)
+{
+	void *ret;
+
+	if (ptr == NULL) {
+		return k_malloc(size);
+	}
+
+	if (size == 0) {
+		k_free(ptr);
+		return NULL;
+	}
+
+	if (heap_realloc(ptr, size, &ret)) {
+		return ret;
+	}
+
+	return pool_realloc(ptr, size);
+}
+
 void k_thread_system_pool_assign(struct k_thread *thread)
 {
 	thread->resource_pool = _HEAP_MEM_POOL;
 }
 #else
 #define _HEAP_MEM_POOL	NULL
+
+static inline bool heap_free(void *ptr)
+{
+	return false;
+}
 #endif
 
+void k_free(void *ptr)
+{
+	if (ptr != NULL && !heap_free(ptr)) {
+		/* point to hidden block descriptor at start of block */
+		ptr = (char *)ptr - WB_UP(sizeof(struct k_mem_block_id));
+
+		/* return block to the heap memory pool */
+		k_mem_pool_free_id(ptr);
+	}
+}
+
 void *z_thread_malloc(size_t size)
 {
 	void *ret;
@@ -203,6 +337,12 @@ void *z_thread_malloc(size_t size)
 		pool = _current->resource_pool;
 	}
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+	if (pool == _HEAP_MEM_POOL) {
+		return k_malloc(size);
+	}
+#endif
+
 	if (pool) {
 		ret = k_mem_pool_malloc(pool, size);
 	} else {
@@ -25,6 +25,7 @@
 #if defined(CONFIG_SCHED_DUMB)
 #define _priq_run_add		z_priq_dumb_add
 #define _priq_run_remove	z_priq_dumb_remove
+#define _priq_run_head		z_priq_dumb_best
 # if defined(CONFIG_SCHED_CPU_MASK)
 #  define _priq_run_best	_priq_dumb_mask_best
 # else
@@ -33,11 +34,17 @@
 #elif defined(CONFIG_SCHED_SCALABLE)
 #define _priq_run_add		z_priq_rb_add
 #define _priq_run_remove	z_priq_rb_remove
+#define _priq_run_head		z_priq_rb_best
 #define _priq_run_best		z_priq_rb_best
 #elif defined(CONFIG_SCHED_MULTIQ)
 #define _priq_run_add		z_priq_mq_add
 #define _priq_run_remove	z_priq_mq_remove
-#define _priq_run_best		z_priq_mq_best
+#define _priq_run_head		z_priq_mq_best
+# if defined(CONFIG_SCHED_CPU_MASK)
+#  define _priq_run_best	_priq_mq_mask_best
+# else
+#  define _priq_run_best	z_priq_mq_best
+# endif
 #endif
 
 #if defined(CONFIG_WAITQ_SCALABLE)
@@ -176,9 +183,177 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_CPU_MASK)
+/* Kept out of line so that the iterator stack the tree walk
+ * allocates is released after each priority level.
+ */
+static struct k_thread *mq_level_mask_best(struct _priq_mq *pq, int level)
+{
+	struct k_thread *thread;
+
+#ifdef CONFIG_SCHED_DEADLINE
+	RB_FOR_EACH_CONTAINER(&pq->queues[level].tree, thread, base.qnode_rb) {
+#else
+	SYS_DLIST_FOR_EACH_CONTAINER(&pq->queues[level], thread,
+				     base.qnode_dlist) {
+#endif
+		if ((thread->base.cpu_mask & BIT(_current_cpu->id)) != 0) {
+			return thread;
+		}
+	}
+	return NULL;
+}
+
+static struct k_thread *_priq_mq_mask_best(struct _priq_mq *pq)
+{
+	/* The head of the most important non-empty level is normally
+	 * allowed to run here and is all we look at.  Otherwise walk
+	 * that level in order, then the less important ones.
+	 */
+	unsigned int levels = pq->bitmask;
+	struct k_thread *thread;
+
+	while (levels != 0U) {
+		thread = mq_level_mask_best(pq, __builtin_ctz(levels));
+		if (thread != NULL) {
+			return thread;
+		}
+		levels &= levels - 1U;
+	}
+	return NULL;
+}
+#endif
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+/* The ready queue holding a queued thread is the one of the CPU
+ * recorded in base.cpu, which is otherwise the CPU it last ran on.
+ */
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+	return &_kernel.cpus[thread->base.cpu].ready_q.runq;
+}
+
+/* Most important thread other than @a thread that a CPU is running or
+ * has queued, NULL if it has nothing else to do.
+ */
+static struct k_thread *cpu_load(struct _cpu *cpu, struct k_thread *thread)
+{
+	struct k_thread *head = _priq_run_head(&cpu->ready_q.runq);
+	struct k_thread *curr = cpu->current;
+
+	if (curr == NULL || curr == thread || z_is_idle_thread_object(curr) ||
+	    z_is_thread_prevented_from_running(curr)) {
+		curr = NULL;
+	}
+
+	if (head != NULL &&
+	    (curr == NULL || z_is_t1_higher_prio_than_t2(head, curr))) {
+		return head;
+	}
+
+	return curr;
+}
+
+/* Chooses the ready queue for a thread: the one of the allowed CPU
+ * with the least important load, starting from (and so preferring on
+ * ties) the CPU the thread last ran on.  That CPU is interrupted when
+ * the thread should run there right away.
+ */
+static void runq_place(struct k_thread *thread)
+{
+	struct k_thread *best_load = NULL;
+	int best = -1;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		int id = (thread->base.cpu + i) % CONFIG_MP_NUM_CPUS;
+		struct k_thread *load;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+		if ((thread->base.cpu_mask & BIT(id)) == 0) {
+			continue;
+		}
+#endif
+		load = cpu_load(&_kernel.cpus[id], thread);
+
+		if (best < 0 || (best_load != NULL &&
+				 (load == NULL ||
+				  z_is_t1_higher_prio_than_t2(best_load,
+							      load)))) {
+			best = id;
+			best_load = load;
+		}
+	}
+
+	if (best < 0) {
+		/* Not allowed anywhere, park it where it was */
+		return;
+	}
+
+	thread->base.cpu = best;
+
+#ifdef CONFIG_SCHED_IPI_SUPPORTED
+	if (best != _current_cpu->id &&
+	    (best_load == NULL ||
+	     z_is_t1_higher_prio_than_t2(thread, best_load))) {
+		arch_sched_ipi();
+	}
+#endif
+}
+
+/* Best thread for this CPU: the head of its own queue, unless another
+ * CPU has queued a thread of strictly higher priority that may run
+ * here, in which case it is pulled from there.
+ */
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	struct k_thread *thread = _priq_run_best(&_current_cpu->ready_q.runq);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *t;
+
+		if (i == _current_cpu->id) {
+			continue;
+		}
+
+		t = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		if (t != NULL && (thread == NULL ||
+				  z_is_t1_higher_prio_than_t2(t, thread))) {
+			thread = t;
+		}
+	}
+
+	return thread;
+}
+#else
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+	ARG_UNUSED(thread);
+
+	return &_kernel.ready_q.runq;
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+#endif /* CONFIG_SCHED_PER_CPU_RUNQ */
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	runq_place(thread);
+#endif
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(thread_runq(thread), thread);
+}
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
-	struct k_thread *thread = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -248,15 +423,16 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
 	z_mark_thread_as_not_queued(thread);
+	thread->base.cpu = _current_cpu->id;
 
 	return thread;
 #endif
@@ -380,10 +556,11 @@ static void ready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
-#if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
+#if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED) && \
+	!defined(CONFIG_SCHED_PER_CPU_RUNQ)
 		arch_sched_ipi();
 #endif
 	}
@@ -400,9 +577,9 @@ void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 		}
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(thread == _current);
 	}
@@ -428,7 +605,7 @@ void z_thread_single_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		z_mark_thread_as_suspended(thread);
@@ -462,8 +639,7 @@ void z_thread_single_abort(struct k_thread *thread)
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_ready(thread)) {
 			if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 			update_cache(thread == _current);
@@ -508,7 +684,7 @@ void z_thread_single_abort(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 		z_mark_thread_as_not_queued(thread);
 	}
 	update_cache(thread == _current);
@@ -654,9 +830,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -912,7 +1088,11 @@ ALWAYS_INLINE void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread)
 {
 	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
 
+#ifdef CONFIG_SCHED_DEADLINE
+	z_priq_rb_add(&pq->queues[priority_bit], thread);
+#else
 	sys_dlist_append(&pq->queues[priority_bit], &thread->base.qnode_dlist);
+#endif
 	pq->bitmask |= BIT(priority_bit);
 }
 
@@ -926,10 +1106,17 @@ ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread
 #endif
 	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
 
+#ifdef CONFIG_SCHED_DEADLINE
+	z_priq_rb_remove(&pq->queues[priority_bit], thread);
+	if (pq->queues[priority_bit].tree.root == NULL) {
+		pq->bitmask &= ~BIT(priority_bit);
+	}
+#else
 	sys_dlist_remove(&thread->base.qnode_dlist);
 	if (sys_dlist_is_empty(&pq->queues[priority_bit])) {
 		pq->bitmask &= ~BIT(priority_bit);
 	}
+#endif
 }
 
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
@@ -938,6 +1125,9 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 		return NULL;
 	}
 
+#ifdef CONFIG_SCHED_DEADLINE
+	return z_priq_rb_best(&pq->queues[__builtin_ctz(pq->bitmask)]);
+#else
 	struct k_thread *thread = NULL;
 	sys_dlist_t *l = &pq->queues[__builtin_ctz(pq->bitmask)];
 	sys_dnode_t *n = sys_dlist_peek_head(l);
@@ -946,6 +1136,7 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 		thread = CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
 	}
 	return thread;
+#endif
 }
 
 int z_unpend_all(_wait_q_t *wait_q)
@@ -962,14 +1153,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -977,9 +1168,28 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+#ifdef CONFIG_SCHED_DEADLINE
+		rq->runq.queues[i] = (struct _priq_rb) {
+			.tree = {
+				.lessthan_fn = z_priq_rb_lessthan,
+			}
+		};
+#else
+		sys_dlist_init(&rq->runq.queues[i]);
+#endif
+	}
+#endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1037,10 +1247,17 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	struct k_thread *thread = tid;
 
 	LOCKED(&sched_spinlock) {
+		/* The deadline is part of the sort key of the tree
+		 * backed queues, so dequeue before changing it
+		 */
+		bool queued = z_is_thread_queued(thread);
+
+		if (queued) {
+			runq_remove(thread);
+		}
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
-		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+		if (queued) {
+			runq_add(thread);
 		}
 	}
 }
@@ -1069,10 +1286,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -1237,7 +1453,7 @@ void z_sched_abort(struct k_thread *thread)
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
 		} else if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
@@ -19,8 +19,6 @@
 
 static u64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -41,6 +39,160 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_SCALABLE
+/* Pending timeouts are kept in a pairing heap ordered on the absolute
+ * expiry tick, ties broken by insertion order.  The root of the heap is
+ * the first child of timeout_heap.  The dlist node of a queued timeout
+ * holds the heap links: node.next points back to the parent (for a
+ * first child) or to the previous sibling, and node.prev to the next
+ * sibling.  node.next is never NULL while the timeout is queued, so
+ * z_is_inactive_timeout() works unchanged.
+ */
+static struct _timeout timeout_heap;
+
+static u32_t timeout_seq;
+
+static inline struct _timeout *heap_back(struct _timeout *t)
+{
+	return CONTAINER_OF(t->node.next, struct _timeout, node);
+}
+
+static inline void heap_set_back(struct _timeout *t, struct _timeout *back)
+{
+	t->node.next = &back->node;
+}
+
+static inline struct _timeout *heap_sibling(struct _timeout *t)
+{
+	sys_dnode_t *n = t->node.prev;
+
+	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
+}
+
+static inline void heap_set_sibling(struct _timeout *t, struct _timeout *s)
+{
+	t->node.prev = s == NULL ? NULL : &s->node;
+}
+
+static bool heap_before(struct _timeout *a, struct _timeout *b)
+{
+	if (a->expiry != b->expiry) {
+		return a->expiry < b->expiry;
+	}
+
+	return (s32_t)(a->seq - b->seq) < 0;
+}
+
+/* Links two heaps, returning the new root.  The sibling link of the
+ * returned root is left for the caller to set.
+ */
+static struct _timeout *heap_meld(struct _timeout *a, struct _timeout *b)
+{
+	if (heap_before(b, a)) {
+		struct _timeout *tmp = a;
+
+		a = b;
+		b = tmp;
+	}
+
+	heap_set_sibling(b, a->child);
+	if (a->child != NULL) {
+		heap_set_back(a->child, b);
+	}
+	heap_set_back(b, a);
+	a->child = b;
+
+	return a;
+}
+
+/* Standard two pass pairing: meld the sibling list pairwise from the
+ * left, then meld the resulting heaps from the right.
+ */
+static struct _timeout *heap_merge_pairs(struct _timeout *t)
+{
+	struct _timeout *pairs = NULL;
+	struct _timeout *a, *b;
+
+	while (t != NULL) {
+		a = t;
+		b = heap_sibling(a);
+		if (b != NULL) {
+			t = heap_sibling(b);
+			a = heap_meld(a, b);
+		} else {
+			t = NULL;
+		}
+
+		heap_set_sibling(a, pairs);
+		pairs = a;
+	}
+
+	while (pairs != NULL) {
+		a = pairs;
+		pairs = heap_sibling(a);
+		t = t == NULL ? a : heap_meld(t, a);
+	}
+
+	return t;
+}
+
+static struct _timeout *first(void)
+{
+	return timeout_heap.child;
+}
+
+static void heap_set_root(struct _timeout *t)
+{
+	timeout_heap.child = t;
+	if (t != NULL) {
+		heap_set_back(t, &timeout_heap);
+		heap_set_sibling(t, NULL);
+	}
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	struct _timeout *back = heap_back(t);
+	struct _timeout *sibling = heap_sibling(t);
+	struct _timeout *sub = heap_merge_pairs(t->child);
+
+	if (back->child == t) {
+		back->child = sibling;
+	} else {
+		heap_set_sibling(back, sibling);
+	}
+
+	if (sibling != NULL) {
+		heap_set_back(sibling, back);
+	}
+
+	if (sub != NULL) {
+		heap_set_root(first() == NULL ? sub : heap_meld(first(), sub));
+	}
+
+	t->child = NULL;
+	sys_dnode_init(&t->node);
+}
+
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	to->dticks = ticks;
+	to->expiry = curr_tick + ticks;
+	to->seq = timeout_seq++;
+	to->child = NULL;
+	heap_set_sibling(to, NULL);
+
+	heap_set_root(first() == NULL ? to : heap_meld(first(), to));
+}
+
+/* Ticks from curr_tick until the timeout expires */
+static s32_t timeout_ticks(struct _timeout *to)
+{
+	return (s32_t)(to->expiry - curr_tick);
+}
+#else
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -64,6 +216,43 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	for (t = first(); t != NULL; t = next(t)) {
+		__ASSERT(t->dticks >= 0, "");
+
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
+/* Ticks from curr_tick until the timeout expires */
+static s32_t timeout_ticks(struct _timeout *to)
+{
+	s32_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (to == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+#endif /* CONFIG_TIMEOUT_SCALABLE */
+
 static s32_t elapsed(void)
 {
 	return announce_remaining == 0 ? z_clock_elapsed() : 0;
@@ -73,7 +262,8 @@ static s32_t next_timeout(void)
 {
 	struct _timeout *to = first();
 	s32_t ticks_elapsed = elapsed();
-	s32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - ticks_elapsed);
+	s32_t ret = to == NULL ? MAX_WAIT :
+		MAX(0, timeout_ticks(to) - ticks_elapsed);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -90,23 +280,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			__ASSERT(t->dticks >= 0, "");
-
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		insert_timeout(to, ticks + elapsed());
 
 		if (to == first()) {
 			z_clock_set_timeout(next_timeout(), false);
@@ -137,12 +311,7 @@ s32_t z_timeout_remaining(struct _timeout *timeout)
 	}
 
 	LOCKED(&timeout_lock) {
-		for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-			ticks += t->dticks;
-			if (timeout == t) {
-				break;
-			}
-		}
+		ticks = timeout_ticks(timeout);
 	}
 
 	return ticks - elapsed();
@@ -191,9 +360,10 @@ void z_clock_announce(s32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
+	while (first() != NULL &&
+	       timeout_ticks(first()) <= announce_remaining) {
 		struct _timeout *t = first();
-		int dt = t->dticks;
+		int dt = timeout_ticks(t);
 
 		curr_tick += dt;
 		announce_remaining -= dt;
@@ -205,7 +375,8 @@ void z_clock_announce(s32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
+	/* Heap entries hold absolute expiry ticks */
+	if (!IS_ENABLED(CONFIG_TIMEOUT_SCALABLE) && first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
 
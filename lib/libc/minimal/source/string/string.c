@@ -8,8 +8,113 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <sys/types.h>
 
+#define MEM_WORD_MASK (sizeof(mem_word_t) - 1)
+
+/* Word with each byte set to 0x01, and to 0x80 */
+#define MEM_WORD_ONES ((mem_word_t)-1 / 0xff)
+#define MEM_WORD_HIGHS (MEM_WORD_ONES * 0x80)
+
+#if defined(CONFIG_X86)
+#if Z_MEM_WORD_T_WIDTH > 32
+#define X86_REP_MOVS_WORD "rep movsq"
+#define X86_REP_STOS_WORD "rep stosq"
+#else
+#define X86_REP_MOVS_WORD "rep movsl"
+#define X86_REP_STOS_WORD "rep stosl"
+#endif
+#endif
+
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+/* Non-zero if any byte of the word is zero */
+#define MEM_WORD_HAS_ZERO(w) (((w) - MEM_WORD_ONES) & ~(w) & MEM_WORD_HIGHS)
+
+/* Bytes of a misaligned word, from the two aligned words it straddles */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define MEM_WORD_MERGE(w0, w1, shift) \
+	(((w0) << (shift)) | ((w1) >> (Z_MEM_WORD_T_WIDTH - (shift))))
+#else
+#define MEM_WORD_MERGE(w0, w1, shift) \
+	(((w0) >> (shift)) | ((w1) << (Z_MEM_WORD_T_WIDTH - (shift))))
+#endif
+
+static inline bool mem_word_aligned(const void *p1, const void *p2)
+{
+	return (((uintptr_t)p1 ^ (uintptr_t)p2) & MEM_WORD_MASK) == 0;
+}
+
+/*
+ * Forward copy for memcpy() and memmove(). Once the destination is word
+ * aligned, words are copied directly if the source is aligned too, or else
+ * merged from the two aligned source words they straddle. Every aligned
+ * word read holds at least one source byte, so no read crosses a page or
+ * MPU region boundary the source does not.
+ */
+static void copy_forward(unsigned char *d_byte, const unsigned char *s_byte,
+			 size_t n)
+{
+	if (n >= 2 * sizeof(mem_word_t)) {
+		mem_word_t *d_word;
+		const mem_word_t *s_word;
+		unsigned int offset;
+
+		while (((uintptr_t)d_byte) & MEM_WORD_MASK) {
+			*(d_byte++) = *(s_byte++);
+			n--;
+		}
+
+		d_word = (mem_word_t *)d_byte;
+		offset = ((uintptr_t)s_byte) & MEM_WORD_MASK;
+		s_word = (const mem_word_t *)(s_byte - offset);
+
+		if (offset == 0U) {
+			/* Blocks of four words allow the use of multiple
+			 * register loads and stores.
+			 */
+			while (n >= 4 * sizeof(mem_word_t)) {
+				d_word[0] = s_word[0];
+				d_word[1] = s_word[1];
+				d_word[2] = s_word[2];
+				d_word[3] = s_word[3];
+				d_word += 4;
+				s_word += 4;
+				n -= 4 * sizeof(mem_word_t);
+			}
+
+			while (n >= sizeof(mem_word_t)) {
+				*(d_word++) = *(s_word++);
+				n -= sizeof(mem_word_t);
+			}
+
+			s_byte = (const unsigned char *)s_word;
+		} else {
+			unsigned int shift = offset * 8U;
+			mem_word_t w0 = *(s_word++);
+			mem_word_t w1;
+
+			while (n >= sizeof(mem_word_t)) {
+				w1 = *(s_word++);
+				*(d_word++) = MEM_WORD_MERGE(w0, w1, shift);
+				w0 = w1;
+				n -= sizeof(mem_word_t);
+			}
+
+			s_byte = (const unsigned char *)s_word -
+				 sizeof(mem_word_t) + offset;
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	while (n > 0) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
+}
+#endif /* !CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE */
+
 /**
  *
  * @brief Copy a string
@@ -106,6 +211,7 @@ char *strrchr(const char *s, int c)
 
 size_t strlen(const char *s)
 {
+#if defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
 	size_t n = 0;
 
 	while (*s != '\0') {
@@ -114,6 +220,30 @@ size_t strlen(const char *s)
 	}
 
 	return n;
+#else
+	const char *p = s;
+	const mem_word_t *p_word;
+
+	while (((uintptr_t)p) & MEM_WORD_MASK) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
+	}
+
+	/* An aligned word never spans past the page of the terminator */
+	p_word = (const mem_word_t *)p;
+	while (!MEM_WORD_HAS_ZERO(*p_word)) {
+		p_word++;
+	}
+
+	p = (const char *)p_word;
+	while (*p != '\0') {
+		p++;
+	}
+
+	return p - s;
+#endif
 }
 
 /**
@@ -144,6 +274,30 @@ size_t strnlen(const char *s, size_t maxlen)
 
 int strcmp(const char *s1, const char *s2)
 {
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	if (mem_word_aligned(s1, s2)) {
+		const mem_word_t *w1, *w2;
+
+		while (((uintptr_t)s1) & MEM_WORD_MASK) {
+			if ((*s1 != *s2) || (*s1 == '\0')) {
+				return *s1 - *s2;
+			}
+			s1++;
+			s2++;
+		}
+
+		w1 = (const mem_word_t *)s1;
+		w2 = (const mem_word_t *)s2;
+		while ((*w1 == *w2) && !MEM_WORD_HAS_ZERO(*w1)) {
+			w1++;
+			w2++;
+		}
+
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+#endif
+
 	while ((*s1 == *s2) && (*s1 != '\0')) {
 		s1++;
 		s2++;
@@ -206,6 +360,39 @@ int memcmp(const void *m1, const void *m2, size_t n)
 		return 0;
 	}
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	if ((n >= 2 * sizeof(mem_word_t)) && mem_word_aligned(c1, c2)) {
+		const mem_word_t *w1, *w2;
+
+		while (((uintptr_t)c1) & MEM_WORD_MASK) {
+			if (*c1 != *c2) {
+				return *c1 - *c2;
+			}
+			c1++;
+			c2++;
+			n--;
+		}
+
+		/* Skip the equal words, the bytes of the first differing
+		 * word are compared below.
+		 */
+		w1 = (const mem_word_t *)c1;
+		w2 = (const mem_word_t *)c2;
+		while ((n >= sizeof(mem_word_t)) && (*w1 == *w2)) {
+			w1++;
+			w2++;
+			n -= sizeof(mem_word_t);
+		}
+
+		if (!n) {
+			return 0;
+		}
+
+		c1 = (const char *)w1;
+		c2 = (const char *)w2;
+	}
+#endif
+
 	while ((--n > 0) && (*c1 == *c2)) {
 		c1++;
 		c2++;
@@ -232,18 +419,43 @@ void *memmove(void *d, const void *s, size_t n)
 		 * Copy backwards to prevent the premature corruption of <src>.
 		 */
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+		if ((n >= 2 * sizeof(mem_word_t)) &&
+		    mem_word_aligned(dest + n, src + n)) {
+			mem_word_t *d_word;
+			const mem_word_t *s_word;
+
+			while (((uintptr_t)(dest + n)) & MEM_WORD_MASK) {
+				n--;
+				dest[n] = src[n];
+			}
+
+			d_word = (mem_word_t *)(dest + n);
+			s_word = (const mem_word_t *)(src + n);
+			while (n >= sizeof(mem_word_t)) {
+				*(--d_word) = *(--s_word);
+				n -= sizeof(mem_word_t);
+			}
+		}
+#endif
+
 		while (n > 0) {
 			n--;
 			dest[n] = src[n];
 		}
 	} else {
 		/* It is safe to perform a forward-copy */
+#if defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
 		while (n > 0) {
 			*dest = *src;
 			dest++;
 			src++;
 			n--;
 		}
+#else
+		copy_forward((unsigned char *)dest, (const unsigned char *)src,
+			     n);
+#endif
 	}
 
 	return d;
@@ -258,11 +470,35 @@ void *memmove(void *d, const void *s, size_t n)
 
 void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 {
+#if defined(CONFIG_X86)
+	/* String instructions copy a word per cycle or better whatever the
+	 * alignment, with the shortest code.
+	 */
+	unsigned char *d_byte = (unsigned char *)d;
+	const unsigned char *s_byte = (const unsigned char *)s;
+	size_t words = n / sizeof(mem_word_t);
+	size_t bytes = n % sizeof(mem_word_t);
+
+	__asm__ volatile(X86_REP_MOVS_WORD
+			 : "+D" (d_byte), "+S" (s_byte), "+c" (words)
+			 :
+			 : "memory");
+	__asm__ volatile("rep movsb"
+			 : "+D" (d_byte), "+S" (s_byte), "+c" (bytes)
+			 :
+			 : "memory");
+
+	return d;
+#elif !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	copy_forward((unsigned char *)d, (const unsigned char *)s, n);
+
+	return d;
+#else
 	/* attempt word-sized copying only if buffers have identical alignment */
 
 	unsigned char *d_byte = (unsigned char *)d;
 	const unsigned char *s_byte = (const unsigned char *)s;
-	const uintptr_t mask = sizeof(mem_word_t) - 1;
+	const uintptr_t mask = MEM_WORD_MASK;
 
 	if ((((uintptr_t)d ^ (uintptr_t)s_byte) & mask) == 0) {
 
@@ -298,6 +534,7 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 	}
 
 	return d;
+#endif
 }
 
 /**
@@ -309,12 +546,29 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 
 void *memset(void *buf, int c, size_t n)
 {
+#if defined(CONFIG_X86)
+	unsigned char *d_byte = (unsigned char *)buf;
+	mem_word_t c_word = MEM_WORD_ONES * (unsigned char)c;
+	size_t words = n / sizeof(mem_word_t);
+	size_t bytes = n % sizeof(mem_word_t);
+
+	__asm__ volatile(X86_REP_STOS_WORD
+			 : "+D" (d_byte), "+c" (words)
+			 : "a" (c_word)
+			 : "memory");
+	__asm__ volatile("rep stosb"
+			 : "+D" (d_byte), "+c" (bytes)
+			 : "a" (c_word)
+			 : "memory");
+
+	return buf;
+#else
 	/* do byte-sized initialization until word-aligned or finished */
 
 	unsigned char *d_byte = (unsigned char *)buf;
 	unsigned char c_byte = (unsigned char)c;
 
-	while (((uintptr_t)d_byte) & (sizeof(mem_word_t) - 1)) {
+	while (((uintptr_t)d_byte) & MEM_WORD_MASK) {
 		if (n == 0) {
 			return buf;
 		}
@@ -348,6 +602,7 @@ void *memset(void *buf, int c, size_t n)
 	}
 
 	return buf;
+#endif
 }
 
 /**
@@ -359,6 +614,42 @@ void *memset(void *buf, int c, size_t n)
 
 void *memchr(const void *s, int c, size_t n)
 {
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	const unsigned char *p = s;
+	unsigned char c_byte = (unsigned char)c;
+
+	while ((n > 0) && (((uintptr_t)p) & MEM_WORD_MASK)) {
+		if (*p == c_byte) {
+			return (void *)p;
+		}
+		p++;
+		n--;
+	}
+
+	if (n >= sizeof(mem_word_t)) {
+		/* Bytes equal to c are zero after the xor */
+		mem_word_t c_word = MEM_WORD_ONES * c_byte;
+		const mem_word_t *p_word = (const mem_word_t *)p;
+
+		while ((n >= sizeof(mem_word_t)) &&
+		       !MEM_WORD_HAS_ZERO(*p_word ^ c_word)) {
+			p_word++;
+			n -= sizeof(mem_word_t);
+		}
+
+		p = (const unsigned char *)p_word;
+	}
+
+	while (n > 0) {
+		if (*p == c_byte) {
+			return (void *)p;
+		}
+		p++;
+		n--;
+	}
+
+	return NULL;
+#else
 	if (n != 0) {
 		const unsigned char *p = s;
 
@@ -371,4 +662,5 @@ void *memchr(const void *s, int c, size_t n)
 	}
 
 	return NULL;
+#endif
 }
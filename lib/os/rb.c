@@ -64,11 +64,15 @@ static void set_color(struct rbnode *n, enum rb_color color)
 {
 	CHECK(n);
 
-	uintptr_t *p = (void *) &n->children[0];
+	/* Not through a uintptr_t pointer, which the compiler may
+	 * assume doesn't alias the child pointers set by set_child()
+	 */
+	uintptr_t l = (uintptr_t) n->children[0];
 
-	*p = (*p & ~1UL) | (uint8_t)color;
+	n->children[0] = (void *) ((l & ~1UL) | (uint8_t)color);
 }
 
+#ifndef CONFIG_RBTREE_PARENT_POINTERS
 /* Searches the tree down to a node that is either identical with the
  * "node" argument or has an empty/leaf child pointer where "node"
  * should be, leaving all nodes found in the resulting stack.  Note
@@ -96,6 +100,7 @@ static int find_and_stack(struct rbtree *tree, struct rbnode *node,
 
 	return sz;
 }
+#endif
 
 struct rbnode *z_rb_get_minmax(struct rbtree *tree, int side)
 {
@@ -115,6 +120,37 @@ static int get_side(struct rbnode *parent, struct rbnode *child)
 	return get_child(parent, 1) == child ? 1 : 0;
 }
 
+/* Returns the node following the current minimum of a tree, which is
+ * about to be removed.  The minimum has no left child, so this is the
+ * leftmost node of its right subtree if it has one, otherwise its
+ * parent (NULL if it is the root).
+ */
+static struct rbnode *next_min(struct rbnode *min, struct rbnode *parent)
+{
+	struct rbnode *n = get_child(min, 1);
+
+	if (n == NULL) {
+		return parent;
+	}
+
+	while (get_child(n, 0) != NULL) {
+		n = get_child(n, 0);
+	}
+
+	return n;
+}
+
+/* Every path from the root of a red/black tree down to a leaf has at
+ * least as many black nodes as red ones, so no node is deeper than
+ * twice the black height of the root.  That bound is what
+ * tree->max_depth holds: the stacks used to modify and walk the tree
+ * are sized by it.  It changes by two whenever the black height
+ * does, which is when an insert recolors the root and when the black
+ * missing after a removal propagates up to the root.
+ */
+
+#ifndef CONFIG_RBTREE_PARENT_POINTERS
+
 /* Swaps the position of the two nodes at the top of the provided
  * stack, modifying the stack accordingly. Does not change the color
  * of either node.  That is, it effects the following transition (or
@@ -152,7 +188,8 @@ static void rotate(struct rbnode **stack, int stacksz)
  * too.  Iteratively fix the tree so it becomes a valid red black tree
  * again
  */
-static void fix_extra_red(struct rbnode **stack, int stacksz)
+static void fix_extra_red(struct rbtree *tree, struct rbnode **stack,
+			  int stacksz)
 {
 	while (stacksz > 1) {
 		struct rbnode *node = stack[stacksz - 1];
@@ -211,6 +248,7 @@ static void fix_extra_red(struct rbnode **stack, int stacksz)
 	 * which must be black.
 	 */
 	set_color(stack[0], BLACK);
+	tree->max_depth += 2;
 }
 
 void rb_insert(struct rbtree *tree, struct rbnode *node)
@@ -220,7 +258,8 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 
 	if (tree->root == NULL) {
 		tree->root = node;
-		tree->max_depth = 1;
+		tree->min = node;
+		tree->max_depth = 2;
 		set_color(node, BLACK);
 		return;
 	}
@@ -240,13 +279,14 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 	set_child(parent, side, node);
 	set_color(node, RED);
 
-	stack[stacksz++] = node;
-	fix_extra_red(stack, stacksz);
-
-	if (stacksz > tree->max_depth) {
-		tree->max_depth = stacksz;
+	/* Only a left child of the minimum can sort below it */
+	if (side == 0 && parent == tree->min) {
+		tree->min = node;
 	}
 
+	stack[stacksz++] = node;
+	fix_extra_red(tree, stack, stacksz);
+
 	/* We may have rotated up into the root! */
 	tree->root = stack[0];
 	CHECK(is_black(tree->root));
@@ -262,8 +302,8 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
  * then clean it up (replace it with a simple NULL child in the
  * parent) when finished.
  */
-static void fix_missing_black(struct rbnode **stack, int stacksz,
-			      struct rbnode *null_node)
+static void fix_missing_black(struct rbtree *tree, struct rbnode **stack,
+			      int stacksz, struct rbnode *null_node)
 {
 	/* Loop upward until we reach the root */
 	while (stacksz > 1) {
@@ -360,6 +400,9 @@ static void fix_missing_black(struct rbnode **stack, int stacksz,
 		}
 		return;
 	}
+
+	/* The missing black reached the root */
+	tree->max_depth -= 2;
 }
 
 void rb_remove(struct rbtree *tree, struct rbnode *node)
@@ -377,6 +420,11 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 		return;
 	}
 
+	if (node == tree->min) {
+		tree->min = next_min(node, stacksz > 1 ?
+				     stack[stacksz - 2] : NULL);
+	}
+
 	/* We can only remove a node with zero or one child, if we
 	 * have two then pick the "biggest" child of side 0 (smallest
 	 * of 1 would work too) and swap our spot in the tree with
@@ -469,7 +517,7 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 	 */
 	if (child == NULL) {
 		if (is_black(node)) {
-			fix_missing_black(stack, stacksz, node);
+			fix_missing_black(tree, stack, stacksz, node);
 		} else {
 			/* Red childless nodes can just be dropped */
 			set_child(parent, get_side(parent, node), NULL);
@@ -485,13 +533,257 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 			set_color(child, BLACK);
 		} else {
 			stack[stacksz - 1] = child;
-			fix_missing_black(stack, stacksz, NULL);
+			fix_missing_black(tree, stack, stacksz, NULL);
 		}
 	}
 
 	/* We may have rotated up into the root! */
 	tree->root = stack[0];
 }
+#else /* CONFIG_RBTREE_PARENT_POINTERS */
+
+/* Replaces the subtree rooted at old with the one rooted at new in
+ * the parent of old, new may be NULL.
+ */
+static void replace_child(struct rbtree *tree, struct rbnode *old,
+			  struct rbnode *new)
+{
+	struct rbnode *parent = old->parent;
+
+	if (parent == NULL) {
+		tree->root = new;
+	} else {
+		set_child(parent, get_side(parent, old), new);
+	}
+
+	if (new != NULL) {
+		new->parent = parent;
+	}
+}
+
+/* Swaps the position of child and its parent, the same transition as
+ * the stack based rotate():
+ *
+ *    P          N
+ *  N  c  -->  a   P
+ * a b            b c
+ *
+ */
+static void rotate_up(struct rbtree *tree, struct rbnode *child)
+{
+	struct rbnode *parent = child->parent;
+	int side = get_side(parent, child);
+	struct rbnode *b = get_child(child, side == 0 ? 1 : 0);
+
+	replace_child(tree, parent, child);
+
+	set_child(parent, side, b);
+	if (b != NULL) {
+		b->parent = parent;
+	}
+
+	set_child(child, side == 0 ? 1 : 0, parent);
+	parent->parent = child;
+}
+
+/* Node is red, and so may be its parent.  Same cases as the stack
+ * based fix_extra_red(), walking up through the parent pointers.
+ */
+static void fix_extra_red(struct rbtree *tree, struct rbnode *node)
+{
+	struct rbnode *parent;
+
+	while ((parent = node->parent) != NULL && is_red(parent)) {
+		/* A red parent is never the root */
+		struct rbnode *grandparent = parent->parent;
+		int side = get_side(grandparent, parent);
+		struct rbnode *aunt = get_child(grandparent,
+						side == 0 ? 1 : 0);
+
+		if ((aunt != NULL) && is_red(aunt)) {
+			set_color(grandparent, RED);
+			set_color(parent, BLACK);
+			set_color(aunt, BLACK);
+			node = grandparent;
+			continue;
+		}
+
+		if (get_side(parent, node) != side) {
+			rotate_up(tree, node);
+			parent = node;
+		}
+
+		rotate_up(tree, parent);
+		set_color(parent, BLACK);
+		set_color(grandparent, RED);
+		return;
+	}
+
+	/* Or we stopped at the root, which may have been recolored */
+	if (parent == NULL && is_red(node)) {
+		set_color(node, BLACK);
+		tree->max_depth += 2;
+	}
+}
+
+void rb_insert(struct rbtree *tree, struct rbnode *node)
+{
+	struct rbnode *parent = NULL;
+	struct rbnode *n = tree->root;
+	int side = 0;
+
+	set_child(node, 0, NULL);
+	set_child(node, 1, NULL);
+
+	while (n != NULL) {
+		parent = n;
+		side = tree->lessthan_fn(node, n) ? 0 : 1;
+		n = get_child(n, side);
+	}
+
+	node->parent = parent;
+
+	if (parent == NULL) {
+		tree->root = node;
+		tree->min = node;
+		tree->max_depth = 2;
+		set_color(node, BLACK);
+		return;
+	}
+
+	set_child(parent, side, node);
+	set_color(node, RED);
+
+	/* Only a left child of the minimum can sort below it */
+	if (side == 0 && parent == tree->min) {
+		tree->min = node;
+	}
+
+	fix_extra_red(tree, node);
+}
+
+/* Called after a black node was removed from the side of parent
+ * where node (possibly NULL) now is, leaving that subtree a black
+ * short.  Same cases as the stack based fix_missing_black().
+ */
+static void fix_missing_black(struct rbtree *tree, struct rbnode *node,
+			      struct rbnode *parent)
+{
+	while (parent != NULL && (node == NULL || is_black(node))) {
+		int n_side = get_child(parent, 0) == node ? 0 : 1;
+		struct rbnode *sib = get_child(parent, n_side == 0 ? 1 : 0);
+		struct rbnode *inner, *outer;
+
+		/* The missing black guarantees a sibling */
+		CHECK(sib);
+
+		if (is_red(sib)) {
+			rotate_up(tree, sib);
+			set_color(parent, RED);
+			set_color(sib, BLACK);
+			sib = get_child(parent, n_side == 0 ? 1 : 0);
+		}
+
+		inner = get_child(sib, n_side);
+		outer = get_child(sib, n_side == 0 ? 1 : 0);
+
+		if ((inner == NULL || is_black(inner)) &&
+		    (outer == NULL || is_black(outer))) {
+			set_color(sib, RED);
+			node = parent;
+			parent = node->parent;
+			continue;
+		}
+
+		if (outer == NULL || is_black(outer)) {
+			rotate_up(tree, inner);
+			set_color(sib, RED);
+			set_color(inner, BLACK);
+			outer = sib;
+			sib = inner;
+		}
+
+		set_color(sib, get_color(parent));
+		set_color(parent, BLACK);
+		set_color(outer, BLACK);
+		rotate_up(tree, sib);
+		return;
+	}
+
+	if (node != NULL && is_red(node)) {
+		set_color(node, BLACK);
+	} else {
+		/* The missing black reached the root */
+		tree->max_depth -= 2;
+	}
+}
+
+void rb_remove(struct rbtree *tree, struct rbnode *node)
+{
+	struct rbnode *n = tree->root;
+	struct rbnode *child, *parent;
+	enum rb_color color;
+
+	while (n != NULL && n != node) {
+		n = get_child(n, tree->lessthan_fn(node, n) ? 0 : 1);
+	}
+
+	if (n == NULL) {
+		return;
+	}
+
+	if (node == tree->min) {
+		tree->min = next_min(node, node->parent);
+	}
+
+	color = get_color(node);
+
+	if (get_child(node, 0) == NULL || get_child(node, 1) == NULL) {
+		child = get_child(node, 0);
+		if (child == NULL) {
+			child = get_child(node, 1);
+		}
+
+		parent = node->parent;
+		replace_child(tree, node, child);
+	} else {
+		/* Put the "biggest" node of side 0 in our place, the
+		 * parent pointers make this a plain relinking with no
+		 * special cases for the root.
+		 */
+		struct rbnode *node2 = get_child(node, 0);
+
+		while (get_child(node2, 1) != NULL) {
+			node2 = get_child(node2, 1);
+		}
+
+		color = get_color(node2);
+		child = get_child(node2, 0);
+
+		if (node2->parent == node) {
+			parent = node2;
+		} else {
+			parent = node2->parent;
+			replace_child(tree, node2, child);
+			set_child(node2, 0, get_child(node, 0));
+			get_child(node2, 0)->parent = node2;
+		}
+
+		replace_child(tree, node, node2);
+		set_child(node2, 1, get_child(node, 1));
+		get_child(node2, 1)->parent = node2;
+		set_color(node2, get_color(node));
+	}
+
+	if (color == BLACK) {
+		fix_missing_black(tree, child, parent);
+	}
+
+	if (tree->root == NULL) {
+		tree->max_depth = 0;
+	}
+}
+#endif /* CONFIG_RBTREE_PARENT_POINTERS */
 
 #ifndef CONFIG_MISRA_SANE
 void z_rb_walk(struct rbnode *node, rb_visit_t visit_fn, void *cookie)
@@ -217,3 +217,208 @@ u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size)
 
 	return total_size;
 }
+
+u32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *rb, u8_t **data,
+			      u32_t size)
+{
+	u32_t tail = atomic_get(&rb->tail);
+	u32_t offset = tail & (rb->size - 1);
+
+	size = MIN(size, ring_buf_spsc_space_get(rb));
+	size = MIN(size, rb->size - offset);
+
+	*data = &rb->buf[offset];
+
+	return size;
+}
+
+int ring_buf_spsc_put_commit(struct ring_buf_spsc *rb, u32_t size)
+{
+	if (size > ring_buf_spsc_space_get(rb)) {
+		return -EINVAL;
+	}
+
+	/* Publishes the data written before to the consumer */
+	atomic_add(&rb->tail, size);
+
+	return 0;
+}
+
+u32_t ring_buf_spsc_put(struct ring_buf_spsc *rb, const u8_t *data,
+			u32_t size)
+{
+	u32_t tail = atomic_get(&rb->tail);
+	u32_t offset = tail & (rb->size - 1);
+	u32_t first;
+
+	size = MIN(size, ring_buf_spsc_space_get(rb));
+	first = MIN(size, rb->size - offset);
+
+	memcpy(&rb->buf[offset], data, first);
+	memcpy(rb->buf, data + first, size - first);
+
+	atomic_add(&rb->tail, size);
+
+	return size;
+}
+
+u32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *rb, u8_t **data,
+			      u32_t size)
+{
+	u32_t head = atomic_get(&rb->head);
+	u32_t offset = head & (rb->size - 1);
+
+	size = MIN(size, ring_buf_spsc_used_get(rb));
+	size = MIN(size, rb->size - offset);
+
+	*data = &rb->buf[offset];
+
+	return size;
+}
+
+int ring_buf_spsc_get_commit(struct ring_buf_spsc *rb, u32_t size)
+{
+	if (size > ring_buf_spsc_used_get(rb)) {
+		return -EINVAL;
+	}
+
+	/* Hands the space back to the producer once the data is read */
+	atomic_add(&rb->head, size);
+
+	return 0;
+}
+
+u32_t ring_buf_spsc_get(struct ring_buf_spsc *rb, u8_t *data, u32_t size)
+{
+	u32_t head = atomic_get(&rb->head);
+	u32_t offset = head & (rb->size - 1);
+	u32_t first;
+
+	size = MIN(size, ring_buf_spsc_used_get(rb));
+	first = MIN(size, rb->size - offset);
+
+	memcpy(data, &rb->buf[offset], first);
+	memcpy(data + first, rb->buf, size - first);
+
+	atomic_add(&rb->head, size);
+
+	return size;
+}
+
+/*
+ * MPSC record slots follow the bounded queue of Dmitry Vyukov. Record
+ * positions run freely, the slot of position pos is (pos & mask) and
+ * its lap is (pos & ~mask). The state of a slot tells which side may
+ * use it for which position:
+ *
+ * - lap: free for a producer writing position lap + slot,
+ * - lap + 1: committed, the consumer may read position lap + slot,
+ * - lap + mask + 1: read, free for the producer of the next lap.
+ *
+ * All states start at 0, so a zeroed ring buffer is empty.
+ */
+static inline u32_t mpsc_lap(struct ring_buf_mpsc *rb, u32_t pos)
+{
+	return pos & ~rb->mask;
+}
+
+static inline u8_t *mpsc_record(struct ring_buf_mpsc *rb, u32_t pos)
+{
+	return &rb->buf[(pos & rb->mask) * rb->record_size];
+}
+
+void ring_buf_mpsc_init(struct ring_buf_mpsc *rb, u32_t record_size,
+			u32_t count, atomic_t *seq, void *data)
+{
+	__ASSERT(is_power_of_two(count), "count must be a power of 2");
+	/* With a single slot a committed record looks free on the next lap */
+	__ASSERT(count >= 2, "count must be at least 2");
+	__ASSERT((record_size % 4) == 0, "record size must be 4 aligned");
+
+	atomic_set(&rb->put_pos, 0);
+	rb->get_pos = 0U;
+	rb->mask = count - 1;
+	rb->record_size = record_size;
+	rb->seq = seq;
+	rb->buf = data;
+
+	for (u32_t i = 0; i < count; i++) {
+		atomic_set(&seq[i], 0);
+	}
+}
+
+void *ring_buf_mpsc_put_claim(struct ring_buf_mpsc *rb)
+{
+	u32_t pos, state;
+	s32_t diff;
+
+	do {
+		pos = atomic_get(&rb->put_pos);
+		state = atomic_get(&rb->seq[pos & rb->mask]);
+		diff = (s32_t)(state - mpsc_lap(rb, pos));
+
+		if (diff < 0) {
+			/* Not read yet in the previous lap */
+			return NULL;
+		}
+
+		/* Otherwise another producer took pos first: retry */
+	} while (diff != 0 || !atomic_cas(&rb->put_pos, pos, pos + 1));
+
+	return mpsc_record(rb, pos);
+}
+
+void ring_buf_mpsc_put_commit(struct ring_buf_mpsc *rb, void *record)
+{
+	u32_t slot = ((u8_t *)record - rb->buf) / rb->record_size;
+
+	/* Only the owner of a reserved slot changes its state */
+	atomic_inc(&rb->seq[slot]);
+}
+
+int ring_buf_mpsc_put(struct ring_buf_mpsc *rb, const void *record)
+{
+	void *dst = ring_buf_mpsc_put_claim(rb);
+
+	if (dst == NULL) {
+		return -ENOMEM;
+	}
+
+	memcpy(dst, record, rb->record_size);
+	ring_buf_mpsc_put_commit(rb, dst);
+
+	return 0;
+}
+
+void *ring_buf_mpsc_get_claim(struct ring_buf_mpsc *rb)
+{
+	u32_t pos = rb->get_pos;
+	u32_t state = atomic_get(&rb->seq[pos & rb->mask]);
+
+	if (state != mpsc_lap(rb, pos) + 1) {
+		return NULL;
+	}
+
+	return mpsc_record(rb, pos);
+}
+
+void ring_buf_mpsc_get_commit(struct ring_buf_mpsc *rb)
+{
+	u32_t pos = rb->get_pos++;
+
+	atomic_set(&rb->seq[pos & rb->mask], mpsc_lap(rb, pos) + rb->mask + 1);
+}
+
+int ring_buf_mpsc_get(struct ring_buf_mpsc *rb, void *record)
+{
+	void *src = ring_buf_mpsc_get_claim(rb);
+
+	if (src == NULL) {
+		return -EAGAIN;
+	}
+
+	memcpy(record, src, rb->record_size);
+	ring_buf_mpsc_get_commit(rb);
+
+	return 0;
+}
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <sys/tlsf.h>
+#include <sys/__assert.h>
+
+#define SL_LOG2		CONFIG_SYS_TLSF_SL_LOG2
+#define SL_COUNT	(1U << SL_LOG2)
+
+/* Block addresses and sizes are multiples of two words, which leaves
+ * the two low bits of the size free for flags.
+ */
+#define ALIGN		(2 * sizeof(void *))
+#define ALIGN_LOG2	(sizeof(void *) == 8 ? 4 : 3)
+
+/* Blocks smaller than SMALL_BLOCK all go to the first level list 0,
+ * split in second level lists of ALIGN bytes each.
+ */
+#define FL_SHIFT	(SL_LOG2 + ALIGN_LOG2)
+#define SMALL_BLOCK	(1U << FL_SHIFT)
+
+/* Block sizes stay below 2 GiB so that they map with 32-bit bitmaps */
+#define MAX_HEAP	((1U << 31) - ALIGN)
+#define FL_MAX		(32 - FL_SHIFT)
+
+#define BLOCK_FREE	BIT(0)
+#define BLOCK_PREV_FREE	BIT(1)
+#define BLOCK_FLAGS	(BLOCK_FREE | BLOCK_PREV_FREE)
+
+struct block {
+	/* Previous block in memory, only valid if that one is free */
+	struct block *prev_phys;
+	/* Size including this header, and the BLOCK_* flags */
+	size_t size;
+	/* Free list links, only present in free blocks */
+	struct block *next_free;
+	struct block *prev_free;
+};
+
+#define HDR_SIZE	offsetof(struct block, next_free)
+#define MIN_BLOCK	sizeof(struct block)
+
+struct z_tlsf {
+	/* First block, and the zero sized used block ending the heap */
+	struct block *first;
+	struct block *last;
+	u32_t fl_count;
+	u32_t fl_bitmap;
+	u32_t sl_bitmap[FL_MAX];
+	/* fl_count * SL_COUNT free list heads */
+	struct block *free[];
+};
+
+static inline size_t block_size(struct block *b)
+{
+	return b->size & ~(size_t)BLOCK_FLAGS;
+}
+
+static inline struct block *next_phys(struct block *b)
+{
+	return (struct block *)((u8_t *)b + block_size(b));
+}
+
+static inline void *block_mem(struct block *b)
+{
+	return (u8_t *)b + HDR_SIZE;
+}
+
+static inline struct block *mem_block(void *mem)
+{
+	return (struct block *)((u8_t *)mem - HDR_SIZE);
+}
+
+static void mapping(size_t size, u32_t *fl, u32_t *sl)
+{
+	if (size < SMALL_BLOCK) {
+		*fl = 0U;
+		*sl = size / ALIGN;
+	} else {
+		u32_t msb = find_msb_set(size) - 1;
+
+		*fl = msb - FL_SHIFT + 1;
+		*sl = (size >> (msb - SL_LOG2)) - SL_COUNT;
+	}
+}
+
+static inline struct block **free_head(struct z_tlsf *t, u32_t fl, u32_t sl)
+{
+	return &t->free[fl * SL_COUNT + sl];
+}
+
+static void free_list_insert(struct z_tlsf *t, struct block *b)
+{
+	struct block **head;
+	u32_t fl, sl;
+
+	mapping(block_size(b), &fl, &sl);
+	head = free_head(t, fl, sl);
+
+	b->prev_free = NULL;
+	b->next_free = *head;
+	if (*head != NULL) {
+		(*head)->prev_free = b;
+	}
+	*head = b;
+
+	t->fl_bitmap |= BIT(fl);
+	t->sl_bitmap[fl] |= BIT(sl);
+}
+
+static void free_list_remove(struct z_tlsf *t, struct block *b)
+{
+	struct block **head;
+	u32_t fl, sl;
+
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b->prev_free;
+	}
+
+	if (b->prev_free != NULL) {
+		b->prev_free->next_free = b->next_free;
+		return;
+	}
+
+	mapping(block_size(b), &fl, &sl);
+	head = free_head(t, fl, sl);
+
+	*head = b->next_free;
+	if (*head == NULL) {
+		t->sl_bitmap[fl] &= ~BIT(sl);
+		if (t->sl_bitmap[fl] == 0U) {
+			t->fl_bitmap &= ~BIT(fl);
+		}
+	}
+}
+
+/* Any block on the returned list is at least @a size bytes: the size
+ * is rounded up to the next list boundary before looking for the first
+ * non-empty list, so that no list has to be searched.
+ */
+static struct block *find_free(struct z_tlsf *t, size_t size)
+{
+	u32_t fl, sl, map;
+
+	if (size >= SMALL_BLOCK) {
+		size += BIT(find_msb_set(size) - 1 - SL_LOG2) - 1;
+		if (size > MAX_HEAP) {
+			return NULL;
+		}
+	}
+
+	mapping(size, &fl, &sl);
+	if (fl >= t->fl_count) {
+		return NULL;
+	}
+
+	map = t->sl_bitmap[fl] & (~0U << sl);
+	if (map == 0U) {
+		map = t->fl_bitmap & (~0U << (fl + 1));
+		if (map == 0U) {
+			return NULL;
+		}
+
+		fl = find_lsb_set(map) - 1;
+		map = t->sl_bitmap[fl];
+	}
+
+	sl = find_lsb_set(map) - 1;
+
+	return *free_head(t, fl, sl);
+}
+
+/* Marks a block free, merges it with its free neighbours and puts the
+ * result on the free lists.
+ */
+static void block_release(struct z_tlsf *t, struct block *b)
+{
+	struct block *next = next_phys(b);
+
+	if ((b->size & BLOCK_PREV_FREE) != 0U) {
+		struct block *prev = b->prev_phys;
+
+		free_list_remove(t, prev);
+		prev->size += block_size(b);
+		b = prev;
+	}
+
+	if ((next->size & BLOCK_FREE) != 0U) {
+		free_list_remove(t, next);
+		b->size += block_size(next);
+		next = next_phys(b);
+	}
+
+	b->size |= BLOCK_FREE;
+	next->size |= BLOCK_PREV_FREE;
+	next->prev_phys = b;
+
+	free_list_insert(t, b);
+}
+
+/* Trims a used block to @a size bytes, releasing the rest if it is
+ * large enough to be a block of its own.
+ */
+static void block_trim(struct z_tlsf *t, struct block *b, size_t size)
+{
+	size_t rest = block_size(b) - size;
+	struct block *r;
+
+	if (rest < MIN_BLOCK) {
+		return;
+	}
+
+	b->size -= rest;
+
+	r = next_phys(b);
+	r->size = rest;
+	block_release(t, r);
+}
+
+/* Block size needed for an allocation, 0 if it cannot be satisfied */
+static size_t block_need(size_t bytes)
+{
+	size_t need;
+
+	if (bytes == 0 || bytes > MAX_HEAP) {
+		return 0;
+	}
+
+	need = ROUND_UP(bytes + HDR_SIZE, ALIGN);
+
+	return MAX(need, MIN_BLOCK);
+}
+
+void sys_tlsf_init(struct sys_tlsf *h, void *mem, size_t bytes)
+{
+	uintptr_t start = ROUND_UP((uintptr_t)mem, ALIGN);
+	uintptr_t end = ROUND_DOWN((uintptr_t)mem + bytes, ALIGN);
+	struct z_tlsf *t = (struct z_tlsf *)start;
+	size_t control;
+	u32_t fl, sl;
+
+	__ASSERT(end > start, "heap memory too small");
+
+	if (end - start > MAX_HEAP) {
+		end = start + MAX_HEAP;
+	}
+
+	/* Enough lists for the largest block the memory could hold */
+	mapping(end - start, &fl, &sl);
+	control = ROUND_UP(offsetof(struct z_tlsf, free) +
+			   (fl + 1) * SL_COUNT * sizeof(struct block *),
+			   ALIGN);
+
+	__ASSERT(end - start >= control + MIN_BLOCK + HDR_SIZE,
+		 "heap memory too small");
+
+	(void)memset(t, 0, control);
+	t->fl_count = fl + 1;
+	t->first = (struct block *)(start + control);
+	t->last = (struct block *)(end - HDR_SIZE);
+
+	t->last->size = 0;
+	t->first->size = (uintptr_t)t->last - (uintptr_t)t->first;
+	block_release(t, t->first);
+
+	h->tlsf = t;
+}
+
+void *sys_tlsf_alloc(struct sys_tlsf *h, size_t bytes)
+{
+	struct z_tlsf *t = h->tlsf;
+	size_t need = block_need(bytes);
+	struct block *b;
+
+	if (need == 0) {
+		return NULL;
+	}
+
+	b = find_free(t, need);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	free_list_remove(t, b);
+	b->size &= ~(size_t)BLOCK_FREE;
+	next_phys(b)->size &= ~(size_t)BLOCK_PREV_FREE;
+
+	block_trim(t, b, need);
+
+	return block_mem(b);
+}
+
+void sys_tlsf_free(struct sys_tlsf *h, void *mem)
+{
+	struct block *b;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	b = mem_block(mem);
+
+	__ASSERT(sys_tlsf_owns(h, mem), "%p not from this heap", mem);
+	__ASSERT((b->size & BLOCK_FREE) == 0U, "%p already free", mem);
+
+	block_release(h->tlsf, b);
+}
+
+void *sys_tlsf_realloc(struct sys_tlsf *h, void *mem, size_t bytes)
+{
+	struct z_tlsf *t = h->tlsf;
+	struct block *b, *next;
+	size_t need, size;
+	void *new_mem;
+
+	if (mem == NULL) {
+		return sys_tlsf_alloc(h, bytes);
+	}
+
+	if (bytes == 0) {
+		sys_tlsf_free(h, mem);
+		return NULL;
+	}
+
+	need = block_need(bytes);
+	if (need == 0) {
+		return NULL;
+	}
+
+	b = mem_block(mem);
+	size = block_size(b);
+
+	if (need <= size) {
+		block_trim(t, b, need);
+		return mem;
+	}
+
+	next = next_phys(b);
+	if ((next->size & BLOCK_FREE) != 0U &&
+	    size + block_size(next) >= need) {
+		free_list_remove(t, next);
+		b->size += block_size(next);
+		next_phys(b)->size &= ~(size_t)BLOCK_PREV_FREE;
+
+		block_trim(t, b, need);
+		return mem;
+	}
+
+	new_mem = sys_tlsf_alloc(h, bytes);
+	if (new_mem != NULL) {
+		(void)memcpy(new_mem, mem, size - HDR_SIZE);
+		block_release(t, b);
+	}
+
+	return new_mem;
+}
+
+bool sys_tlsf_owns(struct sys_tlsf *h, void *mem)
+{
+	struct z_tlsf *t = h->tlsf;
+
+	return (u8_t *)mem >= (u8_t *)t->first &&
+	       (u8_t *)mem < (u8_t *)t->last;
+}
+
+void sys_tlsf_stats_get(struct sys_tlsf *h, struct sys_tlsf_stats *stats)
+{
+	struct z_tlsf *t = h->tlsf;
+	size_t free_size = 0;
+	struct block *b;
+
+	stats->free_bytes = 0;
+	stats->max_free_block = 0;
+
+	for (u32_t i = 0; i < t->fl_count * SL_COUNT; i++) {
+		for (b = t->free[i]; b != NULL; b = b->next_free) {
+			size_t usable = block_size(b) - HDR_SIZE;
+
+			free_size += block_size(b);
+			stats->free_bytes += usable;
+			stats->max_free_block = MAX(stats->max_free_block,
+						    usable);
+		}
+	}
+
+	stats->allocated_bytes = (uintptr_t)t->last - (uintptr_t)t->first -
+				 free_size;
+}
+
+bool sys_tlsf_validate(struct sys_tlsf *h)
+{
+	struct z_tlsf *t = h->tlsf;
+	struct block *b, *prev = NULL;
+	size_t free_blocks = 0;
+	u32_t fl, sl;
+
+	for (b = t->first; b != t->last; b = next_phys(b)) {
+		bool prev_free = prev != NULL &&
+				 (prev->size & BLOCK_FREE) != 0U;
+
+		if (((uintptr_t)b % ALIGN) != 0U ||
+		    block_size(b) < MIN_BLOCK ||
+		    block_size(b) > (uintptr_t)t->last - (uintptr_t)b) {
+			return false;
+		}
+
+		if (prev_free != ((b->size & BLOCK_PREV_FREE) != 0U) ||
+		    (prev_free && b->prev_phys != prev)) {
+			return false;
+		}
+
+		if ((b->size & BLOCK_FREE) != 0U) {
+			/* Free neighbours must have been merged */
+			if (prev_free) {
+				return false;
+			}
+			free_blocks++;
+		}
+
+		prev = b;
+	}
+
+	if ((prev->size & BLOCK_FREE) !=
+	    ((t->last->size & BLOCK_PREV_FREE) != 0U ? BLOCK_FREE : 0U)) {
+		return false;
+	}
+
+	for (fl = 0; fl < FL_MAX; fl++) {
+		bool fl_used = fl < t->fl_count && t->sl_bitmap[fl] != 0U;
+
+		if (fl_used != ((t->fl_bitmap & BIT(fl)) != 0U) ||
+		    (fl >= t->fl_count && t->sl_bitmap[fl] != 0U)) {
+			return false;
+		}
+
+		for (sl = 0; fl < t->fl_count && sl < SL_COUNT; sl++) {
+			struct block *head = *free_head(t, fl, sl);
+
+			if ((head != NULL) !=
+			    ((t->sl_bitmap[fl] & BIT(sl)) != 0U)) {
+				return false;
+			}
+
+			for (b = head, prev = NULL; b != NULL;
+			     prev = b, b = b->next_free) {
+				u32_t b_fl, b_sl;
+
+				mapping(block_size(b), &b_fl, &b_sl);
+				if ((b->size & BLOCK_FREE) == 0U ||
+				    b->prev_free != prev ||
+				    b_fl != fl || b_sl != sl ||
+				    free_blocks == 0) {
+					return false;
+				}
+				free_blocks--;
+			}
+		}
+	}
+
+	return free_blocks == 0;
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Script to generate the database used to decode dictionary format logs
+
+With CONFIG_LOG_DICTIONARY_ENABLE, log messages leave the target as binary
+records holding the addresses of their format strings and the ID of their
+source instead of text. This script extracts from the ELF file what the host
+needs to format them again:
+
+- the target byte order and pointer size,
+- the names of the log sources, indexed by source ID,
+- the content of the read-only data sections, where the format strings
+  and source names live.
+
+The database is written in JSON and read by log_dict_parser.py.
+"""
+
+import sys
+import argparse
+import json
+import struct
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+from elftools.elf.constants import SH_FLAGS
+
+
+def parse_args():
+    global args
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-e", "--elf", required=True,
+                        help="Zephyr ELF file")
+    parser.add_argument("-o", "--output", required=True,
+                        help="Output JSON database")
+    args = parser.parse_args()
+
+
+def get_symbols(elf):
+    for section in elf.iter_sections():
+        if isinstance(section, SymbolTableSection):
+            return {sym.name: sym['st_value']
+                    for sym in section.iter_symbols()}
+
+    raise LookupError("Could not find symbol table")
+
+
+def get_ro_sections(elf):
+    sections = []
+
+    for section in elf.iter_sections():
+        flags = section['sh_flags']
+
+        # Log sources are constant but not always in a read-only section
+        if section.name != 'log_const_sections' and \
+           (section['sh_type'] != 'SHT_PROGBITS' or
+            not flags & SH_FLAGS.SHF_ALLOC or
+            flags & (SH_FLAGS.SHF_WRITE | SH_FLAGS.SHF_EXECINSTR)):
+            continue
+
+        sections.append((section.name, section['sh_addr'], section.data()))
+
+    return sections
+
+
+def read_mem(sections, addr, size):
+    for _, start, data in sections:
+        if start <= addr and addr + size <= start + len(data):
+            return data[addr - start:addr - start + size]
+
+    return None
+
+
+def read_string(sections, addr):
+    for _, start, data in sections:
+        if start <= addr < start + len(data):
+            end = data.index(b'\0', addr - start)
+            return data[addr - start:end].decode('utf-8', 'replace')
+
+    return None
+
+
+def get_sources(elf, symbols, sections):
+    ptr_size = elf.elfclass // 8
+    ptr_fmt = ('<' if elf.little_endian else '>') + \
+              ('Q' if ptr_size == 8 else 'I')
+    # struct log_source_const_data: name pointer and level, padded
+    entry_size = 2 * ptr_size
+
+    start = symbols.get('__log_const_start')
+    end = symbols.get('__log_const_end')
+    if start is None or end is None:
+        return []
+
+    sources = []
+    for addr in range(start, end, entry_size):
+        data = read_mem(sections, addr, ptr_size)
+        if data is None:
+            sys.exit("Log source at 0x%x not found in %s" %
+                     (addr, args.elf))
+
+        name_addr, = struct.unpack(ptr_fmt, data)
+        sources.append(read_string(sections, name_addr))
+
+    return sources
+
+
+def main():
+    parse_args()
+
+    with open(args.elf, 'rb') as f:
+        elf = ELFFile(f)
+        symbols = get_symbols(elf)
+        sections = get_ro_sections(elf)
+
+        db = {
+            'little_endian': elf.little_endian,
+            'pointer_size': elf.elfclass // 8,
+            'arg_size': elf.elfclass // 8,
+            'sources': get_sources(elf, symbols, sections),
+            'sections': [{'name': name, 'address': addr, 'data': data.hex()}
+                         for name, addr, data in sections],
+        }
+
+    with open(args.output, 'w') as f:
+        json.dump(db, f)
+
+
+if __name__ == "__main__":
+    main()
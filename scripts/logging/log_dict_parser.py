@@ -0,0 +1,433 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Script to format dictionary format logs on the host
+
+Reads the binary records a backend outputs with CONFIG_LOG_DICTIONARY_ENABLE,
+from a file or a serial port, and prints them as the text the target would
+have printed. The database generated by gen_log_dict_db.py at build time
+(log_dictionary.json in the build directory) must come from the same build
+as the firmware.
+
+Each record starts with a sync marker. Data that does not decode as a
+record, for instance after bytes were lost on the link, is skipped up to
+the next marker.
+"""
+
+import sys
+import argparse
+import json
+import struct
+
+SYNC = b'\xa5\x5a'
+
+RECORD_STD = 0
+RECORD_HEXDUMP = 1
+RECORD_DROPPED = 2
+
+LEVELS = [None, "err", "wrn", "inf", "dbg"]
+
+# Characters the target skips between '%' and the conversion
+SPEC_CHARS = "-+ #0123456789.*lhjzt"
+LENGTH_CHARS = "lhjzt"
+FLOAT_CONVS = "aAeEfFgG"
+
+# Argument words of a record, at most two per argument
+MAX_ARG_WORDS = 2 * 15
+
+HEXDUMP_BYTES_IN_LINE = 16
+
+
+def parse_args():
+    global args
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-d", "--database", required=True,
+                        help="log_dictionary.json of the build")
+    parser.add_argument("-i", "--input", default="-",
+                        help="captured log data, standard input by default")
+    parser.add_argument("-s", "--serial_port",
+                        help="serial port to read the log data from")
+    parser.add_argument("-b", "--serial_baudrate", default=115200, type=int,
+                        help="serial baudrate")
+    parser.add_argument("-f", "--timestamp_freq", type=int,
+                        help="timestamp frequency in Hz, raw timestamps "
+                        "are printed when not given")
+    args = parser.parse_args()
+
+
+class Database:
+    def __init__(self, path):
+        with open(path) as f:
+            db = json.load(f)
+
+        self.endian = '<' if db['little_endian'] else '>'
+        self.ptr_fmt = 'Q' if db['pointer_size'] == 8 else 'I'
+        self.arg_size = db['arg_size']
+        self.arg_fmt = 'Q' if self.arg_size == 8 else 'I'
+        self.sources = db['sources']
+        self.sections = [(s['address'], bytes.fromhex(s['data']))
+                         for s in db['sections']]
+
+    def string(self, addr):
+        for start, data in self.sections:
+            if start <= addr < start + len(data):
+                end = data.index(b'\0', addr - start)
+                return data[addr - start:end].decode('utf-8', 'replace')
+
+        return None
+
+    def source(self, source_id):
+        if source_id < len(self.sources):
+            return self.sources[source_id]
+
+        return "<source %u>" % source_id
+
+
+class RecordError(Exception):
+    pass
+
+
+class Reader:
+    def __init__(self, stream, endian):
+        self.stream = stream
+        self.endian = endian
+        # Data given back after a bad record, read again first
+        self.pending = b''
+        # Data read since the sync marker of the current record
+        self.record = None
+
+    def read(self, size):
+        data = self.pending[:size]
+        self.pending = self.pending[size:]
+
+        while len(data) < size:
+            more = self.stream.read(size - len(data))
+            if not more:
+                raise EOFError
+            data += more
+
+        if self.record is not None:
+            self.record += data
+
+        return data
+
+    def sync(self):
+        """Skip to the data following the next sync marker"""
+        self.record = None
+        window = b''
+
+        while window != SYNC:
+            window = (window + self.read(1))[-len(SYNC):]
+
+        self.record = b''
+
+    def resync(self):
+        """Give back what was read of a bad record, to look for a marker"""
+        self.pending = self.record + self.pending
+        self.record = None
+
+    def unpack(self, fmt):
+        return struct.unpack(self.endian + fmt,
+                             self.read(struct.calcsize(self.endian + fmt)))
+
+    def string(self):
+        data = b''
+        while True:
+            c = self.read(1)
+            if c == b'\0':
+                return data.decode('utf-8', 'replace')
+            data += c
+
+
+def parse_format(fmt):
+    """
+    Split a format string in text and conversion specifications, the way
+    the target scans it to know which arguments are strings.
+    """
+    parts = []
+    text = ''
+    i = 0
+
+    while i < len(fmt):
+        c = fmt[i]
+        i += 1
+
+        if c != '%':
+            text += c
+            continue
+
+        if i < len(fmt) and fmt[i] == '%':
+            text += '%'
+            i += 1
+            continue
+
+        start = i
+        while i < len(fmt) and fmt[i] in SPEC_CHARS:
+            i += 1
+
+        if i == len(fmt):
+            break
+
+        parts.append(text)
+        parts.append((fmt[start:i], fmt[i]))
+        text = ''
+        i += 1
+
+    parts.append(text)
+
+    return parts
+
+
+def is_64(mod, conv):
+    """Whether the argument is sent as a 64-bit value"""
+    return conv in FLOAT_CONVS or mod.count('l') > 1 or 'j' in mod
+
+
+def arg_convs(parts):
+    """Modifiers and conversion of each argument consumed by the format"""
+    convs = []
+
+    for part in parts:
+        if isinstance(part, tuple):
+            mod, conv = part
+            convs += [('', 'd')] * mod.count('*') + [(mod, conv)]
+
+    return convs
+
+
+def string_count(convs, nwords, arg_size):
+    """Number of %s arguments among those held by nwords words"""
+    count = 0
+
+    for mod, conv in convs:
+        nwords -= 8 // arg_size if is_64(mod, conv) else 1
+        if nwords < 0:
+            break
+        if conv == 's':
+            count += 1
+
+    return count
+
+
+class Args:
+    """Argument words of a record"""
+    def __init__(self, data, endian, arg_fmt):
+        self.data = data
+        self.endian = endian
+        self.arg_fmt = arg_fmt
+
+    def __bool__(self):
+        return len(self.data) > 0
+
+    def pop(self, fmt):
+        size = struct.calcsize(self.endian + fmt)
+        if len(self.data) < size:
+            raise IndexError
+
+        value, = struct.unpack(self.endian + fmt, self.data[:size])
+        self.data = self.data[size:]
+
+        return value
+
+    def word(self):
+        return self.pop(self.arg_fmt)
+
+
+def signed(value, bits):
+    value &= (1 << bits) - 1
+
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def format_spec(mod, conv, args, strings, arg_size):
+    flags = ''.join(c for c in mod if c not in LENGTH_CHARS)
+    length = ''.join(c for c in mod if c in LENGTH_CHARS)
+
+    while '*' in flags:
+        flags = flags.replace('*', str(signed(args.word(), 32)), 1)
+
+    if conv in FLOAT_CONVS:
+        return ('%' + flags + conv) % args.pop('d')
+
+    if is_64(mod, conv):
+        value = args.pop('Q')
+        bits = 64
+    else:
+        value = args.word()
+        if length in ('l', 'z', 't'):
+            bits = arg_size * 8
+        elif length == 'h':
+            bits = 16
+        elif length == 'hh':
+            bits = 8
+        else:
+            bits = 32
+
+    if conv in 'di':
+        return ('%' + flags + 'd') % signed(value, bits)
+    if conv == 'u':
+        return ('%' + flags + 'd') % (value & ((1 << bits) - 1))
+    if conv in 'xXo':
+        return ('%' + flags + conv) % (value & ((1 << bits) - 1))
+    if conv == 'c':
+        return ('%' + flags + 'c') % chr(value & 0xff)
+    if conv == 's':
+        return ('%' + flags + 's') % strings.pop(0)
+    if conv == 'p':
+        return '0x%x' % value
+
+    return '%' + mod + conv
+
+
+def format_message(fmt, args, strings, arg_size):
+    out = ''
+    strings = list(strings)
+
+    for part in parse_format(fmt):
+        if isinstance(part, tuple):
+            try:
+                out += format_spec(part[0], part[1], args, strings,
+                                   arg_size)
+            except IndexError:
+                out += '<missing argument>'
+                break
+        else:
+            out += part
+
+    return out
+
+
+def timestamp_str(timestamp):
+    if not args.timestamp_freq:
+        return "[%08u]" % timestamp
+
+    us = timestamp * 1000000 // args.timestamp_freq
+    seconds = us // 1000000
+
+    return "[%02u:%02u:%02u.%03u,%03u]" % (seconds // 3600,
+                                          (seconds // 60) % 60,
+                                          seconds % 60,
+                                          (us // 1000) % 1000, us % 1000)
+
+
+def prefix_str(db, level, source_id, timestamp):
+    return "%s <%s> %s: " % (timestamp_str(timestamp), LEVELS[level],
+                             db.source(source_id))
+
+
+def hexdump_str(prefix, data):
+    lines = []
+
+    for i in range(0, len(data), HEXDUMP_BYTES_IN_LINE):
+        line = data[i:i + HEXDUMP_BYTES_IN_LINE]
+        hexs = ' '.join('%02x' % b for b in line)
+        text = ''.join(chr(b) if 32 <= b < 127 else '.' for b in line)
+        lines.append(' ' * len(prefix) + '%-*s |%s' %
+                     (3 * HEXDUMP_BYTES_IN_LINE, hexs, text))
+
+    return '\n'.join(lines)
+
+
+def process_record(db, reader):
+    reader.sync()
+
+    ctrl, = reader.unpack('B')
+    record = ctrl & 0x3
+    level = (ctrl >> 2) & 0x7
+
+    if level >= len(LEVELS):
+        raise RecordError("invalid level %u" % level)
+
+    if record == RECORD_DROPPED:
+        if ctrl != RECORD_DROPPED:
+            raise RecordError("invalid dropped record")
+
+        count, = reader.unpack('I')
+        return "--- %u messages dropped ---\n" % count
+
+    source_id, timestamp = reader.unpack('HI')
+    addr, = reader.unpack(db.ptr_fmt)
+
+    if record == RECORD_STD:
+        fmt = db.string(addr)
+        if fmt is None:
+            raise RecordError("unknown format string 0x%x" % addr)
+
+        nwords, = reader.unpack('B')
+        if nwords > MAX_ARG_WORDS:
+            raise RecordError("too many arguments")
+
+        log_args = Args(reader.read(nwords * db.arg_size), db.endian,
+                        db.arg_fmt)
+        strings = [reader.string() for i in
+                   range(string_count(arg_convs(parse_format(fmt)),
+                                      nwords, db.arg_size))]
+        msg = format_message(fmt, log_args, strings, db.arg_size)
+
+        if level == 0:
+            return msg
+
+        return prefix_str(db, level, source_id, timestamp) + msg + '\n'
+
+    if record == RECORD_HEXDUMP:
+        length, = reader.unpack('H')
+        data = reader.read(length)
+
+        if level == 0:
+            return data.decode('utf-8', 'replace')
+
+        prefix = prefix_str(db, level, source_id, timestamp)
+        metadata = db.string(addr) if addr else ''
+        if metadata is None:
+            raise RecordError("unknown metadata string 0x%x" % addr)
+
+        return prefix + metadata + '\n' + hexdump_str(prefix, data) + '\n'
+
+    raise RecordError("unknown record type %u" % record)
+
+
+def process_stream(db, reader):
+    """Formatted records of the stream, until its end"""
+    while True:
+        try:
+            yield process_record(db, reader)
+        except RecordError as e:
+            sys.stderr.write("Skipping bad record (%s), is the database "
+                             "matching the firmware?\n" % e)
+            reader.resync()
+        except EOFError:
+            return
+
+
+def main():
+    parse_args()
+
+    db = Database(args.database)
+
+    if args.serial_port:
+        import serial
+        stream = serial.Serial(args.serial_port, args.serial_baudrate)
+    elif args.input == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.input, 'rb')
+
+    reader = Reader(stream, db.endian)
+
+    try:
+        for text in process_stream(db, reader):
+            sys.stdout.write(text)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+# Copyright (c) 2020 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import io
+import json
+import struct
+
+import pytest
+
+import log_dict_parser as parser
+
+FMT_ADDR = 0x1000
+META_ADDR = 0x1100
+
+FORMATS = {
+    FMT_ADDR: "a %d %s %lld %.2f %x",
+    META_ADDR: "data",
+}
+
+
+def make_db(tmp_path, arg_size):
+    section = bytearray(0x200)
+    for addr, text in FORMATS.items():
+        data = text.encode() + b'\0'
+        section[addr - FMT_ADDR:addr - FMT_ADDR + len(data)] = data
+
+    db = {
+        'little_endian': True,
+        'pointer_size': arg_size,
+        'arg_size': arg_size,
+        'sources': ['main', 'test'],
+        'sections': [{'address': FMT_ADDR, 'data': section.hex()}],
+    }
+    path = tmp_path / 'log_dictionary.json'
+    path.write_text(json.dumps(db))
+
+    return parser.Database(str(path))
+
+
+def hdr(record, level, addr, arg_size):
+    ptr = 'Q' if arg_size == 8 else 'I'
+
+    return parser.SYNC + struct.pack('<BHI' + ptr, record | (level << 2),
+                                     1, 42, addr)
+
+
+def std_record(arg_size):
+    word = 'Q' if arg_size == 8 else 'I'
+    words = struct.pack('<' + word + word, (1 << (8 * arg_size)) - 5, 0)
+    words += struct.pack('<qd', -0x123456789, 1.5)
+    words += struct.pack('<' + word, 0xbeef)
+
+    return hdr(parser.RECORD_STD, 2, FMT_ADDR, arg_size) + \
+        struct.pack('<B', len(words) // arg_size) + words + b'str\0'
+
+
+def hexdump_record(arg_size):
+    return hdr(parser.RECORD_HEXDUMP, 3, META_ADDR, arg_size) + \
+        struct.pack('<H', 4) + b'ab\x00\x7f'
+
+
+def dropped_record():
+    return parser.SYNC + struct.pack('<BI', parser.RECORD_DROPPED, 7)
+
+
+STD_TEXT = "[00000042] <wrn> test: a -5 str -4886718345 1.50 beef\n"
+HEXDUMP_TEXT = ("[00000042] <inf> test: data\n" + ' ' * 23 +
+                '%-48s |ab..\n' % '61 62 00 7f')
+DROPPED_TEXT = "--- 7 messages dropped ---\n"
+
+
+@pytest.fixture(autouse=True)
+def parser_args():
+    parser.args = argparse.Namespace(timestamp_freq=None)
+
+
+def parse(db, data):
+    reader = parser.Reader(io.BytesIO(data), db.endian)
+
+    return ''.join(parser.process_stream(db, reader))
+
+
+@pytest.mark.parametrize('arg_size', [4, 8])
+def test_records(tmp_path, arg_size):
+    db = make_db(tmp_path, arg_size)
+    data = std_record(arg_size) + hexdump_record(arg_size) + \
+        dropped_record()
+
+    assert parse(db, data) == STD_TEXT + HEXDUMP_TEXT + DROPPED_TEXT
+
+
+def test_64bit_arguments_take_two_words(tmp_path):
+    db = make_db(tmp_path, 4)
+    record = std_record(4)
+
+    # 1 word each for %d and %s, 2 for %lld and %.2f, 1 for %x
+    assert record[len(parser.SYNC) + struct.calcsize("<BHII")] == 7
+    assert parse(db, record) == STD_TEXT
+
+
+def test_missing_arguments(tmp_path):
+    db = make_db(tmp_path, 4)
+    data = hdr(parser.RECORD_STD, 2, FMT_ADDR, 4) + \
+        struct.pack('<BII', 2, 3, 0) + b'str\0'
+
+    assert parse(db, data) == \
+        "[00000042] <wrn> test: a 3 str <missing argument>\n"
+
+
+def test_resync_after_garbage(tmp_path, capsys):
+    db = make_db(tmp_path, 4)
+    data = b'\x00\xa5\xff' + std_record(4) + \
+        parser.SYNC + b'\x03garbage' + dropped_record()
+
+    assert parse(db, data) == STD_TEXT + DROPPED_TEXT
+    assert 'unknown record type' in capsys.readouterr().err
+
+
+def test_resync_inside_bad_record(tmp_path):
+    db = make_db(tmp_path, 4)
+    # A record cut short by lost bytes, the next one starts in its body
+    cut = std_record(4)[:10]
+
+    assert parse(db, cut + std_record(4)) == STD_TEXT
+
+
+def test_unknown_format_string(tmp_path, capsys):
+    db = make_db(tmp_path, 4)
+    data = hdr(parser.RECORD_STD, 2, 0x42, 4) + dropped_record()
+
+    assert parse(db, data) == DROPPED_TEXT
+    assert 'unknown format string' in capsys.readouterr().err
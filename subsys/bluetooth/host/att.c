@@ -734,7 +734,6 @@ static u8_t err_to_att(int err)
 
 struct read_type_data {
 	struct bt_att *att;
-	struct bt_uuid *uuid;
 	struct net_buf *buf;
 	struct bt_att_read_type_rsp *rsp;
 	struct bt_att_data *item;
@@ -748,11 +747,6 @@ static u8_t read_type_cb(const struct bt_gatt_attr *attr, void *user_data)
 	struct bt_conn *conn = att->chan.chan.conn;
 	int read;
 
-	/* Skip if doesn't match */
-	if (bt_uuid_cmp(attr->uuid, data->uuid)) {
-		return BT_GATT_ITER_CONTINUE;
-	}
-
 	BT_DBG("handle 0x%04x", attr->handle);
 
 	/*
@@ -822,14 +816,14 @@ static u8_t att_read_type_rsp(struct bt_att *att, struct bt_uuid *uuid,
 	}
 
 	data.att = att;
-	data.uuid = uuid;
 	data.rsp = net_buf_add(data.buf, sizeof(*data.rsp));
 	data.rsp->len = 0U;
 
 	/* Pre-set error if no attr will be found in handle */
 	data.err = BT_ATT_ERR_ATTRIBUTE_NOT_FOUND;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, read_type_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle, uuid, NULL, 0,
+				  read_type_cb, &data);
 
 	if (data.err) {
 		net_buf_unref(data.buf);
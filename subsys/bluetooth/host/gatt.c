@@ -78,6 +78,119 @@ static sys_slist_t db;
 
 static atomic_t init;
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+struct gatt_index_entry {
+	const struct bt_gatt_attr *attr;
+	u32_t uuid_key;
+	u16_t handle;
+};
+
+/* All attributes sorted by handle, static ones first, and their
+ * positions sorted by UUID key then handle. Static attributes are
+ * constant and have no handle set, their handle is the position + 1.
+ */
+static struct {
+	struct gatt_index_entry attrs[CONFIG_BT_GATT_DB_INDEX_SIZE];
+	u16_t by_uuid[CONFIG_BT_GATT_DB_INDEX_SIZE];
+	u16_t count;
+	bool valid;
+} gatt_index;
+
+/* UUIDs comparing equal map to the same key: 16 and 32-bit UUIDs are
+ * 128-bit UUIDs built on the Bluetooth Base UUID.
+ */
+static u32_t gatt_uuid_key(const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return BT_UUID_16(uuid)->val;
+	case BT_UUID_TYPE_32:
+		return BT_UUID_32(uuid)->val;
+	default:
+		return sys_get_le32(&BT_UUID_128(uuid)->val[12]);
+	}
+}
+
+static bool gatt_index_uuid_less(u16_t pos, u32_t key, u16_t handle)
+{
+	const struct gatt_index_entry *entry = &gatt_index.attrs[pos];
+
+	return entry->uuid_key < key ||
+	       (entry->uuid_key == key && entry->handle < handle);
+}
+
+static void gatt_index_add(const struct bt_gatt_attr *attr, u16_t handle)
+{
+	struct gatt_index_entry *entry;
+
+	if (gatt_index.count == ARRAY_SIZE(gatt_index.attrs)) {
+		gatt_index.valid = false;
+		return;
+	}
+
+	entry = &gatt_index.attrs[gatt_index.count++];
+	entry->attr = attr;
+	entry->uuid_key = gatt_uuid_key(attr->uuid);
+	entry->handle = handle;
+}
+
+static void gatt_index_build(void)
+{
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	struct bt_gatt_service *svc;
+#endif
+	struct gatt_index_entry *entry;
+	u16_t handle = 1U;
+	u16_t i, j, pos;
+
+	gatt_index.count = 0U;
+	gatt_index.valid = true;
+
+	Z_STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
+		for (i = 0U; i < static_svc->attr_count; i++) {
+			gatt_index_add(&static_svc->attrs[i], handle++);
+		}
+	}
+
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		for (i = 0U; i < svc->attr_count; i++) {
+			gatt_index_add(&svc->attrs[i], svc->attrs[i].handle);
+		}
+	}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+
+	if (!gatt_index.valid) {
+		BT_WARN("Too many attributes to index, increase "
+			"CONFIG_BT_GATT_DB_INDEX_SIZE");
+		return;
+	}
+
+	/* Insertion sort, the database changes rarely */
+	for (i = 0U; i < gatt_index.count; i++) {
+		entry = &gatt_index.attrs[i];
+
+		for (j = i; j > 0U; j--) {
+			pos = gatt_index.by_uuid[j - 1];
+			if (gatt_index_uuid_less(pos, entry->uuid_key,
+						 entry->handle)) {
+				break;
+			}
+
+			gatt_index.by_uuid[j] = pos;
+		}
+
+		gatt_index.by_uuid[j] = i;
+	}
+
+	BT_DBG("%u attributes indexed", gatt_index.count);
+}
+#else
+static inline void gatt_index_build(void)
+{
+}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 static ssize_t read_name(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 			 void *buf, u16_t len, u16_t offset)
 {
@@ -818,6 +931,7 @@ populate:
 	}
 
 	gatt_insert(svc, last_handle);
+	gatt_index_build();
 
 	return 0;
 }
@@ -963,6 +1077,8 @@ void bt_gatt_init(void)
 		last_static_handle += svc->attr_count;
 	}
 
+	gatt_index_build();
+
 #if defined(CONFIG_BT_GATT_CACHING)
 	k_delayed_work_init(&db_hash_work, db_hash_process);
 
@@ -1084,6 +1200,8 @@ int bt_gatt_service_unregister(struct bt_gatt_service *svc)
 		return -ENOENT;
 	}
 
+	gatt_index_build();
+
 	sc_indicate(svc->attrs[0].handle,
 		    svc->attrs[svc->attr_count - 1].handle);
 
@@ -1331,6 +1449,91 @@ static void foreach_attr_type_dyndb(u16_t start_handle, u16_t end_handle,
 #endif /* CONFIG_BT_GATT_DYNAMIC_DB */
 }
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+static u8_t gatt_index_iter(u16_t pos, u16_t start_handle, u16_t end_handle,
+			    const struct bt_uuid *uuid,
+			    const void *attr_data, uint16_t *num_matches,
+			    bt_gatt_attr_func_t func, void *user_data)
+{
+	const struct gatt_index_entry *entry = &gatt_index.attrs[pos];
+	struct bt_gatt_attr attr;
+
+	if (entry->handle > last_static_handle) {
+		return gatt_foreach_iter(entry->attr, start_handle, end_handle,
+					 uuid, attr_data, num_matches, func,
+					 user_data);
+	}
+
+	memcpy(&attr, entry->attr, sizeof(attr));
+	attr.handle = entry->handle;
+
+	return gatt_foreach_iter(&attr, start_handle, end_handle, uuid,
+				 attr_data, num_matches, func, user_data);
+}
+
+static bool foreach_attr_type_index(u16_t start_handle, u16_t end_handle,
+				    const struct bt_uuid *uuid,
+				    const void *attr_data, uint16_t num_matches,
+				    bt_gatt_attr_func_t func, void *user_data)
+{
+	u16_t lo = 0U, hi = gatt_index.count, mid;
+	u32_t key;
+
+	if (!gatt_index.valid) {
+		return false;
+	}
+
+	if (!uuid) {
+		/* First attribute with a handle not below start_handle */
+		while (lo < hi) {
+			mid = (lo + hi) / 2U;
+			if (gatt_index.attrs[mid].handle < start_handle) {
+				lo = mid + 1U;
+			} else {
+				hi = mid;
+			}
+		}
+
+		for (; lo < gatt_index.count; lo++) {
+			if (gatt_index_iter(lo, start_handle, end_handle, NULL,
+					    attr_data, &num_matches, func,
+					    user_data) == BT_GATT_ITER_STOP) {
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	/* First attribute of the UUID with a handle not below start_handle,
+	 * the following ones of the same UUID are in handle order.
+	 */
+	key = gatt_uuid_key(uuid);
+	while (lo < hi) {
+		mid = (lo + hi) / 2U;
+		if (gatt_index_uuid_less(gatt_index.by_uuid[mid], key,
+					 start_handle)) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	for (; lo < gatt_index.count; lo++) {
+		u16_t pos = gatt_index.by_uuid[lo];
+
+		if (gatt_index.attrs[pos].uuid_key != key ||
+		    gatt_index_iter(pos, start_handle, end_handle, uuid,
+				    attr_data, &num_matches, func,
+				    user_data) == BT_GATT_ITER_STOP) {
+			break;
+		}
+	}
+
+	return true;
+}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
 			       const struct bt_uuid *uuid,
 			       const void *attr_data, uint16_t num_matches,
@@ -1342,6 +1545,13 @@ void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
 		num_matches = UINT16_MAX;
 	}
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+	if (foreach_attr_type_index(start_handle, end_handle, uuid, attr_data,
+				    num_matches, func, user_data)) {
+		return;
+	}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 	if (start_handle <= last_static_handle) {
 		u16_t handle = 1;
 
@@ -67,8 +67,19 @@
 
 static struct friend_cred friend_cred[FRIEND_CRED_COUNT];
 
+/* The network message cache is a ring of message hashes, a new message
+ * replacing the oldest one. An open addressing table with linear probing
+ * refers to the ring entries (index + 1, 0 when empty) by hash so that
+ * lookups don't scan the whole ring.
+ */
 static u64_t msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
 static u16_t msg_cache_next;
+static u16_t msg_cache_table[2 * CONFIG_BT_MESH_MSG_CACHE_SIZE];
+
+#if defined(CONFIG_BT_MESH_MSG_CACHE_BLOOM)
+/* Counting Bloom filter of the cached hashes, 4 counters per entry */
+static u8_t msg_cache_bloom[4 * CONFIG_BT_MESH_MSG_CACHE_SIZE];
+#endif
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -121,23 +132,167 @@ static u64_t msg_hash(struct bt_mesh_net_rx *rx, struct net_buf_simple *pdu)
 	return (u64_t)hash1 << 32 | (u64_t)hash2;
 }
 
-static bool msg_cache_match(struct bt_mesh_net_rx *rx,
-			    struct net_buf_simple *pdu)
+static u32_t msg_cache_mix(u64_t hash)
 {
-	u64_t hash = msg_hash(rx, pdu);
-	u16_t i;
+	u32_t val = (u32_t)hash ^ (u32_t)(hash >> 32);
+
+	val = (val ^ (val >> 16)) * 0x45d9f3bU;
+
+	return val ^ (val >> 16);
+}
+
+static u32_t msg_cache_slot(u64_t hash)
+{
+	return msg_cache_mix(hash) % ARRAY_SIZE(msg_cache_table);
+}
+
+#if defined(CONFIG_BT_MESH_MSG_CACHE_BLOOM)
+static void msg_cache_bloom_update(u64_t hash, int diff)
+{
+	u32_t val = msg_cache_mix(hash);
+	u8_t *cnt[2] = {
+		&msg_cache_bloom[(val & 0xffff) % ARRAY_SIZE(msg_cache_bloom)],
+		&msg_cache_bloom[(val >> 16) % ARRAY_SIZE(msg_cache_bloom)],
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(cnt); i++) {
+		/* Saturated counters stay set */
+		if (*cnt[i] != UINT8_MAX) {
+			*cnt[i] += diff;
+		}
+	}
+}
+
+static bool msg_cache_bloom_test(u64_t hash)
+{
+	u32_t val = msg_cache_mix(hash);
+
+	return msg_cache_bloom[(val & 0xffff) %
+			       ARRAY_SIZE(msg_cache_bloom)] &&
+	       msg_cache_bloom[(val >> 16) % ARRAY_SIZE(msg_cache_bloom)];
+}
+#else
+static inline void msg_cache_bloom_update(u64_t hash, int diff)
+{
+}
+
+static inline bool msg_cache_bloom_test(u64_t hash)
+{
+	return true;
+}
+#endif /* CONFIG_BT_MESH_MSG_CACHE_BLOOM */
+
+static bool msg_cache_find(u64_t hash)
+{
+	u32_t i = msg_cache_slot(hash);
+
+	if (!msg_cache_bloom_test(hash)) {
+		return false;
+	}
 
-	for (i = 0U; i < ARRAY_SIZE(msg_cache); i++) {
-		if (msg_cache[i] == hash) {
+	while (msg_cache_table[i]) {
+		if (msg_cache[msg_cache_table[i] - 1] == hash) {
 			return true;
 		}
+
+		i = (i + 1) % ARRAY_SIZE(msg_cache_table);
 	}
 
-	/* Add to the cache */
-	rx->msg_cache_idx = msg_cache_next++;
-	msg_cache[rx->msg_cache_idx] = hash;
+	return false;
+}
+
+static void msg_cache_link(u16_t idx)
+{
+	u32_t i = msg_cache_slot(msg_cache[idx]);
+
+	while (msg_cache_table[i]) {
+		i = (i + 1) % ARRAY_SIZE(msg_cache_table);
+	}
+
+	msg_cache_table[i] = idx + 1;
+	msg_cache_bloom_update(msg_cache[idx], 1);
+}
+
+static void msg_cache_unlink(u16_t idx)
+{
+	u32_t i = msg_cache_slot(msg_cache[idx]);
+	u32_t j, home;
+
+	while (msg_cache_table[i] != idx + 1) {
+		/* Never added or already removed */
+		if (!msg_cache_table[i]) {
+			return;
+		}
+
+		i = (i + 1) % ARRAY_SIZE(msg_cache_table);
+	}
+
+	msg_cache_bloom_update(msg_cache[idx], -1);
+
+	/* Move back the following entries of the probe sequence unless
+	 * that puts them before their home slot.
+	 */
+	for (j = i;;) {
+		j = (j + 1) % ARRAY_SIZE(msg_cache_table);
+		if (!msg_cache_table[j]) {
+			break;
+		}
+
+		home = msg_cache_slot(msg_cache[msg_cache_table[j] - 1]);
+		if (i <= j ? (i < home && home <= j) :
+			     (i < home || home <= j)) {
+			continue;
+		}
+
+		msg_cache_table[i] = msg_cache_table[j];
+		i = j;
+	}
+
+	msg_cache_table[i] = 0U;
+}
+
+static void msg_cache_clear(void)
+{
+	(void)memset(msg_cache, 0, sizeof(msg_cache));
+	(void)memset(msg_cache_table, 0, sizeof(msg_cache_table));
+#if defined(CONFIG_BT_MESH_MSG_CACHE_BLOOM)
+	(void)memset(msg_cache_bloom, 0, sizeof(msg_cache_bloom));
+#endif
+	msg_cache_next = 0U;
+}
+
+/* Add to the cache, replacing the oldest entry */
+static u16_t msg_cache_add(u64_t hash)
+{
+	u16_t idx = msg_cache_next++;
+
+	msg_cache_unlink(idx);
+	msg_cache[idx] = hash;
+	msg_cache_link(idx);
 	msg_cache_next %= ARRAY_SIZE(msg_cache);
 
+	return idx;
+}
+
+static void msg_cache_remove(u16_t idx)
+{
+	msg_cache_unlink(idx);
+	msg_cache[idx] = 0ULL;
+	/* Rewind the next index now that we're not using this entry */
+	msg_cache_next = idx;
+}
+
+static bool msg_cache_match(struct bt_mesh_net_rx *rx,
+			    struct net_buf_simple *pdu)
+{
+	u64_t hash = msg_hash(rx, pdu);
+
+	if (msg_cache_find(hash)) {
+		return true;
+	}
+
+	rx->msg_cache_idx = msg_cache_add(hash);
+
 	return false;
 }
 
@@ -437,8 +592,7 @@ int bt_mesh_net_create(u16_t idx, u8_t flags, const u8_t key[16],
 
 	BT_DBG("NetKey %s", bt_hex(key, 16));
 
-	(void)memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0U;
+	msg_cache_clear();
 
 	sub = &bt_mesh.sub[0];
 
@@ -563,6 +717,8 @@ void bt_mesh_rpl_reset(void)
 			}
 		}
 	}
+
+	bt_mesh_rpl_reindex();
 }
 
 #if defined(CONFIG_BT_MESH_IV_UPDATE_TEST)
@@ -640,7 +796,7 @@ bool bt_mesh_net_iv_update(u32_t iv_index, bool iv_update)
 
 		if (iv_index > bt_mesh.iv_index + 1) {
 			BT_WARN("Performing IV Index Recovery");
-			(void)memset(bt_mesh.rpl, 0, sizeof(bt_mesh.rpl));
+			bt_mesh_rpl_clear();
 			bt_mesh.iv_index = iv_index;
 			bt_mesh.seq = 0U;
 			goto do_update;
@@ -1329,9 +1485,7 @@ void bt_mesh_net_recv(struct net_buf_simple *data, s8_t rssi,
 	 */
 	if (bt_mesh_trans_recv(&buf, &rx) == -EAGAIN) {
 		BT_WARN("Removing rejected message from Network Message Cache");
-		msg_cache[rx.msg_cache_idx] = 0ULL;
-		/* Rewind the next index now that we're not using this entry */
-		msg_cache_next = rx.msg_cache_idx;
+		msg_cache_remove(rx.msg_cache_idx);
 	}
 
 	/* Relay if this was a group/virtual address, or if the destination
@@ -538,9 +538,96 @@ int bt_mesh_trans_send(struct bt_mesh_net_tx *tx, struct net_buf_simple *msg,
 	return err;
 }
 
+/* Open addressing table with linear probing of the RPL entries by
+ * source address, storing the entry index + 1 (0 when empty). Entries
+ * are only added here, the table is rebuilt when entries are removed.
+ */
+static u16_t rpl_index[2 * CONFIG_BT_MESH_CRPL];
+
+static u32_t rpl_slot(u16_t src)
+{
+	return ((u32_t)src * 2654435761U >> 8) % ARRAY_SIZE(rpl_index);
+}
+
+static void rpl_index_add(struct bt_mesh_rpl *rpl)
+{
+	u16_t idx = rpl - bt_mesh.rpl;
+	u32_t i = rpl_slot(rpl->src);
+
+	/* Slots of removed entries, or pointing to this entry before it was
+	 * reused, are stale and can be taken over.
+	 */
+	while (rpl_index[i] && rpl_index[i] != idx + 1 &&
+	       bt_mesh.rpl[rpl_index[i] - 1].src) {
+		i = (i + 1) % ARRAY_SIZE(rpl_index);
+	}
+
+	rpl_index[i] = idx + 1;
+}
+
+void bt_mesh_rpl_reindex(void)
+{
+	int i;
+
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
+		if (bt_mesh.rpl[i].src) {
+			rpl_index_add(&bt_mesh.rpl[i]);
+		}
+	}
+}
+
+struct bt_mesh_rpl *bt_mesh_rpl_find(u16_t src)
+{
+	u32_t i = rpl_slot(src);
+	int n;
+
+	for (n = 0; n < ARRAY_SIZE(rpl_index) && rpl_index[i]; n++) {
+		struct bt_mesh_rpl *rpl = &bt_mesh.rpl[rpl_index[i] - 1];
+
+		if (rpl->src == src) {
+			return rpl;
+		}
+
+		i = (i + 1) % ARRAY_SIZE(rpl_index);
+	}
+
+	return NULL;
+}
+
+static struct bt_mesh_rpl *rpl_get_free(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
+		if (!bt_mesh.rpl[i].src) {
+			return &bt_mesh.rpl[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct bt_mesh_rpl *bt_mesh_rpl_alloc(u16_t src)
+{
+	struct bt_mesh_rpl *rpl = rpl_get_free();
+
+	if (rpl) {
+		rpl->src = src;
+		rpl_index_add(rpl);
+	}
+
+	return rpl;
+}
+
 static void update_rpl(struct bt_mesh_rpl *rpl, struct bt_mesh_net_rx *rx)
 {
-	rpl->src = rx->ctx.addr;
+	if (rpl->src != rx->ctx.addr) {
+		rpl->src = rx->ctx.addr;
+		rpl_index_add(rpl);
+	}
+
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
 
@@ -556,7 +643,7 @@ static void update_rpl(struct bt_mesh_rpl *rpl, struct bt_mesh_net_rx *rx)
  */
 static bool is_replay(struct bt_mesh_net_rx *rx, struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -568,11 +655,14 @@ static bool is_replay(struct bt_mesh_net_rx *rx, struct bt_mesh_rpl **match)
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
-		struct bt_mesh_rpl *rpl = &bt_mesh.rpl[i];
+	/* Existing slot for given address */
+	rpl = bt_mesh_rpl_find(rx->ctx.addr);
+	if (rpl) {
+		if (rx->old_iv && !rpl->old_iv) {
+			return true;
+		}
 
-		/* Empty slot */
-		if (!rpl->src) {
+		if ((!rx->old_iv && rpl->old_iv) || rpl->seq < rx->seq) {
 			if (match) {
 				*match = rpl;
 			} else {
@@ -582,25 +672,19 @@ static bool is_replay(struct bt_mesh_net_rx *rx, struct bt_mesh_rpl **match)
 			return false;
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
-
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					update_rpl(rpl, rx);
-				}
+		return true;
+	}
 
-				return false;
-			} else {
-				return true;
-			}
+	/* Empty slot, the address is set when it gets updated */
+	rpl = rpl_get_free();
+	if (rpl) {
+		if (match) {
+			*match = rpl;
+		} else {
+			update_rpl(rpl, rx);
 		}
+
+		return false;
 	}
 
 	BT_ERR("RPL is full!");
@@ -1623,7 +1707,7 @@ void bt_mesh_rx_reset(void)
 	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
 		bt_mesh_clear_rpl();
 	} else {
-		(void)memset(bt_mesh.rpl, 0, sizeof(bt_mesh.rpl));
+		bt_mesh_rpl_clear();
 	}
 }
 
@@ -1658,6 +1742,7 @@ void bt_mesh_rpl_clear(void)
 {
 	BT_DBG("");
 	(void)memset(bt_mesh.rpl, 0, sizeof(bt_mesh.rpl));
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
 }
 
 void bt_mesh_heartbeat_send(void)
@@ -96,6 +96,12 @@ void bt_mesh_trans_init(void);
 
 void bt_mesh_rpl_clear(void);
 
+struct bt_mesh_rpl *bt_mesh_rpl_find(u16_t src);
+
+struct bt_mesh_rpl *bt_mesh_rpl_alloc(u16_t src);
+
+void bt_mesh_rpl_reindex(void);
+
 void bt_mesh_heartbeat_send(void);
 
 int bt_mesh_app_key_get(const struct bt_mesh_subnet *subnet, u16_t app_idx,
@@ -59,6 +59,7 @@ int console_init(void)
 		return ret;
 	}
 
+#ifndef CONFIG_CONSOLE_TTY_ASYNC
 	/* Checks device driver supports for interrupt driven data transfers. */
 	if (CONFIG_CONSOLE_GETCHAR_BUFSIZE + CONFIG_CONSOLE_PUTCHAR_BUFSIZE) {
 		const struct uart_driver_api *api =
@@ -67,6 +68,7 @@ int console_init(void)
 			return -ENOTSUP;
 		}
 	}
+#endif
 
 	tty_set_tx_buf(&console_serial, console_txbuf, sizeof(console_txbuf));
 	tty_set_rx_buf(&console_serial, console_rxbuf, sizeof(console_rxbuf));
@@ -8,10 +8,196 @@
 #include <drivers/uart.h>
 #include <sys/printk.h>
 #include <console/tty.h>
+#include <string.h>
 
+#ifndef CONFIG_CONSOLE_TTY_ASYNC
 static int tty_irq_input_hook(struct tty_serial *tty, u8_t c);
+#endif
 static int tty_putchar(struct tty_serial *tty, u8_t c);
 
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+/*
+ * In asynchronous mode the RX ring buffer is split into two halves which are
+ * passed to the UART driver in turn, so data is received directly into the
+ * ring buffer. The driver is given a half only once all data in it has been
+ * read; until then the request is left pending (or reception is stopped if
+ * the driver runs out of buffer) and is completed by tty_read().
+ */
+static u8_t *tty_rx_other_half(struct tty_serial *tty, u8_t *half)
+{
+	u32_t half_sz = tty->rx_ringbuf_sz / 2U;
+
+	return (half == tty->rx_ringbuf) ? tty->rx_ringbuf + half_sz :
+					   tty->rx_ringbuf;
+}
+
+/* Must be called from the UART callback or with interrupts locked. */
+static void tty_rx_resume(struct tty_serial *tty)
+{
+	u32_t half_sz = tty->rx_ringbuf_sz / 2U;
+	u8_t *next;
+
+	if (!tty->rx_req_pending && !tty->rx_disabled) {
+		return;
+	}
+
+	/* Stopped (e.g. on error) before the current half was full. */
+	if (tty->rx_disabled && tty->rx_cur_len < half_sz) {
+		tty->rx_disabled = false;
+		uart_rx_enable(tty->uart_dev, tty->rx_cur + tty->rx_cur_len,
+			       half_sz - tty->rx_cur_len,
+			       CONFIG_CONSOLE_TTY_ASYNC_RX_TIMEOUT);
+		return;
+	}
+
+	/* Other half still holds unread data. */
+	if (tty->rx_avail > tty->rx_cur_len) {
+		return;
+	}
+
+	next = tty_rx_other_half(tty, tty->rx_cur);
+
+	if (tty->rx_disabled) {
+		tty->rx_disabled = false;
+		tty->rx_cur = next;
+		tty->rx_cur_len = 0U;
+		uart_rx_enable(tty->uart_dev, next, half_sz,
+			       CONFIG_CONSOLE_TTY_ASYNC_RX_TIMEOUT);
+	} else {
+		tty->rx_req_pending = false;
+		tty->rx_next_given = true;
+		uart_rx_buf_rsp(tty->uart_dev, next, half_sz);
+	}
+}
+
+static void tty_tx_start(struct tty_serial *tty)
+{
+	u16_t tx_end = tty->tx_put;
+
+	if (tty->tx_len || tx_end == tty->tx_get) {
+		return;
+	}
+
+	if (tx_end < tty->tx_get) {
+		tx_end = tty->tx_ringbuf_sz;
+	}
+
+	tty->tx_len = tx_end - tty->tx_get;
+	uart_tx(tty->uart_dev, &tty->tx_ringbuf[tty->tx_get], tty->tx_len,
+		K_FOREVER);
+}
+
+static void tty_tx_done(struct tty_serial *tty, size_t len)
+{
+	tty->tx_get += len;
+	if (tty->tx_get >= tty->tx_ringbuf_sz) {
+		tty->tx_get = 0U;
+	}
+	tty->tx_len = 0U;
+
+	while (len--) {
+		k_sem_give(&tty->tx_sem);
+	}
+
+	tty_tx_start(tty);
+}
+
+static void tty_uart_callback(struct uart_event *evt, void *user_data)
+{
+	struct tty_serial *tty = user_data;
+	u32_t half_sz = tty->rx_ringbuf_sz / 2U;
+	u32_t pos;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		tty_tx_done(tty, evt->data.tx.len);
+		break;
+	case UART_RX_RDY:
+		pos = evt->data.rx.buf - tty->rx_ringbuf +
+		      evt->data.rx.offset + evt->data.rx.len;
+		tty->rx_put = (pos >= tty->rx_ringbuf_sz) ? 0 : pos;
+		tty->rx_avail += evt->data.rx.len;
+		tty->rx_cur_len = evt->data.rx.buf - tty->rx_cur +
+				  evt->data.rx.offset + evt->data.rx.len;
+		k_sem_give(&tty->rx_sem);
+		break;
+	case UART_RX_BUF_REQUEST:
+		tty->rx_req_pending = true;
+		tty_rx_resume(tty);
+		break;
+	case UART_RX_BUF_RELEASED:
+		if (evt->data.rx_buf.buf < tty->rx_cur ||
+		    evt->data.rx_buf.buf >= tty->rx_cur + half_sz) {
+			break;
+		}
+
+		/* The driver moves on to the next half only once the current
+		 * one is full. A half released early (on error) is resumed
+		 * where it stopped, so that received data stays contiguous.
+		 */
+		if (tty->rx_next_given && tty->rx_cur_len == half_sz) {
+			tty->rx_cur = tty_rx_other_half(tty, tty->rx_cur);
+			tty->rx_cur_len = 0U;
+		}
+		tty->rx_next_given = false;
+		break;
+	case UART_RX_DISABLED:
+		tty->rx_req_pending = false;
+		tty->rx_disabled = true;
+		tty_rx_resume(tty);
+		break;
+	default:
+		break;
+	}
+}
+
+static ssize_t tty_read_async(struct tty_serial *tty, void *buf, size_t size)
+{
+	u8_t *p = buf;
+	size_t out_size = 0;
+	unsigned int key;
+	size_t len;
+	int res;
+
+	while (size) {
+		key = irq_lock();
+		len = tty->rx_avail;
+		irq_unlock(key);
+
+		if (len == 0) {
+			if (out_size) {
+				break;
+			}
+
+			res = k_sem_take(&tty->rx_sem, tty->rx_timeout);
+			if (res < 0) {
+				errno = -res;
+				return res;
+			}
+			continue;
+		}
+
+		len = MIN(len, size);
+		len = MIN(len, tty->rx_ringbuf_sz - tty->rx_get);
+		memcpy(p, &tty->rx_ringbuf[tty->rx_get], len);
+		p += len;
+		size -= len;
+		out_size += len;
+
+		key = irq_lock();
+		tty->rx_get += len;
+		if (tty->rx_get >= tty->rx_ringbuf_sz) {
+			tty->rx_get = 0U;
+		}
+		tty->rx_avail -= len;
+		tty_rx_resume(tty);
+		irq_unlock(key);
+	}
+
+	return out_size;
+}
+#else
 static void tty_uart_isr(void *user_data)
 {
 	struct tty_serial *tty = user_data;
@@ -66,6 +252,7 @@ static int tty_irq_input_hook(struct tty_serial *tty, u8_t c)
 
 	return 1;
 }
+#endif /* CONFIG_CONSOLE_TTY_ASYNC */
 
 static int tty_putchar(struct tty_serial *tty, u8_t c)
 {
@@ -91,8 +278,13 @@ static int tty_putchar(struct tty_serial *tty, u8_t c)
 	tty->tx_ringbuf[tty->tx_put] = c;
 	tty->tx_put = tx_next;
 
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	tty_tx_start(tty);
+	irq_unlock(key);
+#else
 	irq_unlock(key);
 	uart_irq_tx_enable(tty->uart_dev);
+#endif
 	return 0;
 }
 
@@ -137,6 +329,7 @@ ssize_t tty_write(struct tty_serial *tty, const void *buf, size_t size)
 	return out_size;
 }
 
+#ifndef CONFIG_CONSOLE_TTY_ASYNC
 static int tty_getchar(struct tty_serial *tty)
 {
 	unsigned int key;
@@ -157,6 +350,7 @@ static int tty_getchar(struct tty_serial *tty)
 
 	return c;
 }
+#endif /* !CONFIG_CONSOLE_TTY_ASYNC */
 
 static ssize_t tty_read_unbuf(struct tty_serial *tty, void *buf, size_t size)
 {
@@ -201,16 +395,13 @@ static ssize_t tty_read_unbuf(struct tty_serial *tty, void *buf, size_t size)
 	return out_size;
 }
 
-ssize_t tty_read(struct tty_serial *tty, void *buf, size_t size)
+#ifndef CONFIG_CONSOLE_TTY_ASYNC
+static ssize_t tty_read_irq(struct tty_serial *tty, void *buf, size_t size)
 {
 	u8_t *p = buf;
 	size_t out_size = 0;
 	int res = 0;
 
-	if (tty->rx_ringbuf_sz == 0U) {
-		return tty_read_unbuf(tty, buf, size);
-	}
-
 	while (size--) {
 		res = tty_getchar(tty);
 		if (res < 0) {
@@ -235,6 +426,20 @@ ssize_t tty_read(struct tty_serial *tty, void *buf, size_t size)
 
 	return out_size;
 }
+#endif /* !CONFIG_CONSOLE_TTY_ASYNC */
+
+ssize_t tty_read(struct tty_serial *tty, void *buf, size_t size)
+{
+	if (tty->rx_ringbuf_sz == 0U) {
+		return tty_read_unbuf(tty, buf, size);
+	}
+
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	return tty_read_async(tty, buf, size);
+#else
+	return tty_read_irq(tty, buf, size);
+#endif
+}
 
 int tty_init(struct tty_serial *tty, struct device *uart_dev)
 {
@@ -255,13 +460,46 @@ int tty_init(struct tty_serial *tty, struct device *uart_dev)
 	tty->rx_timeout = K_FOREVER;
 	tty->tx_timeout = K_FOREVER;
 
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	tty->tx_len = 0U;
+
+	return uart_callback_set(uart_dev, tty_uart_callback, tty);
+#else
 	uart_irq_callback_user_data_set(uart_dev, tty_uart_isr, tty);
 
 	return 0;
+#endif
 }
 
 int tty_set_rx_buf(struct tty_serial *tty, void *buf, size_t size)
 {
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	/* Reception can't be restarted synchronously with a new buffer. */
+	if (tty->rx_ringbuf_sz > 0U) {
+		return -EBUSY;
+	}
+
+	if (size == 1U || size > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	tty->rx_ringbuf = buf;
+	tty->rx_ringbuf_sz = size & ~1U;
+
+	if (size > 0) {
+		k_sem_init(&tty->rx_sem, 0, UINT_MAX);
+		tty->rx_avail = 0U;
+		tty->rx_cur = tty->rx_ringbuf;
+		tty->rx_cur_len = 0U;
+		tty->rx_req_pending = false;
+		tty->rx_next_given = false;
+		tty->rx_disabled = false;
+		return uart_rx_enable(tty->uart_dev, tty->rx_cur, size / 2U,
+				      CONFIG_CONSOLE_TTY_ASYNC_RX_TIMEOUT);
+	}
+
+	return 0;
+#else
 	uart_irq_rx_disable(tty->uart_dev);
 
 	tty->rx_ringbuf = buf;
@@ -273,11 +511,19 @@ int tty_set_rx_buf(struct tty_serial *tty, void *buf, size_t size)
 	}
 
 	return 0;
+#endif /* CONFIG_CONSOLE_TTY_ASYNC */
 }
 
 int tty_set_tx_buf(struct tty_serial *tty, void *buf, size_t size)
 {
+#ifdef CONFIG_CONSOLE_TTY_ASYNC
+	/* Transfer in progress uses the old buffer. */
+	if (tty->tx_len) {
+		return -EBUSY;
+	}
+#else
 	uart_irq_tx_disable(tty->uart_dev);
+#endif
 
 	tty->tx_ringbuf = buf;
 	tty->tx_ringbuf_sz = size;
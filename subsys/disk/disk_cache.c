@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/types.h>
+#include <sys/__assert.h>
+#include <sys/dlist.h>
+#include <sys/util.h>
+#include <init.h>
+#include <disk/disk_access.h>
+#include <errno.h>
+
+#include "disk_cache.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define SECTOR_SIZE CONFIG_DISK_ACCESS_CACHE_SECTOR_SIZE
+#define IO_SECTORS CONFIG_DISK_ACCESS_CACHE_IO_SECTORS
+
+BUILD_ASSERT_MSG(IO_SECTORS <= CONFIG_DISK_ACCESS_CACHE_SECTORS,
+		 "Cannot transfer more sectors at once than the cache holds");
+
+struct cache_entry {
+	sys_dnode_t node;
+	/* Disk the sector belongs to, NULL for a free entry */
+	struct disk_info *disk;
+	u32_t sector;
+	/* Modified since read from or written to the disk */
+	bool dirty;
+	u8_t data[SECTOR_SIZE] __aligned(4);
+};
+
+static struct cache_entry entries[CONFIG_DISK_ACCESS_CACHE_SECTORS];
+
+/* All entries, the most recently used first and the free ones last */
+static sys_dlist_t lru_list;
+
+/* Contiguous sectors read ahead or written back at once */
+static u8_t io_buf[IO_SECTORS * SECTOR_SIZE] __aligned(4);
+
+static K_MUTEX_DEFINE(cache_mutex);
+
+static struct cache_entry *entry_find(struct disk_info *disk, u32_t sector)
+{
+	struct cache_entry *entry;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru_list, entry, node) {
+		if (entry->disk == NULL) {
+			break;
+		}
+
+		if (entry->disk == disk && entry->sector == sector) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void entry_touch(struct cache_entry *entry)
+{
+	sys_dlist_remove(&entry->node);
+	sys_dlist_prepend(&lru_list, &entry->node);
+}
+
+static void entry_free(struct cache_entry *entry)
+{
+	entry->disk = NULL;
+	entry->dirty = false;
+
+	sys_dlist_remove(&entry->node);
+	sys_dlist_append(&lru_list, &entry->node);
+}
+
+/* Writes back the sector of a dirty entry, along with the dirty sectors
+ * contiguous to it.
+ */
+static int entry_write_back(struct cache_entry *entry)
+{
+	struct disk_info *disk = entry->disk;
+	u32_t size = disk->cache_sector_size;
+	struct cache_entry *run[IO_SECTORS];
+	struct cache_entry *other;
+	u32_t first = entry->sector;
+	u32_t n;
+	int rc;
+
+	while (first > 0 && entry->sector - first < IO_SECTORS - 1) {
+		other = entry_find(disk, first - 1);
+		if (other == NULL || !other->dirty) {
+			break;
+		}
+
+		first--;
+	}
+
+	for (n = 0U; n < IO_SECTORS; n++) {
+		other = entry_find(disk, first + n);
+		if (other == NULL || !other->dirty) {
+			break;
+		}
+
+		run[n] = other;
+	}
+
+	if (n == 1U) {
+		rc = disk->ops->write(disk, entry->data, first, 1);
+	} else {
+		for (u32_t i = 0; i < n; i++) {
+			memcpy(&io_buf[i * size], run[i]->data, size);
+		}
+
+		rc = disk->ops->write(disk, io_buf, first, n);
+	}
+
+	if (rc != 0) {
+		LOG_ERR("Writing back sectors %u-%u failed (%d)", first,
+			first + n - 1, rc);
+		return rc;
+	}
+
+	for (u32_t i = 0; i < n; i++) {
+		run[i]->dirty = false;
+	}
+
+	return 0;
+}
+
+/* Writes back the dirty ones among the count least recently used entries,
+ * these are the ones entry_alloc() then reuses.
+ */
+static int make_room(u32_t count)
+{
+	sys_dnode_t *node = sys_dlist_peek_tail(&lru_list);
+	struct cache_entry *entry;
+	int rc;
+
+	while (node != NULL && count--) {
+		entry = CONTAINER_OF(node, struct cache_entry, node);
+
+		if (entry->dirty) {
+			rc = entry_write_back(entry);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+
+		node = sys_dlist_peek_prev(&lru_list, node);
+	}
+
+	return 0;
+}
+
+static struct cache_entry *entry_alloc(struct disk_info *disk, u32_t sector)
+{
+	struct cache_entry *entry;
+
+	entry = CONTAINER_OF(sys_dlist_peek_tail(&lru_list),
+			     struct cache_entry, node);
+
+	__ASSERT(!entry->dirty, "Reusing a dirty entry");
+
+	entry->disk = disk;
+	entry->sector = sector;
+	entry_touch(entry);
+
+	return entry;
+}
+
+void disk_cache_attach(struct disk_info *disk)
+{
+	u32_t size, count;
+
+	if (disk->cache_sector_size != 0U || disk->ops->ioctl == NULL) {
+		return;
+	}
+
+	if (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &size) != 0 ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT, &count) != 0) {
+		LOG_DBG("Disk %s geometry unknown, not cached", disk->name);
+		return;
+	}
+
+	if (size == 0U || size > SECTOR_SIZE) {
+		LOG_WRN("Disk %s sectors of %u bytes not cached", disk->name,
+			size);
+		return;
+	}
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	disk->cache_sector_count = count;
+	disk->cache_next_read = count;
+	disk->cache_sector_size = size;
+
+	k_mutex_unlock(&cache_mutex);
+}
+
+int disk_cache_detach(struct disk_info *disk)
+{
+	struct cache_entry *entry, *next;
+	int rc;
+
+	rc = disk_cache_sync(disk);
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&lru_list, entry, next, node) {
+		if (entry->disk == disk) {
+			entry_free(entry);
+		}
+	}
+
+	disk->cache_sector_size = 0U;
+
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+int disk_cache_read(struct disk_info *disk, u8_t *data_buf,
+		    u32_t start_sector, u32_t num_sector)
+{
+	u32_t size = disk->cache_sector_size;
+	u32_t end = start_sector + num_sector;
+	struct cache_entry *entry;
+	u32_t sector, n, fetch;
+	bool sequential;
+	int rc = 0;
+
+	if (size == 0U) {
+		return disk->ops->read(disk, data_buf, start_sector,
+				       num_sector);
+	}
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	sequential = IS_ENABLED(CONFIG_DISK_ACCESS_CACHE_READ_AHEAD) &&
+		     start_sector == disk->cache_next_read;
+	disk->cache_next_read = end;
+
+	for (sector = start_sector; sector < end;
+	     sector += n, data_buf += n * size) {
+		entry = entry_find(disk, sector);
+		if (entry != NULL) {
+			memcpy(data_buf, entry->data, size);
+			entry_touch(entry);
+			n = 1U;
+			continue;
+		}
+
+		/* Read the sectors up to the next cached one at once */
+		for (n = 1U; sector + n < end; n++) {
+			if (entry_find(disk, sector + n) != NULL) {
+				break;
+			}
+		}
+
+		if (n >= IO_SECTORS) {
+			rc = disk->ops->read(disk, data_buf, sector, n);
+			if (rc != 0) {
+				break;
+			}
+
+			continue;
+		}
+
+		/* Reading on where a previous read ended, or next to data
+		 * read earlier, is likely to go on.
+		 */
+		if (IS_ENABLED(CONFIG_DISK_ACCESS_CACHE_READ_AHEAD) &&
+		    sector > 0 && entry_find(disk, sector - 1) != NULL) {
+			sequential = true;
+		}
+
+		fetch = n;
+
+		while (sequential && fetch < IO_SECTORS &&
+		       sector + fetch < disk->cache_sector_count &&
+		       entry_find(disk, sector + fetch) == NULL) {
+			fetch++;
+		}
+
+		rc = make_room(fetch);
+		if (rc != 0) {
+			break;
+		}
+
+		rc = disk->ops->read(disk, io_buf, sector, fetch);
+		if (rc != 0) {
+			break;
+		}
+
+		memcpy(data_buf, io_buf, n * size);
+
+		for (u32_t i = 0; i < fetch; i++) {
+			entry = entry_alloc(disk, sector + i);
+			memcpy(entry->data, &io_buf[i * size], size);
+		}
+	}
+
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const u8_t *data_buf,
+		     u32_t start_sector, u32_t num_sector)
+{
+	u32_t size = disk->cache_sector_size;
+	struct cache_entry *entry;
+	u32_t offset;
+	int rc = 0;
+
+	if (size == 0U) {
+		return disk->ops->write(disk, data_buf, start_sector,
+					num_sector);
+	}
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	if (num_sector >= IO_SECTORS) {
+		rc = disk->ops->write(disk, data_buf, start_sector,
+				      num_sector);
+		if (rc != 0) {
+			goto out;
+		}
+
+		/* Keep the cached copies up to date */
+		SYS_DLIST_FOR_EACH_CONTAINER(&lru_list, entry, node) {
+			if (entry->disk == NULL) {
+				break;
+			}
+
+			offset = entry->sector - start_sector;
+
+			if (entry->disk == disk && offset < num_sector) {
+				memcpy(entry->data, &data_buf[offset * size],
+				       size);
+				entry->dirty = false;
+			}
+		}
+
+		goto out;
+	}
+
+	for (u32_t i = 0; i < num_sector; i++) {
+		entry = entry_find(disk, start_sector + i);
+		if (entry != NULL) {
+			entry_touch(entry);
+		} else {
+			rc = make_room(1);
+			if (rc != 0) {
+				break;
+			}
+
+			entry = entry_alloc(disk, start_sector + i);
+		}
+
+		memcpy(entry->data, &data_buf[i * size], size);
+		entry->dirty = true;
+	}
+
+out:
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	struct cache_entry *entry;
+	int rc = 0;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru_list, entry, node) {
+		if (entry->disk == NULL) {
+			break;
+		}
+
+		if (entry->disk == disk && entry->dirty) {
+			rc = entry_write_back(entry);
+			if (rc != 0) {
+				break;
+			}
+		}
+	}
+
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+static int disk_cache_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	sys_dlist_init(&lru_list);
+
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		sys_dlist_append(&lru_list, &entries[i].node);
+	}
+
+	return 0;
+}
+
+SYS_INIT(disk_cache_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+#define ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+
+#include <disk/disk_access.h>
+
+/*
+ * Start caching a disk once initialized. Disks whose sectors do not fit
+ * the cache are left alone, the other functions then pass the requests
+ * straight to the disk.
+ */
+void disk_cache_attach(struct disk_info *disk);
+
+/* Write back and drop the cached sectors of a disk */
+int disk_cache_detach(struct disk_info *disk);
+
+int disk_cache_read(struct disk_info *disk, u8_t *data_buf,
+		    u32_t start_sector, u32_t num_sector);
+
+int disk_cache_write(struct disk_info *disk, const u8_t *data_buf,
+		     u32_t start_sector, u32_t num_sector);
+
+/* Write back the dirty sectors of a disk */
+int disk_cache_sync(struct disk_info *disk);
+
+#endif /* ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_ */
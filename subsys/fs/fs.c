@@ -19,48 +19,121 @@ LOG_MODULE_REGISTER(fs);
 /* list of mounted file systems */
 static sys_dlist_t fs_mnt_list;
 
+/*
+ * Mount points are also kept in a trie of path components: the children
+ * of a mount point are the mount points nested in it, and no two siblings
+ * are nested in each other. Resolving a path walks down from the top level
+ * mount points, comparing only the path components past the parent mount
+ * point, and ends at the longest matching mount point.
+ */
+static sys_dlist_t fs_mnt_trie;
+
 /* lock to protect mount list operations */
 static struct k_mutex mutex;
 
 /* file system map table */
 static struct fs_file_system_t *fs_map[FS_TYPE_END];
 
-static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
-			    const char *name, size_t *match_len)
+static inline sys_dlist_t *mnt_trie_children(struct fs_mount_t *mp)
 {
-	struct fs_mount_t *mnt_p = NULL, *itr;
-	size_t longest_match = 0;
-	size_t len, name_len = strlen(name);
-	sys_dnode_t *node;
+	return (mp != NULL) ? &mp->trie_children : &fs_mnt_trie;
+}
 
-	k_mutex_lock(&mutex, K_FOREVER);
-	SYS_DLIST_FOR_EACH_NODE(&fs_mnt_list, node) {
-		itr = CONTAINER_OF(node, struct fs_mount_t, node);
-		len = itr->mountp_len;
+/*
+ * Check whether mount point mp covers the path name, whose first skip
+ * characters are already known to match.
+ */
+static bool mnt_covers(const struct fs_mount_t *mp, const char *name,
+		       size_t skip)
+{
+	size_t len = mp->mountp_len;
 
-		/*
-		 * Move to next node if mount point length is
-		 * shorter than longest_match match or if path
-		 * name is shorter than the mount point name.
-		 */
-		if ((len < longest_match) || (len > name_len)) {
-			continue;
-		}
+	if (strncmp(name + skip, mp->mnt_point + skip, len - skip) != 0) {
+		return false;
+	}
 
-		/*
-		 * Move to next node if name does not have a directory
-		 * separator where mount point name ends.
-		 */
-		if ((len > 1) && (name[len] != '/') && (name[len] != '\0')) {
-			continue;
+	/* The mount point must end at a directory separator of the name */
+	return (len == 1) || (name[len] == '/') || (name[len] == '\0');
+}
+
+/* Find the longest mount point covering name. Must be called locked. */
+static struct fs_mount_t *mnt_trie_lookup(const char *name)
+{
+	struct fs_mount_t *mnt_p = NULL, *itr;
+	bool descend = true;
+
+	while (descend) {
+		descend = false;
+
+		SYS_DLIST_FOR_EACH_CONTAINER(mnt_trie_children(mnt_p), itr,
+					     trie_node) {
+			if (mnt_covers(itr, name,
+				       mnt_p ? mnt_p->mountp_len : 0)) {
+				mnt_p = itr;
+				descend = true;
+				break;
+			}
 		}
+	}
+
+	return mnt_p;
+}
+
+/* Add a mount point to the trie. Must be called locked. */
+static int mnt_trie_insert(struct fs_mount_t *mp)
+{
+	struct fs_mount_t *parent, *itr, *next;
+	sys_dlist_t *siblings;
 
-		/* Check for mount point match */
-		if (strncmp(name, itr->mnt_point, len) == 0) {
-			mnt_p = itr;
-			longest_match = len;
+	parent = mnt_trie_lookup(mp->mnt_point);
+	if ((parent != NULL) && (parent->mountp_len == mp->mountp_len)) {
+		return -EBUSY;
+	}
+
+	sys_dlist_init(&mp->trie_children);
+	mp->trie_parent = parent;
+	siblings = mnt_trie_children(parent);
+
+	/* Siblings nested in the new mount point become its children */
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(siblings, itr, next, trie_node) {
+		if ((itr->mountp_len > mp->mountp_len) &&
+		    mnt_covers(mp, itr->mnt_point,
+			       parent ? parent->mountp_len : 0)) {
+			sys_dlist_remove(&itr->trie_node);
+			sys_dlist_append(&mp->trie_children, &itr->trie_node);
+			itr->trie_parent = mp;
 		}
 	}
+
+	sys_dlist_append(siblings, &mp->trie_node);
+
+	return 0;
+}
+
+/* Remove a mount point from the trie. Must be called locked. */
+static void mnt_trie_remove(struct fs_mount_t *mp)
+{
+	sys_dlist_t *siblings = mnt_trie_children(mp->trie_parent);
+	struct fs_mount_t *itr, *next;
+
+	/* Nested mount points move up to the parent */
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&mp->trie_children, itr, next,
+					  trie_node) {
+		sys_dlist_remove(&itr->trie_node);
+		sys_dlist_append(siblings, &itr->trie_node);
+		itr->trie_parent = mp->trie_parent;
+	}
+
+	sys_dlist_remove(&mp->trie_node);
+}
+
+static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
+			    const char *name, size_t *match_len)
+{
+	struct fs_mount_t *mnt_p;
+
+	k_mutex_lock(&mutex, K_FOREVER);
+	mnt_p = mnt_trie_lookup(name);
 	k_mutex_unlock(&mutex);
 
 	if (mnt_p == NULL) {
@@ -75,6 +148,199 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 }
 
 /* File operations */
+static ssize_t file_read(struct fs_file_t *zfp, void *ptr, size_t size)
+{
+	int rc = -EINVAL;
+
+	if (zfp->mp->fs->read != NULL) {
+		rc = zfp->mp->fs->read(zfp, ptr, size);
+		if (rc < 0) {
+			LOG_ERR("file read error (%d)", rc);
+		}
+	}
+
+	return rc;
+}
+
+static ssize_t file_write(struct fs_file_t *zfp, const void *ptr,
+			  size_t size)
+{
+	int rc = -EINVAL;
+
+	if (zfp->mp->fs->write != NULL) {
+		rc = zfp->mp->fs->write(zfp, ptr, size);
+		if (rc < 0) {
+			LOG_ERR("file write error (%d)", rc);
+		}
+	}
+
+	return rc;
+}
+
+#if defined(CONFIG_FS_FILE_BUFFERING)
+/*
+ * Buffer of a file opened with fs_open_buffered(). It either holds data
+ * read ahead of the file position, or data written and not passed to the
+ * file system yet.
+ */
+struct fs_file_buf {
+	struct k_mem_block block;
+	/* Size of the buffer */
+	size_t size;
+	/* Number of valid bytes in the buffer */
+	size_t len;
+	/* Position of the file in the buffer */
+	size_t pos;
+	/* The valid bytes were written, not read ahead */
+	bool dirty;
+};
+
+K_MEM_SLAB_DEFINE(file_buf_slab, sizeof(struct fs_file_buf),
+		  CONFIG_FS_FILE_BUFFER_NUM_FILES, 4);
+
+K_MEM_POOL_DEFINE(file_buf_pool,
+		  CONFIG_FS_FILE_BUFFER_MEM_POOL_MIN_SIZE,
+		  CONFIG_FS_FILE_BUFFER_MEM_POOL_MAX_SIZE,
+		  CONFIG_FS_FILE_BUFFER_MEM_POOL_NUM_BLOCKS, 4);
+
+static int buf_flush(struct fs_file_t *zfp)
+{
+	struct fs_file_buf *buf = zfp->bufp;
+	u8_t *data = buf->block.data;
+	ssize_t rc;
+
+	if (buf->dirty) {
+		rc = file_write(zfp, data, buf->len);
+		if (rc < 0) {
+			return rc;
+		}
+
+		if (rc < buf->len) {
+			/* Keep what did not fit for a later attempt */
+			memmove(data, &data[rc], buf->len - rc);
+			buf->len -= rc;
+			buf->pos = buf->len;
+			return -ENOSPC;
+		}
+	} else if (buf->pos < buf->len) {
+		/* Move the file position back to the data not read yet */
+		rc = zfp->mp->fs->lseek(zfp, -(off_t)(buf->len - buf->pos),
+					FS_SEEK_CUR);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	buf->len = 0;
+	buf->pos = 0;
+	buf->dirty = false;
+
+	return 0;
+}
+
+static ssize_t buf_read(struct fs_file_t *zfp, u8_t *ptr, size_t size)
+{
+	struct fs_file_buf *buf = zfp->bufp;
+	size_t done = 0;
+	size_t len;
+	ssize_t rc;
+
+	if (buf->dirty) {
+		rc = buf_flush(zfp);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	while (size > 0) {
+		if (buf->pos < buf->len) {
+			len = MIN(size, buf->len - buf->pos);
+			memcpy(&ptr[done], (u8_t *)buf->block.data + buf->pos,
+			       len);
+			buf->pos += len;
+			done += len;
+			size -= len;
+			continue;
+		}
+
+		/* Large reads need no buffering */
+		if (size >= buf->size) {
+			rc = file_read(zfp, &ptr[done], size);
+		} else {
+			rc = file_read(zfp, buf->block.data, buf->size);
+			if (rc > 0) {
+				buf->len = rc;
+				buf->pos = 0;
+				continue;
+			}
+		}
+
+		if (rc < 0) {
+			return (done > 0) ? done : rc;
+		}
+
+		done += rc;
+		break;
+	}
+
+	return done;
+}
+
+static ssize_t buf_write(struct fs_file_t *zfp, const u8_t *ptr, size_t size)
+{
+	struct fs_file_buf *buf = zfp->bufp;
+	size_t done = 0;
+	size_t len;
+	ssize_t rc;
+
+	if (!buf->dirty) {
+		rc = buf_flush(zfp);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	while (size > 0) {
+		/* Large writes need no buffering */
+		if (buf->len == 0 && size >= buf->size) {
+			rc = file_write(zfp, &ptr[done], size);
+			if (rc < 0) {
+				return (done > 0) ? done : rc;
+			}
+
+			return done + rc;
+		}
+
+		len = MIN(size, buf->size - buf->len);
+		memcpy((u8_t *)buf->block.data + buf->len, &ptr[done], len);
+		buf->len += len;
+		buf->pos = buf->len;
+		buf->dirty = true;
+		done += len;
+		size -= len;
+
+		if (buf->len == buf->size) {
+			rc = buf_flush(zfp);
+			if (rc < 0) {
+				return rc;
+			}
+		}
+	}
+
+	return done;
+}
+
+static void buf_free(struct fs_file_t *zfp)
+{
+	struct fs_file_buf *buf = zfp->bufp;
+
+	k_mem_pool_free(&buf->block);
+	k_mem_slab_free(&file_buf_slab, &zfp->bufp);
+	zfp->bufp = NULL;
+}
+
+#endif /* CONFIG_FS_FILE_BUFFERING */
+
 int fs_open(struct fs_file_t *zfp, const char *file_name)
 {
 	struct fs_mount_t *mp;
@@ -93,6 +359,9 @@ int fs_open(struct fs_file_t *zfp, const char *file_name)
 	}
 
 	zfp->mp = mp;
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	zfp->bufp = NULL;
+#endif
 
 	if (zfp->mp->fs->open != NULL) {
 		rc = zfp->mp->fs->open(zfp, file_name);
@@ -105,18 +374,87 @@ int fs_open(struct fs_file_t *zfp, const char *file_name)
 	return rc;
 }
 
+#if defined(CONFIG_FS_FILE_BUFFERING)
+int fs_open_buffered(struct fs_file_t *zfp, const char *file_name,
+		     size_t size)
+{
+	struct fs_file_buf *buf;
+	int rc;
+
+	rc = fs_open(zfp, file_name);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if ((size == 0) || (size > CONFIG_FS_FILE_BUFFER_MEM_POOL_MAX_SIZE)) {
+		size = CONFIG_FS_FILE_BUFFER_MEM_POOL_MAX_SIZE;
+	}
+
+	if (k_mem_slab_alloc(&file_buf_slab, &zfp->bufp, K_NO_WAIT) != 0) {
+		LOG_WRN("no file buffer, %s not buffered",
+			log_strdup(file_name));
+		return rc;
+	}
+
+	buf = zfp->bufp;
+	if (k_mem_pool_alloc(&file_buf_pool, &buf->block, size,
+			     K_NO_WAIT) != 0) {
+		LOG_WRN("no memory for %zu byte buffer, %s not buffered",
+			size, log_strdup(file_name));
+		k_mem_slab_free(&file_buf_slab, &zfp->bufp);
+		zfp->bufp = NULL;
+		return rc;
+	}
+
+	buf->size = size;
+	buf->len = 0;
+	buf->pos = 0;
+	buf->dirty = false;
+
+	return rc;
+}
+#endif
+
 int fs_close(struct fs_file_t *zfp)
 {
 	int rc = -EINVAL;
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	int flush_rc = 0;
+
+	/* The file is closed even if the flush fails, the first error is
+	 * returned.
+	 */
+	if (zfp->bufp != NULL) {
+		flush_rc = buf_flush(zfp);
+		if (flush_rc < 0) {
+			LOG_ERR("file buffer flush error (%d)", flush_rc);
+		}
+	}
+#endif
 
 	if (zfp->mp->fs->close != NULL) {
 		rc = zfp->mp->fs->close(zfp);
 		if (rc < 0) {
 			LOG_ERR("file close error (%d)", rc);
+#if defined(CONFIG_FS_FILE_BUFFERING)
+			if (flush_rc < 0) {
+				rc = flush_rc;
+			}
+#endif
 			return rc;
 		}
 	}
 
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if (zfp->bufp != NULL) {
+		buf_free(zfp);
+	}
+
+	if (flush_rc < 0) {
+		rc = flush_rc;
+	}
+#endif
+
 	zfp->mp = NULL;
 
 	return rc;
@@ -124,36 +462,40 @@ int fs_close(struct fs_file_t *zfp)
 
 ssize_t fs_read(struct fs_file_t *zfp, void *ptr, size_t size)
 {
-	int rc = -EINVAL;
-
-	if (zfp->mp->fs->read != NULL) {
-		rc = zfp->mp->fs->read(zfp, ptr, size);
-		if (rc < 0) {
-			LOG_ERR("file read error (%d)", rc);
-		}
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if (zfp->bufp != NULL) {
+		return buf_read(zfp, ptr, size);
 	}
+#endif
 
-	return rc;
+	return file_read(zfp, ptr, size);
 }
 
 ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 {
-	int rc = -EINVAL;
-
-	if (zfp->mp->fs->write != NULL) {
-		rc = zfp->mp->fs->write(zfp, ptr, size);
-		if (rc < 0) {
-			LOG_ERR("file write error (%d)", rc);
-		}
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if (zfp->bufp != NULL) {
+		return buf_write(zfp, ptr, size);
 	}
+#endif
 
-	return rc;
+	return file_write(zfp, ptr, size);
 }
 
 int fs_seek(struct fs_file_t *zfp, off_t offset, int whence)
 {
 	int rc = -EINVAL;
 
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if (zfp->bufp != NULL) {
+		rc = buf_flush(zfp);
+		if (rc < 0) {
+			LOG_ERR("file buffer flush error (%d)", rc);
+			return rc;
+		}
+	}
+#endif
+
 	if (zfp->mp->fs->lseek != NULL) {
 		rc = zfp->mp->fs->lseek(zfp, offset, whence);
 		if (rc < 0) {
@@ -175,6 +517,19 @@ off_t fs_tell(struct fs_file_t *zfp)
 		}
 	}
 
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if ((rc >= 0) && (zfp->bufp != NULL)) {
+		struct fs_file_buf *buf = zfp->bufp;
+
+		/* Account for the data the file system has not seen yet */
+		if (buf->dirty) {
+			rc += buf->len;
+		} else {
+			rc -= (off_t)(buf->len - buf->pos);
+		}
+	}
+#endif
+
 	return rc;
 }
 
@@ -182,6 +537,16 @@ int fs_truncate(struct fs_file_t *zfp, off_t length)
 {
 	int rc = -EINVAL;
 
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if (zfp->bufp != NULL) {
+		rc = buf_flush(zfp);
+		if (rc < 0) {
+			LOG_ERR("file buffer flush error (%d)", rc);
+			return rc;
+		}
+	}
+#endif
+
 	if (zfp->mp->fs->truncate != NULL) {
 		rc = zfp->mp->fs->truncate(zfp, length);
 		if (rc < 0) {
@@ -196,6 +561,16 @@ int fs_sync(struct fs_file_t *zfp)
 {
 	int rc = -EINVAL;
 
+#if defined(CONFIG_FS_FILE_BUFFERING)
+	if (zfp->bufp != NULL) {
+		rc = buf_flush(zfp);
+		if (rc < 0) {
+			LOG_ERR("file buffer flush error (%d)", rc);
+			return rc;
+		}
+	}
+#endif
+
 	if (zfp->mp->fs->sync != NULL) {
 		rc = zfp->mp->fs->sync(zfp);
 		if (rc < 0) {
@@ -493,9 +868,7 @@ int fs_statvfs(const char *abs_path, struct fs_statvfs *stat)
 
 int fs_mount(struct fs_mount_t *mp)
 {
-	struct fs_mount_t *itr;
 	struct fs_file_system_t *fs;
-	sys_dnode_t *node;
 	int rc = -EINVAL;
 
 	if ((mp == NULL) || (mp->mnt_point == NULL)) {
@@ -529,32 +902,23 @@ int fs_mount(struct fs_mount_t *mp)
 	}
 
 	/* Check if mount point already exists */
-	SYS_DLIST_FOR_EACH_NODE(&fs_mnt_list, node) {
-		itr = CONTAINER_OF(node, struct fs_mount_t, node);
-		/* continue if length does not match */
-		if (mp->mountp_len != itr->mountp_len) {
-			continue;
-		}
-
-		if (strncmp(mp->mnt_point, itr->mnt_point,
-					mp->mountp_len) == 0) {
-			LOG_ERR("mount Point already exists!!");
-			rc = -EBUSY;
-			goto mount_err;
-		}
+	rc = mnt_trie_insert(mp);
+	if (rc < 0) {
+		LOG_ERR("mount Point already exists!!");
+		goto mount_err;
 	}
 
-
 	rc = fs->mount(mp);
 	if (rc < 0) {
 		LOG_ERR("fs mount error (%d)", rc);
+		mnt_trie_remove(mp);
 		goto mount_err;
 	}
 
 	/* set mount point fs interface */
 	mp->fs = fs;
 
-	/*  append to the mount list */
+	/* append to the mount list */
 	sys_dlist_append(&fs_mnt_list, &mp->node);
 	LOG_DBG("fs mounted at %s", log_strdup(mp->mnt_point));
 
@@ -592,6 +956,7 @@ int fs_unmount(struct fs_mount_t *mp)
 
 	/* remove mount node from the list */
 	sys_dlist_remove(&mp->node);
+	mnt_trie_remove(mp);
 	LOG_DBG("fs unmounted from %s", log_strdup(mp->mnt_point));
 
 unmount_err:
@@ -672,6 +1037,7 @@ static int fs_init(struct device *dev)
 {
 	k_mutex_init(&mutex);
 	sys_dlist_init(&fs_mnt_list);
+	sys_dlist_init(&fs_mnt_trie);
 	return 0;
 }
 
@@ -28,6 +28,94 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 }
 /* end basic routines */
 
+static int nvs_prev_ate(struct nvs_fs *fs, u32_t *addr, struct nvs_ate *ate);
+static int nvs_ate_crc8_check(const struct nvs_ate *entry);
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* lookup cache routines */
+/* nvs_lookup_cache_pos returns the cache slot an id is hashed to */
+static inline size_t nvs_lookup_cache_pos(u16_t id)
+{
+	u32_t hash = id;
+
+	/* 16-bit integer mixing, spreads consecutive ids over the cache */
+	hash ^= hash >> 8;
+	hash *= 0x88b5U;
+	hash &= 0xFFFF;
+	hash ^= hash >> 7;
+	hash *= 0xdb2dU;
+	hash &= 0xFFFF;
+	hash ^= hash >> 9;
+
+	return hash % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+
+/* nvs_lookup_cache_rebuild walks the complete allocation table from newest
+ * to oldest entry and stores for every slot the address of the first (most
+ * recent) valid ate hashed to it.
+ */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	u32_t addr, ate_addr;
+	u32_t *cache_entry;
+	struct nvs_ate ate;
+
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	addr = fs->ate_wra;
+
+	while (1) {
+		/* nvs_prev_ate advances addr, keep where the ate was read */
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		cache_entry = &fs->lookup_cache[nvs_lookup_cache_pos(ate.id)];
+
+		if ((ate.id != 0xFFFF) &&
+		    (*cache_entry == NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    (!nvs_ate_crc8_check(&ate))) {
+			*cache_entry = ate_addr;
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/* nvs_lookup_cache_invalidate drops all cache slots pointing into a sector */
+static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, u32_t addr)
+{
+	u32_t sector = addr >> ADDR_SECT_SHIFT;
+
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs->lookup_cache[i] >> ADDR_SECT_SHIFT) == sector) {
+			fs->lookup_cache[i] = NVS_LOOKUP_CACHE_NO_ADDR;
+		}
+	}
+}
+/* end of lookup cache routines */
+#endif
+
+/* nvs_lookup_start returns the address at which a walk searching for the
+ * most recent ate of id should start. Without lookup cache this is the
+ * newest ate, with lookup cache it is the latest ate hashed to the same
+ * slot as id, or NVS_LOOKUP_CACHE_NO_ADDR when id is not stored.
+ */
+static inline u32_t nvs_lookup_start(struct nvs_fs *fs, u16_t id)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	return fs->lookup_cache[nvs_lookup_cache_pos(id)];
+#else
+	return fs->ate_wra;
+#endif
+}
+
 /* flash routines */
 /* basic aligned flash write to nvs address */
 static int nvs_flash_al_wrt(struct nvs_fs *fs, u32_t addr, const void *data,
@@ -103,6 +191,13 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 
 	rc = nvs_flash_al_wrt(fs, fs->ate_wra, entry,
 			       sizeof(struct nvs_ate));
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* 0xFFFF is the id of sector close ate's, these are never looked up */
+	if (!rc && (entry->id != 0xFFFF)) {
+		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] =
+			fs->ate_wra;
+	}
+#endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	return rc;
@@ -242,6 +337,9 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, u32_t addr)
 		/* flash erase error */
 		return rc;
 	}
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	nvs_lookup_cache_invalidate(fs, addr);
+#endif
 	(void) flash_write_protection_set(fs->flash_device, 1);
 	return 0;
 }
@@ -480,7 +578,10 @@ static int nvs_gc(struct nvs_fs *fs)
 		if (rc) {
 			return rc;
 		}
-		wlk_addr = fs->ate_wra;
+		wlk_addr = nvs_lookup_start(fs, gc_ate.id);
+		if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+			wlk_addr = fs->ate_wra;
+		}
 		while (1) {
 			wlk_prev_addr = wlk_addr;
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
@@ -639,6 +740,13 @@ static int nvs_startup(struct nvs_fs *fs)
 		fs->data_wra += fs->write_block_size;
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	rc = nvs_lookup_cache_rebuild(fs);
+	if (rc) {
+		goto end;
+	}
+#endif
+
 	/* if the sector after the write sector is not empty gc was interrupted
 	 * we need to restart gc, first erase the sector before restarting gc
 	 * otherwise the data may not fit into the sector.
@@ -774,10 +882,10 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
-	wlk_addr = fs->ate_wra;
+	wlk_addr = nvs_lookup_start(fs, id);
 	rd_addr = wlk_addr;
 
-	while (1) {
+	while (wlk_addr != NVS_LOOKUP_CACHE_NO_ADDR) {
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
@@ -892,7 +1000,10 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
-	wlk_addr = fs->ate_wra;
+	wlk_addr = nvs_lookup_start(fs, id);
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		return -ENOENT;
+	}
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
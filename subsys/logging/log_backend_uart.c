@@ -28,11 +28,23 @@ static u8_t buf;
 
 LOG_OUTPUT_DEFINE(log_output, char_out, &buf, 1);
 
+static u32_t format_flag(void)
+{
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE)) {
+		return LOG_OUTPUT_FLAG_FORMAT_SYST;
+	}
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICT_ENABLE)) {
+		return LOG_OUTPUT_FLAG_FORMAT_DICT;
+	}
+
+	return 0;
+}
+
 static void put(const struct log_backend *const backend,
 		struct log_msg *msg)
 {
-	u32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
-		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+	u32_t flag = format_flag();
 
 	log_backend_std_put(&log_output, flag, msg);
 }
@@ -56,15 +68,18 @@ static void dropped(const struct log_backend *const backend, u32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_backend_std_dropped(&log_output, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICT_ENABLE)) {
+		log_output_dropped_dict_process(&log_output, cnt);
+	} else {
+		log_backend_std_dropped(&log_output, cnt);
+	}
 }
 
 static void sync_string(const struct log_backend *const backend,
 		     struct log_msg_ids src_level, u32_t timestamp,
 		     const char *fmt, va_list ap)
 {
-	u32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
-		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+	u32_t flag = format_flag();
 
 	log_backend_std_sync_string(&log_output, flag, src_level,
 				    timestamp, fmt, ap);
@@ -74,8 +89,7 @@ static void sync_hexdump(const struct log_backend *const backend,
 			 struct log_msg_ids src_level, u32_t timestamp,
 			 const char *metadata, const u8_t *data, u32_t length)
 {
-	u32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
-		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+	u32_t flag = format_flag();
 
 	log_backend_std_sync_hexdump(&log_output, flag, src_level,
 				     timestamp, metadata, data, length);
@@ -420,6 +420,7 @@ static void log_msg_hexdump_data_op(struct log_msg *msg,
 	}
 
 	if (offset < chunk_len) {
+		chunk_len -= offset;
 		cpy_len = req_len > chunk_len ? chunk_len : req_len;
 
 		if (put_op) {
@@ -430,6 +431,7 @@ static void log_msg_hexdump_data_op(struct log_msg *msg,
 
 		req_len -= cpy_len;
 		data += cpy_len;
+		offset = 0;
 	} else {
 		offset -= chunk_len;
 		chunk_len = HEXDUMP_BYTES_CONT_MSG;
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <logging/log.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+
+/*
+ * Messages are not formatted on the target. Each one leaves as a binary
+ * record, in the byte order of the target, that scripts/logging/
+ * log_dict_parser.py turns back into text with the help of the database
+ * generated from the ELF file by scripts/logging/gen_log_dict_db.py.
+ *
+ * Every record starts with the two sync bytes 0xA5 0x5A, which let the
+ * parser find the next record again after corrupted or lost data, then a
+ * control byte:
+ *   bits 0-1 record type, bits 2-4 level, bits 5-7 domain ID
+ *
+ * Standard message:
+ *   u16_t source ID, u32_t timestamp, format string address,
+ *   u8_t number of argument words, log_arg_t argument words,
+ *   the content of each %s argument, null terminated
+ *
+ * An argument takes one word, except double and 64-bit integer arguments
+ * which take the 8 bytes of their value, two words when log_arg_t is 32
+ * bits wide.
+ *
+ * Hexdump message (or raw string when the level is 0):
+ *   u16_t source ID, u32_t timestamp, metadata string address,
+ *   u16_t length, data
+ *
+ * Dropped messages:
+ *   u32_t number of messages dropped
+ */
+
+#define DICT_SYNC_0		0xA5
+#define DICT_SYNC_1		0x5A
+
+#define DICT_RECORD_STD		0
+#define DICT_RECORD_HEXDUMP	1
+#define DICT_RECORD_DROPPED	2
+
+#define DICT_CTRL(type, level, domain_id) \
+	((type) | ((level) << 2) | ((domain_id) << 5))
+
+struct dict_hdr {
+	u8_t sync[2];
+	u8_t ctrl;
+	u16_t source_id;
+	u32_t timestamp;
+} __packed;
+
+/* Conversion of an argument consumed by a format string, with the number
+ * of long length modifiers in front of it.
+ */
+struct dict_arg {
+	char conv;
+	u8_t longs;
+};
+
+/* Number of words of a double or 64-bit integer argument */
+#define DICT_ARG64_WORDS	(sizeof(u64_t) / sizeof(log_arg_t))
+
+static bool dict_arg_is_float(const struct dict_arg *arg)
+{
+	return (arg->conv != '\0') && (strchr("aAeEfFgG", arg->conv) != NULL);
+}
+
+static bool dict_arg_is_64(const struct dict_arg *arg)
+{
+	return dict_arg_is_float(arg) || (arg->longs > 1);
+}
+
+/* Stores a 64-bit argument value in words, returns the number of words */
+static u32_t dict_arg64_put(log_arg_t *words, const void *value)
+{
+	memcpy(words, value, sizeof(u64_t));
+
+	return DICT_ARG64_WORDS;
+}
+
+static void dict_write(const struct log_output *log_output,
+		       const void *data, size_t len)
+{
+	const u8_t *src = data;
+	size_t part;
+	int processed;
+
+	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
+		/* Backend must be thread safe in synchronous operation. */
+		while (len != 0) {
+			processed = log_output->func((u8_t *)src, len,
+					log_output->control_block->ctx);
+			src += processed;
+			len -= processed;
+		}
+
+		return;
+	}
+
+	while (len != 0) {
+		if (log_output->control_block->offset == log_output->size) {
+			log_output_flush(log_output);
+		}
+
+		part = MIN(len, log_output->size -
+			   log_output->control_block->offset);
+		memcpy(&log_output->buf[log_output->control_block->offset],
+		       src, part);
+		atomic_add(&log_output->control_block->offset, part);
+
+		src += part;
+		len -= part;
+	}
+}
+
+static void hdr_write(const struct log_output *log_output, u8_t type,
+		      struct log_msg_ids src_level, u32_t timestamp)
+{
+	struct dict_hdr hdr = {
+		.sync = { DICT_SYNC_0, DICT_SYNC_1 },
+		.ctrl = DICT_CTRL(type, src_level.level, src_level.domain_id),
+		.source_id = src_level.source_id,
+		.timestamp = timestamp,
+	};
+
+	dict_write(log_output, &hdr, sizeof(hdr));
+}
+
+/* Finds the conversions of the arguments consumed by a format string. A
+ * width or precision given as argument is an int.
+ */
+static u32_t fmt_args_scan(const char *fmt, struct dict_arg *args, u32_t max)
+{
+	u32_t n = 0U;
+	u8_t longs;
+
+	while (*fmt != '\0' && n < max) {
+		if (*fmt++ != '%') {
+			continue;
+		}
+
+		if (*fmt == '%') {
+			fmt++;
+			continue;
+		}
+
+		longs = 0U;
+
+		while (*fmt != '\0' && strchr("-+ #0123456789.*lhjzt", *fmt)) {
+			if (*fmt == '*' && n < max) {
+				args[n].conv = 'd';
+				args[n++].longs = 0U;
+			} else if (*fmt == 'l' || *fmt == 'j') {
+				longs += (*fmt == 'j') ? 2U : 1U;
+			} else if (*fmt == 'z' || *fmt == 't') {
+				longs = MAX(longs, 1U);
+			}
+
+			fmt++;
+		}
+
+		if (*fmt == '\0' || n == max) {
+			break;
+		}
+
+		args[n].conv = *fmt++;
+		args[n++].longs = longs;
+	}
+
+	return n;
+}
+
+static void std_write(const struct log_output *log_output,
+		      struct log_msg_ids src_level, u32_t timestamp,
+		      const char *fmt, log_arg_t *words, u32_t nwords,
+		      const struct dict_arg *conv, u32_t nargs)
+{
+	u8_t n = nwords;
+	const char *str;
+	u32_t w = 0U;
+
+	hdr_write(log_output, DICT_RECORD_STD, src_level, timestamp);
+	dict_write(log_output, &fmt, sizeof(fmt));
+	dict_write(log_output, &n, sizeof(n));
+	dict_write(log_output, words, nwords * sizeof(log_arg_t));
+
+	/* Strings may not outlive the message, send their content */
+	for (u32_t i = 0; i < nargs; i++) {
+		if (conv[i].conv != 's') {
+			w += dict_arg_is_64(&conv[i]) ? DICT_ARG64_WORDS : 1U;
+			continue;
+		}
+
+		str = (const char *)words[w++];
+		if (str == NULL) {
+			str = "";
+		}
+
+		dict_write(log_output, str, strlen(str) + 1);
+	}
+}
+
+static void std_msg_process(const struct log_output *log_output,
+			    struct log_msg_ids src_level, struct log_msg *msg)
+{
+	const char *fmt = log_msg_str_get(msg);
+	u32_t nargs = log_msg_nargs_get(msg);
+	struct dict_arg conv[LOG_MAX_NARGS];
+	log_arg_t words[LOG_MAX_NARGS * DICT_ARG64_WORDS];
+	u32_t nwords = 0U;
+	log_arg_t arg;
+
+	/* Arguments the format string does not use are not marked */
+	memset(conv, 0, sizeof(conv));
+	fmt_args_scan(fmt, conv, nargs);
+
+	/* A message holds every argument in a single word, cast by the
+	 * logging macro. Widen those the format string reads as 64 bits.
+	 */
+	for (u32_t i = 0; i < nargs; i++) {
+		arg = log_msg_arg_get(msg, i);
+
+		if (dict_arg_is_float(&conv[i])) {
+			double value = arg;
+
+			nwords += dict_arg64_put(&words[nwords], &value);
+		} else if (dict_arg_is_64(&conv[i])) {
+			s64_t value = (conv[i].conv == 'd' ||
+				       conv[i].conv == 'i') ?
+				      (s64_t)(long)arg : (s64_t)arg;
+
+			nwords += dict_arg64_put(&words[nwords], &value);
+		} else {
+			words[nwords++] = arg;
+		}
+	}
+
+	std_write(log_output, src_level, log_msg_timestamp_get(msg), fmt,
+		  words, nwords, conv, nargs);
+}
+
+static void hexdump_msg_process(const struct log_output *log_output,
+				struct log_msg_ids src_level,
+				struct log_msg *msg)
+{
+	const char *metadata = log_msg_str_get(msg);
+	u16_t length = msg->hdr.params.hexdump.length;
+	u32_t offset = 0U;
+	u8_t buf[16];
+	size_t part;
+
+	hdr_write(log_output, DICT_RECORD_HEXDUMP, src_level,
+		  log_msg_timestamp_get(msg));
+	dict_write(log_output, &metadata, sizeof(metadata));
+	dict_write(log_output, &length, sizeof(length));
+
+	do {
+		part = sizeof(buf);
+		log_msg_hexdump_data_get(msg, buf, &part, offset);
+		dict_write(log_output, buf, part);
+		offset += part;
+	} while (part != 0);
+}
+
+void log_output_msg_dict_process(const struct log_output *log_output,
+				 struct log_msg *msg, u32_t flag)
+{
+	struct log_msg_ids src_level = {
+		.level = log_msg_level_get(msg),
+		.domain_id = log_msg_domain_id_get(msg),
+		.source_id = log_msg_source_id_get(msg),
+	};
+
+	if (log_msg_is_std(msg)) {
+		std_msg_process(log_output, src_level, msg);
+	} else {
+		hexdump_msg_process(log_output, src_level, msg);
+	}
+
+	log_output_flush(log_output);
+}
+
+void log_output_string_dict_process(const struct log_output *log_output,
+				    struct log_msg_ids src_level,
+				    u32_t timestamp, const char *fmt,
+				    va_list ap, u32_t flag)
+{
+	struct dict_arg conv[LOG_MAX_NARGS];
+	log_arg_t words[LOG_MAX_NARGS * DICT_ARG64_WORDS];
+	u32_t nwords = 0U;
+	u32_t nargs;
+
+	/* The arguments are passed as given to the logging macro */
+	nargs = fmt_args_scan(fmt, conv, LOG_MAX_NARGS);
+
+	for (u32_t i = 0; i < nargs; i++) {
+		if (conv[i].conv == 's' || conv[i].conv == 'p') {
+			words[nwords++] = (log_arg_t)va_arg(ap, void *);
+		} else if (dict_arg_is_float(&conv[i])) {
+			double value = va_arg(ap, double);
+
+			nwords += dict_arg64_put(&words[nwords], &value);
+		} else if (conv[i].longs > 1) {
+			long long value = va_arg(ap, long long);
+
+			nwords += dict_arg64_put(&words[nwords], &value);
+		} else if (conv[i].longs == 1) {
+			words[nwords++] = (log_arg_t)va_arg(ap, long);
+		} else {
+			words[nwords++] = (log_arg_t)va_arg(ap, int);
+		}
+	}
+
+	std_write(log_output, src_level, timestamp, fmt, words, nwords,
+		  conv, nargs);
+	log_output_flush(log_output);
+}
+
+void log_output_hexdump_dict_process(const struct log_output *log_output,
+				     struct log_msg_ids src_level,
+				     u32_t timestamp, const char *metadata,
+				     const u8_t *data, u32_t length,
+				     u32_t flag)
+{
+	u16_t len = MIN(length, LOG_MSG_HEXDUMP_MAX_LENGTH);
+
+	hdr_write(log_output, DICT_RECORD_HEXDUMP, src_level, timestamp);
+	dict_write(log_output, &metadata, sizeof(metadata));
+	dict_write(log_output, &len, sizeof(len));
+	dict_write(log_output, data, len);
+	log_output_flush(log_output);
+}
+
+void log_output_dropped_dict_process(const struct log_output *log_output,
+				     u32_t cnt)
+{
+	u8_t hdr[] = { DICT_SYNC_0, DICT_SYNC_1, DICT_RECORD_DROPPED };
+
+	dict_write(log_output, hdr, sizeof(hdr));
+	dict_write(log_output, &cnt, sizeof(cnt));
+	log_output_flush(log_output);
+}
@@ -59,6 +59,18 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* Connection handlers with a local port are also linked into conn_hash,
+ * in the bucket selected by protocol and local port, or by protocol,
+ * local port, remote port and remote address when all of those are
+ * specified. Handlers without a local port are linked into
+ * conn_wildcard. Like conn_used, every list is kept newest first.
+ */
+static sys_slist_t conn_hash[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wildcard;
+static u32_t conn_seq;
+#endif
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -127,11 +139,198 @@ static struct net_conn *conn_get_unused(void)
 	return CONTAINER_OF(node, struct net_conn, node);
 }
 
+#if defined(CONFIG_NET_CONN_HASH)
+static u32_t conn_hash_mix(u32_t hash, u32_t value)
+{
+	hash ^= value;
+	hash *= 0x01000193;
+
+	return hash;
+}
+
+static u32_t conn_hash_key(u16_t proto, u16_t local_port,
+			   u16_t remote_port, const void *remote_addr,
+			   size_t addr_len)
+{
+	const u8_t *addr = remote_addr;
+	u32_t hash = 0x811c9dc5;
+	size_t i;
+
+	hash = conn_hash_mix(hash, ((u32_t)proto << 16) | local_port);
+
+	if (addr) {
+		hash = conn_hash_mix(hash, remote_port);
+
+		for (i = 0; i < addr_len; i += sizeof(u32_t)) {
+			hash = conn_hash_mix(hash,
+					     UNALIGNED_GET((u32_t *)&addr[i]));
+		}
+	}
+
+	/* Ports are in network byte order and the bucket is taken from
+	 * the low bits, so spread the high bits down.
+	 */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+
+	return hash % CONFIG_NET_CONN_HASH_BUCKETS;
+}
+
+static sys_slist_t *conn_hash_list(struct net_conn *conn)
+{
+	u16_t local_port = net_sin(&conn->local_addr)->sin_port;
+	u16_t remote_port = net_sin(&conn->remote_addr)->sin_port;
+
+	if (!local_port) {
+		return &conn_wildcard;
+	}
+
+	if (remote_port && (conn->flags & NET_CONN_REMOTE_ADDR_SPEC)) {
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    conn->remote_addr.sa_family == AF_INET6) {
+			return &conn_hash[conn_hash_key(
+				conn->proto, local_port, remote_port,
+				&net_sin6(&conn->remote_addr)->sin6_addr,
+				sizeof(struct in6_addr))];
+		} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+			   conn->remote_addr.sa_family == AF_INET) {
+			return &conn_hash[conn_hash_key(
+				conn->proto, local_port, remote_port,
+				&net_sin(&conn->remote_addr)->sin_addr,
+				sizeof(struct in_addr))];
+		}
+	}
+
+	return &conn_hash[conn_hash_key(conn->proto, local_port, 0,
+					NULL, 0)];
+}
+
+/* Lookup cursor over the lists that may hold handlers for a packet:
+ * the wildcard list, the local port bucket and the fully specified
+ * bucket. The lists are merged on the registration sequence number so
+ * that handlers are visited in the same order as a walk of conn_used.
+ */
+struct conn_iter {
+	struct net_conn *next[3];
+};
+
+static void conn_iter_init(struct conn_iter *iter, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, u16_t proto,
+			   u16_t src_port, u16_t dst_port)
+{
+	const void *src_addr = NULL;
+	size_t addr_len = 0;
+	u32_t port_key;
+	u32_t key;
+
+	(void)memset(iter, 0, sizeof(*iter));
+
+	iter->next[0] = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_wildcard,
+						      iter->next[0],
+						      hash_node);
+
+	/* Handlers in the buckets all have a local port, so they cannot
+	 * match a packet without one.
+	 */
+	if (!dst_port) {
+		return;
+	}
+
+	port_key = conn_hash_key(proto, dst_port, 0, NULL, 0);
+	iter->next[1] = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_hash[port_key],
+						      iter->next[1],
+						      hash_node);
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		src_addr = &ip_hdr->ipv6->src;
+		addr_len = sizeof(struct in6_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_pkt_family(pkt) == AF_INET) {
+		src_addr = &ip_hdr->ipv4->src;
+		addr_len = sizeof(struct in_addr);
+	}
+
+	if (!src_addr || !src_port) {
+		return;
+	}
+
+	key = conn_hash_key(proto, dst_port, src_port, src_addr, addr_len);
+	if (key != port_key) {
+		iter->next[2] = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_hash[key],
+							      iter->next[2],
+							      hash_node);
+	}
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *conn;
+	int best = -1;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(iter->next); i++) {
+		if (!iter->next[i]) {
+			continue;
+		}
+
+		if (best < 0 ||
+		    (s32_t)(iter->next[i]->seq - iter->next[best]->seq) > 0) {
+			best = i;
+		}
+	}
+
+	if (best < 0) {
+		return NULL;
+	}
+
+	conn = iter->next[best];
+	iter->next[best] = SYS_SLIST_PEEK_NEXT_CONTAINER(conn, hash_node);
+
+	return conn;
+}
+#else
+struct conn_iter {
+	struct net_conn *next;
+};
+
+static void conn_iter_init(struct conn_iter *iter, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, u16_t proto,
+			   u16_t src_port, u16_t dst_port)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto);
+	ARG_UNUSED(src_port);
+	ARG_UNUSED(dst_port);
+
+	iter->next = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_used, iter->next,
+						   node);
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *conn = iter->next;
+
+	if (conn) {
+		iter->next = SYS_SLIST_PEEK_NEXT_CONTAINER(conn, node);
+	}
+
+	return conn;
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
 static void conn_set_used(struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+
+#if defined(CONFIG_NET_CONN_HASH)
+	conn->seq = conn_seq++;
+
+	sys_slist_prepend(conn_hash_list(conn), &conn->hash_node);
+#endif
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -374,6 +573,10 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_find_and_remove(conn_hash_list(conn), &conn->hash_node);
+#endif
+
 	conn_set_unused(conn);
 
 	return 0;
@@ -509,6 +712,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	struct net_conn *best_match = NULL;
 	bool is_mcast_pkt = false, mcast_pkt_delivered = false;
 	s16_t best_rank = -1;
+	struct conn_iter iter;
 	struct net_conn *conn;
 	u16_t src_port;
 	u16_t dst_port;
@@ -564,7 +768,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	conn_iter_init(&iter, pkt, ip_hdr, proto, src_port, dst_port);
+
+	while ((conn = conn_iter_next(&iter)) != NULL) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -729,6 +935,14 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONFIG_NET_CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
+#endif
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
@@ -50,6 +50,14 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Internal slist node for the hash bucket or wildcard list */
+	sys_snode_t hash_node;
+
+	/** Registration sequence number, orders the lookup lists */
+	u32_t seq;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -181,6 +181,7 @@ static struct net_pkt *dhcpv4_create_message(struct net_if *iface, u8_t type,
 	pkt = net_pkt_alloc_with_buffer(iface, size, AF_INET,
 					IPPROTO_UDP, K_FOREVER);
 
+	net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 	net_pkt_set_ipv4_ttl(pkt, 0xFF);
 
 	if (net_ipv4_create(pkt, addr, server_addr) ||
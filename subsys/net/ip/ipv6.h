@@ -113,6 +113,11 @@ struct net_ipv6_nbr_data {
 	 */
 	u32_t stale_counter;
 #endif
+
+#if defined(CONFIG_NET_IPV6_NBR_CACHE_HASH)
+	/** Node in the neighbor hash bucket of the IPv6 address */
+	sys_snode_t hash_node;
+#endif
 };
 
 static inline struct net_ipv6_nbr_data *net_ipv6_nbr_data(struct net_nbr *nbr)
@@ -255,6 +255,52 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+#if defined(CONFIG_NET_IPV6_NBR_CACHE_HASH)
+/* Neighbors in use, hashed by their IPv6 address. */
+static sys_slist_t nbr_hash[CONFIG_NET_IPV6_NBR_CACHE_HASH_BUCKETS];
+
+static sys_slist_t *nbr_hash_bucket(const struct in6_addr *addr)
+{
+	u32_t hash = 0x811c9dc5;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(addr->s6_addr32); i++) {
+		hash ^= UNALIGNED_GET(&addr->s6_addr32[i]);
+		hash *= 0x01000193;
+	}
+
+	/* Neighbors often differ only in the last bytes of the address,
+	 * spread those to the low bits used for the bucket.
+	 */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+
+	return &nbr_hash[hash % CONFIG_NET_IPV6_NBR_CACHE_HASH_BUCKETS];
+}
+
+static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
+				  struct net_if *iface,
+				  const struct in6_addr *addr)
+{
+	struct net_ipv6_nbr_data *data;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_hash_bucket(addr), data, hash_node) {
+		struct net_nbr *nbr = CONTAINER_OF((u8_t *)data,
+						   struct net_nbr, __nbr);
+
+		if (iface && nbr->iface != iface) {
+			continue;
+		}
+
+		if (net_ipv6_addr_cmp(&data->addr, addr)) {
+			return nbr;
+		}
+	}
+
+	return NULL;
+}
+#else
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  const struct in6_addr *addr)
@@ -279,6 +325,7 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 
 	return NULL;
 }
+#endif /* CONFIG_NET_IPV6_NBR_CACHE_HASH */
 
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
 {
@@ -431,6 +478,11 @@ static struct net_nbr *nbr_new(struct net_if *iface,
 
 	nbr_init(nbr, iface, addr, is_router, state);
 
+#if defined(CONFIG_NET_IPV6_NBR_CACHE_HASH)
+	sys_slist_append(nbr_hash_bucket(addr),
+			 &net_ipv6_nbr_data(nbr)->hash_node);
+#endif
+
 	NET_DBG("nbr %p iface %p state %d IPv6 %s",
 		nbr, iface, state,
 		log_strdup(net_sprint_ipv6_addr(addr)));
@@ -647,6 +699,12 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
+#if defined(CONFIG_NET_IPV6_NBR_CACHE_HASH)
+	sys_slist_find_and_remove(
+		nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr),
+		&net_ipv6_nbr_data(nbr)->hash_node);
+#endif
+
 	return;
 }
 
@@ -1044,6 +1102,7 @@ int net_ipv6_send_na(struct net_if *iface, const struct in6_addr *src,
 		return -ENOMEM;
 	}
 
+	net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 	net_pkt_set_ipv6_hop_limit(pkt, NET_IPV6_ND_HOP_LIMIT);
 
 	if (net_ipv6_create(pkt, src, dst) ||
@@ -1838,6 +1897,7 @@ int net_ipv6_send_ns(struct net_if *iface,
 		goto drop;
 	}
 
+	net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 	net_pkt_set_ipv6_hop_limit(pkt, NET_IPV6_ND_HOP_LIMIT);
 
 	if (net_ipv6_create(pkt, src, dst) ||
@@ -1953,6 +2013,7 @@ int net_ipv6_send_rs(struct net_if *iface)
 		return -ENOMEM;
 	}
 
+	net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 	net_pkt_set_ipv6_hop_limit(pkt, NET_IPV6_ND_HOP_LIMIT);
 
 	if (net_ipv6_create(pkt, src, &dst) ||
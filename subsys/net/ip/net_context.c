@@ -52,6 +52,13 @@ LOG_MODULE_REGISTER(net_ctx, CONFIG_NET_CONTEXT_LOG_LEVEL);
 
 static struct net_context contexts[NET_MAX_CONTEXT];
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+/* Kept outside of the contexts as net_context_get() clears those,
+ * while packets of the previous user may still be charged here.
+ */
+static struct net_pkt_quota context_quotas[NET_MAX_CONTEXT][2];
+#endif
+
 /* We need to lock the contexts array as these APIs are typically called
  * from applications which are usually run in task context.
  */
@@ -248,6 +255,13 @@ int net_context_get(sa_family_t family,
 		contexts[i].flags = 0U;
 		atomic_set(&contexts[i].refcount, 1);
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+		(void)net_pkt_quota_set(&context_quotas[i][0], 0,
+				CONFIG_NET_PKT_QUOTA_CONTEXT_TX_MAX);
+		(void)net_pkt_quota_set(&context_quotas[i][1], 0,
+				CONFIG_NET_PKT_QUOTA_CONTEXT_RX_MAX);
+#endif
+
 		net_context_set_family(&contexts[i], family);
 		net_context_set_type(&contexts[i], type);
 		net_context_set_ip_proto(&contexts[i], ip_proto);
@@ -1311,6 +1325,14 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 		net_pkt_set_context(pkt, context);
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (pkt && !net_pkt_quota_charge(pkt, NET_PKT_QUOTA_CONTEXT,
+				net_context_pkt_quota(context, false))) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+#endif
+
 	return pkt;
 }
 
@@ -1734,6 +1756,17 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 		goto unlock;
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* TCP data is not refused here as it has been acked already,
+	 * the receive window limits it instead.
+	 */
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP &&
+	    !net_pkt_quota_charge(pkt, NET_PKT_QUOTA_CONTEXT,
+				  net_context_pkt_quota(context, true))) {
+		goto unlock;
+	}
+#endif
+
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
 		net_stats_update_tcp_recv(net_pkt_iface(pkt),
 					  net_pkt_remaining_data(pkt));
@@ -1844,6 +1877,13 @@ static enum net_verdict net_context_raw_packet_received(
 	net_context_set_iface(context, net_pkt_iface(pkt));
 	net_pkt_set_context(pkt, context);
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (!net_pkt_quota_charge(pkt, NET_PKT_QUOTA_CONTEXT,
+				  net_context_pkt_quota(context, true))) {
+		return NET_DROP;
+	}
+#endif
+
 	context->recv_cb(context, pkt, ip_hdr, proto_hdr, 0, user_data);
 
 #if defined(CONFIG_NET_CONTEXT_SYNC_RECV)
@@ -2150,7 +2190,22 @@ void net_context_foreach(net_context_cb_t cb, void *user_data)
 	k_sem_give(&contexts_lock);
 }
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+struct net_pkt_quota *net_context_pkt_quota(struct net_context *context,
+					    bool rx)
+{
+	return &context_quotas[context - contexts][rx];
+}
+#endif
+
 void net_context_init(void)
 {
 	k_sem_init(&contexts_lock, 1, UINT_MAX);
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	for (int i = 0; i < NET_MAX_CONTEXT; i++) {
+		net_pkt_quota_init(&context_quotas[i][0], false, 0, 0);
+		net_pkt_quota_init(&context_quotas[i][1], true, 0, 0);
+	}
+#endif
 }
@@ -33,6 +33,10 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 #include <net/lldp.h>
 #endif
 
+#if defined(CONFIG_NET_PKT_QUOTA) && defined(CONFIG_NET_L2_ETHERNET)
+#include <net/ethernet.h>
+#endif
+
 #include "net_private.h"
 #include "net_shell.h"
 
@@ -367,10 +371,156 @@ static void process_rx_packet(struct k_work *work)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+#if defined(CONFIG_NET_PKT_QUOTA)
+static bool rx_is_control_l4(struct net_pkt *pkt, u8_t proto,
+			     u16_t len)
+{
+	union {
+		struct net_icmp_hdr icmp;
+		struct net_udp_hdr udp;
+		struct net_tcp_hdr tcp;
+	} hdr;
+	u16_t port;
+
+	switch (proto) {
+	case IPPROTO_ICMPV6:
+		if (net_pkt_read(pkt, &hdr.icmp, sizeof(hdr.icmp))) {
+			return false;
+		}
+
+		return hdr.icmp.type >= NET_ICMPV6_RS &&
+			hdr.icmp.type <= NET_ICMPV6_NA;
+	case IPPROTO_UDP:
+		if (net_pkt_read(pkt, &hdr.udp, sizeof(hdr.udp))) {
+			return false;
+		}
+
+		port = ntohs(hdr.udp.dst_port);
+
+		return port == DHCPV4_SERVER_PORT ||
+			port == DHCPV4_CLIENT_PORT ||
+			port == 546U || port == 547U;
+	case IPPROTO_TCP:
+		if (net_pkt_read(pkt, &hdr.tcp, sizeof(hdr.tcp))) {
+			return false;
+		}
+
+		/* Connection setup and teardown, and segments that
+		 * only acknowledge.
+		 */
+		return (hdr.tcp.flags & (NET_TCP_SYN | NET_TCP_FIN |
+					 NET_TCP_RST)) ||
+			len <= (hdr.tcp.offset >> 4) * 4U;
+	}
+
+	return false;
+}
+
+/* Tell ARP, neighbor discovery, DHCP and TCP control packets apart
+ * before the traffic class is charged, so that a flood of data cannot
+ * take the packets reserved for them. Only the L2s that hand over
+ * plain Ethernet or IP frames are looked into, and IPv6 extension
+ * headers are not followed.
+ */
+static bool rx_is_control(struct net_if *iface, struct net_pkt *pkt)
 {
-	u8_t prio = net_pkt_priority(pkt);
-	u8_t tc = net_rx_priority2tc(prio);
+	struct net_pkt_cursor backup;
+	union {
+		struct net_ipv4_hdr ipv4;
+		struct net_ipv6_hdr ipv6;
+	} hdr;
+	bool control = false;
+	bool ip = false;
+	u16_t hdr_len;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY)) {
+		ip = true;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		u16_t type;
+
+		if (net_pkt_skip(pkt, 2 * sizeof(struct net_eth_addr)) ||
+		    net_pkt_read_be16(pkt, &type)) {
+			goto out;
+		}
+
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_skip(pkt, sizeof(u16_t)) ||
+		     net_pkt_read_be16(pkt, &type))) {
+			goto out;
+		}
+
+		if (type == NET_ETH_PTYPE_ARP) {
+			control = true;
+			goto out;
+		}
+
+		ip = type == NET_ETH_PTYPE_IP || type == NET_ETH_PTYPE_IPV6;
+	}
+#endif
+
+	/* The IPv4 header is the shorter one, read the rest of the IPv6
+	 * header once the version is known.
+	 */
+	if (!ip || net_pkt_read(pkt, &hdr, sizeof(hdr.ipv4))) {
+		goto out;
+	}
+
+	if ((hdr.ipv4.vhl & 0xf0) == 0x40) {
+		hdr_len = (hdr.ipv4.vhl & 0x0f) * 4U;
+		if (hdr_len < sizeof(hdr.ipv4) ||
+		    ntohs(hdr.ipv4.len) < hdr_len ||
+		    net_pkt_skip(pkt, hdr_len - sizeof(hdr.ipv4))) {
+			goto out;
+		}
+
+		control = rx_is_control_l4(pkt, hdr.ipv4.proto,
+					   ntohs(hdr.ipv4.len) - hdr_len);
+	} else if ((hdr.ipv4.vhl & 0xf0) == 0x60) {
+		if (net_pkt_read(pkt, (u8_t *)&hdr + sizeof(hdr.ipv4),
+				 sizeof(hdr.ipv6) - sizeof(hdr.ipv4))) {
+			goto out;
+		}
+
+		control = rx_is_control_l4(pkt, hdr.ipv6.nexthdr,
+					   ntohs(hdr.ipv6.len));
+	}
+
+out:
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return control;
+}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
+static int net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	u8_t prio;
+	u8_t tc;
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (rx_is_control(iface, pkt)) {
+		net_pkt_set_priority(pkt, NET_PRIORITY_NC);
+	}
+#endif
+
+	prio = net_pkt_priority(pkt);
+	tc = net_rx_priority2tc(prio);
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (!net_pkt_quota_charge(pkt, NET_PKT_QUOTA_TC,
+				  net_tc_pkt_quota(tc, true))) {
+		NET_DBG("RX traffic class quota exceeded, pkt %p", pkt);
+		return -ENOBUFS;
+	}
+#endif
 
 	k_work_init(net_pkt_work(pkt), process_rx_packet);
 
@@ -385,6 +535,8 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 #endif
 
 	net_tc_submit_to_rx_queue(tc, pkt);
+
+	return 0;
 }
 
 /* Called by driver when an IP packet has been received */
@@ -414,9 +566,7 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
-	net_queue_rx(iface, pkt);
-
-	return 0;
+	return net_queue_rx(iface, pkt);
 }
 
 static inline void l3_init(void)
@@ -294,10 +294,26 @@ void net_if_stats_reset_all(void)
 #endif
 }
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+struct net_pkt_quota *net_if_pkt_quota(struct net_if *iface, bool rx)
+{
+	return &iface->pkt_quota[rx];
+}
+#endif
+
 static inline void init_iface(struct net_if *iface)
 {
 	const struct net_if_api *api = net_if_get_device(iface)->driver_api;
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	net_pkt_quota_init(&iface->pkt_quota[0], false,
+			   CONFIG_NET_PKT_QUOTA_IF_RESERVED,
+			   CONFIG_NET_PKT_QUOTA_IF_MAX);
+	net_pkt_quota_init(&iface->pkt_quota[1], true,
+			   CONFIG_NET_PKT_QUOTA_IF_RESERVED,
+			   CONFIG_NET_PKT_QUOTA_IF_MAX);
+#endif
+
 	if (!api || !api->init) {
 		NET_ERR("Iface %p driver API init NULL", iface);
 		return;
@@ -308,6 +324,13 @@ static inline void init_iface(struct net_if *iface)
 	api->init(iface);
 }
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+static inline u8_t tx_tc(struct net_pkt *pkt)
+{
+	return net_tx_priority2tc(net_pkt_priority(pkt));
+}
+#endif
+
 enum net_verdict net_if_send_data(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct net_context *context = net_pkt_context(pkt);
@@ -323,6 +346,16 @@ enum net_verdict net_if_send_data(struct net_if *iface, struct net_pkt *pkt)
 		goto done;
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (!net_pkt_quota_charge(pkt, NET_PKT_QUOTA_TC,
+				  net_tc_pkt_quota(tx_tc(pkt), false))) {
+		NET_DBG("TX traffic class quota exceeded, pkt %p", pkt);
+		verdict = NET_DROP;
+		status = -ENOBUFS;
+		goto done;
+	}
+#endif
+
 	/* If the ll address is not set at all, then we must set
 	 * it here.
 	 * Workaround Linux bug, see:
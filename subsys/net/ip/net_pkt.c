@@ -39,6 +39,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 #include <net/udp.h>
 
 #include "net_private.h"
+#include "net_stats.h"
 #include "tcp_internal.h"
 
 /* Find max header size of IP protocol (IPv4 or IPv6) */
@@ -129,6 +130,156 @@ NET_BUF_POOL_VAR_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
 /* Allocation tracking is only available if separately enabled */
+#if defined(CONFIG_NET_PKT_QUOTA)
+/* Reservations are kept per packet slab. "unused" is the number of
+ * reserved packets no owner has taken yet: packets that are not
+ * served from a reservation are only kept while the slab has at least
+ * that many free packets left, and the buffer pool the same share of
+ * its buffers.
+ */
+struct pkt_quota_pool {
+	struct k_mem_slab *slab;
+	struct net_buf_pool *bufs;
+	atomic_t unused;
+	atomic_t total;
+};
+
+static struct pkt_quota_pool quota_pools[] = {
+	{ .slab = &tx_pkts, .bufs = &tx_bufs },
+	{ .slab = &rx_pkts, .bufs = &rx_bufs },
+};
+
+static bool quota_pool_reserved(struct pkt_quota_pool *pool)
+{
+	atomic_val_t unused = atomic_get(&pool->unused);
+
+	if ((atomic_val_t)k_mem_slab_num_free_get(pool->slab) < unused) {
+		return true;
+	}
+
+	return pool->bufs->avail_count <
+		unused * pool->bufs->buf_count / pool->slab->num_blocks;
+}
+
+int net_pkt_quota_set(struct net_pkt_quota *quota, u16_t reserved,
+		      u16_t max)
+{
+	struct pkt_quota_pool *pool = &quota_pools[quota->rx];
+	atomic_val_t delta = (atomic_val_t)reserved - quota->reserved;
+
+	if (max && reserved > max) {
+		return -EINVAL;
+	}
+
+	if (atomic_add(&pool->total, delta) + delta >
+	    (atomic_val_t)pool->slab->num_blocks) {
+		atomic_sub(&pool->total, delta);
+		return -ENOMEM;
+	}
+
+	quota->reserved = reserved;
+	quota->max = max;
+
+	atomic_add(&pool->unused, delta);
+
+	return 0;
+}
+
+void net_pkt_quota_init(struct net_pkt_quota *quota, bool rx,
+			u16_t reserved, u16_t max)
+{
+	quota->rx = rx;
+
+	if (net_pkt_quota_set(quota, reserved, max) < 0) {
+		NET_ERR("Cannot reserve %u %s packets", reserved,
+			rx ? "RX" : "TX");
+		quota->max = max;
+	}
+}
+
+static void quota_release(struct net_pkt *pkt,
+			  enum net_pkt_quota_owner owner)
+{
+	struct net_pkt_quota *quota = pkt->quota[owner];
+
+	if (!quota) {
+		return;
+	}
+
+	if (pkt->quota_reserved & BIT(owner)) {
+		atomic_dec(&quota->reserved_used);
+		atomic_inc(&quota_pools[quota->rx].unused);
+		pkt->quota_reserved &= ~BIT(owner);
+	}
+
+	atomic_dec(&quota->used);
+	pkt->quota[owner] = NULL;
+}
+
+/* Charge pkt to the quota of an owner, replacing the quota it was
+ * charged to before. A NULL quota, e.g. of a traffic class that does
+ * not exist, accounts nothing and always lets the packet through.
+ */
+bool net_pkt_quota_charge(struct net_pkt *pkt,
+			  enum net_pkt_quota_owner owner,
+			  struct net_pkt_quota *quota)
+{
+	struct pkt_quota_pool *pool;
+	atomic_val_t used, taken;
+
+	if (!quota) {
+		return true;
+	}
+
+	pool = &quota_pools[quota->rx];
+
+	/* Packets from other slabs, e.g. the per context ones, are not
+	 * accounted.
+	 */
+	if (pkt->slab != pool->slab || pkt->quota[owner] == quota) {
+		return true;
+	}
+
+	quota_release(pkt, owner);
+
+	used = atomic_inc(&quota->used);
+	if (quota->max && used >= quota->max) {
+		atomic_dec(&quota->used);
+		net_stats_update_pkt_quota_cap_drop(net_pkt_iface(pkt));
+		return false;
+	}
+
+	do {
+		taken = atomic_get(&quota->reserved_used);
+		if (taken >= quota->reserved) {
+			break;
+		}
+	} while (!atomic_cas(&quota->reserved_used, taken, taken + 1));
+
+	if (taken < quota->reserved) {
+		atomic_dec(&pool->unused);
+		pkt->quota_reserved |= BIT(owner);
+		net_stats_update_pkt_quota_reserved(net_pkt_iface(pkt));
+	} else if (owner == NET_PKT_QUOTA_TC && !pkt->quota_reserved &&
+		   quota_pool_reserved(pool)) {
+		/* This packet would be holding a slot that was
+		 * reserved for somebody else. Only the traffic class
+		 * charge checks this: the interface and context ones
+		 * are made before the packet is classified, when it
+		 * cannot be told yet whether a class reservation will
+		 * serve it.
+		 */
+		atomic_dec(&quota->used);
+		net_stats_update_pkt_quota_reserve_drop(net_pkt_iface(pkt));
+		return false;
+	}
+
+	pkt->quota[owner] = quota;
+
+	return true;
+}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 struct net_pkt_alloc {
 	union {
@@ -591,6 +742,12 @@ done:
 		net_pkt_cursor_init(pkt);
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	for (int i = 0; i < NET_PKT_QUOTA_OWNERS; i++) {
+		quota_release(pkt, i);
+	}
+#endif
+
 	k_mem_slab_free(pkt->slab, (void **)&pkt);
 }
 
@@ -1289,6 +1446,16 @@ static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 		net_pkt_set_iface(pkt, iface);
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (pkt && iface &&
+	    !net_pkt_quota_charge(pkt, NET_PKT_QUOTA_IFACE,
+				  net_if_pkt_quota(iface,
+						   slab == &rx_pkts))) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+#endif
+
 	return pkt;
 }
 
@@ -78,6 +78,14 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt);
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+void net_pkt_quota_init(struct net_pkt_quota *quota, bool rx,
+			u16_t reserved, u16_t max);
+bool net_pkt_quota_charge(struct net_pkt *pkt,
+			  enum net_pkt_quota_owner owner,
+			  struct net_pkt_quota *quota);
+#endif
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
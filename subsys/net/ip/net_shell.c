@@ -66,6 +66,10 @@ LOG_MODULE_REGISTER(net_shell, LOG_LEVEL_DBG);
 #include "net_shell.h"
 #include "net_stats.h"
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+#include "dns_cache.h"
+#endif
+
 #include <sys/fdtable.h>
 #include "websocket/websocket_internal.h"
 
@@ -951,6 +955,13 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	PR("Bytes sent     %u\n", GET_STAT(iface, bytes.sent));
 	PR("Processing err %d\n", GET_STAT(iface, processing_error));
 
+#if defined(CONFIG_NET_STATISTICS_PKT_QUOTA)
+	PR("Pkt quota rsvd %d\tcapdrop\t%d\trsvdrop\t%d\n",
+	   GET_STAT(iface, pkt_quota.reserved),
+	   GET_STAT(iface, pkt_quota.cap_drop),
+	   GET_STAT(iface, pkt_quota.reserve_drop));
+#endif
+
 	print_tc_tx_stats(shell, iface);
 	print_tc_rx_stats(shell, iface);
 
@@ -1617,6 +1628,74 @@ static int cmd_net_dns_cancel(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_cb(const char *name, enum dns_query_type type,
+			 int count, u32_t ttl, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *entries = data->user_data;
+
+	if (*entries == 0) {
+		PR("     TTL  Type  Addresses  Name\n");
+	}
+
+	(*entries)++;
+
+	if (count) {
+		PR("%8u  %-4s  %9d  %s\n", ttl,
+		   type == DNS_QUERY_TYPE_A ? "A" : "AAAA", count, name);
+	} else {
+		PR("%8u  %-4s  %9s  %s\n", ttl,
+		   type == DNS_QUERY_TYPE_A ? "A" : "AAAA", "NXDOMAIN", name);
+	}
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct net_shell_user_data user_data;
+	int entries = 0;
+
+	user_data.shell = shell;
+	user_data.user_data = &entries;
+
+	dns_cache_foreach(dns_cache_cb, &user_data);
+
+	if (!entries) {
+		PR("DNS cache is empty.\n");
+	}
+
+#if defined(CONFIG_NET_STATISTICS_DNS)
+	PR("Cache hit %d miss %d evict %d\n",
+	   net_stats.dns.cache_hit, net_stats.dns.cache_miss,
+	   net_stats.dns.cache_evict);
+#endif
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_DNS_RESOLVER_CACHE", "DNS cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_flush(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_resolve_cache_flush();
+
+	PR("DNS cache flushed.\n");
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_DNS_RESOLVER_CACHE", "DNS cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns_query(const struct shell *shell, size_t argc,
 			     char *argv[])
 {
@@ -3405,6 +3484,12 @@ static int cmd_net_stats_all(const struct shell *shell, size_t argc,
 
 	/* Print global network statistics */
 	net_shell_print_statistics_all(&user_data);
+
+#if defined(CONFIG_NET_STATISTICS_DNS)
+	PR("\nDNS cache hit  %d\tmiss\t%d\tevict\t%d\n",
+	   net_stats.dns.cache_hit, net_stats.dns.cache_miss,
+	   net_stats.dns.cache_evict);
+#endif
 #else
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
@@ -4071,8 +4156,12 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_arp,
 );
 
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
+	SHELL_CMD(cache, NULL, "Show cached DNS results.",
+		  cmd_net_dns_cache),
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
+	SHELL_CMD(flush, NULL, "Remove all entries from DNS cache.",
+		  cmd_net_dns_flush),
 	SHELL_CMD(query, NULL,
 		  "'net dns <hostname> [A or AAAA]' queries IPv4 address "
 		  "(default) or IPv6 address for a host name.",
@@ -284,6 +284,18 @@ static int net_stats_get(u32_t mgmt_request, struct net_if *iface,
 		len_chk = sizeof(struct net_stats_tcp);
 		src = GET_STAT_ADDR(iface, tcp);
 		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_DNS)
+	case NET_REQUEST_STATS_CMD_GET_DNS:
+		len_chk = sizeof(struct net_stats_dns);
+		src = &net_stats.dns;
+		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_PKT_QUOTA)
+	case NET_REQUEST_STATS_CMD_GET_PKT_QUOTA:
+		len_chk = sizeof(struct net_stats_pkt_quota);
+		src = GET_STAT_ADDR(iface, pkt_quota);
+		break;
 #endif
 	}
 
@@ -338,6 +350,16 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TCP,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_DNS)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_DNS,
+				  net_stats_get);
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_QUOTA)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PKT_QUOTA,
+				  net_stats_get);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 void net_stats_reset(struct net_if *iface)
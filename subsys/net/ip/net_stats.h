@@ -186,6 +186,60 @@ static inline void net_stats_update_udp_chkerr(struct net_if *iface)
 #define net_stats_update_udp_chkerr(iface)
 #endif /* CONFIG_NET_STATISTICS_UDP */
 
+#if defined(CONFIG_NET_STATISTICS_DNS) && defined(CONFIG_NET_NATIVE)
+/* DNS stats, these are not related to any network interface */
+static inline void net_stats_update_dns_cache_hit(void)
+{
+	UPDATE_STAT_GLOBAL(stats.dns.cache_hit++);
+}
+
+static inline void net_stats_update_dns_cache_miss(void)
+{
+	UPDATE_STAT_GLOBAL(stats.dns.cache_miss++);
+}
+
+static inline void net_stats_update_dns_cache_evict(void)
+{
+	UPDATE_STAT_GLOBAL(stats.dns.cache_evict++);
+}
+#else
+#define net_stats_update_dns_cache_hit()
+#define net_stats_update_dns_cache_miss()
+#define net_stats_update_dns_cache_evict()
+#endif /* CONFIG_NET_STATISTICS_DNS */
+
+#if defined(CONFIG_NET_STATISTICS_PKT_QUOTA) && defined(CONFIG_NET_NATIVE)
+/* Packet quota stats, the packet might not have an interface yet */
+#define UPDATE_PKT_QUOTA_STAT(_iface, _cmd)		\
+	do {						\
+		if (_iface) {				\
+			UPDATE_STAT(_iface, _cmd);	\
+		} else {				\
+			UPDATE_STAT_GLOBAL(_cmd);	\
+		}					\
+	} while (0)
+
+static inline void net_stats_update_pkt_quota_reserved(struct net_if *iface)
+{
+	UPDATE_PKT_QUOTA_STAT(iface, stats.pkt_quota.reserved++);
+}
+
+static inline void net_stats_update_pkt_quota_cap_drop(struct net_if *iface)
+{
+	UPDATE_PKT_QUOTA_STAT(iface, stats.pkt_quota.cap_drop++);
+}
+
+static inline
+void net_stats_update_pkt_quota_reserve_drop(struct net_if *iface)
+{
+	UPDATE_PKT_QUOTA_STAT(iface, stats.pkt_quota.reserve_drop++);
+}
+#else
+#define net_stats_update_pkt_quota_reserved(iface)
+#define net_stats_update_pkt_quota_cap_drop(iface)
+#define net_stats_update_pkt_quota_reserve_drop(iface)
+#endif /* CONFIG_NET_STATISTICS_PKT_QUOTA */
+
 #if defined(CONFIG_NET_STATISTICS_TCP) && defined(CONFIG_NET_NATIVE_TCP)
 /* TCP stats */
 static inline void net_stats_update_tcp_sent(struct net_if *iface, u32_t bytes)
@@ -43,6 +43,30 @@ void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt)
 	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
 }
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+struct net_pkt_quota *net_tc_pkt_quota(u8_t tc, bool rx)
+{
+	if (rx) {
+		return tc < NET_TC_RX_COUNT ? &rx_classes[tc].pkt_quota : NULL;
+	}
+
+	return tc < NET_TC_TX_COUNT ? &tx_classes[tc].pkt_quota : NULL;
+}
+
+/* Network control traffic gets the reserved packets */
+static void tc_pkt_quota_init(struct net_traffic_class *classes, int count,
+			      u8_t nc_tc, bool rx)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		net_pkt_quota_init(&classes[i].pkt_quota, rx,
+				   i == nc_tc ?
+				   CONFIG_NET_PKT_QUOTA_NC_RESERVED : 0, 0);
+	}
+}
+#endif
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 	if (prio > NET_PRIORITY_NC) {
@@ -232,6 +256,11 @@ void net_tc_tx_init(void)
 	net_if_foreach(net_tc_tx_stats_priority_setup, NULL);
 #endif
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	tc_pkt_quota_init(tx_classes, NET_TC_TX_COUNT,
+			  net_tx_priority2tc(NET_PRIORITY_NC), false);
+#endif
+
 	for (i = 0; i < NET_TC_TX_COUNT; i++) {
 		u8_t thread_priority;
 
@@ -271,6 +300,11 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	tc_pkt_quota_init(rx_classes, NET_TC_RX_COUNT,
+			  net_rx_priority2tc(NET_PRIORITY_NC), true);
+#endif
+
 	for (i = 0; i < NET_TC_RX_COUNT; i++) {
 		u8_t thread_priority;
 
@@ -250,6 +250,222 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 			route->iface);					\
 	} } while (0)
 
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+/* The routes are also kept in a path compressed binary trie so that the
+ * longest prefix match only needs to look at the prefixes on the path of the
+ * destination address. Each trie node has a prefix, the routes (one per
+ * interface) having exactly that prefix, and up to two children whose
+ * prefixes continue the node prefix with a 0 or a 1 bit. A node without
+ * routes only exists where two branches meet, so there are less than two
+ * nodes per route.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+	sys_slist_t routes;
+	struct in6_addr prefix;
+	u8_t len;
+};
+
+static struct route_trie_node route_trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *route_trie_free;
+static struct route_trie_node *route_trie_root;
+
+static inline u8_t route_trie_bit(const struct in6_addr *addr, u8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7 - pos % 8U)) & 1;
+}
+
+/* Number of leading bits, at most max, which are the same in a and b */
+static u8_t route_trie_common_len(const struct in6_addr *a,
+				  const struct in6_addr *b, u8_t max)
+{
+	u8_t len = 0U;
+	u8_t diff;
+
+	while (len < max) {
+		diff = a->s6_addr[len / 8U] ^ b->s6_addr[len / 8U];
+		if (diff) {
+			len += __builtin_clz((u32_t)diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_trie_node *route_trie_node_alloc(struct in6_addr *prefix,
+						     u8_t len)
+{
+	struct route_trie_node *node = route_trie_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	route_trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	net_ipaddr_copy(&node->prefix, prefix);
+	node->len = len;
+
+	return node;
+}
+
+static void route_trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = route_trie_free;
+	route_trie_free = node;
+}
+
+static void route_trie_init(void)
+{
+	int i;
+
+	route_trie_root = NULL;
+	route_trie_free = NULL;
+
+	for (i = 0; i < ARRAY_SIZE(route_trie_nodes); i++) {
+		route_trie_node_free(&route_trie_nodes[i]);
+	}
+}
+
+static int route_trie_add(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node *node, *leaf, *glue;
+	u8_t common;
+
+	while (*link) {
+		node = *link;
+		common = route_trie_common_len(&route->addr, &node->prefix,
+					       MIN(route->prefix_len,
+						   node->len));
+
+		if (common == node->len) {
+			if (node->len == route->prefix_len) {
+				sys_slist_append(&node->routes,
+						 &route->prefix_node);
+				return 0;
+			}
+
+			link = &node->child[route_trie_bit(&route->addr,
+							   node->len)];
+			continue;
+		}
+
+		leaf = route_trie_node_alloc(&route->addr, route->prefix_len);
+		if (!leaf) {
+			return -ENOMEM;
+		}
+
+		sys_slist_append(&leaf->routes, &route->prefix_node);
+
+		if (common == route->prefix_len) {
+			/* The route prefix is a prefix of the node prefix */
+			leaf->child[route_trie_bit(&node->prefix, common)] =
+				node;
+			*link = leaf;
+			return 0;
+		}
+
+		/* The prefixes differ at bit common, join them there */
+		glue = route_trie_node_alloc(&route->addr, common);
+		if (!glue) {
+			route_trie_node_free(leaf);
+			return -ENOMEM;
+		}
+
+		glue->child[route_trie_bit(&route->addr, common)] = leaf;
+		glue->child[route_trie_bit(&node->prefix, common)] = node;
+		*link = glue;
+
+		return 0;
+	}
+
+	leaf = route_trie_node_alloc(&route->addr, route->prefix_len);
+	if (!leaf) {
+		return -ENOMEM;
+	}
+
+	sys_slist_append(&leaf->routes, &route->prefix_node);
+	*link = leaf;
+
+	return 0;
+}
+
+static void route_trie_del(struct net_route_entry *route)
+{
+	struct route_trie_node **parent_link = NULL;
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node *node, *child;
+
+	while (*link && (*link)->len < route->prefix_len) {
+		parent_link = link;
+		link = &(*link)->child[route_trie_bit(&route->addr,
+						      (*link)->len)];
+	}
+
+	node = *link;
+	if (!node || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->prefix_node)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	child = node->child[0] ? node->child[0] : node->child[1];
+	*link = child;
+	route_trie_node_free(node);
+
+	if (child || !parent_link) {
+		return;
+	}
+
+	/* The parent lost a child, it is not needed anymore if it was only
+	 * joining two branches.
+	 */
+	node = *parent_link;
+	if (sys_slist_is_empty(&node->routes)) {
+		*parent_link = node->child[0] ? node->child[0] :
+			node->child[1];
+		route_trie_node_free(node);
+	}
+}
+
+static struct net_route_entry *route_trie_lookup(struct net_if *iface,
+						 struct in6_addr *dst)
+{
+	struct route_trie_node *node = route_trie_root;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node && net_ipv6_is_prefix((u8_t *)dst,
+					  (u8_t *)&node->prefix, node->len)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route,
+					     prefix_node) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[route_trie_bit(dst, node->len)];
+	}
+
+	return found;
+}
+#endif /* CONFIG_NET_ROUTE_LPM_TRIE */
+
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
@@ -260,7 +476,11 @@ static inline void update_route_access(struct net_route_entry *route)
 struct net_route_entry *net_route_lookup(struct net_if *iface,
 					 struct in6_addr *dst)
 {
-	struct net_route_entry *route, *found = NULL;
+	struct net_route_entry *found = NULL;
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+	found = route_trie_lookup(iface, dst);
+#else
+	struct net_route_entry *route;
 	u8_t longest_match = 0U;
 	int i;
 
@@ -285,6 +505,7 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 			longest_match = route->prefix_len;
 		}
 	}
+#endif
 
 	if (found) {
 		net_route_info("Found", found, dst);
@@ -412,6 +633,14 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	sys_slist_init(&route->nexthop);
 	sys_slist_prepend(&route->nexthop, &nexthop_route->node);
 
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+	if (route_trie_add(route) < 0) {
+		NET_ERR("No trie node available for route!");
+		net_route_del(route);
+		return NULL;
+	}
+#endif
+
 	net_route_info("Added", route, addr);
 
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
@@ -461,14 +690,20 @@ int net_route_del(struct net_route_entry *route)
 		return -ENOENT;
 	}
 
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+	route_trie_del(route);
+#endif
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
-		if (!nexthop_route->nbr) {
-			continue;
+		if (nexthop_route->nbr) {
+			nbr_nexthop_put(nexthop_route->nbr);
 		}
 
-		nbr_nexthop_put(nexthop_route->nbr);
+		/* Return the entry taken by get_nexthop_route() */
+		net_nbr_unref(CONTAINER_OF(nexthop_route, struct net_nbr,
+					   __nbr));
 	}
 
 	nbr_free(nbr);
@@ -845,6 +1080,10 @@ int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface)
 
 void net_route_init(void)
 {
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+	route_trie_init();
+#endif
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
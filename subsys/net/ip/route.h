@@ -59,6 +59,13 @@ struct net_route_entry {
 
 	/** IPv6 address/prefix length. */
 	u8_t prefix_len;
+
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+	/** Node in the list of routes of the trie node holding the prefix
+	 * of this route.
+	 */
+	sys_snode_t prefix_node;
+#endif
 };
 
 /**
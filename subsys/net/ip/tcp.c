@@ -407,6 +407,8 @@ static int prepare_segment(struct net_tcp *tcp,
 			return -ENOMEM;
 		}
 
+		/* A segment without data only controls the connection */
+		net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 		net_pkt_set_context(pkt, context);
 		pkt_allocated = true;
 	}
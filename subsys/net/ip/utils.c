@@ -489,33 +489,101 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
-static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+#if !defined(CONFIG_NET_CHKSUM_ARCH)
+/* Ones' complement sum of the 16 bit words of data, which must start at an
+ * even address. The words are added in native byte order, which gives the
+ * byte swapped sum on little endian CPUs (see RFC 1071, 2.(B)).
+ */
+static u64_t chksum_native(const u8_t *data, size_t len)
 {
-	const u8_t *end;
-	u16_t tmp;
+	u64_t acc = 0U;
+
+	if (((uintptr_t)data & 2) && len >= 2) {
+		acc += *(const u16_t *)data;
+		data += 2;
+		len -= 2;
+	}
 
-	end = data + len - 1;
+	/* A 64 bit accumulator can't overflow when adding 32 bit words
+	 * as no packet comes close to 2^32 words.
+	 */
+	for (; len >= 16; len -= 16) {
+		acc += *(const u32_t *)data;
+		acc += *(const u32_t *)(data + 4);
+		acc += *(const u32_t *)(data + 8);
+		acc += *(const u32_t *)(data + 12);
+		data += 16;
+	}
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	for (; len >= 4; len -= 4) {
+		acc += *(const u32_t *)data;
+		data += 4;
+	}
 
+	if (len >= 2) {
+		acc += *(const u16_t *)data;
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
+	if (len) {
+		/* Trailing byte is the high order byte of a big endian word */
+		acc += sys_cpu_to_be16((u16_t)(data[0] << 8));
+	}
+
+	return acc;
+}
+
+static inline u16_t chksum_fold(u64_t acc)
+{
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	return (u16_t)acc;
+}
+
+static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	u16_t tmp, first;
+
+	if (!len) {
+		return sum;
+	}
+
+	if ((uintptr_t)data & 1) {
+		/* Sum the rest from the next, aligned, byte on. The words
+		 * summed that way are byte swapped versions of the real
+		 * ones, and so is their sum.
+		 */
+		tmp = chksum_fold(chksum_native(data + 1, len - 1));
+		tmp = sys_be16_to_cpu(tmp);
+		tmp = (tmp << 8) | (tmp >> 8);
+
+		/* The first byte is the high order byte of a word */
+		first = data[0] << 8;
+		tmp += first;
+		if (tmp < first) {
+			tmp++;
 		}
+	} else {
+		tmp = sys_be16_to_cpu(chksum_fold(chksum_native(data, len)));
+	}
+
+	sum += tmp;
+	if (sum < tmp) {
+		sum++;
 	}
 
 	return sum;
 }
+#else
+static inline u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	return arch_net_chksum(sum, data, len);
+}
+#endif /* !CONFIG_NET_CHKSUM_ARCH */
 
 static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 {
@@ -254,6 +254,7 @@ static inline struct net_pkt *arp_prepare(struct net_if *iface,
 		}
 	}
 
+	net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 	net_pkt_set_vlan_tag(pkt, net_eth_get_vlan_tag(iface));
 
 	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
@@ -498,6 +499,7 @@ static inline struct net_pkt *arp_prepare_reply(struct net_if *iface,
 		return NULL;
 	}
 
+	net_pkt_set_priority(pkt, NET_PRIORITY_NC);
 	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
 
 	hdr = NET_ARP_HDR(pkt);
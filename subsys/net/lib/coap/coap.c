@@ -97,6 +97,29 @@ static inline bool append(struct coap_packet *cpkt, const u8_t *data, u16_t len)
 	return true;
 }
 
+static void option_index_reset(struct coap_packet *cpkt)
+{
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_idx_num = 0U;
+	cpkt->opt_idx_overflow = false;
+#endif
+}
+
+static void option_index_add(struct coap_packet *cpkt, u16_t code,
+			     u16_t offset)
+{
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->opt_idx_num == ARRAY_SIZE(cpkt->opt_idx)) {
+		cpkt->opt_idx_overflow = true;
+		return;
+	}
+
+	cpkt->opt_idx[cpkt->opt_idx_num].code = code;
+	cpkt->opt_idx[cpkt->opt_idx_num].offset = offset;
+	cpkt->opt_idx_num++;
+#endif
+}
+
 int coap_packet_init(struct coap_packet *cpkt, u8_t *data,
 		     u16_t max_len, u8_t ver, u8_t type,
 		     u8_t tokenlen, u8_t *token, u8_t code, u16_t id)
@@ -240,6 +263,7 @@ static int encode_option(struct coap_packet *cpkt, u16_t code,
 int coap_packet_append_option(struct coap_packet *cpkt, u16_t code,
 			      const u8_t *value, u16_t len)
 {
+	u16_t offset;
 	int r;
 
 	if (!cpkt) {
@@ -260,6 +284,8 @@ int coap_packet_append_option(struct coap_packet *cpkt, u16_t code,
 		code = (code == cpkt->delta) ? 0 : code - cpkt->delta;
 	}
 
+	offset = cpkt->offset;
+
 	r = encode_option(cpkt, code, value, len);
 	if (r < 0) {
 		return -EINVAL;
@@ -268,6 +294,8 @@ int coap_packet_append_option(struct coap_packet *cpkt, u16_t code,
 	cpkt->opt_len += r;
 	cpkt->delta += code;
 
+	option_index_add(cpkt, cpkt->delta, offset);
+
 	return 0;
 }
 
@@ -531,6 +559,7 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 {
 	u16_t opt_len;
 	u16_t offset;
+	u16_t start;
 	u16_t delta;
 	u8_t num;
 	u8_t tkl;
@@ -554,6 +583,7 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 	cpkt->opt_len = 0U;
 	cpkt->hdr_len = 0U;
 	cpkt->delta = 0U;
+	option_index_reset(cpkt);
 
 	/* Token lengths 9-15 are reserved. */
 	tkl = cpkt->data[0] & 0x0f;
@@ -580,11 +610,18 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 		struct coap_option *option;
 
 		option = num < opt_num ? &options[num++] : NULL;
+		start = offset;
 		ret = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
 				   &delta, &opt_len, option);
 		if (ret < 0) {
 			return ret;
-		} else if (ret == 0) {
+		}
+
+		if (cpkt->data[start] != COAP_MARKER) {
+			option_index_add(cpkt, delta, start);
+		}
+
+		if (ret == 0) {
 			break;
 		}
 	}
@@ -596,6 +633,43 @@ int coap_packet_parse(struct coap_packet *cpkt, u8_t *data, u16_t len,
 	return 0;
 }
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+static int find_indexed_options(const struct coap_packet *cpkt, u16_t code,
+				struct coap_option *options, u16_t veclen)
+{
+	const struct coap_option_index *idx = cpkt->opt_idx;
+	u16_t opt_len = 0U;
+	u16_t offset;
+	u16_t delta;
+	u8_t num = 0U;
+	u8_t i;
+	int r;
+
+	i = 0U;
+	while (i < cpkt->opt_idx_num && idx[i].code < code) {
+		i++;
+	}
+
+	/* Options are in ascending order, the matches are contiguous */
+	for (; i < cpkt->opt_idx_num && idx[i].code == code && num < veclen;
+	     i++) {
+		/* Option deltas are relative to the previous option */
+		delta = (i > 0) ? idx[i - 1].code : 0U;
+
+		r = parse_option(cpkt->data, idx[i].offset, &offset,
+				 cpkt->max_len, &delta, &opt_len,
+				 &options[num]);
+		if (r < 0) {
+			return -EINVAL;
+		}
+
+		num++;
+	}
+
+	return num;
+}
+#endif
+
 int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 		      struct coap_option *options, u16_t veclen)
 {
@@ -605,6 +679,12 @@ int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 	u8_t num;
 	int r;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (!cpkt->opt_idx_overflow) {
+		return find_indexed_options(cpkt, code, options, veclen);
+	}
+#endif
+
 	offset = cpkt->hdr_len;
 	opt_len = 0U;
 	delta = 0U;
@@ -744,6 +824,65 @@ const u8_t *coap_packet_get_payload(const struct coap_packet *cpkt, u16_t *len)
 		cpkt->data + cpkt->hdr_len + cpkt->opt_len;
 }
 
+/* 32 bit FNV-1a hash of path segments, each followed by a NUL separator.
+ * 0 is reserved for resources whose hash is not computed yet.
+ */
+#define PATH_HASH_INIT 2166136261U
+#define PATH_HASH_PRIME 16777619U
+
+static u32_t path_hash_update(u32_t hash, const u8_t *segment, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ segment[i]) * PATH_HASH_PRIME;
+	}
+
+	return hash * PATH_HASH_PRIME;
+}
+
+static u32_t path_hash_final(u32_t hash)
+{
+	return hash ? hash : 1U;
+}
+
+static u32_t resource_path_hash(struct coap_resource *resource)
+{
+	const char * const *path = resource->path;
+	u32_t hash;
+
+	if (resource->path_hash) {
+		return resource->path_hash;
+	}
+
+	hash = PATH_HASH_INIT;
+	for (; *path; path++) {
+		hash = path_hash_update(hash, (const u8_t *)*path,
+					strlen(*path));
+	}
+
+	resource->path_hash = path_hash_final(hash);
+
+	return resource->path_hash;
+}
+
+static u32_t request_path_hash(struct coap_option *options, u8_t opt_num)
+{
+	u32_t hash = PATH_HASH_INIT;
+	u8_t i;
+
+	for (i = 0U; i < opt_num; i++) {
+		if (options[i].delta != COAP_OPTION_URI_PATH) {
+			continue;
+		}
+
+		hash = path_hash_update(hash, options[i].value,
+					options[i].len);
+	}
+
+	return path_hash_final(hash);
+}
+
 static bool uri_path_eq(const struct coap_packet *cpkt,
 			const char * const *path,
 			struct coap_option *options,
@@ -812,17 +951,24 @@ int coap_handle_request(struct coap_packet *cpkt,
 			struct sockaddr *addr, socklen_t addr_len)
 {
 	struct coap_resource *resource;
+	u32_t hash;
 
 	if (!is_request(cpkt)) {
 		return 0;
 	}
 
+	/* Extract the requested path once, then only compare the paths
+	 * of the resources with the same hash.
+	 */
+	hash = request_path_hash(options, opt_num);
+
 	/* FIXME: deal with hierarchical resources */
 	for (resource = resources; resource && resource->path; resource++) {
 		coap_method_t method;
 		u8_t code;
 
-		if (!uri_path_eq(cpkt, resource->path, options, opt_num)) {
+		if (resource_path_hash(resource) != hash ||
+		    !uri_path_eq(cpkt, resource->path, options, opt_num)) {
 			continue;
 		}
 
@@ -0,0 +1,253 @@
+/** @file
+ * @brief DNS resolver cache
+ *
+ * Positive and negative query results, kept until their TTL expires or
+ * they are evicted as the least recently used entry.
+ */
+
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/dlist.h>
+
+#include <net/net_mgmt.h>
+#include <net/net_event.h>
+#include <net/dns_resolve.h>
+
+#include "dns_cache.h"
+#include "net_stats.h"
+
+struct dns_cache_entry {
+	sys_dnode_t node;
+
+	/** Uptime in ms when the entry expires */
+	s64_t expires;
+
+	/** Number of addresses, 0 for a negative entry */
+	u8_t count;
+
+	/** Query type, DNS_QUERY_TYPE_A or DNS_QUERY_TYPE_AAAA */
+	u8_t type;
+
+	char name[CONFIG_DNS_RESOLVER_CACHE_NAME_LEN + 1];
+
+	u8_t addrs[DNS_CACHE_ADDRS][DNS_CACHE_ADDR_LEN];
+};
+
+#define DNS_CACHE_ENTRIES MAX(1, CONFIG_DNS_RESOLVER_CACHE_SIZE /	\
+			      sizeof(struct dns_cache_entry))
+
+static struct dns_cache_entry entries[DNS_CACHE_ENTRIES];
+
+/* Entries in use, the most recently used one first */
+static sys_dlist_t lru_list;
+static sys_dlist_t free_list;
+
+static K_MUTEX_DEFINE(lock);
+
+static void entry_free(struct dns_cache_entry *entry)
+{
+	sys_dlist_remove(&entry->node);
+	sys_dlist_append(&free_list, &entry->node);
+}
+
+/* Returns the entry for name and type, freeing it if it has expired */
+static struct dns_cache_entry *entry_find(const char *name,
+					  enum dns_query_type type)
+{
+	struct dns_cache_entry *entry;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru_list, entry, node) {
+		if (entry->type != type ||
+		    strncasecmp(entry->name, name, sizeof(entry->name))) {
+			continue;
+		}
+
+		if (entry->expires - k_uptime_get() <= 0) {
+			entry_free(entry);
+			return NULL;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+void dns_cache_add(const char *name, enum dns_query_type type,
+		   const u8_t addrs[][DNS_CACHE_ADDR_LEN], int count,
+		   u32_t ttl)
+{
+	struct dns_cache_entry *entry;
+
+	ttl = MIN(ttl, CONFIG_DNS_RESOLVER_CACHE_MAX_TTL);
+
+	if (!ttl || strlen(name) >= sizeof(entry->name)) {
+		return;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	entry = entry_find(name, type);
+	if (!entry) {
+		entry = SYS_DLIST_PEEK_HEAD_CONTAINER(&free_list, entry,
+						      node);
+		if (!entry) {
+			entry = CONTAINER_OF(sys_dlist_peek_tail(&lru_list),
+					     struct dns_cache_entry, node);
+			net_stats_update_dns_cache_evict();
+		}
+
+		strcpy(entry->name, name);
+		entry->type = type;
+	}
+
+	entry->count = MIN(count, DNS_CACHE_ADDRS);
+	entry->expires = k_uptime_get() + ttl * MSEC_PER_SEC;
+	memcpy(entry->addrs, addrs, entry->count * DNS_CACHE_ADDR_LEN);
+
+	sys_dlist_remove(&entry->node);
+	sys_dlist_prepend(&lru_list, &entry->node);
+
+	k_mutex_unlock(&lock);
+
+	NET_DBG("Cached %s type %d, %d addresses ttl %u",
+		log_strdup(name), type, count, ttl);
+}
+
+int dns_cache_find(const char *name, enum dns_query_type type,
+		   struct dns_addrinfo info[DNS_CACHE_ADDRS])
+{
+	struct dns_cache_entry *entry;
+	int i, count;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	entry = entry_find(name, type);
+	if (!entry) {
+		k_mutex_unlock(&lock);
+		net_stats_update_dns_cache_miss();
+		return -ENOENT;
+	}
+
+	sys_dlist_remove(&entry->node);
+	sys_dlist_prepend(&lru_list, &entry->node);
+
+	count = entry->count;
+
+	for (i = 0; i < count; i++) {
+		(void)memset(&info[i], 0, sizeof(info[i]));
+
+		if (type == DNS_QUERY_TYPE_A) {
+			info[i].ai_family = AF_INET;
+			info[i].ai_addrlen = sizeof(struct sockaddr_in);
+			memcpy(&net_sin(&info[i].ai_addr)->sin_addr,
+			       entry->addrs[i], sizeof(struct in_addr));
+		} else {
+#if defined(CONFIG_NET_IPV6)
+			info[i].ai_family = AF_INET6;
+			info[i].ai_addrlen = sizeof(struct sockaddr_in6);
+			memcpy(&net_sin6(&info[i].ai_addr)->sin6_addr,
+			       entry->addrs[i], sizeof(struct in6_addr));
+#endif
+		}
+
+		info[i].ai_addr.sa_family = info[i].ai_family;
+	}
+
+	k_mutex_unlock(&lock);
+
+	net_stats_update_dns_cache_hit();
+
+	return count;
+}
+
+void dns_cache_foreach(dns_cache_cb_t cb, void *user_data)
+{
+	struct dns_cache_entry *entry;
+	s64_t remaining;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru_list, entry, node) {
+		remaining = entry->expires - k_uptime_get();
+		if (remaining <= 0) {
+			continue;
+		}
+
+		cb(entry->name, entry->type, entry->count,
+		   ceiling_fraction(remaining, MSEC_PER_SEC), user_data);
+	}
+
+	k_mutex_unlock(&lock);
+}
+
+void dns_resolve_cache_flush(void)
+{
+	struct dns_cache_entry *entry;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	while ((entry = SYS_DLIST_PEEK_HEAD_CONTAINER(&lru_list, entry,
+						      node))) {
+		entry_free(entry);
+	}
+
+	k_mutex_unlock(&lock);
+
+	NET_DBG("DNS cache flushed");
+}
+
+#if defined(CONFIG_NET_MGMT_EVENT)
+static struct net_mgmt_event_callback iface_cb;
+static struct net_mgmt_event_callback server_cb;
+
+/* Addresses learned through an interface, or from a server, that went
+ * away may no longer be valid or reachable.
+ */
+static void flush_handler(struct net_mgmt_event_callback *cb,
+			  u32_t mgmt_event, struct net_if *iface)
+{
+	switch (mgmt_event) {
+	case NET_EVENT_IF_DOWN:
+	case NET_EVENT_IF_UP:
+	case NET_EVENT_DNS_SERVER_ADD:
+	case NET_EVENT_DNS_SERVER_DEL:
+		dns_resolve_cache_flush();
+		break;
+	}
+}
+#endif /* CONFIG_NET_MGMT_EVENT */
+
+void dns_cache_init(void)
+{
+	int i;
+
+	sys_dlist_init(&lru_list);
+	sys_dlist_init(&free_list);
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		sys_dnode_init(&entries[i].node);
+		sys_dlist_append(&free_list, &entries[i].node);
+	}
+
+#if defined(CONFIG_NET_MGMT_EVENT)
+	net_mgmt_init_event_callback(&iface_cb, flush_handler,
+				     NET_EVENT_IF_DOWN | NET_EVENT_IF_UP);
+	net_mgmt_add_event_callback(&iface_cb);
+
+	net_mgmt_init_event_callback(&server_cb, flush_handler,
+				     NET_EVENT_DNS_SERVER_ADD |
+				     NET_EVENT_DNS_SERVER_DEL);
+	net_mgmt_add_event_callback(&server_cb);
+#endif
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _DNS_CACHE_H_
+#define _DNS_CACHE_H_
+
+#include <zephyr/types.h>
+#include <net/net_ip.h>
+#include <net/dns_resolve.h>
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+
+#define DNS_CACHE_ADDRS CONFIG_DNS_RESOLVER_CACHE_ADDRS
+
+/* Big enough for the address of either query type */
+#if defined(CONFIG_NET_IPV6)
+#define DNS_CACHE_ADDR_LEN sizeof(struct in6_addr)
+#else
+#define DNS_CACHE_ADDR_LEN sizeof(struct in_addr)
+#endif
+
+/**
+ * @brief Store the result of a query in the cache.
+ *
+ * @details Replaces any earlier result for the same name and query type,
+ * evicting the least recently used entry if the cache is full. A result
+ * without addresses is a negative one, caching that the name does not
+ * exist.
+ *
+ * @param name Queried name, names longer than
+ *        CONFIG_DNS_RESOLVER_CACHE_NAME_LEN are not cached.
+ * @param type Query type.
+ * @param addrs Addresses of the answer, each one DNS_CACHE_ADDR_LEN bytes
+ *        and as long as the query type requires.
+ * @param count Number of addresses, only the first DNS_CACHE_ADDRS ones are
+ *        kept.
+ * @param ttl Time to live of the result in seconds.
+ */
+void dns_cache_add(const char *name, enum dns_query_type type,
+		   const u8_t addrs[][DNS_CACHE_ADDR_LEN], int count,
+		   u32_t ttl);
+
+/**
+ * @brief Look up a query result from the cache.
+ *
+ * @param name Name to look up.
+ * @param type Query type.
+ * @param info Filled with up to DNS_CACHE_ADDRS resolved addresses.
+ *
+ * @return Number of addresses, 0 for a cached negative result or -ENOENT
+ *         if there is no valid result in the cache.
+ */
+int dns_cache_find(const char *name, enum dns_query_type type,
+		   struct dns_addrinfo info[DNS_CACHE_ADDRS]);
+
+/**
+ * @typedef dns_cache_cb_t
+ * @brief Callback used while iterating over the cache entries.
+ *
+ * @param name Cached name.
+ * @param type Query type.
+ * @param count Number of cached addresses, 0 for a negative entry.
+ * @param ttl Remaining time to live in seconds.
+ * @param user_data A valid pointer to user data or NULL
+ */
+typedef void (*dns_cache_cb_t)(const char *name, enum dns_query_type type,
+			       int count, u32_t ttl, void *user_data);
+
+/**
+ * @brief Go through all the valid cache entries, most recently used first.
+ *
+ * @param cb User supplied callback function to call.
+ * @param user_data User specified data.
+ */
+void dns_cache_foreach(dns_cache_cb_t cb, void *user_data);
+
+/** Initialize the cache and start listening for flush events */
+void dns_cache_init(void);
+
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
+#endif /* _DNS_CACHE_H_ */
@@ -24,6 +24,7 @@ LOG_MODULE_REGISTER(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #include <net/net_mgmt.h>
 #include <net/dns_resolve.h>
 #include "dns_pack.h"
+#include "dns_cache.h"
 
 #define DNS_SERVER_COUNT CONFIG_DNS_RESOLVER_MAX_SERVERS
 #define SERVER_COUNT     (DNS_SERVER_COUNT + DNS_MAX_MCAST_SERVERS)
@@ -370,6 +371,10 @@ static int dns_read(struct dns_resolve_context *ctx,
 	/* Helper struct to track the dns msg received from the server */
 	struct dns_msg_t dns_msg;
 	u32_t ttl; /* RR ttl, so far it is not passed to caller */
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	u8_t cache_addrs[DNS_CACHE_ADDRS][DNS_CACHE_ADDR_LEN];
+	u32_t cache_ttl = UINT32_MAX;
+#endif
 	u8_t *src, *addr;
 	const char *query_name;
 	int address_size;
@@ -450,22 +455,28 @@ static int dns_read(struct dns_resolve_context *ctx,
 			goto quit;
 		}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/* The result is valid as long as every record of the chain */
+		cache_ttl = MIN(cache_ttl, ttl);
+#endif
+
 		switch (dns_msg.response_type) {
 		case DNS_RESPONSE_IP:
-			if (query_idx >= 0) {
-				goto query_known;
-			}
-
-			query_name = dns_msg.msg + dns_msg.query_offset;
+			if (query_idx < 0) {
+				query_name = dns_msg.msg + dns_msg.query_offset;
 
-			/* Add \0 and query type (A or AAAA) to the hash */
-			*query_hash = crc16_ansi(query_name,
-						 strlen(query_name) + 1 + 2);
+				/* Add \0 and query type (A or AAAA) to the
+				 * hash
+				 */
+				*query_hash = crc16_ansi(query_name,
+						strlen(query_name) + 1 + 2);
 
-			query_idx = get_slot_by_id(ctx, *dns_id, *query_hash);
-			if (query_idx < 0) {
-				ret = DNS_EAI_SYSTEM;
-				goto quit;
+				query_idx = get_slot_by_id(ctx, *dns_id,
+							   *query_hash);
+				if (query_idx < 0) {
+					ret = DNS_EAI_SYSTEM;
+					goto quit;
+				}
 			}
 
 			if (ctx->queries[query_idx].query_type ==
@@ -521,7 +532,12 @@ static int dns_read(struct dns_resolve_context *ctx,
 			src = dns_msg.msg + dns_msg.response_position;
 			memcpy(addr, src, address_size);
 
-		query_known:
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			if (items < DNS_CACHE_ADDRS) {
+				memcpy(cache_addrs[items], src, address_size);
+			}
+#endif
+
 			ctx->queries[query_idx].cb(DNS_EAI_INPROGRESS, &info,
 					ctx->queries[query_idx].user_data);
 			items++;
@@ -586,6 +602,22 @@ static int dns_read(struct dns_resolve_context *ctx,
 		ret = DNS_EAI_ALLDONE;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* mDNS answers (dns_id 0) can come from any host on the link, so
+	 * those are not cached.
+	 */
+	if (*dns_id > 0 && items > 0) {
+		dns_cache_add(ctx->queries[query_idx].query,
+			      ctx->queries[query_idx].query_type,
+			      cache_addrs, items, cache_ttl);
+	} else if (*dns_id > 0 &&
+		   dns_header_rcode(dns_msg.msg) == DNS_HEADER_NAMEERROR) {
+		dns_cache_add(ctx->queries[query_idx].query,
+			      ctx->queries[query_idx].query_type,
+			      NULL, 0, CONFIG_DNS_RESOLVER_CACHE_NEG_TTL);
+	}
+#endif
+
 	if (k_delayed_work_remaining_get(&ctx->queries[query_idx].timer) > 0) {
 		k_delayed_work_cancel(&ctx->queries[query_idx].timer);
 	}
@@ -895,6 +927,9 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 	int failure = 0;
 	bool mdns_query = false;
 	u8_t hop_limit;
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_addrinfo cached[DNS_CACHE_ADDRS];
+#endif
 
 	if (!ctx || !ctx->is_used || !query || !cb) {
 		return -EINVAL;
@@ -957,6 +992,23 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 	}
 
 try_resolve:
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ret = dns_cache_find(query, type, cached);
+	if (ret >= 0) {
+		for (j = 0; j < ret; j++) {
+			cb(DNS_EAI_INPROGRESS, &cached[j], user_data);
+		}
+
+		cb(ret ? DNS_EAI_ALLDONE : DNS_EAI_NODATA, NULL, user_data);
+
+		if (dns_id) {
+			*dns_id = 0U;
+		}
+
+		return 0;
+	}
+#endif
+
 	i = get_cb_slot(ctx);
 	if (i < 0) {
 		return -EAGAIN;
@@ -1138,6 +1190,13 @@ void dns_init_resolver(void)
 	static const char *dns_servers[SERVER_COUNT + 1];
 	int count = DNS_SERVER_COUNT;
 	int ret;
+#endif
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_cache_init();
+#endif
+
+#if defined(CONFIG_DNS_SERVER_IP_ADDRESSES)
 
 	if (count > 5) {
 		count = 5;
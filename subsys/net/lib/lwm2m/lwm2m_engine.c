@@ -32,6 +32,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <errno.h>
 #include <init.h>
 #include <sys/printk.h>
+#include <sys/atomic.h>
 #include <net/net_ip.h>
 #include <net/http_parser_url.h>
 #include <net/socket.h>
@@ -87,6 +88,9 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 struct observe_node {
 	sys_snode_t node;
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_snode_t hash_node;
+#endif
 	struct lwm2m_ctx *ctx;
 	struct lwm2m_obj_path path;
 	u8_t  token[MAX_TOKEN_LEN];
@@ -97,6 +101,7 @@ struct observe_node {
 	u32_t counter;
 	u16_t format;
 	u8_t  tkl;
+	bool  event_batched;
 };
 
 struct notification_attrs {
@@ -127,6 +132,53 @@ static sys_slist_t engine_obj_inst_list;
 static sys_slist_t engine_observer_list;
 static sys_slist_t engine_service_list;
 
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+/* Objects, object instances and observers are also linked into hash
+ * tables, in the bucket selected by their object ID and object instance
+ * ID (0 for objects).
+ */
+static sys_slist_t engine_obj_hash[CONFIG_LWM2M_ENGINE_HASH_BUCKETS];
+static sys_slist_t engine_obj_inst_hash[CONFIG_LWM2M_ENGINE_HASH_BUCKETS];
+static sys_slist_t engine_observer_hash[CONFIG_LWM2M_ENGINE_HASH_BUCKETS];
+
+static sys_slist_t *engine_hash_bucket(sys_slist_t *table, u16_t obj_id,
+				       u16_t obj_inst_id)
+{
+	u32_t hash = ((u32_t)obj_id << 16) | obj_inst_id;
+
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+
+	return &table[hash % CONFIG_LWM2M_ENGINE_HASH_BUCKETS];
+}
+
+/* Iterate over the candidates of a lookup, only those in the right
+ * bucket when hashing, all of them otherwise.
+ */
+#define ENGINE_OBJ_FOR_EACH(obj_id, obj)				\
+	SYS_SLIST_FOR_EACH_CONTAINER(					\
+		engine_hash_bucket(engine_obj_hash, obj_id, 0),		\
+		obj, hash_node)
+#define ENGINE_OBJ_INST_FOR_EACH(obj_id, obj_inst_id, obj_inst)	\
+	SYS_SLIST_FOR_EACH_CONTAINER(					\
+		engine_hash_bucket(engine_obj_inst_hash, obj_id,	\
+				   obj_inst_id),			\
+		obj_inst, hash_node)
+#define ENGINE_OBSERVER_FOR_EACH(obj_id, obj_inst_id, obs)		\
+	SYS_SLIST_FOR_EACH_CONTAINER(					\
+		engine_hash_bucket(engine_observer_hash, obj_id,	\
+				   obj_inst_id),			\
+		obs, hash_node)
+#else
+#define ENGINE_OBJ_FOR_EACH(obj_id, obj)				\
+	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node)
+#define ENGINE_OBJ_INST_FOR_EACH(obj_id, obj_inst_id, obj_inst)	\
+	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst, node)
+#define ENGINE_OBSERVER_FOR_EACH(obj_id, obj_inst_id, obs)		\
+	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node)
+#endif
+
 static K_THREAD_STACK_DEFINE(engine_thread_stack,
 			      CONFIG_LWM2M_ENGINE_STACK_SIZE);
 static struct k_thread engine_thread_data;
@@ -372,17 +424,26 @@ static void clear_attrs(void *ref)
 
 int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
 {
+	struct lwm2m_engine_obj *obj = get_engine_obj(obj_id);
 	struct observe_node *obs;
+	bool batched = obj && atomic_get(&obj->notify_batch) > 0;
+	s64_t timestamp = k_uptime_get();
 	int ret = 0;
 
 	/* look for observers which match our resource */
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
+	ENGINE_OBSERVER_FOR_EACH(obj_id, obj_inst_id, obs) {
 		if (obs->path.obj_id == obj_id &&
 		    obs->path.obj_inst_id == obj_inst_id &&
 		    (obs->path.level < 3 ||
 		     obs->path.res_id == res_id)) {
-			/* update the event time for this observer */
-			obs->event_timestamp = k_uptime_get();
+			/* update the event time for this observer, at the
+			 * end of the batch if one is open
+			 */
+			if (batched) {
+				obs->event_batched = true;
+			} else {
+				obs->event_timestamp = timestamp;
+			}
 
 			LOG_DBG("NOTIFY EVENT %u/%u/%u",
 				obj_id, obj_inst_id, res_id);
@@ -400,6 +461,78 @@ int lwm2m_notify_observer_path(struct lwm2m_obj_path *path)
 				     path->res_id);
 }
 
+int lwm2m_engine_notify_batch_begin(u16_t obj_id)
+{
+	struct lwm2m_engine_obj *obj = get_engine_obj(obj_id);
+
+	if (!obj) {
+		LOG_ERR("unable to find obj: %u", obj_id);
+		return -ENOENT;
+	}
+
+	atomic_inc(&obj->notify_batch);
+	return 0;
+}
+
+int lwm2m_engine_notify_batch_end(u16_t obj_id)
+{
+	struct lwm2m_engine_obj *obj = get_engine_obj(obj_id);
+	s64_t timestamp;
+	int i;
+
+	if (!obj) {
+		LOG_ERR("unable to find obj: %u", obj_id);
+		return -ENOENT;
+	}
+
+	__ASSERT(atomic_get(&obj->notify_batch) > 0,
+		 "no notification batch open on obj %u", obj_id);
+	if (atomic_get(&obj->notify_batch) <= 0) {
+		return -EINVAL;
+	}
+
+	if (atomic_dec(&obj->notify_batch) != 1) {
+		return 0;
+	}
+
+	/* one event per observer, whatever the number of changes */
+	timestamp = k_uptime_get();
+	for (i = 0; i < CONFIG_LWM2M_ENGINE_MAX_OBSERVER; i++) {
+		if (observe_node_data[i].ctx &&
+		    observe_node_data[i].path.obj_id == obj_id &&
+		    observe_node_data[i].event_batched) {
+			observe_node_data[i].event_batched = false;
+			observe_node_data[i].event_timestamp = timestamp;
+		}
+	}
+
+	return 0;
+}
+
+static void engine_observer_link(struct observe_node *obs)
+{
+	sys_slist_append(&engine_observer_list, &obs->node);
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_slist_append(engine_hash_bucket(engine_observer_hash,
+					    obs->path.obj_id,
+					    obs->path.obj_inst_id),
+			 &obs->hash_node);
+#endif
+}
+
+static void engine_observer_free(sys_snode_t *prev_node,
+				 struct observe_node *obs)
+{
+	sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_slist_find_and_remove(engine_hash_bucket(engine_observer_hash,
+						     obs->path.obj_id,
+						     obs->path.obj_inst_id),
+				  &obs->hash_node);
+#endif
+	(void)memset(obs, 0, sizeof(*obs));
+}
+
 static int engine_add_observer(struct lwm2m_message *msg,
 			       const u8_t *token, u8_t tkl,
 			       u16_t format)
@@ -431,7 +564,7 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	/* TODO: observe dup checking */
 
 	/* make sure this observer doesn't exist already */
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
+	ENGINE_OBSERVER_FOR_EACH(msg->path.obj_id, msg->path.obj_inst_id, obs) {
 		/* TODO: distinguish server object */
 		if (obs->ctx == msg->ctx &&
 		    memcmp(&obs->path, &msg->path, sizeof(msg->path)) == 0) {
@@ -537,8 +670,7 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	observe_node_data[i].max_period_sec = MAX(attrs.pmax, attrs.pmin);
 	observe_node_data[i].format = format;
 	observe_node_data[i].counter = 1U;
-	sys_slist_append(&engine_observer_list,
-			 &observe_node_data[i].node);
+	engine_observer_link(&observe_node_data[i]);
 
 	LOG_DBG("OBSERVER ADDED %u/%u/%u(%u) token:'%s' addr:%s",
 		msg->path.obj_id, msg->path.obj_inst_id,
@@ -574,8 +706,7 @@ static int engine_remove_observer(const u8_t *token, u8_t tkl)
 		return -ENOENT;
 	}
 
-	sys_slist_remove(&engine_observer_list, prev_node, &found_obj->node);
-	(void)memset(found_obj, 0, sizeof(*found_obj));
+	engine_observer_free(prev_node, found_obj);
 
 	LOG_DBG("observer '%s' removed", log_strdup(sprint_token(token, tkl)));
 
@@ -596,8 +727,7 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 			continue;
 		}
 
-		sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
-		(void)memset(obs, 0, sizeof(*obs));
+		engine_observer_free(prev_node, obs);
 	}
 }
 
@@ -606,19 +736,28 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 {
 	sys_slist_append(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_slist_append(engine_hash_bucket(engine_obj_hash, obj->obj_id, 0),
+			 &obj->hash_node);
+#endif
 }
 
 void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 {
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_slist_find_and_remove(engine_hash_bucket(engine_obj_hash,
+						     obj->obj_id, 0),
+				  &obj->hash_node);
+#endif
 }
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
+	ENGINE_OBJ_FOR_EACH(obj_id, obj) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
@@ -648,6 +787,12 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_slist_append(engine_hash_bucket(engine_obj_inst_hash,
+					    obj_inst->obj->obj_id,
+					    obj_inst->obj_inst_id),
+			 &obj_inst->hash_node);
+#endif
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -655,6 +800,12 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	sys_slist_find_and_remove(engine_hash_bucket(engine_obj_inst_hash,
+						     obj_inst->obj->obj_id,
+						     obj_inst->obj_inst_id),
+				  &obj_inst->hash_node);
+#endif
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -662,8 +813,7 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
-				     node) {
+	ENGINE_OBJ_INST_FOR_EACH(obj_id, obj_inst_id, obj_inst) {
 		if (obj_inst->obj->obj_id == obj_id &&
 		    obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
@@ -3972,9 +4122,7 @@ int lwm2m_engine_context_close(struct lwm2m_ctx *client_ctx)
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&engine_observer_list,
 					  obs, tmp, node) {
 		if (obs->ctx == client_ctx) {
-			sys_slist_remove(&engine_observer_list, prev_node,
-					 &obs->node);
-			(void)memset(obs, 0, sizeof(*obs));
+			engine_observer_free(prev_node, obs);
 		} else {
 			prev_node = &obs->node;
 		}
@@ -175,6 +175,10 @@ typedef struct lwm2m_engine_obj_inst *
 struct lwm2m_engine_obj {
 	/* object list */
 	sys_snode_t node;
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	/* object hash bucket */
+	sys_snode_t hash_node;
+#endif
 
 	/* object field definitions */
 	struct lwm2m_engine_obj_field *fields;
@@ -190,6 +194,9 @@ struct lwm2m_engine_obj {
 	u16_t field_count;
 	u16_t instance_count;
 	u16_t max_instance_count;
+
+	/* number of open notification batches */
+	atomic_t notify_batch;
 };
 
 /* Resource instances with this value are considered "not created" yet */
@@ -341,6 +348,10 @@ struct lwm2m_engine_res {
 struct lwm2m_engine_obj_inst {
 	/* instance list */
 	sys_snode_t node;
+#if defined(CONFIG_LWM2M_ENGINE_HASH)
+	/* instance hash bucket */
+	sys_snode_t hash_node;
+#endif
 
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_res *resources;
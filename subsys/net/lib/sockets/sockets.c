@@ -621,6 +621,76 @@ static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
 #include <syscalls/zsock_sendmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+	unsigned int i;
+	ssize_t ret;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	for (i = 0U; i < vlen; i++) {
+		ret = vtable->sendmsg(ctx, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			/* The error is reported by the next call if some
+			 * messages were sent already.
+			 */
+			return i > 0 ? i : -1;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return i;
+}
+
+#ifdef CONFIG_USERSPACE
+static int sock_msg_vrfy(const struct msghdr *msg, bool write)
+{
+	if (Z_SYSCALL_MEMORY_ARRAY(msg->msg_iov, msg->msg_iovlen,
+				   sizeof(struct iovec), false)) {
+		return -EFAULT;
+	}
+
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
+		if (Z_SYSCALL_MEMORY(msg->msg_iov[i].iov_base,
+				     msg->msg_iov[i].iov_len, write)) {
+			return -EFAULT;
+		}
+	}
+
+	if (msg->msg_name &&
+	    Z_SYSCALL_MEMORY(msg->msg_name, msg->msg_namelen, write)) {
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	for (unsigned int i = 0U; i < vlen; i++) {
+		Z_OOPS(sock_msg_vrfy(&msgvec[i].msg_hdr, false));
+	}
+
+	return z_impl_zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
 				 enum net_ip_protocol proto,
 				 struct sockaddr *addr,
@@ -724,16 +794,10 @@ error:
 	return ret;
 }
 
-static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+static struct net_pkt *zsock_dgram_pkt_get(struct net_context *ctx,
+					   int flags)
 {
 	s32_t timeout = K_FOREVER;
-	size_t recv_len = 0;
-	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
@@ -747,7 +811,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		/* EAGAIN when timeout expired, EINTR when cancelled */
 		if (res && res != -EAGAIN && res != -EINTR) {
 			errno = -res;
-			return -1;
+			return NULL;
 		}
 
 		pkt = k_fifo_peek_head(&ctx->recv_q);
@@ -757,42 +821,79 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 
 	if (!pkt) {
 		errno = EAGAIN;
+	}
+
+	return pkt;
+}
+
+static int zsock_dgram_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+				struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	int rv;
+
+	rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+				   src_addr, *addrlen);
+	if (rv < 0) {
+		errno = -rv;
+		return -1;
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	return 0;
+}
+
+static ssize_t zsock_recv_dgram_iov(struct net_context *ctx,
+				    const struct iovec *iov,
+				    size_t iovlen,
+				    int flags,
+				    struct sockaddr *src_addr,
+				    socklen_t *addrlen,
+				    int *msg_flags)
+{
+	size_t recv_len = 0;
+	size_t len;
+	struct net_pkt_cursor backup;
+	struct net_pkt *pkt;
+
+	pkt = zsock_dgram_pkt_get(ctx, flags);
+	if (!pkt) {
 		return -1;
 	}
 
 	net_pkt_cursor_backup(pkt, &backup);
 
-	if (src_addr && addrlen) {
-		int rv;
+	if (src_addr && addrlen &&
+	    zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen) < 0) {
+		return -1;
+	}
 
-		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-					   src_addr, *addrlen);
-		if (rv < 0) {
-			errno = -rv;
-			return -1;
+	for (size_t i = 0; i < iovlen; i++) {
+		len = MIN(net_pkt_remaining_data(pkt), iov[i].iov_len);
+		if (len == 0) {
+			continue;
 		}
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		if (net_pkt_read(pkt, iov[i].iov_base, len)) {
+			errno = ENOBUFS;
 			return -1;
 		}
-	}
 
-	recv_len = net_pkt_remaining_data(pkt);
-	if (recv_len > max_len) {
-		recv_len = max_len;
+		recv_len += len;
 	}
 
-	if (net_pkt_read(pkt, buf, recv_len)) {
-		errno = ENOBUFS;
-		return -1;
+	if (msg_flags && net_pkt_remaining_data(pkt) > 0) {
+		*msg_flags |= ZSOCK_MSG_TRUNC;
 	}
 
 	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
@@ -809,6 +910,22 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	return recv_len;
 }
 
+static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
+				       void *buf,
+				       size_t max_len,
+				       int flags,
+				       struct sockaddr *src_addr,
+				       socklen_t *addrlen)
+{
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+
+	return zsock_recv_dgram_iov(ctx, &iov, 1, flags, src_addr, addrlen,
+				    NULL);
+}
+
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 					void *buf,
 					size_t max_len,
@@ -960,6 +1077,219 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static ssize_t zsock_recv_stream_iov(struct net_context *ctx,
+				     const struct iovec *iov,
+				     size_t iovlen,
+				     int flags)
+{
+	ssize_t recv_len = 0;
+	ssize_t len;
+
+	for (size_t i = 0; i < iovlen; i++) {
+		if (iov[i].iov_len == 0) {
+			continue;
+		}
+
+		len = zsock_recv_stream(ctx, iov[i].iov_base, iov[i].iov_len,
+					flags);
+		if (len < 0) {
+			return recv_len > 0 ? recv_len : -1;
+		}
+
+		recv_len += len;
+
+		if (len < iov[i].iov_len || (flags & ZSOCK_MSG_PEEK)) {
+			break;
+		}
+
+		/* Don't block once some data was received */
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	return recv_len;
+}
+
+ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			  int flags)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	msg->msg_flags = 0;
+	msg->msg_controllen = 0;
+
+	if (sock_type == SOCK_DGRAM) {
+		return zsock_recv_dgram_iov(ctx, msg->msg_iov, msg->msg_iovlen,
+					    flags, msg->msg_name,
+					    msg->msg_name ?
+					    &msg->msg_namelen : NULL,
+					    &msg->msg_flags);
+	} else if (sock_type == SOCK_STREAM) {
+		msg->msg_namelen = 0;
+		return zsock_recv_stream_iov(ctx, msg->msg_iov,
+					     msg->msg_iovlen, flags);
+	} else {
+		__ASSERT(0, "Unknown socket type");
+	}
+
+	return 0;
+}
+
+static ssize_t sock_recvmsg(const struct socket_op_vtable *vtable, void *ctx,
+			    struct msghdr *msg, int flags)
+{
+	if (vtable->recvmsg) {
+		return vtable->recvmsg(ctx, msg, flags);
+	}
+
+	/* Socket implementations without recvmsg() can still receive
+	 * into a single buffer.
+	 */
+	if (vtable->recvfrom == NULL || msg->msg_iovlen != 1) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	msg->msg_flags = 0;
+	msg->msg_controllen = 0;
+
+	return vtable->recvfrom(ctx, msg->msg_iov[0].iov_base,
+				msg->msg_iov[0].iov_len, flags,
+				msg->msg_name,
+				msg->msg_name ? &msg->msg_namelen : NULL);
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+	unsigned int i;
+	ssize_t ret;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* Peeking repeatedly would return the same message */
+	if (flags & ZSOCK_MSG_PEEK) {
+		vlen = MIN(vlen, 1U);
+	}
+
+	for (i = 0U; i < vlen; i++) {
+		ret = sock_recvmsg(vtable, ctx, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			return i > 0 ? i : -1;
+		}
+
+		msgvec[i].msg_len = ret;
+
+		/* Only the first message is waited for */
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	return i;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	for (unsigned int i = 0U; i < vlen; i++) {
+		Z_OOPS(sock_msg_vrfy(&msgvec[i].msg_hdr, true));
+	}
+
+	return z_impl_zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+ssize_t zsock_recv_loan(int sock, struct zsock_loan *loan, int flags,
+			struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	size_t offset;
+
+	ctx = z_get_fd_obj(sock, (const struct fd_op_vtable *)
+				 &sock_fd_op_vtable, ENOTSUP);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (net_context_get_type(ctx) != SOCK_DGRAM ||
+	    (flags & ZSOCK_MSG_PEEK)) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	pkt = zsock_dgram_pkt_get(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	if (src_addr && addrlen &&
+	    zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen) < 0) {
+		net_pkt_unref(pkt);
+		return -1;
+	}
+
+	/* The cursor was left at the start of the payload */
+	frag = pkt->cursor.buf;
+	offset = frag ? pkt->cursor.pos - frag->data : 0;
+	while (frag && offset >= frag->len) {
+		frag = frag->frags;
+		offset = 0;
+	}
+
+	loan->frag = frag;
+	loan->offset = offset;
+	loan->len = net_pkt_remaining_data(pkt);
+	loan->pkt = pkt;
+
+	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
+				    net_pkt_priority(pkt),
+				    net_pkt_timestamp(pkt)->nanosecond,
+				    k_cycle_get_32());
+
+	return loan->len;
+}
+
+int zsock_loan_iov(const struct zsock_loan *loan, struct iovec *iov,
+		   int iovcnt)
+{
+	struct net_buf *frag = loan->frag;
+	size_t offset = loan->offset;
+	size_t left = loan->len;
+	int i = 0;
+
+	while (i < iovcnt && frag && left > 0) {
+		if (frag->len > offset) {
+			iov[i].iov_base = frag->data + offset;
+			iov[i].iov_len = MIN(frag->len - offset, left);
+			left -= iov[i].iov_len;
+			i++;
+		}
+
+		frag = frag->frags;
+		offset = 0;
+	}
+
+	return i;
+}
+
+void zsock_loan_release(struct zsock_loan *loan)
+{
+	if (loan->pkt) {
+		net_pkt_unref(loan->pkt);
+		loan->pkt = NULL;
+		loan->frag = NULL;
+	}
+}
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1645,6 +1975,11 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static ssize_t sock_recvmsg_vmeth(void *obj, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg_ctx(obj, msg, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -1671,6 +2006,7 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.sendto = sock_sendto_vmeth,
 	.sendmsg = sock_sendmsg_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
+	.recvmsg = sock_recvmsg_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 };
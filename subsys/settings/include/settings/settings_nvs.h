@@ -38,6 +38,13 @@ struct settings_nvs {
 	struct nvs_fs cf_nvs;
 	u16_t last_name_id;
 	const char *flash_dev_name;
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	/* Hash of the name stored at NVS_NAMECNT_ID + 1 + index, 0 when
+	 * that name ID is free. Only valid once name_cache_ready is set.
+	 */
+	u16_t name_cache[CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE];
+	bool name_cache_ready;
+#endif
 };
 
 /* register nvs to be a source of settings */
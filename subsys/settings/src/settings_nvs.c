@@ -48,6 +48,90 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 	return rc;
 }
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+#define SETTINGS_NVS_CACHE_IDX(name_id) ((name_id) - (NVS_NAMECNT_ID + 1))
+
+/* Hash recorded for name IDs whose name could not be read from flash. Such
+ * names are always read back on save, where the hash is filled in again.
+ */
+#define SETTINGS_NVS_HASH_UNKNOWN 0xFFFF
+
+/* 16 bit FNV-1a hash of a setting's name, 0 is reserved for free name IDs
+ * and SETTINGS_NVS_HASH_UNKNOWN for unreadable ones.
+ */
+static u16_t settings_nvs_name_hash(const char *name, size_t len)
+{
+	u32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (u8_t)name[i];
+		hash *= 16777619U;
+	}
+
+	hash = (hash >> 16) ^ (hash & 0xFFFF);
+
+	if (hash == 0U) {
+		return 1U;
+	}
+
+	if (hash == SETTINGS_NVS_HASH_UNKNOWN) {
+		return SETTINGS_NVS_HASH_UNKNOWN - 1;
+	}
+
+	return (u16_t)hash;
+}
+
+static inline bool settings_nvs_cache_covers(u16_t name_id)
+{
+	return SETTINGS_NVS_CACHE_IDX(name_id) <
+	       CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+}
+
+static void settings_nvs_cache_set(struct settings_nvs *cf, u16_t name_id,
+				   u16_t hash)
+{
+	if (settings_nvs_cache_covers(name_id)) {
+		cf->name_cache[SETTINGS_NVS_CACHE_IDX(name_id)] = hash;
+	}
+}
+
+/* Read all names covered by the cache and record their hash. Used when a
+ * setting is saved before the cache got built by settings_nvs_load(). Names
+ * that can't be read are marked unknown rather than giving up on the cache,
+ * so a flash error doesn't make every later save scan all names again.
+ */
+static void settings_nvs_cache_fill(struct settings_nvs *cf)
+{
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	u16_t name_id;
+	ssize_t rc;
+
+	(void)memset(cf->name_cache, 0, sizeof(cf->name_cache));
+
+	for (name_id = NVS_NAMECNT_ID + 1;
+	     name_id <= cf->last_name_id && settings_nvs_cache_covers(name_id);
+	     name_id++) {
+		rc = nvs_read(&cf->cf_nvs, name_id, &name, sizeof(name));
+		if (rc == -ENOENT) {
+			continue;
+		}
+
+		if (rc < 0) {
+			settings_nvs_cache_set(cf, name_id,
+					       SETTINGS_NVS_HASH_UNKNOWN);
+			continue;
+		}
+
+		/* Names longer than the buffer can't match any setting */
+		settings_nvs_cache_set(cf, name_id,
+				       settings_nvs_name_hash(name,
+						MIN(rc, sizeof(name))));
+	}
+
+	cf->name_cache_ready = true;
+}
+#endif /* CONFIG_SETTINGS_NVS_NAME_CACHE */
+
 int settings_nvs_src(struct settings_nvs *cf)
 {
 	cf->cf_store.cs_itf = &settings_nvs_itf;
@@ -77,6 +161,12 @@ static int settings_nvs_load(struct settings_store *cs,
 
 	name_id = cf->last_name_id + 1;
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	/* The cache is rebuilt while walking through all stored names */
+	cf->name_cache_ready = false;
+	(void)memset(cf->name_cache, 0, sizeof(cf->name_cache));
+#endif
+
 	while (1) {
 
 		name_id--;
@@ -92,6 +182,14 @@ static int settings_nvs_load(struct settings_store *cs,
 		rc2 = nvs_read(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET,
 			       &buf, sizeof(buf));
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		if ((rc1 < 0) && (rc1 != -ENOENT)) {
+			/* Flash error, the name ID might still be in use */
+			settings_nvs_cache_set(cf, name_id,
+					       SETTINGS_NVS_HASH_UNKNOWN);
+		}
+#endif
+
 		if ((rc1 <= 0) && (rc2 <= 0)) {
 			continue;
 		}
@@ -114,6 +212,10 @@ static int settings_nvs_load(struct settings_store *cs,
 
 		/* Found a name, this might not include a trailing \0 */
 		name[rc1] = '\0';
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		settings_nvs_cache_set(cf, name_id,
+				       settings_nvs_name_hash(name, rc1));
+#endif
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
 
@@ -125,6 +227,12 @@ static int settings_nvs_load(struct settings_store *cs,
 			break;
 		}
 	}
+
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	if (!ret) {
+		cf->name_cache_ready = true;
+	}
+#endif
 	return ret;
 }
 
@@ -136,11 +244,21 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	u16_t name_id, write_name_id;
 	bool delete, write_name;
 	int rc = 0;
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	u16_t name_hash, cached_hash;
+#endif
 
 	if (!name) {
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	name_hash = settings_nvs_name_hash(name, strlen(name));
+	if (!cf->name_cache_ready) {
+		settings_nvs_cache_fill(cf);
+	}
+#endif
+
 	/* Find out if we are doing a delete */
 	delete = ((value == NULL) || (val_len == 0));
 
@@ -154,6 +272,25 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			break;
 		}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		/* Only read back names whose hash matches */
+		if (cf->name_cache_ready &&
+		    settings_nvs_cache_covers(name_id)) {
+			cached_hash =
+				cf->name_cache[SETTINGS_NVS_CACHE_IDX(name_id)];
+
+			if (!cached_hash) {
+				write_name_id = name_id;
+				continue;
+			}
+
+			if ((cached_hash != name_hash) &&
+			    (cached_hash != SETTINGS_NVS_HASH_UNKNOWN)) {
+				continue;
+			}
+		}
+#endif
+
 		rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
 
 		if (rc < 0) {
@@ -166,6 +303,16 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 
 		rdname[rc] = '\0';
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		if (cf->name_cache_ready && settings_nvs_cache_covers(name_id) &&
+		    (cf->name_cache[SETTINGS_NVS_CACHE_IDX(name_id)] ==
+		     SETTINGS_NVS_HASH_UNKNOWN)) {
+			settings_nvs_cache_set(cf, name_id,
+				settings_nvs_name_hash(rdname,
+					MIN(rc, sizeof(rdname))));
+		}
+#endif
+
 		if (strcmp(name, rdname)) {
 			continue;
 		}
@@ -194,6 +341,9 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 				return rc;
 			}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+			settings_nvs_cache_set(cf, name_id, 0);
+#endif
 			return 0;
 		}
 		write_name_id = name_id;
@@ -220,6 +370,9 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 		if (rc < 0) {
 			return rc;
 		}
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		settings_nvs_cache_set(cf, write_name_id, name_hash);
+#endif
 	}
 
 	/* update the last_name_id and write to flash if required*/
@@ -8,6 +8,7 @@
 #include <drivers/uart.h>
 #include <init.h>
 #include <logging/log.h>
+#include <string.h>
 
 #define LOG_MODULE_NAME shell_uart
 LOG_MODULE_REGISTER(shell_uart);
@@ -132,6 +133,219 @@ static void uart_callback(void *user_data)
 }
 #endif /* CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN */
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+#define RX_BUF_COUNT CONFIG_SHELL_BACKEND_SERIAL_ASYNC_RX_BUF_COUNT
+
+static u8_t rx_buf_idx_next(u8_t idx)
+{
+	return (idx + 1 < RX_BUF_COUNT) ? idx + 1 : 0;
+}
+
+/* Must be called from the UART callback or with interrupts locked. */
+static struct shell_uart_rx_buf *rx_buf_alloc(struct shell_uart_ctrl_blk *blk)
+{
+	struct shell_uart_rx_buf *rx_buf;
+
+	if (blk->rx_free == 0U) {
+		return NULL;
+	}
+
+	/* Buffers are passed to the driver and read by the shell in the same
+	 * order, so the next buffer in turn is always the free one.
+	 */
+	rx_buf = &blk->rx_bufs[blk->rx_alloc_idx];
+	blk->rx_alloc_idx = rx_buf_idx_next(blk->rx_alloc_idx);
+	blk->rx_free--;
+
+	return rx_buf;
+}
+
+static void rx_enable(const struct shell_uart *sh_uart,
+		      struct shell_uart_rx_buf *rx_buf)
+{
+	int err;
+
+	err = uart_rx_enable(sh_uart->ctrl_blk->dev, rx_buf->data,
+			     sizeof(rx_buf->data),
+			     CONFIG_SHELL_BACKEND_SERIAL_ASYNC_RX_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to enable RX (%d)", err);
+	}
+}
+
+static void async_tx_start(const struct shell_uart *sh_uart)
+{
+	u8_t *data;
+	u32_t len;
+	int err;
+
+	len = ring_buf_get_claim(sh_uart->tx_ringbuf, &data,
+				 sh_uart->tx_ringbuf->size);
+	if (len) {
+		err = uart_tx(sh_uart->ctrl_blk->dev, data, len, K_FOREVER);
+		__ASSERT_NO_MSG(err == 0);
+		(void)err;
+	} else {
+		sh_uart->ctrl_blk->tx_busy = 0;
+		/* Data may have been put after the claim but before tx_busy
+		 * was cleared.
+		 */
+		if (!ring_buf_is_empty(sh_uart->tx_ringbuf) &&
+		    atomic_set(&sh_uart->ctrl_blk->tx_busy, 1) == 0) {
+			async_tx_start(sh_uart);
+		}
+	}
+}
+
+static void async_tx_done(const struct shell_uart *sh_uart, size_t len)
+{
+	int err;
+
+	err = ring_buf_get_finish(sh_uart->tx_ringbuf, len);
+	__ASSERT_NO_MSG(err == 0);
+	(void)err;
+
+	async_tx_start(sh_uart);
+
+	sh_uart->ctrl_blk->handler(SHELL_TRANSPORT_EVT_TX_RDY,
+				   sh_uart->ctrl_blk->context);
+}
+
+static void async_callback(struct uart_event *evt, void *user_data)
+{
+	const struct shell_uart *sh_uart = (struct shell_uart *)user_data;
+	struct shell_uart_ctrl_blk *blk = sh_uart->ctrl_blk;
+	struct shell_uart_rx_buf *rx_buf;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		async_tx_done(sh_uart, evt->data.tx.len);
+		break;
+	case UART_RX_RDY:
+		rx_buf = CONTAINER_OF(evt->data.rx.buf,
+				      struct shell_uart_rx_buf, data);
+		rx_buf->len = evt->data.rx.offset + evt->data.rx.len;
+		blk->handler(SHELL_TRANSPORT_EVT_RX_RDY, blk->context);
+		break;
+	case UART_RX_BUF_REQUEST:
+		rx_buf = rx_buf_alloc(blk);
+		if (rx_buf) {
+			uart_rx_buf_rsp(blk->dev, rx_buf->data,
+					sizeof(rx_buf->data));
+		} else {
+			blk->rx_req_pending = true;
+		}
+		break;
+	case UART_RX_BUF_RELEASED:
+		rx_buf = CONTAINER_OF(evt->data.rx_buf.buf,
+				      struct shell_uart_rx_buf, data);
+		rx_buf->released = true;
+		break;
+	case UART_RX_DISABLED:
+		/* Reception is restarted by the shell thread once it has
+		 * freed a buffer.
+		 */
+		blk->rx_req_pending = false;
+		blk->rx_disabled = true;
+		blk->handler(SHELL_TRANSPORT_EVT_RX_RDY, blk->context);
+		break;
+	case UART_RX_STOPPED:
+		LOG_WRN("RX stopped (reason: %d)", evt->data.rx_stop.reason);
+		break;
+	default:
+		break;
+	}
+}
+
+static void async_init(const struct shell_uart *sh_uart)
+{
+	struct shell_uart_ctrl_blk *blk = sh_uart->ctrl_blk;
+	int err;
+
+	blk->rx_rd_idx = 0U;
+	blk->rx_alloc_idx = 0U;
+	blk->rx_free = RX_BUF_COUNT;
+	blk->rx_req_pending = false;
+	blk->rx_disabled = false;
+
+	err = uart_callback_set(blk->dev, async_callback, (void *)sh_uart);
+	if (err) {
+		LOG_ERR("Failed to set UART callback (%d)", err);
+		return;
+	}
+
+	rx_enable(sh_uart, rx_buf_alloc(blk));
+}
+
+/* Copies received data directly from the RX buffers, returning each buffer
+ * to the pool once it has been released by the driver and fully read. A
+ * buffer freed this way completes a pending buffer request or restarts
+ * reception.
+ */
+static void async_read(const struct shell_uart *sh_uart, u8_t *data,
+		       size_t length, size_t *cnt)
+{
+	struct shell_uart_ctrl_blk *blk = sh_uart->ctrl_blk;
+	struct shell_uart_rx_buf *rx_buf;
+	struct shell_uart_rx_buf *next;
+	unsigned int key;
+	bool released;
+	bool restart;
+	size_t len;
+
+	*cnt = 0;
+
+	while (length) {
+		rx_buf = &blk->rx_bufs[blk->rx_rd_idx];
+
+		/* Once released the buffer length is final. */
+		key = irq_lock();
+		released = rx_buf->released;
+		len = rx_buf->len - rx_buf->rd;
+		irq_unlock(key);
+
+		if (len) {
+			len = MIN(len, length);
+			memcpy(data, &rx_buf->data[rx_buf->rd], len);
+			rx_buf->rd += len;
+			data += len;
+			length -= len;
+			*cnt += len;
+			continue;
+		}
+
+		if (!released) {
+			break;
+		}
+
+		next = NULL;
+
+		key = irq_lock();
+		rx_buf->len = 0U;
+		rx_buf->rd = 0U;
+		rx_buf->released = false;
+		blk->rx_rd_idx = rx_buf_idx_next(blk->rx_rd_idx);
+		blk->rx_free++;
+		restart = blk->rx_disabled;
+		if (blk->rx_disabled || blk->rx_req_pending) {
+			blk->rx_disabled = false;
+			blk->rx_req_pending = false;
+			next = rx_buf_alloc(blk);
+			if (!restart) {
+				uart_rx_buf_rsp(blk->dev, next->data,
+						sizeof(next->data));
+			}
+		}
+		irq_unlock(key);
+
+		if (restart) {
+			rx_enable(sh_uart, next);
+		}
+	}
+}
+#endif /* CONFIG_SHELL_BACKEND_SERIAL_ASYNC */
+
 static void uart_irq_init(const struct shell_uart *sh_uart)
 {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
@@ -168,7 +382,11 @@ static int init(const struct shell_transport *transport,
 	sh_uart->ctrl_blk->handler = evt_handler;
 	sh_uart->ctrl_blk->context = context;
 
-	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)) {
+	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)) {
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+		async_init(sh_uart);
+#endif
+	} else if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)) {
 		uart_irq_init(sh_uart);
 	} else {
 		k_timer_init(sh_uart->timer, timer_handler, NULL);
@@ -205,7 +423,9 @@ static void irq_write(const struct shell_uart *sh_uart, const void *data,
 	*cnt = ring_buf_put(sh_uart->tx_ringbuf, data, length);
 
 	if (atomic_set(&sh_uart->ctrl_blk->tx_busy, 1) == 0) {
-#ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
+#if defined(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)
+		async_tx_start(sh_uart);
+#elif defined(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)
 		uart_irq_tx_enable(sh_uart->ctrl_blk->dev);
 #endif
 	}
@@ -217,7 +437,8 @@ static int write(const struct shell_transport *transport,
 	const struct shell_uart *sh_uart = (struct shell_uart *)transport->ctx;
 	const u8_t *data8 = (const u8_t *)data;
 
-	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) &&
+	if ((IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) ||
+	     IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)) &&
 		!sh_uart->ctrl_blk->blocking_tx) {
 		irq_write(sh_uart, data, length, cnt);
 	} else {
@@ -239,7 +460,11 @@ static int read(const struct shell_transport *transport,
 {
 	struct shell_uart *sh_uart = (struct shell_uart *)transport->ctx;
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+	async_read(sh_uart, data, length, cnt);
+#else
 	*cnt = ring_buf_get(sh_uart->rx_ringbuf, data, length);
+#endif
 
 	return 0;
 }
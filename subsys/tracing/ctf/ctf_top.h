@@ -42,11 +42,18 @@
 }
 
 #ifdef CONFIG_TRACING_CTF_TIMESTAMP
+/*
+ * The timestamp is taken with the interrupts of the CPU locked until the
+ * event is in its buffer, so that the events of a CPU are in timestamp
+ * order and within the timestamps of their packet.
+ */
 #define CTF_EVENT(...)							    \
 	{								    \
+		unsigned int ctf_key = arch_irq_lock();			    \
 		const u32_t tstamp = k_cycle_get_32();			    \
 									    \
 		CTF_GATHER_FIELDS(tstamp, __VA_ARGS__)			    \
+		arch_irq_unlock(ctf_key);				    \
 	}
 #else
 #define CTF_EVENT(...)							    \
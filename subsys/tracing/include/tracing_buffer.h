@@ -14,34 +14,69 @@
 extern "C" {
 #endif
 
+/*
+ * Each CPU has its own tracing buffer. The put functions write to the
+ * buffer of the calling CPU and must be called with its interrupts
+ * locked, so that they are the only producer of that buffer. The get
+ * functions may then read any buffer from any CPU without locking, as
+ * long as there is only one reader.
+ */
+
 /**
- * @brief Initialize tracing buffer.
+ * @brief Initialize tracing buffers.
  */
 void tracing_buffer_init(void);
 
 /**
- * @brief Tracing buffer is empty or not.
+ * @brief Tracing buffer of a CPU is empty or not.
+ *
+ * @param cpu CPU id.
  *
  * @return true if the ring buffer is empty, or false if not.
  */
-bool tracing_buffer_is_empty(void);
+bool tracing_buffer_is_empty(u32_t cpu);
+
+/**
+ * @brief Get the amount of data in the tracing buffer of a CPU.
+ *
+ * @param cpu CPU id.
+ *
+ * @return Number of bytes that can be read.
+ */
+u32_t tracing_buffer_used_get(u32_t cpu);
+
+/**
+ * @brief Get how much was committed to the tracing buffer of a CPU.
+ *
+ * Unlike the amount of data in the buffer, this only ever grows, data
+ * committed since an earlier call is the difference of the two results.
+ *
+ * @param cpu CPU id.
+ * @param cycles Cycle count taken right after the last commit, only
+ * updated when CONFIG_TRACING_PACKET_HEADER is enabled.
+ *
+ * @return Number of bytes committed so far, wrapping around at 2^32.
+ */
+u32_t tracing_buffer_committed_get(u32_t cpu, u32_t *cycles);
 
 /**
- * @brief Get free space in the tracing buffer.
+ * @brief Get free space in the tracing buffer of the calling CPU.
  *
  * @return Tracing buffer free space (in bytes).
  */
 u32_t tracing_buffer_space_get(void);
 
 /**
- * @brief Get tracing buffer capacity (max size).
+ * @brief Get tracing buffer capacity (max size), the same for all CPUs.
  *
  * @return Tracing buffer capacity (in bytes).
  */
 u32_t tracing_buffer_capacity_get(void);
 
 /**
- * @brief Try to allocate buffer in the tracing buffer.
+ * @brief Try to allocate buffer in the tracing buffer of the calling CPU.
+ *
+ * Claiming again before the data is finished returns the same buffer.
  *
  * @param data Pointer to the address. It's set to a location
  *             within the tracing buffer.
@@ -63,7 +98,7 @@ u32_t tracing_buffer_put_claim(u8_t **data, u32_t size);
 int tracing_buffer_put_finish(u32_t size);
 
 /**
- * @brief Write data to tracing buffer.
+ * @brief Write data to the tracing buffer of the calling CPU.
  *
  * @param data Address of data.
  * @param size Data size (in bytes).
@@ -73,8 +108,9 @@ int tracing_buffer_put_finish(u32_t size);
 u32_t tracing_buffer_put(u8_t *data, u32_t size);
 
 /**
- * @brief Get address of the first valid data in tracing buffer.
+ * @brief Get address of the first valid data in the tracing buffer of a CPU.
  *
+ * @param cpu  CPU id.
  * @param data Pointer to the address. It's set to a location pointing to
  *             the first valid data within the tracing buffer.
  * @param size Requested buffer size (in bytes).
@@ -82,27 +118,29 @@ u32_t tracing_buffer_put(u8_t *data, u32_t size);
  * @return Size of valid buffer which can be smaller than requested
  *         if there isn't enough valid data or buffer wraps.
  */
-u32_t tracing_buffer_get_claim(u8_t **data, u32_t size);
+u32_t tracing_buffer_get_claim(u32_t cpu, u8_t **data, u32_t size);
 
 /**
  * @brief Indicate number of bytes read from claimed buffer.
  *
+ * @param cpu  CPU id.
  * @param size Number of bytes read from claimed buffer.
  *
  * @retval 0 Successful operation.
  * @retval -EINVAL Given @a size exceeds available data of tracing buffer.
  */
-int tracing_buffer_get_finish(u32_t size);
+int tracing_buffer_get_finish(u32_t cpu, u32_t size);
 
 /**
- * @brief Read data from tracing buffer to output buffer.
+ * @brief Read data from the tracing buffer of a CPU to output buffer.
  *
+ * @param cpu  CPU id.
  * @param data Address of the output buffer.
  * @param size Data size (in bytes).
  *
  * @retval Number of bytes written to the output buffer.
  */
-u32_t tracing_buffer_get(u8_t *data, u32_t size);
+u32_t tracing_buffer_get(u32_t cpu, u8_t *data, u32_t size);
 
 /**
  * @brief Get buffer from tracing command buffer.
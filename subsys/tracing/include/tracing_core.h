@@ -8,6 +8,7 @@
 #define _TRACE_CORE_H
 
 #include <irq.h>
+#include <kernel_structs.h>
 #include <zephyr/types.h>
 
 #ifdef __cplusplus
@@ -18,6 +19,49 @@ extern "C" {
 
 #define TRACING_UNLOCK()	{ irq_unlock(key); } }
 
+/* Only locks the interrupts of the calling CPU, which is all it takes to
+ * write to its tracing buffer.
+ */
+#define TRACING_CPU_LOCK()	{ unsigned int key; key = arch_irq_lock()
+
+#define TRACING_CPU_UNLOCK()	{ arch_irq_unlock(key); } }
+
+#define TRACING_PACKET_MAGIC	0xc1fc1fc1
+
+/* All packets are of the one CTF stream class */
+#define TRACING_PACKET_STREAM_ID	0
+
+/**
+ * @brief Header of a packet, matching the CTF packet header and context.
+ *
+ * Each CPU is its own instance of the stream. Sizes are in bits and
+ * include the header. The events of the packet were timestamped within
+ * [timestamp_begin, timestamp_end], and timestamp_begin is the
+ * timestamp_end of the previous packet of that CPU.
+ */
+struct tracing_packet_header {
+	u32_t magic;
+	u32_t stream_id;
+	u32_t stream_instance_id;
+	u32_t content_size;
+	u32_t packet_size;
+	u32_t timestamp_begin;
+	u32_t timestamp_end;
+	u8_t cpu_id;
+} __packed;
+
+/**
+ * @brief Get the id of the calling CPU.
+ *
+ * Interrupts must be locked, so that the thread cannot move to another CPU.
+ *
+ * @return CPU id.
+ */
+static inline u32_t tracing_cpu_id_get(void)
+{
+	return _current_cpu->id;
+}
+
 /**
  * @brief Check tracing enabled or not.
  *
@@ -33,6 +77,29 @@ bool is_tracing_enabled(void);
  */
 void tracing_buffer_handle(u8_t *data, u32_t length);
 
+/**
+ * @brief Give a packet header to backend.
+ *
+ * Does nothing unless CONFIG_TRACING_PACKET_HEADER is enabled.
+ *
+ * @param cpu Id of the CPU the packet data comes from.
+ * @param length Length of the packet data following the header.
+ * @param timestamp_end Cycle count taken after the last event of the
+ * packet was put.
+ */
+void tracing_packet_header_handle(u32_t cpu, u32_t length,
+				  u32_t timestamp_end);
+
+/**
+ * @brief Give the data in the tracing buffer of a CPU to backend.
+ *
+ * The data buffered at the time of the call is given as one packet, so
+ * it only holds whole events as long as these are put in one go.
+ *
+ * @param cpu CPU id.
+ */
+void tracing_buffer_output(u32_t cpu);
+
 /**
  * @brief Handle tracing packet drop.
  */
@@ -21,6 +21,7 @@ extern "C" {
 typedef struct {
 	int status;
 	u32_t length;
+	u8_t data[CONFIG_TRACING_PACKET_MAX_SIZE];
 } tracing_ctx_t;
 
 #ifdef CONFIG_NEWLIB_LIBC
@@ -4,12 +4,54 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <kernel.h>
+#include <sys/atomic.h>
 #include <sys/ring_buffer.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
 
-static struct ring_buf tracing_ring_buf;
-static u8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
+/* The lock-free ring buffers need a power of two size, round the
+ * configured size down to one at build time.
+ */
+#define TRACING_BUFFER_SIZE BIT(31 - __builtin_clz(CONFIG_TRACING_BUFFER_SIZE))
+
+/* What the producer of a CPU committed so far and when, read by the
+ * consumer under a sequence count as the producer may run on another CPU.
+ */
+struct tracing_buffer_stamp {
+	atomic_t seq;
+	atomic_t committed;
+	atomic_t cycles;
+};
+
+static struct ring_buf_spsc tracing_ring_buf[CONFIG_MP_NUM_CPUS];
+static u8_t tracing_buffer[CONFIG_MP_NUM_CPUS][TRACING_BUFFER_SIZE];
+static struct tracing_buffer_stamp tracing_stamp[CONFIG_MP_NUM_CPUS];
 static u8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
 
+static inline struct ring_buf_spsc *current_ring_buf(void)
+{
+	return &tracing_ring_buf[tracing_cpu_id_get()];
+}
+
+/* Called by the producer with the interrupts of its CPU locked */
+static void tracing_buffer_stamp_update(u32_t size)
+{
+	struct tracing_buffer_stamp *stamp;
+
+	if (size == 0U) {
+		return;
+	}
+
+	stamp = &tracing_stamp[tracing_cpu_id_get()];
+	atomic_inc(&stamp->seq);
+	atomic_add(&stamp->committed, size);
+	if (IS_ENABLED(CONFIG_TRACING_PACKET_HEADER)) {
+		atomic_set(&stamp->cycles, k_cycle_get_32());
+	}
+	atomic_inc(&stamp->seq);
+}
+
 u32_t tracing_cmd_buffer_alloc(u8_t **data)
 {
 	*data = &tracing_cmd_buffer[0];
@@ -19,51 +61,82 @@ u32_t tracing_cmd_buffer_alloc(u8_t **data)
 
 u32_t tracing_buffer_put_claim(u8_t **data, u32_t size)
 {
-	return ring_buf_put_claim(&tracing_ring_buf, data, size);
+	return ring_buf_spsc_put_claim(current_ring_buf(), data, size);
 }
 
 int tracing_buffer_put_finish(u32_t size)
 {
-	return ring_buf_put_finish(&tracing_ring_buf, size);
+	int err = ring_buf_spsc_put_commit(current_ring_buf(), size);
+
+	if (err == 0) {
+		tracing_buffer_stamp_update(size);
+	}
+
+	return err;
 }
 
 u32_t tracing_buffer_put(u8_t *data, u32_t size)
 {
-	return ring_buf_put(&tracing_ring_buf, data, size);
+	u32_t put_size = ring_buf_spsc_put(current_ring_buf(), data, size);
+
+	tracing_buffer_stamp_update(put_size);
+
+	return put_size;
 }
 
-u32_t tracing_buffer_get_claim(u8_t **data, u32_t size)
+u32_t tracing_buffer_get_claim(u32_t cpu, u8_t **data, u32_t size)
 {
-	return ring_buf_get_claim(&tracing_ring_buf, data, size);
+	return ring_buf_spsc_get_claim(&tracing_ring_buf[cpu], data, size);
 }
 
-int tracing_buffer_get_finish(u32_t size)
+int tracing_buffer_get_finish(u32_t cpu, u32_t size)
 {
-	return ring_buf_get_finish(&tracing_ring_buf, size);
+	return ring_buf_spsc_get_commit(&tracing_ring_buf[cpu], size);
 }
 
-u32_t tracing_buffer_get(u8_t *data, u32_t size)
+u32_t tracing_buffer_get(u32_t cpu, u8_t *data, u32_t size)
 {
-	return ring_buf_get(&tracing_ring_buf, data, size);
+	return ring_buf_spsc_get(&tracing_ring_buf[cpu], data, size);
 }
 
 void tracing_buffer_init(void)
 {
-	ring_buf_init(&tracing_ring_buf,
-		      sizeof(tracing_buffer), tracing_buffer);
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		ring_buf_spsc_init(&tracing_ring_buf[i], TRACING_BUFFER_SIZE,
+				   tracing_buffer[i]);
+	}
+}
+
+bool tracing_buffer_is_empty(u32_t cpu)
+{
+	return ring_buf_spsc_used_get(&tracing_ring_buf[cpu]) == 0U;
+}
+
+u32_t tracing_buffer_used_get(u32_t cpu)
+{
+	return ring_buf_spsc_used_get(&tracing_ring_buf[cpu]);
 }
 
-bool tracing_buffer_is_empty(void)
+u32_t tracing_buffer_committed_get(u32_t cpu, u32_t *cycles)
 {
-	return ring_buf_is_empty(&tracing_ring_buf);
+	struct tracing_buffer_stamp *stamp = &tracing_stamp[cpu];
+	atomic_val_t seq, committed;
+
+	do {
+		seq = atomic_get(&stamp->seq);
+		committed = atomic_get(&stamp->committed);
+		*cycles = atomic_get(&stamp->cycles);
+	} while ((seq & 1) || (atomic_get(&stamp->seq) != seq));
+
+	return committed;
 }
 
 u32_t tracing_buffer_capacity_get(void)
 {
-	return ring_buf_capacity_get(&tracing_ring_buf);
+	return TRACING_BUFFER_SIZE;
 }
 
 u32_t tracing_buffer_space_get(void)
 {
-	return ring_buf_space_get(&tracing_ring_buf);
+	return ring_buf_spsc_space_get(current_ring_buf());
 }
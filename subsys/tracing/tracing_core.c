@@ -22,6 +22,8 @@
 #define TRACING_BACKEND_NAME "tracing_backend_usb"
 #elif defined CONFIG_TRACING_BACKEND_POSIX
 #define TRACING_BACKEND_NAME "tracing_backend_posix"
+#elif defined CONFIG_TRACING_BACKEND_CUSTOM
+#define TRACING_BACKEND_NAME "tracing_backend_custom"
 #else
 #define TRACING_BACKEND_NAME ""
 #endif
@@ -35,6 +37,12 @@ static atomic_t tracing_state;
 static atomic_t tracing_packet_drop_num;
 static struct tracing_backend *working_backend;
 
+#ifdef CONFIG_TRACING_PACKET_HEADER
+/* Only used by the one consumer of the tracing buffers */
+static u32_t tracing_packet_end[CONFIG_MP_NUM_CPUS];
+#endif
+static u32_t tracing_consumed[CONFIG_MP_NUM_CPUS];
+
 #ifdef CONFIG_TRACING_ASYNC
 #define TRACING_THREAD_NAME "tracing_thread"
 
@@ -47,24 +55,25 @@ static K_THREAD_STACK_DEFINE(tracing_thread_stack,
 
 static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
-	u8_t *transferring_buf;
-	u32_t transferring_length, tracing_buffer_max_length;
+	bool all_empty;
 
 	tracing_thread_tid = k_current_get();
 
-	tracing_buffer_max_length = tracing_buffer_capacity_get();
-
 	while (true) {
-		if (tracing_buffer_is_empty()) {
+		all_empty = true;
+
+		/* Takes turns between the CPUs, so that one producing a lot
+		 * of data does not hold back the packets of the others.
+		 */
+		for (u32_t cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+			if (!tracing_buffer_is_empty(cpu)) {
+				tracing_buffer_output(cpu);
+				all_empty = false;
+			}
+		}
+
+		if (all_empty) {
 			k_sem_take(&tracing_thread_sem, K_FOREVER);
-		} else {
-			transferring_length =
-				tracing_buffer_get_claim(
-						&transferring_buf,
-						tracing_buffer_max_length);
-			tracing_buffer_handle(transferring_buf,
-					      transferring_length);
-			tracing_buffer_get_finish(transferring_length);
 		}
 	}
 }
@@ -147,6 +156,52 @@ void tracing_buffer_handle(u8_t *data, u32_t length)
 	tracing_backend_output(working_backend, data, length);
 }
 
+void tracing_packet_header_handle(u32_t cpu, u32_t length,
+				  u32_t timestamp_end)
+{
+#ifdef CONFIG_TRACING_PACKET_HEADER
+	struct tracing_packet_header header = {
+		.magic = TRACING_PACKET_MAGIC,
+		.stream_id = TRACING_PACKET_STREAM_ID,
+		.stream_instance_id = cpu,
+		.content_size = (sizeof(header) + length) * 8U,
+		.packet_size = (sizeof(header) + length) * 8U,
+		.timestamp_begin = tracing_packet_end[cpu],
+		.timestamp_end = timestamp_end,
+		.cpu_id = cpu,
+	};
+
+	tracing_packet_end[cpu] = timestamp_end;
+
+	tracing_buffer_handle((u8_t *)&header, sizeof(header));
+#endif
+}
+
+void tracing_buffer_output(u32_t cpu)
+{
+	u32_t committed, cycles, length, transferring_length;
+	u8_t *transferring_buf;
+
+	/* Producers only ever add whole events, the data committed now ends
+	 * on an event boundary even if more is added meanwhile. The cycle
+	 * count taken after that last event ends the packet.
+	 */
+	committed = tracing_buffer_committed_get(cpu, &cycles);
+	length = committed - tracing_consumed[cpu];
+	tracing_consumed[cpu] = committed;
+
+	tracing_packet_header_handle(cpu, length, cycles);
+
+	while (length) {
+		transferring_length = tracing_buffer_get_claim(cpu,
+							      &transferring_buf,
+							      length);
+		tracing_buffer_handle(transferring_buf, transferring_length);
+		tracing_buffer_get_finish(cpu, transferring_length);
+		length -= transferring_length;
+	}
+}
+
 void tracing_packet_drop_handle(void)
 {
 	atomic_inc(&tracing_packet_drop_num);
@@ -19,10 +19,10 @@ void tracing_format_string(const char *str, ...)
 
 	va_start(args, str);
 
-	TRACING_LOCK();
-	before_put_is_empty = tracing_buffer_is_empty();
+	TRACING_CPU_LOCK();
+	before_put_is_empty = tracing_buffer_is_empty(tracing_cpu_id_get());
 	put_success = tracing_format_string_put(str, args);
-	TRACING_UNLOCK();
+	TRACING_CPU_UNLOCK();
 
 	va_end(args);
 
@@ -41,10 +41,10 @@ void tracing_format_raw_data(u8_t *data, u32_t length)
 		return;
 	}
 
-	TRACING_LOCK();
-	before_put_is_empty = tracing_buffer_is_empty();
+	TRACING_CPU_LOCK();
+	before_put_is_empty = tracing_buffer_is_empty(tracing_cpu_id_get());
 	put_success = tracing_format_raw_data_put(data, length);
-	TRACING_UNLOCK();
+	TRACING_CPU_UNLOCK();
 
 	if (put_success) {
 		tracing_trigger_output(before_put_is_empty);
@@ -61,10 +61,10 @@ void tracing_format_data(tracing_data_t *tracing_data_array, u32_t count)
 		return;
 	}
 
-	TRACING_LOCK();
-	before_put_is_empty = tracing_buffer_is_empty();
+	TRACING_CPU_LOCK();
+	before_put_is_empty = tracing_buffer_is_empty(tracing_cpu_id_get());
 	put_success = tracing_format_data_put(tracing_data_array, count);
-	TRACING_UNLOCK();
+	TRACING_CPU_UNLOCK();
 
 	if (put_success) {
 		tracing_trigger_output(before_put_is_empty);
@@ -8,18 +8,18 @@
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
 
+/*
+ * Messages are gathered and then put to the tracing buffer in one go, as
+ * the buffer only hands out one area at a time and its reader must never
+ * see part of a message.
+ */
 static int str_put(int c, void *ctx)
 {
 	tracing_ctx_t *str_ctx = (tracing_ctx_t *)ctx;
 
 	if (str_ctx->status == 0) {
-		u8_t *buf;
-		u32_t claimed_size;
-
-		claimed_size = tracing_buffer_put_claim(&buf, 1);
-		if (claimed_size) {
-			*buf = (u8_t)c;
-			str_ctx->length++;
+		if (str_ctx->length < sizeof(str_ctx->data)) {
+			str_ctx->data[str_ctx->length++] = (u8_t)c;
 		} else {
 			str_ctx->status = -1;
 		}
@@ -39,11 +39,10 @@ bool tracing_format_string_put(const char *str, va_list args)
 #endif
 
 	if (str_ctx.status == 0) {
-		tracing_buffer_put_finish(str_ctx.length);
-		return true;
+		return tracing_format_raw_data_put(str_ctx.data,
+						   str_ctx.length);
 	}
 
-	tracing_buffer_put_finish(0);
 	return false;
 }
 
@@ -61,28 +60,21 @@ bool tracing_format_raw_data_put(u8_t *data, u32_t size)
 
 bool tracing_format_data_put(tracing_data_t *tracing_data_array, u32_t count)
 {
-	u32_t total_size = 0U;
+	tracing_ctx_t data_ctx = {0};
 
 	for (u32_t i = 0; i < count; i++) {
 		tracing_data_t *tracing_data =
 				tracing_data_array + i;
-		u8_t *data = tracing_data->data, *buf;
-		u32_t length = tracing_data->length, claimed_size;
-
-		do {
-			claimed_size = tracing_buffer_put_claim(&buf, length);
-			memcpy(buf, data, claimed_size);
-			total_size += claimed_size;
-			length -= claimed_size;
-			data += claimed_size;
-		} while (length && claimed_size);
-
-		if (length && claimed_size == 0) {
-			tracing_buffer_put_finish(0);
+
+		if (tracing_data->length >
+		    sizeof(data_ctx.data) - data_ctx.length) {
 			return false;
 		}
+
+		memcpy(&data_ctx.data[data_ctx.length], tracing_data->data,
+		       tracing_data->length);
+		data_ctx.length += tracing_data->length;
 	}
 
-	tracing_buffer_put_finish(total_size);
-	return true;
+	return tracing_format_raw_data_put(data_ctx.data, data_ctx.length);
 }
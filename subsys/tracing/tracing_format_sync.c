@@ -4,32 +4,27 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <kernel.h>
 #include <tracing_core.h>
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
 
 void tracing_format_string(const char *str, ...)
 {
-	u8_t *data;
 	va_list args;
 	bool put_success;
-	u32_t length, tracing_buffer_size;
 
 	if (!is_tracing_enabled()) {
 		return;
 	}
 
-	tracing_buffer_size = tracing_buffer_capacity_get();
-
 	va_start(args, str);
 
 	TRACING_LOCK();
 	put_success = tracing_format_string_put(str, args);
 
 	if (put_success) {
-		length = tracing_buffer_get_claim(&data, tracing_buffer_size);
-		tracing_buffer_handle(data, length);
-		tracing_buffer_get_finish(length);
+		tracing_buffer_output(tracing_cpu_id_get());
 	} else {
 		tracing_packet_drop_handle();
 	}
@@ -45,29 +40,25 @@ void tracing_format_raw_data(u8_t *data, u32_t length)
 	}
 
 	TRACING_LOCK();
+	tracing_packet_header_handle(tracing_cpu_id_get(), length,
+				     k_cycle_get_32());
 	tracing_buffer_handle(data, length);
 	TRACING_UNLOCK();
 }
 
 void tracing_format_data(tracing_data_t *tracing_data_array, u32_t count)
 {
-	u8_t *data;
 	bool put_success;
-	u32_t length, tracing_buffer_size;
 
 	if (!is_tracing_enabled()) {
 		return;
 	}
 
-	tracing_buffer_size = tracing_buffer_capacity_get();
-
 	TRACING_LOCK();
 	put_success = tracing_format_data_put(tracing_data_array, count);
 
 	if (put_success) {
-		length = tracing_buffer_get_claim(&data, tracing_buffer_size);
-		tracing_buffer_handle(data, length);
-		tracing_buffer_get_finish(length);
+		tracing_buffer_output(tracing_cpu_id_get());
 	} else {
 		tracing_packet_drop_handle();
 	}
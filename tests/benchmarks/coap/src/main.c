@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <net/coap.h>
+
+/* A server with N_OBJECTS * N_RESOURCES resources, receiving a mix of
+ * GET, PUT and POST requests spread over all of them. Every request is
+ * parsed, its options are looked up and it is dispatched to its
+ * resource, the results are average cycles per request for each step.
+ */
+
+#define ITERATIONS 10000
+#define N_OBJECTS 8
+#define N_RESOURCES 8
+#define N_REQUESTS 3
+#define MAX_OPTIONS 8
+#define PDU_SIZE 64
+
+static const char * const objects[N_OBJECTS] = {
+	"0", "1", "3", "4", "5", "3303", "3304", "3311",
+};
+
+static const char * const res_ids[N_RESOURCES] = {
+	"0", "1", "2", "3", "4", "5", "5700", "5701",
+};
+
+static const char *paths[N_OBJECTS * N_RESOURCES][4];
+static struct coap_resource resources[N_OBJECTS * N_RESOURCES + 1];
+
+static u8_t pdus[N_OBJECTS * N_RESOURCES][N_REQUESTS][PDU_SIZE];
+static u16_t pdu_lens[N_OBJECTS * N_RESOURCES][N_REQUESTS];
+
+static struct sockaddr_in6 peer = {
+	.sin6_family = AF_INET6,
+	.sin6_port = htons(5683),
+};
+
+static u32_t handled;
+
+static int method(struct coap_resource *resource,
+		  struct coap_packet *request,
+		  struct sockaddr *addr, socklen_t addr_len)
+{
+	handled++;
+
+	return 0;
+}
+
+static void setup_resources(void)
+{
+	int n = 0;
+
+	for (int i = 0; i < N_OBJECTS; i++) {
+		for (int j = 0; j < N_RESOURCES; j++, n++) {
+			paths[n][0] = objects[i];
+			paths[n][1] = "0";
+			paths[n][2] = res_ids[j];
+			paths[n][3] = NULL;
+
+			resources[n].path = paths[n];
+			resources[n].get = method;
+			resources[n].put = method;
+			resources[n].post = method;
+		}
+	}
+}
+
+static int append_path(struct coap_packet *cpkt, const char * const *path)
+{
+	int r;
+
+	for (; *path; path++) {
+		r = coap_packet_append_option(cpkt, COAP_OPTION_URI_PATH,
+					      *path, strlen(*path));
+		if (r < 0) {
+			return r;
+		}
+	}
+
+	return 0;
+}
+
+static int build_request(int res, int type)
+{
+	static const u8_t code[N_REQUESTS] = {
+		COAP_METHOD_GET, COAP_METHOD_PUT, COAP_METHOD_POST,
+	};
+	static u8_t payload[] = "22.5";
+	struct coap_packet cpkt;
+	u8_t token[4] = { 1, 2, 3, 4 };
+	int r;
+
+	r = coap_packet_init(&cpkt, pdus[res][type], PDU_SIZE, 1,
+			     COAP_TYPE_CON, sizeof(token), token, code[type],
+			     coap_next_id());
+	if (r < 0) {
+		return r;
+	}
+
+	switch (type) {
+	case 0:
+		r = coap_append_option_int(&cpkt, COAP_OPTION_OBSERVE, 0);
+		r = r ? r : append_path(&cpkt, paths[res]);
+		r = r ? r : coap_append_option_int(&cpkt, COAP_OPTION_ACCEPT,
+						   11542);
+		break;
+	case 1:
+		r = append_path(&cpkt, paths[res]);
+		r = r ? r : coap_append_option_int(&cpkt,
+						   COAP_OPTION_CONTENT_FORMAT,
+						   0);
+		r = r ? r : coap_packet_append_payload_marker(&cpkt);
+		r = r ? r : coap_packet_append_payload(&cpkt, payload,
+						       sizeof(payload) - 1);
+		break;
+	default:
+		r = append_path(&cpkt, paths[res]);
+		r = r ? r : coap_packet_append_option(&cpkt,
+						      COAP_OPTION_URI_QUERY,
+						      "pmin=10", 7);
+		r = r ? r : coap_packet_append_option(&cpkt,
+						      COAP_OPTION_URI_QUERY,
+						      "pmax=60", 7);
+		break;
+	}
+
+	pdu_lens[res][type] = cpkt.offset;
+
+	return r;
+}
+
+/* The options a LwM2M server looks at for each request */
+static void find_options(struct coap_packet *cpkt)
+{
+	struct coap_option options[MAX_OPTIONS];
+
+	coap_find_options(cpkt, COAP_OPTION_OBSERVE, options, 1);
+	coap_find_options(cpkt, COAP_OPTION_URI_PATH, options, MAX_OPTIONS);
+	coap_find_options(cpkt, COAP_OPTION_CONTENT_FORMAT, options, 1);
+	coap_find_options(cpkt, COAP_OPTION_ACCEPT, options, 1);
+	coap_find_options(cpkt, COAP_OPTION_URI_QUERY, options, MAX_OPTIONS);
+}
+
+void main(void)
+{
+	struct coap_option options[MAX_OPTIONS];
+	struct coap_packet cpkt;
+	u32_t parse = 0U, find = 0U, dispatch = 0U;
+	u32_t start, mid, end;
+	int res, type;
+
+	setup_resources();
+
+	for (res = 0; res < N_OBJECTS * N_RESOURCES; res++) {
+		for (type = 0; type < N_REQUESTS; type++) {
+			if (build_request(res, type) < 0) {
+				printk("Could not build request\n");
+				return;
+			}
+		}
+	}
+
+	handled = 0U;
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		/* Spread the requests over all resources and methods */
+		res = (i * 7) % (N_OBJECTS * N_RESOURCES);
+		type = i % N_REQUESTS;
+
+		start = k_cycle_get_32();
+		coap_packet_parse(&cpkt, pdus[res][type], pdu_lens[res][type],
+				  options, MAX_OPTIONS);
+		mid = k_cycle_get_32();
+		find_options(&cpkt);
+		end = k_cycle_get_32();
+		coap_handle_request(&cpkt, resources, options, MAX_OPTIONS,
+				    (struct sockaddr *)&peer, sizeof(peer));
+
+		parse += mid - start;
+		find += end - mid;
+		dispatch += k_cycle_get_32() - end;
+	}
+
+	if (handled != ITERATIONS) {
+		printk("Only %u of %u requests dispatched\n", handled,
+		       ITERATIONS);
+		return;
+	}
+
+	printk("%u resources\n", N_OBJECTS * N_RESOURCES);
+	printk("parse %6u cycles find options %6u cycles "
+	       "dispatch %6u cycles\n", parse / ITERATIONS,
+	       find / ITERATIONS, dispatch / ITERATIONS);
+
+	printk("fin\n");
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/crc.h>
+
+#define BUF_SIZE 4096
+#define N_RUNS 8
+
+static u8_t buf[BUF_SIZE];
+
+/* Keep the results alive so the computations are not optimized out */
+static volatile u32_t sink;
+
+enum {
+	CRC32_IEEE,
+	CRC16_CCITT,
+	CRC16_ITU_T,
+	CRC8_CCITT,
+	NUM_CRCS
+};
+
+static const char *const names[NUM_CRCS] = {
+	"crc32_ieee", "crc16_ccitt", "crc16_itu_t", "crc8_ccitt"
+};
+
+static u32_t run_crc(int crc)
+{
+	switch (crc) {
+	case CRC32_IEEE:
+		return crc32_ieee(buf, sizeof(buf));
+	case CRC16_CCITT:
+		return crc16_ccitt(0, buf, sizeof(buf));
+	case CRC16_ITU_T:
+		return crc16_itu_t(0, buf, sizeof(buf));
+	case CRC8_CCITT:
+		return crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, buf, sizeof(buf));
+	default:
+		return 0;
+	}
+}
+
+static const char *implementation(void)
+{
+	if (IS_ENABLED(CONFIG_CRC_SW_BITWISE)) {
+		return "bitwise";
+	} else if (IS_ENABLED(CONFIG_CRC_SW_BYTE_TABLE)) {
+		return "256 entry tables";
+	} else if (IS_ENABLED(CONFIG_CRC_SW_SLICE_BY_8)) {
+		return "slice-by-8";
+	} else {
+		return "16 entry tables";
+	}
+}
+
+void main(void)
+{
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = (u8_t)(i * 7 + (i >> 8));
+	}
+
+	printk("CRC benchmark, %s%s\n", implementation(),
+	       IS_ENABLED(CONFIG_CRC32_IEEE_ARCH) ?
+	       ", arch specific crc32_ieee" : "");
+
+	for (int crc = 0; crc < NUM_CRCS; crc++) {
+		u32_t best = UINT32_MAX;
+		u32_t bpc_milli;
+
+		for (int run = 0; run < N_RUNS; run++) {
+			u32_t start = k_cycle_get_32();
+
+			sink = run_crc(crc);
+			best = MIN(best, k_cycle_get_32() - start);
+		}
+
+		/* Bytes per cycle, in thousandths */
+		bpc_milli = best ? (u32_t)(((u64_t)BUF_SIZE * 1000U) / best) :
+			    0;
+
+		printk("%-12s %6u bytes %10u cycles %4u.%03u bytes/cycle\n",
+		       names[crc], BUF_SIZE, best, bpc_milli / 1000U,
+		       bpc_milli % 1000U);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <disk/disk_access.h>
+
+#define DISK_NAME "SLOW"
+#define RAM_DISK_NAME CONFIG_DISK_RAM_VOLUME_NAME
+#define SECTOR_SIZE 512
+
+/* Per command and per sector time of an SD card on a 25 MHz SPI bus */
+#define CMD_US 100
+#define SECTOR_US 170
+
+#define N_SECTORS 256
+#define DATA_START 64
+
+static u32_t disk_ops;
+static u8_t buf[SECTOR_SIZE];
+
+/* Forwards to the RAM disk after the time the transfer takes on a card.
+ * The RAM disk is not initialized through disk_access_init(), so that it
+ * is never cached itself.
+ */
+static int slow_read(struct disk_info *disk, u8_t *data_buf,
+		     u32_t start_sector, u32_t num_sector)
+{
+	disk_ops++;
+	k_busy_wait(CMD_US + num_sector * SECTOR_US);
+
+	return disk_access_read(RAM_DISK_NAME, data_buf, start_sector,
+				num_sector);
+}
+
+static int slow_write(struct disk_info *disk, const u8_t *data_buf,
+		      u32_t start_sector, u32_t num_sector)
+{
+	disk_ops++;
+	k_busy_wait(CMD_US + num_sector * SECTOR_US);
+
+	return disk_access_write(RAM_DISK_NAME, data_buf, start_sector,
+				 num_sector);
+}
+
+static int slow_ioctl(struct disk_info *disk, u8_t cmd, void *buff)
+{
+	return disk_access_ioctl(RAM_DISK_NAME, cmd, buff);
+}
+
+static int slow_init(struct disk_info *disk)
+{
+	return disk_access_status(RAM_DISK_NAME);
+}
+
+static int slow_status(struct disk_info *disk)
+{
+	return disk_access_status(RAM_DISK_NAME);
+}
+
+static const struct disk_operations slow_ops = {
+	.init = slow_init,
+	.status = slow_status,
+	.read = slow_read,
+	.write = slow_write,
+	.ioctl = slow_ioctl,
+};
+
+static struct disk_info slow_disk = {
+	.name = DISK_NAME,
+	.ops = &slow_ops,
+};
+
+static void report(const char *name, u32_t start, u32_t n_sectors)
+{
+	u32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	printk("%-10s %6u kB/s %4u disk ops\n", name,
+	       (u32_t)((u64_t)n_sectors * SECTOR_SIZE * 1000U / 1024U /
+		       MAX(us / 1000U, 1U)), disk_ops);
+}
+
+/* A file read one sector at a time */
+static void sequential(void)
+{
+	u32_t start = k_cycle_get_32();
+
+	disk_ops = 0U;
+
+	for (u32_t i = 0; i < N_SECTORS; i++) {
+		disk_access_read(DISK_NAME, buf, DATA_START + i, 1);
+	}
+
+	report("sequential", start, N_SECTORS);
+}
+
+/* A file read one cluster at a time, looking up each following cluster
+ * in the allocation table.
+ */
+static void fat_walk(void)
+{
+	u32_t start = k_cycle_get_32();
+
+	disk_ops = 0U;
+
+	for (u32_t i = 0; i < N_SECTORS; i++) {
+		disk_access_read(DISK_NAME, buf, 1 + i / (SECTOR_SIZE / 2), 1);
+		disk_access_read(DISK_NAME, buf, DATA_START + i, 1);
+	}
+
+	report("fat walk", start, 2 * N_SECTORS);
+}
+
+/* A file written one sector at a time, updating the allocation table */
+static void write(void)
+{
+	u32_t start = k_cycle_get_32();
+
+	disk_ops = 0U;
+
+	for (u32_t i = 0; i < N_SECTORS; i++) {
+		disk_access_write(DISK_NAME, buf, DATA_START + i, 1);
+		disk_access_write(DISK_NAME, buf, 1 + i / (SECTOR_SIZE / 2), 1);
+	}
+
+	disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+
+	report("write", start, 2 * N_SECTORS);
+}
+
+void main(void)
+{
+	if (disk_access_register(&slow_disk) ||
+	    disk_access_init(DISK_NAME)) {
+		printk("Disk setup failed\n");
+		return;
+	}
+
+	sequential();
+	fat_walk();
+	write();
+
+	printk("fin\n");
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <fs/fs.h>
+#include <fs/littlefs.h>
+#include <storage/flash_map.h>
+
+#define MNT_POINT "/lfs"
+#define FILE_NAME MNT_POINT "/records"
+
+#define RECORD_SIZE 32
+#define N_RECORDS 512
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)DT_FLASH_AREA_STORAGE_ID,
+	.mnt_point = MNT_POINT,
+};
+
+/* Buffer sizes, 0 opens the file unbuffered */
+static const size_t buf_sizes[] = { 0, 128, 512, 1024 };
+
+static u8_t record[RECORD_SIZE];
+
+static int open_file(struct fs_file_t *file, size_t buf_size)
+{
+	if (buf_size == 0) {
+		return fs_open(file, FILE_NAME);
+	}
+
+	return fs_open_buffered(file, FILE_NAME, buf_size);
+}
+
+static int append(size_t buf_size, u32_t *us)
+{
+	struct fs_file_t file;
+	u32_t start;
+	int rc;
+
+	rc = fs_unlink(FILE_NAME);
+	if (rc < 0 && rc != -ENOENT) {
+		return rc;
+	}
+
+	start = k_cycle_get_32();
+
+	rc = open_file(&file, buf_size);
+	if (rc < 0) {
+		return rc;
+	}
+
+	for (u32_t i = 0; i < N_RECORDS; i++) {
+		memset(record, i, sizeof(record));
+		rc = fs_write(&file, record, sizeof(record));
+		if (rc != sizeof(record)) {
+			(void)fs_close(&file);
+			return (rc < 0) ? rc : -ENOSPC;
+		}
+	}
+
+	rc = fs_close(&file);
+
+	*us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	return rc;
+}
+
+static int read_back(size_t buf_size, u32_t *us)
+{
+	struct fs_file_t file;
+	u32_t start;
+	int rc;
+
+	start = k_cycle_get_32();
+
+	rc = open_file(&file, buf_size);
+	if (rc < 0) {
+		return rc;
+	}
+
+	for (u32_t i = 0; i < N_RECORDS; i++) {
+		rc = fs_read(&file, record, sizeof(record));
+		if (rc != sizeof(record) || record[0] != (u8_t)i) {
+			(void)fs_close(&file);
+			return (rc < 0) ? rc : -EIO;
+		}
+	}
+
+	rc = fs_close(&file);
+
+	*us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	return rc;
+}
+
+void main(void)
+{
+	const struct flash_area *pfa;
+	u32_t append_us = 0U, read_us = 0U;
+	int rc;
+
+	/* Start from a freshly formatted file system */
+	rc = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &pfa);
+	if (rc == 0) {
+		rc = flash_area_erase(pfa, 0, pfa->fa_size);
+		flash_area_close(pfa);
+	}
+
+	if (rc < 0 || fs_mount(&lfs_mnt) < 0) {
+		printk("File system setup failed\n");
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(buf_sizes); i++) {
+		rc = append(buf_sizes[i], &append_us);
+		if (rc == 0) {
+			rc = read_back(buf_sizes[i], &read_us);
+		}
+
+		if (rc < 0) {
+			printk("Buffer size %zu failed (%d)\n", buf_sizes[i],
+			       rc);
+			return;
+		}
+
+		if (buf_sizes[i] == 0) {
+			printk("unbuffered     ");
+		} else {
+			printk("buffered %5zu ", buf_sizes[i]);
+		}
+
+		printk("append %8u us read %8u us\n", append_us, read_us);
+	}
+
+	fs_unmount(&lfs_mnt);
+
+	printk("fin\n");
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/util.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/gatt.h>
+#include <bluetooth/uuid.h>
+
+#define N_SERVICES 40
+#define READS_PER_HANDLE 10
+
+static u8_t value[4];
+
+static ssize_t read_value(struct bt_conn *conn,
+			  const struct bt_gatt_attr *attr, void *buf,
+			  u16_t len, u16_t offset)
+{
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, value,
+				 sizeof(value));
+}
+
+#define CHRC(_uuid)							\
+	BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_16(_uuid),		\
+			       BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,	\
+			       BT_GATT_PERM_READ, read_value, NULL, NULL)
+
+#define SERVICE_ATTRS(_n)						\
+	BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_16(0xfe00 + (_n))),	\
+	CHRC(0xff00 + (_n)),						\
+	CHRC(0xff80 + (_n)),						\
+	CHRC(0xffc0 + (_n)),						\
+	BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE)
+
+#define SERVICE_DEFINE(_n, _)						\
+	BT_GATT_SERVICE_DEFINE(bench_svc_##_n, SERVICE_ATTRS(_n));
+
+UTIL_LISTIFY(N_SERVICES, SERVICE_DEFINE, _)
+
+static struct bt_gatt_attr dyn_attrs[] = {
+	SERVICE_ATTRS(N_SERVICES)
+};
+
+static struct bt_gatt_service dyn_svc = BT_GATT_SERVICE(dyn_attrs);
+
+/* One ATT request, collecting up to count attributes */
+struct req {
+	u16_t next;
+	u8_t count;
+};
+
+static u8_t collect(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct req *req = user_data;
+
+	req->next = attr->handle + 1;
+
+	return --req->count ? BT_GATT_ITER_CONTINUE : BT_GATT_ITER_STOP;
+}
+
+static u8_t count_attr(const struct bt_gatt_attr *attr, void *user_data)
+{
+	u16_t *count = user_data;
+
+	(*count)++;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+/* Runs requests until the end of the database is reached, returns the
+ * average cycles per request.
+ */
+static u32_t discover(const struct bt_uuid *uuid, u8_t per_rsp,
+		      u32_t *n_reqs)
+{
+	u32_t start = k_cycle_get_32();
+	u16_t handle = 1U;
+	struct req req;
+
+	*n_reqs = 0U;
+
+	while (handle) {
+		req.next = 0U;
+		req.count = per_rsp;
+		bt_gatt_foreach_attr_type(handle, 0xffff, uuid, NULL, 0,
+					  collect, &req);
+		handle = req.next;
+		(*n_reqs)++;
+	}
+
+	return (k_cycle_get_32() - start) / *n_reqs;
+}
+
+static u32_t read_all(u16_t n_attrs, u32_t *n_reqs)
+{
+	u32_t start = k_cycle_get_32();
+	struct req req;
+
+	*n_reqs = 0U;
+
+	for (int i = 0; i < READS_PER_HANDLE; i++) {
+		for (u16_t handle = 1U; handle <= n_attrs; handle++) {
+			req.count = 1U;
+			bt_gatt_foreach_attr(handle, handle, collect, &req);
+			(*n_reqs)++;
+		}
+	}
+
+	return (k_cycle_get_32() - start) / *n_reqs;
+}
+
+void main(void)
+{
+	u16_t n_attrs = 0U;
+	u32_t cycles, n_reqs;
+	int err;
+
+	err = bt_gatt_service_register(&dyn_svc);
+	if (err) {
+		printk("Registering service failed (err %d)\n", err);
+		return;
+	}
+
+	bt_gatt_foreach_attr(0x0001, 0xffff, count_attr, &n_attrs);
+	printk("attributes %u\n", n_attrs);
+
+	cycles = discover(NULL, 4U, &n_reqs);
+	printk("find info    %4u requests %6u cycles each\n", n_reqs, cycles);
+
+	cycles = discover(BT_UUID_GATT_CHRC, 3U, &n_reqs);
+	printk("read by type %4u requests %6u cycles each\n", n_reqs, cycles);
+
+	cycles = discover(BT_UUID_GATT_CCC, 1U, &n_reqs);
+	printk("find ccc     %4u requests %6u cycles each\n", n_reqs, cycles);
+
+	cycles = read_all(n_attrs, &n_reqs);
+	printk("read         %4u requests %6u cycles each\n", n_reqs, cycles);
+
+	printk("fin\n");
+}
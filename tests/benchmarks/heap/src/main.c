@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This benchmark measures the k_malloc() heap with objects of 40 to
+ * 300 bytes, the typical size of network buffers and JSON nodes:
+ *
+ * 1. fill: objects are allocated until the heap is exhausted.
+ * 2. churn: a random half of the objects is freed and the heap is
+ *    filled again, N_ROUNDS times.
+ * 3. latency: with the heap about half full, random k_malloc(),
+ *    k_free() and growing k_realloc() calls are timed.
+ *
+ * Heap usage is reported as the bytes requested by the live objects
+ * against the heap size, latencies in cycles as average/worst.
+ */
+
+#define HEAP_SIZE CONFIG_HEAP_MEM_POOL_SIZE
+#define MIN_OBJ 40
+#define MAX_OBJ 300
+#define MAX_OBJS (HEAP_SIZE / MIN_OBJ)
+#define N_ROUNDS 50
+#define N_OPS 2000
+
+static struct {
+	void *mem;
+	size_t size;
+} objs[MAX_OBJS];
+
+static int n_objs;
+static size_t used;
+
+static u32_t rand_state = 1U;
+
+struct stat {
+	u32_t total;
+	u32_t worst;
+	u32_t count;
+};
+
+static u32_t pseudo_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+
+	return rand_state >> 16;
+}
+
+static size_t obj_size(void)
+{
+	return MIN_OBJ + pseudo_rand() % (MAX_OBJ - MIN_OBJ + 1);
+}
+
+static void stat_add(struct stat *s, u32_t cycles)
+{
+	s->total += cycles;
+	s->count++;
+	if (cycles > s->worst) {
+		s->worst = cycles;
+	}
+}
+
+static u32_t stat_avg(struct stat *s)
+{
+	return s->count ? s->total / s->count : 0;
+}
+
+static bool obj_alloc(struct stat *s)
+{
+	size_t size = obj_size();
+	u32_t start = k_cycle_get_32();
+	void *mem = k_malloc(size);
+
+	if (s != NULL) {
+		stat_add(s, k_cycle_get_32() - start);
+	}
+
+	if (mem == NULL || n_objs == MAX_OBJS) {
+		k_free(mem);
+		return false;
+	}
+
+	objs[n_objs].mem = mem;
+	objs[n_objs].size = size;
+	n_objs++;
+	used += size;
+
+	return true;
+}
+
+/* Frees a random object, the last one takes its place */
+static void obj_free(struct stat *s)
+{
+	int i = pseudo_rand() % n_objs;
+	u32_t start = k_cycle_get_32();
+
+	k_free(objs[i].mem);
+
+	if (s != NULL) {
+		stat_add(s, k_cycle_get_32() - start);
+	}
+
+	used -= objs[i].size;
+	objs[i] = objs[--n_objs];
+}
+
+static void obj_grow(struct stat *s)
+{
+	int i = pseudo_rand() % n_objs;
+	size_t size = objs[i].size + 1 + pseudo_rand() % 64;
+	u32_t start = k_cycle_get_32();
+	void *mem = k_realloc(objs[i].mem, size);
+
+	stat_add(s, k_cycle_get_32() - start);
+
+	if (mem != NULL) {
+		used += size - objs[i].size;
+		objs[i].mem = mem;
+		objs[i].size = size;
+	}
+}
+
+static void fill(void)
+{
+	while (obj_alloc(NULL)) {
+	}
+}
+
+static u32_t percent(size_t bytes)
+{
+	return bytes * 100U / HEAP_SIZE;
+}
+
+void main(void)
+{
+	struct stat malloc_stat = { 0 }, free_stat = { 0 };
+	struct stat realloc_stat = { 0 };
+	size_t round_used, total_used = 0, worst_used = HEAP_SIZE;
+	u32_t total_objs = 0;
+	int i;
+
+	fill();
+
+	printk("fill   allocs %4d used %5u/%u bytes (%3u%%)\n",
+	       n_objs, (u32_t)used, HEAP_SIZE, percent(used));
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		for (int n = n_objs / 2; n > 0; n--) {
+			obj_free(NULL);
+		}
+
+		fill();
+
+		round_used = used;
+		total_used += round_used;
+		total_objs += n_objs;
+		if (round_used < worst_used) {
+			worst_used = round_used;
+		}
+	}
+
+	printk("churn  allocs %4u used %5u/%u bytes (%3u%%, worst %3u%%)\n",
+	       total_objs / N_ROUNDS, (u32_t)(total_used / N_ROUNDS),
+	       HEAP_SIZE, percent(total_used / N_ROUNDS),
+	       percent(worst_used));
+
+	while (n_objs > 0 && used > HEAP_SIZE / 2) {
+		obj_free(NULL);
+	}
+
+	for (i = 0; i < N_OPS; i++) {
+		switch (pseudo_rand() % 3) {
+		case 0:
+			if (used < HEAP_SIZE / 2) {
+				obj_alloc(&malloc_stat);
+				break;
+			}
+			/* fall through */
+		case 1:
+			if (n_objs > 0) {
+				obj_free(&free_stat);
+			}
+			break;
+		default:
+			if (n_objs > 0 && used < HEAP_SIZE / 2) {
+				obj_grow(&realloc_stat);
+			}
+			break;
+		}
+	}
+
+	printk("malloc %5u/%5u free %5u/%5u realloc %5u/%5u\n",
+	       stat_avg(&malloc_stat), malloc_stat.worst,
+	       stat_avg(&free_stat), free_stat.worst,
+	       stat_avg(&realloc_stat), realloc_stat.worst);
+
+	while (n_objs > 0) {
+		obj_free(NULL);
+	}
+
+	printk("fin\n");
+}
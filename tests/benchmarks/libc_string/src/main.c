@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+
+/* Every function is called ITERATIONS times for each buffer size and
+ * alignment, the results are average cycles per call and throughput.
+ */
+
+#define ITERATIONS 1000
+#define MAX_SIZE 1024
+#define MOVE_DISTANCE 8
+#define BUF_SIZE (MAX_SIZE + MOVE_DISTANCE + 8)
+
+enum alignment {
+	ALIGNED,
+	SRC_OFFSET,
+	DST_OFFSET,
+	N_ALIGNMENTS,
+};
+
+static const char * const alignment_names[N_ALIGNMENTS] = {
+	"aligned", "src+1", "dst+1",
+};
+
+static const size_t sizes[] = { 16, 64, 256, 1024 };
+
+static u8_t buf1[BUF_SIZE] __aligned(8);
+static u8_t buf2[BUF_SIZE] __aligned(8);
+static volatile size_t sink;
+
+static void bench_memcpy(u8_t *dst, u8_t *src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+/* Overlapping, towards the end of the buffer */
+static void bench_memmove(u8_t *dst, u8_t *src, size_t n)
+{
+	memmove(src + MOVE_DISTANCE, src, n);
+}
+
+static void bench_memset(u8_t *dst, u8_t *src, size_t n)
+{
+	memset(dst, 0x5a, n);
+}
+
+static void bench_memcmp(u8_t *dst, u8_t *src, size_t n)
+{
+	sink = memcmp(dst, src, n);
+}
+
+static void bench_memchr(u8_t *dst, u8_t *src, size_t n)
+{
+	sink = (size_t)memchr(src, '\0', n);
+}
+
+static void bench_strlen(u8_t *dst, u8_t *src, size_t n)
+{
+	sink = strlen((char *)src);
+}
+
+static void bench_strcmp(u8_t *dst, u8_t *src, size_t n)
+{
+	sink = strcmp((char *)dst, (char *)src);
+}
+
+static const struct {
+	const char *name;
+	void (*fn)(u8_t *dst, u8_t *src, size_t n);
+	bool uses_dst;
+} benchmarks[] = {
+	{ "memcpy", bench_memcpy, true },
+	{ "memmove", bench_memmove, false },
+	{ "memset", bench_memset, true },
+	{ "memcmp", bench_memcmp, true },
+	{ "memchr", bench_memchr, false },
+	{ "strlen", bench_strlen, false },
+	{ "strcmp", bench_strcmp, true },
+};
+
+/* Equal strings of n characters in both buffers, so that comparisons
+ * and scans go through all of them.
+ */
+static void setup(u8_t *dst, u8_t *src, size_t n)
+{
+	for (int i = 0; i < BUF_SIZE; i++) {
+		buf1[i] = 'a' + i % 26;
+		buf2[i] = 'a' + i % 26;
+	}
+
+	memcpy(dst, src, n);
+	dst[n] = '\0';
+	src[n] = '\0';
+}
+
+void main(void)
+{
+	u32_t start, cycles;
+	u8_t *dst, *src;
+	int b, s, a;
+
+	for (b = 0; b < ARRAY_SIZE(benchmarks); b++) {
+		int n_alignments = benchmarks[b].uses_dst ? N_ALIGNMENTS :
+				   DST_OFFSET;
+
+		for (s = 0; s < ARRAY_SIZE(sizes); s++) {
+			for (a = 0; a < n_alignments; a++) {
+				dst = &buf1[a == DST_OFFSET];
+				src = &buf2[a == SRC_OFFSET];
+				setup(dst, src, sizes[s]);
+
+				start = k_cycle_get_32();
+				for (int i = 0; i < ITERATIONS; i++) {
+					benchmarks[b].fn(dst, src, sizes[s]);
+					compiler_barrier();
+				}
+				cycles = (k_cycle_get_32() - start) /
+					 ITERATIONS;
+
+				printk("%-8s %4u %-7s %6u cycles %6u "
+				       "bytes/kcycle\n", benchmarks[b].name,
+				       (u32_t)sizes[s], alignment_names[a],
+				       cycles,
+				       (u32_t)(sizes[s] * 1000U /
+					       MAX(cycles, 1U)));
+			}
+		}
+	}
+
+	printk("fin\n");
+}
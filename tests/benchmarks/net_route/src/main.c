@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "nbr.h"
+#include "route.h"
+
+/* A router with N_NEIGHBORS neighbors, N_HOSTS host routes and N_PREFIXES
+ * /64 prefix routes through them. Packets to destinations spread over all
+ * routes are forwarded the way the IPv6 input path does it, the results
+ * are average cycles per packet for the route lookup and for the
+ * forwarding to the nexthop.
+ */
+
+#define ITERATIONS 10000
+#define N_NEIGHBORS 32
+#define N_HOSTS 96
+#define N_PREFIXES 32
+#define N_ROUTES (N_HOSTS + N_PREFIXES)
+
+static struct in6_addr neighbors[N_NEIGHBORS];
+static u8_t neighbor_ll[N_NEIGHBORS][6];
+static struct in6_addr dests[N_ROUTES];
+static struct in6_addr src_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0xff, 0xff,
+					0, 0, 0, 0, 0, 0, 0, 0, 0, 1 } } };
+
+static struct net_if *iface;
+static u32_t sent;
+
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	sent++;
+
+	return 0;
+}
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	static u8_t mac[6] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_route_bench, "net_route_bench", bench_dev_init, NULL,
+		NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+/* Route i goes through neighbor i % N_NEIGHBORS. Host routes are in
+ * 2001:db8:1::/64, prefix routes are 2001:db8:100+i::/64 and the
+ * destination used for them is host ::i in the prefix.
+ */
+static struct in6_addr *route_nexthop(int i)
+{
+	return &neighbors[i % N_NEIGHBORS];
+}
+
+static int setup_routes(void)
+{
+	struct net_linkaddr lladdr = {
+		.len = 6U,
+		.type = NET_LINK_DUMMY,
+	};
+	struct in6_addr prefix;
+	int i;
+
+	for (i = 0; i < N_NEIGHBORS; i++) {
+		net_ipv6_addr_create(&neighbors[i], 0xfe80, 0, 0, 0,
+				     0x0200, 0x5eff, 0xfe00, 0x5300 + i);
+		neighbor_ll[i][0] = 0x02;
+		neighbor_ll[i][5] = i + 1;
+		lladdr.addr = neighbor_ll[i];
+
+		if (!net_ipv6_nbr_add(iface, &neighbors[i], &lladdr, false,
+				      NET_IPV6_NBR_STATE_REACHABLE)) {
+			return -ENOMEM;
+		}
+	}
+
+	/* Host routes first, adding a route replaces a covering route
+	 * with a different nexthop.
+	 */
+	for (i = 0; i < N_HOSTS; i++) {
+		net_ipv6_addr_create(&dests[i], 0x2001, 0xdb8, 1, 0,
+				     0, 0, 0x1000 + i, i + 1);
+
+		if (!net_route_add(iface, &dests[i], 128, route_nexthop(i))) {
+			return -ENOMEM;
+		}
+	}
+
+	for (; i < N_ROUTES; i++) {
+		net_ipv6_addr_create(&prefix, 0x2001, 0xdb8, 0x100 + i, 0,
+				     0, 0, 0, 0);
+		net_ipv6_addr_create(&dests[i], 0x2001, 0xdb8, 0x100 + i, 0,
+				     0, 0, 0, i);
+
+		if (!net_route_add(iface, &prefix, 64, route_nexthop(i))) {
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+static struct net_pkt *create_pkt(struct in6_addr *dst)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, 0, AF_INET6, 0, K_MSEC(100));
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (net_ipv6_create(pkt, &src_addr, dst)) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+void main(void)
+{
+	u32_t lookup = 0U, forward = 0U;
+	struct net_route_entry *route;
+	struct in6_addr *nexthop;
+	u32_t start, mid;
+	struct net_pkt *pkt;
+	bool found;
+	int i, r;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	if (setup_routes() < 0) {
+		printk("Could not add routes\n");
+		return;
+	}
+
+	for (i = 0; i < ITERATIONS; i++) {
+		/* Spread the packets over all routes */
+		r = (i * 7) % N_ROUTES;
+
+		pkt = create_pkt(&dests[r]);
+		if (!pkt) {
+			printk("Could not create packet\n");
+			return;
+		}
+
+		start = k_cycle_get_32();
+		found = net_route_get_info(net_pkt_iface(pkt), &dests[r],
+					   &route, &nexthop);
+		mid = k_cycle_get_32();
+
+		if (!found || !net_ipv6_addr_cmp(nexthop, route_nexthop(r))) {
+			printk("Wrong nexthop for route %d\n", r);
+			net_pkt_unref(pkt);
+			return;
+		}
+
+		lookup += mid - start;
+
+		start = k_cycle_get_32();
+		if (net_route_packet(pkt, nexthop) < 0) {
+			printk("Could not forward packet\n");
+			net_pkt_unref(pkt);
+			return;
+		}
+
+		forward += k_cycle_get_32() - start;
+	}
+
+	/* Let the TX thread send the last packets */
+	k_sleep(K_MSEC(10));
+
+	if (sent != ITERATIONS) {
+		printk("Only %u of %u packets sent\n", sent, ITERATIONS);
+		return;
+	}
+
+	printk("%d neighbors %d routes\n", N_NEIGHBORS, N_ROUTES);
+	printk("lookup %6u cycles forward %6u cycles\n", lookup / ITERATIONS,
+	       forward / ITERATIONS);
+
+	printk("fin\n");
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+
+/* This benchmark compares the locked ring buffer, as used between an
+ * ISR and a thread, with the lock-free SPSC and MPSC ring buffers.
+ * Every iteration writes one chunk or record and reads it back, the
+ * results are average cycles per iteration.
+ */
+
+#define ITERATIONS 10000
+#define RECORD_WORDS 4
+
+static const u32_t chunk_sizes[] = { 1, 4, 16, 64 };
+
+RING_BUF_DECLARE(locked_buf, 1024);
+RING_BUF_SPSC_DECLARE_POW2(spsc_buf, 10);
+RING_BUF_ITEM_DECLARE_POW2(item_buf, 8);
+RING_BUF_MPSC_DECLARE_POW2(mpsc_buf, RECORD_WORDS * sizeof(u32_t), 6);
+
+static u8_t in[64];
+static u8_t out[64];
+
+static u32_t bytes_locked(u32_t size)
+{
+	u32_t start = k_cycle_get_32();
+	unsigned int key;
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		key = irq_lock();
+		ring_buf_put(&locked_buf, in, size);
+		irq_unlock(key);
+
+		key = irq_lock();
+		ring_buf_get(&locked_buf, out, size);
+		irq_unlock(key);
+	}
+
+	return (k_cycle_get_32() - start) / ITERATIONS;
+}
+
+static u32_t bytes_spsc(u32_t size)
+{
+	u32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		ring_buf_spsc_put(&spsc_buf, in, size);
+		ring_buf_spsc_get(&spsc_buf, out, size);
+	}
+
+	return (k_cycle_get_32() - start) / ITERATIONS;
+}
+
+static u32_t bytes_spsc_claim(u32_t size)
+{
+	u32_t start = k_cycle_get_32();
+	u8_t *data;
+	u32_t len;
+
+	/* The producer fills the ring buffer in place, the consumer
+	 * checksums it in place, as a driver and its user would.
+	 */
+	for (int i = 0; i < ITERATIONS; i++) {
+		len = ring_buf_spsc_put_claim(&spsc_buf, &data, size);
+		(void)memset(data, i, len);
+		ring_buf_spsc_put_commit(&spsc_buf, len);
+
+		len = ring_buf_spsc_get_claim(&spsc_buf, &data, size);
+		for (u32_t j = 0; j < len; j++) {
+			out[0] += data[j];
+		}
+		ring_buf_spsc_get_commit(&spsc_buf, len);
+	}
+
+	return (k_cycle_get_32() - start) / ITERATIONS;
+}
+
+static u32_t records_locked(void)
+{
+	u32_t record[RECORD_WORDS] = { 0 };
+	u32_t start = k_cycle_get_32();
+	unsigned int key;
+	u16_t type;
+	u8_t value;
+	u8_t size32;
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		key = irq_lock();
+		ring_buf_item_put(&item_buf, 1, 2, record, RECORD_WORDS);
+		irq_unlock(key);
+
+		size32 = RECORD_WORDS;
+		key = irq_lock();
+		ring_buf_item_get(&item_buf, &type, &value, record, &size32);
+		irq_unlock(key);
+	}
+
+	return (k_cycle_get_32() - start) / ITERATIONS;
+}
+
+static u32_t records_mpsc(void)
+{
+	u32_t record[RECORD_WORDS] = { 0 };
+	u32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		ring_buf_mpsc_put(&mpsc_buf, record);
+		ring_buf_mpsc_get(&mpsc_buf, record);
+	}
+
+	return (k_cycle_get_32() - start) / ITERATIONS;
+}
+
+static u32_t records_mpsc_claim(void)
+{
+	u32_t start = k_cycle_get_32();
+	u32_t *record;
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		record = ring_buf_mpsc_put_claim(&mpsc_buf);
+		record[0] = i;
+		ring_buf_mpsc_put_commit(&mpsc_buf, record);
+
+		record = ring_buf_mpsc_get_claim(&mpsc_buf);
+		out[0] += record[0];
+		ring_buf_mpsc_get_commit(&mpsc_buf);
+	}
+
+	return (k_cycle_get_32() - start) / ITERATIONS;
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+		u32_t size = chunk_sizes[i];
+
+		printk("bytes   chunk %3u locked %5u spsc %5u "
+		       "spsc claim %5u\n", size, bytes_locked(size),
+		       bytes_spsc(size), bytes_spsc_claim(size));
+	}
+
+	printk("records %3u bytes locked %5u mpsc %5u mpsc claim %5u\n",
+	       (u32_t)(RECORD_WORDS * sizeof(u32_t)), records_locked(),
+	       records_mpsc(), records_mpsc_claim());
+
+	printk("fin\n");
+}
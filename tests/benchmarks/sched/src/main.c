@@ -58,6 +58,38 @@ enum {
 
 u32_t stamps[NUM_STAMP_STATES];
 
+/* Multi-core context switch throughput: one pair of threads per CPU
+ * hands a token back and forth through two semaphores, every handoff
+ * blocking the giver and switching to its partner.  With SMP the pairs
+ * run concurrently, so the total switch rate shows how well the
+ * scheduler scales with the number of CPUs.
+ */
+#define N_PAIRS CONFIG_MP_NUM_CPUS
+#define N_SWITCHES 10000
+#define PAIR_STACK_SIZE 1024
+
+static K_THREAD_STACK_ARRAY_DEFINE(pair_stacks, 2 * N_PAIRS, PAIR_STACK_SIZE);
+static struct k_thread pair_threads[2 * N_PAIRS];
+static struct k_sem pair_sems[2 * N_PAIRS];
+static struct k_sem pairs_done;
+
+/* Ready queue scaling: the unpend/ready/switch/pend cycle is repeated
+ * with an increasing number of lower priority "filler" threads sitting
+ * in the ready queue, spread over all lower priorities.  They never
+ * run, but every scheduling decision has to look past them, which
+ * shows how each backend (SCHED_DUMB, SCHED_SCALABLE, SCHED_MULTIQ)
+ * scales with the number of ready threads.
+ */
+#define N_FILLERS 500
+#define FILLER_STACK_SIZE 512
+
+static const int filler_counts[] = { 10, 50, 100, 200, 500 };
+
+static K_THREAD_STACK_ARRAY_DEFINE(filler_stacks, N_FILLERS,
+				   FILLER_STACK_SIZE);
+static struct k_thread filler_threads[N_FILLERS];
+static atomic_t fillers_done;
+
 static inline int _stamp(int state)
 {
 	u32_t t;
@@ -95,23 +127,75 @@ static void partner_fn(void *arg1, void *arg2, void *arg3)
 	}
 }
 
-void main(void)
+static void pair_fn(void *arg1, void *arg2, void *arg3)
 {
-	z_waitq_init(&waitq);
+	int idx = POINTER_TO_INT(arg1);
+	struct k_sem *mine = &pair_sems[idx];
+	struct k_sem *partner = &pair_sems[idx ^ 1];
 
-	int main_prio = k_thread_priority_get(k_current_get());
-	int partner_prio = main_prio - 1;
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
 
-	k_tid_t th = k_thread_create(&partner_thread, partner_stack,
-				     K_THREAD_STACK_SIZEOF(partner_stack),
-				     partner_fn, NULL, NULL, NULL,
-				     partner_prio, 0, K_NO_WAIT);
+	for (int i = 0; i < N_SWITCHES / 2; i++) {
+		k_sem_take(mine, K_FOREVER);
+		k_sem_give(partner);
+	}
 
-	/* Let it start running and pend */
-	k_sleep(K_MSEC(100));
+	k_sem_give(&pairs_done);
+}
+
+static void switch_throughput(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	u32_t start, cycles;
+	int i;
+
+	k_sem_init(&pairs_done, 0, 2 * N_PAIRS);
+
+	for (i = 0; i < 2 * N_PAIRS; i++) {
+		/* The first thread of each pair holds the token */
+		k_sem_init(&pair_sems[i], (i & 1) ? 0 : 1, 1);
+		k_thread_create(&pair_threads[i], pair_stacks[i],
+				K_THREAD_STACK_SIZEOF(pair_stacks[i]),
+				pair_fn, INT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_FOREVER);
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < 2 * N_PAIRS; i++) {
+		k_thread_start(&pair_threads[i]);
+	}
+
+	for (i = 0; i < 2 * N_PAIRS; i++) {
+		k_sem_take(&pairs_done, K_FOREVER);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	printk("smp pairs %d switches %d cycles %u (%u per switch)\n",
+	       N_PAIRS, N_PAIRS * N_SWITCHES, cycles,
+	       cycles / (N_PAIRS * N_SWITCHES));
+}
+
+static void filler_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	atomic_inc(&fillers_done);
+}
 
+/* Runs the unpend/ready/switch/pend cycle N_RUNS times after N_SETTLE
+ * warmup runs and returns the average cycle count of a whole cycle,
+ * optionally printing the latencies of every step.
+ */
+static u32_t partner_cycles(k_tid_t th, bool verbose)
+{
 	u64_t tot = 0U;
 	u32_t runs = 0U;
+	u32_t avg = 0U;
 
 	for (int i = 0; i < N_RUNS + N_SETTLE; i++) {
 		stamp(UNPENDING);
@@ -129,7 +213,7 @@ void main(void)
 		k_yield();
 		stamp(YIELDED);
 
-		u32_t avg, whole = stamps[4] - stamps[0];
+		u32_t whole = stamps[4] - stamps[0];
 
 		if (++runs > N_SETTLE) {
 			/* Only compute averages after the first ~10
@@ -144,6 +228,10 @@ void main(void)
 			avg = 0U;
 		}
 
+		if (!verbose) {
+			continue;
+		}
+
 		/* For reference, an unmodified HEAD on qemu_x86 with
 		 * !USERSPACE and SCHED_DUMB and using -icount
 		 * shift=0,sleep=off,align=off, I get results of:
@@ -157,5 +245,56 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+	return avg;
+}
+
+static void ready_queue_scaling(k_tid_t th)
+{
+	int main_prio = k_thread_priority_get(k_current_get());
+	int n_prios = K_LOWEST_APPLICATION_THREAD_PRIO - main_prio;
+	int n = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(filler_counts); i++) {
+		for (; n < filler_counts[i]; n++) {
+			k_thread_create(&filler_threads[n], filler_stacks[n],
+					K_THREAD_STACK_SIZEOF(filler_stacks[n]),
+					filler_fn, NULL, NULL, NULL,
+					main_prio + 1 + n % n_prios, 0,
+					K_NO_WAIT);
+		}
+
+		printk("ready threads %3d avg %4u\n", n,
+		       partner_cycles(th, false));
+	}
+
+	/* Let them all run to completion */
+	while (atomic_get(&fillers_done) < n) {
+		k_sleep(K_MSEC(10));
+	}
+}
+
+void main(void)
+{
+	z_waitq_init(&waitq);
+
+	int main_prio = k_thread_priority_get(k_current_get());
+	int partner_prio = main_prio - 1;
+
+	k_tid_t th = k_thread_create(&partner_thread, partner_stack,
+				     K_THREAD_STACK_SIZEOF(partner_stack),
+				     partner_fn, NULL, NULL, NULL,
+				     partner_prio, 0, K_NO_WAIT);
+
+	/* Let it start running and pend */
+	k_sleep(K_MSEC(100));
+
+	partner_cycles(th, true);
+
+	ready_queue_scaling(th);
+
+	switch_throughput();
+
 	printk("fin\n");
 }
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <stdio.h>
+#include <settings/settings.h>
+#include <stats/stats.h>
+
+/* Number of keys stored after each step of the benchmark */
+static const u16_t key_steps[] = { 16, 32, 64, 128 };
+
+static u32_t loaded_keys;
+static u32_t *flash_read_calls;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	u32_t val;
+
+	if (read_cb(cb_arg, &val, sizeof(val)) == sizeof(val)) {
+		loaded_keys++;
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL, NULL);
+
+#ifdef CONFIG_FLASH_SIMULATOR
+static int flash_read_calls_find(struct stats_hdr *hdr, void *arg,
+				 const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		flash_read_calls = (u32_t *)((u8_t *)hdr + off);
+	}
+
+	return 0;
+}
+#endif
+
+static inline u32_t flash_reads(void)
+{
+	return flash_read_calls ? *flash_read_calls : 0;
+}
+
+static void save_key(u16_t key, u32_t val)
+{
+	char name[16];
+	int rc;
+
+	snprintf(name, sizeof(name), "bench/k%03u", key);
+
+	rc = settings_save_one(name, &val, sizeof(val));
+	if (rc) {
+		printk("settings_save_one(%s) failed: %d\n", name, rc);
+		k_panic();
+	}
+}
+
+static void delete_key(u16_t key)
+{
+	char name[16];
+
+	snprintf(name, sizeof(name), "bench/k%03u", key);
+	(void)settings_delete(name);
+}
+
+void main(void)
+{
+	u32_t start, new_cyc, upd_cyc, load_cyc;
+	u32_t new_rd, upd_rd, load_rd;
+	u16_t keys = 0U;
+	int rc;
+
+	rc = settings_subsys_init();
+	if (rc) {
+		printk("settings_subsys_init failed: %d\n", rc);
+		return;
+	}
+
+#ifdef CONFIG_FLASH_SIMULATOR
+	stats_walk(stats_group_find("flash_sim_stats"), flash_read_calls_find,
+		   NULL);
+#endif
+
+	printk("settings NVS benchmark, name cache %s\n",
+	       IS_ENABLED(CONFIG_SETTINGS_NVS_NAME_CACHE) ?
+	       "enabled" : "disabled");
+
+	/* Start from an empty set of keys, flash may hold a previous run */
+	(void)settings_load();
+	for (u16_t i = 0; i < key_steps[ARRAY_SIZE(key_steps) - 1]; i++) {
+		delete_key(i);
+	}
+
+	for (int step = 0; step < ARRAY_SIZE(key_steps); step++) {
+		u16_t added = key_steps[step] - keys;
+
+		new_rd = flash_reads();
+		start = k_cycle_get_32();
+		for (; keys < key_steps[step]; keys++) {
+			save_key(keys, keys);
+		}
+		new_cyc = (k_cycle_get_32() - start) / added;
+		new_rd = (flash_reads() - new_rd) / added;
+
+		upd_rd = flash_reads();
+		start = k_cycle_get_32();
+		for (u16_t i = 0; i < keys; i++) {
+			save_key(i, i + step + 1);
+		}
+		upd_cyc = (k_cycle_get_32() - start) / keys;
+		upd_rd = (flash_reads() - upd_rd) / keys;
+
+		loaded_keys = 0U;
+		load_rd = flash_reads();
+		start = k_cycle_get_32();
+		(void)settings_load();
+		load_cyc = k_cycle_get_32() - start;
+		load_rd = flash_reads() - load_rd;
+
+		if (loaded_keys != keys) {
+			printk("loaded %u keys, expected %u\n", loaded_keys,
+			       keys);
+		}
+
+		printk("keys %4u new %8u update %8u load %10u (cycles)\n",
+		       keys, new_cyc, upd_cyc, load_cyc);
+		if (flash_read_calls) {
+			printk("keys %4u new %8u update %8u load %10u "
+			       "(flash reads)\n",
+			       keys, new_rd, upd_rd, load_rd);
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* This benchmark measures the kernel timeout queue with an increasing
+ * number of pending timeouts.  The pending timeouts expire far in the
+ * future, in random order, and are never reached.  At each step:
+ *
+ * 1. Timeouts expiring after all pending ones are added, and random
+ *    pending timeouts are aborted and added again, timing each
+ *    z_add_timeout() and z_abort_timeout() call with interrupts locked.
+ * 2. A batch of probe timeouts expiring on the next tick is added. The
+ *    probe handlers record a timestamp, the difference between two
+ *    consecutive handlers is the time z_clock_announce() needs to take
+ *    the next expired timeout off the queue.
+ *
+ * Results are reported in cycles as average/worst.
+ */
+
+#define MAX_PENDING 1000
+#define N_OPS 16
+#define N_PROBES 16
+
+#define FAR_TICKS (60 * CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+
+static const int pending_counts[] = { 10, 100, 250, 500, 1000 };
+
+static struct _timeout pending[MAX_PENDING];
+static struct _timeout late[N_OPS];
+static struct _timeout probes[N_PROBES];
+
+static u32_t probe_stamps[N_PROBES];
+static volatile int probes_fired;
+
+static u32_t rand_state = 1U;
+
+struct stat {
+	u32_t total;
+	u32_t worst;
+	u32_t count;
+};
+
+static u32_t pseudo_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+
+	return rand_state >> 16;
+}
+
+static void stat_add(struct stat *s, u32_t cycles)
+{
+	s->total += cycles;
+	s->count++;
+	if (cycles > s->worst) {
+		s->worst = cycles;
+	}
+}
+
+static u32_t stat_avg(struct stat *s)
+{
+	return s->count ? s->total / s->count : 0;
+}
+
+static void pending_expired(struct _timeout *t)
+{
+	printk("ERROR: pending timeout %p expired\n", t);
+}
+
+static void probe_expired(struct _timeout *t)
+{
+	probe_stamps[probes_fired++] = k_cycle_get_32();
+}
+
+static s32_t pending_ticks(void)
+{
+	return FAR_TICKS + pseudo_rand() % (4 * MAX_PENDING);
+}
+
+static void timed_add(struct stat *s, struct _timeout *t,
+		      _timeout_func_t fn, s32_t ticks)
+{
+	unsigned int key = irq_lock();
+	u32_t start = k_cycle_get_32();
+
+	z_add_timeout(t, fn, ticks);
+	stat_add(s, k_cycle_get_32() - start);
+
+	irq_unlock(key);
+}
+
+static void timed_abort(struct stat *s, struct _timeout *t)
+{
+	unsigned int key = irq_lock();
+	u32_t start = k_cycle_get_32();
+
+	z_abort_timeout(t);
+	stat_add(s, k_cycle_get_32() - start);
+
+	irq_unlock(key);
+}
+
+static void measure(int count)
+{
+	struct stat insert = { 0 }, abort = { 0 }, announce = { 0 };
+	unsigned int key;
+	int i, idx;
+
+	for (i = 0; i < N_OPS; i++) {
+		timed_add(&insert, &late[i], pending_expired,
+			  FAR_TICKS + 8 * MAX_PENDING + i);
+
+		idx = pseudo_rand() % count;
+		timed_abort(&abort, &pending[idx]);
+		timed_add(&insert, &pending[idx], pending_expired,
+			  pending_ticks());
+	}
+
+	for (i = 0; i < N_OPS; i++) {
+		z_abort_timeout(&late[i]);
+	}
+
+	probes_fired = 0;
+
+	key = irq_lock();
+	for (i = 0; i < N_PROBES; i++) {
+		z_add_timeout(&probes[i], probe_expired, 1);
+	}
+	irq_unlock(key);
+
+	while (probes_fired < N_PROBES) {
+		k_sleep(K_MSEC(10));
+	}
+
+	for (i = 1; i < N_PROBES; i++) {
+		stat_add(&announce, probe_stamps[i] - probe_stamps[i - 1]);
+	}
+
+	printk("pending %4d insert %5u/%5u abort %5u/%5u "
+	       "announce %5u/%5u\n", count,
+	       stat_avg(&insert), insert.worst,
+	       stat_avg(&abort), abort.worst,
+	       stat_avg(&announce), announce.worst);
+}
+
+void main(void)
+{
+	int added = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(pending); i++) {
+		z_init_timeout(&pending[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(late); i++) {
+		z_init_timeout(&late[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(probes); i++) {
+		z_init_timeout(&probes[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(pending_counts); i++) {
+		while (added < pending_counts[i]) {
+			z_add_timeout(&pending[added], pending_expired,
+				      pending_ticks());
+			added++;
+		}
+
+		measure(pending_counts[i]);
+	}
+
+	for (i = 0; i < added; i++) {
+		z_abort_timeout(&pending[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
+#include <tracing_backend.h>
+
+/* This benchmark measures the cycles a CTF event costs the traced code,
+ * with tracing disabled, enabled and with a full tracing buffer. Events
+ * are traced in batches that fit the tracing buffer, which is emptied
+ * by the tracing thread between them.
+ */
+
+#define BATCHES 100
+#define BATCH_EVENTS 32
+
+static u32_t output_packets;
+static u32_t output_bytes;
+
+static void custom_init(void)
+{
+}
+
+static void custom_output(const struct tracing_backend *backend,
+			  u8_t *data, u32_t length)
+{
+	if (length == sizeof(struct tracing_packet_header)) {
+		output_packets++;
+	}
+
+	output_bytes += length;
+}
+
+const struct tracing_backend_api tracing_backend_custom_api = {
+	.init = custom_init,
+	.output = custom_output
+};
+
+TRACING_BACKEND_DEFINE(tracing_backend_custom, tracing_backend_custom_api);
+
+static void tracing_set(const char *cmd)
+{
+	tracing_cmd_handle((u8_t *)cmd, strlen(cmd));
+}
+
+/* Context switches add events of their own, so rather than until the
+ * buffer is empty, wait until it has room for more than a batch.
+ */
+static void wait_output(void)
+{
+	while (tracing_buffer_space_get() < tracing_buffer_capacity_get() / 2) {
+		k_sleep(K_MSEC(1));
+	}
+}
+
+static u32_t batch(void)
+{
+	u32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BATCH_EVENTS; i++) {
+		sys_trace_void(SYS_TRACE_ID_SEMA_GIVE);
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static u32_t events_disabled(void)
+{
+	u32_t cycles = 0U;
+
+	tracing_set("disable");
+	for (int i = 0; i < BATCHES; i++) {
+		cycles += batch();
+	}
+	tracing_set("enable");
+
+	return cycles / (BATCHES * BATCH_EVENTS);
+}
+
+static u32_t events_enabled(void)
+{
+	u32_t cycles = 0U;
+
+	for (int i = 0; i < BATCHES; i++) {
+		wait_output();
+		cycles += batch();
+	}
+
+	return cycles / (BATCHES * BATCH_EVENTS);
+}
+
+static u32_t events_dropped(void)
+{
+	u32_t cycles = 0U;
+
+	/* The tracing thread has the lowest priority, it does not empty
+	 * the buffer of this CPU until this thread sleeps.
+	 */
+	wait_output();
+	while (tracing_buffer_space_get() > CONFIG_TRACING_PACKET_MAX_SIZE) {
+		batch();
+	}
+
+	for (int i = 0; i < BATCHES; i++) {
+		cycles += batch();
+	}
+
+	return cycles / (BATCHES * BATCH_EVENTS);
+}
+
+void main(void)
+{
+	printk("event cycles disabled %5u enabled %5u dropped %5u\n",
+	       events_disabled(), events_enabled(), events_dropped());
+
+	k_sleep(K_MSEC(10));
+	printk("packets %5u bytes %7u\n", output_packets, output_bytes);
+
+	printk("fin\n");
+}
@@ -22,6 +22,11 @@ static struct bt_uuid_128 test_chrc_uuid = BT_UUID_INIT_128(
 	0xf2, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
 	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
 
+/* Characteristic declaration UUID on the Bluetooth Base UUID */
+static const struct bt_uuid_128 chrc_uuid128 = BT_UUID_INIT_128(
+	0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+	0x00, 0x10, 0x00, 0x00, 0x03, 0x28, 0x00, 0x00);
+
 static u8_t test_value[] = { 'T', 'e', 's', 't', '\0' };
 
 static struct bt_uuid_128 test1_uuid = BT_UUID_INIT_128(
@@ -202,6 +207,13 @@ void test_gatt_foreach(void)
 				  BT_UUID_GATT_CHRC, NULL, 0, count_attr, &num);
 	zassert_equal(num, 2, "Number of attributes don't match");
 
+	/* Find all characteristics by their 128-bit UUID */
+	num = 0;
+	bt_gatt_foreach_attr_type(test_attrs[0].handle, 0xffff,
+				  &chrc_uuid128.uuid, NULL, 0, count_attr,
+				  &num);
+	zassert_equal(num, 2, "Number of attributes don't match");
+
 	/* Find 1 characteristic */
 	attr = NULL;
 	bt_gatt_foreach_attr_type(test_attrs[0].handle, 0xffff,
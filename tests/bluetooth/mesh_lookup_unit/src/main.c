@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+void test_msg_cache_cluster(void);
+void test_msg_cache_wrap(void);
+void test_msg_cache_remove(void);
+void test_rpl_find(void);
+void test_rpl_reindex(void);
+void test_rpl_stale_slot(void);
+void test_rpl_replay(void);
+
+void test_main(void)
+{
+	ztest_test_suite(mesh_lookup,
+			 ztest_unit_test(test_msg_cache_cluster),
+			 ztest_unit_test(test_msg_cache_wrap),
+			 ztest_unit_test(test_msg_cache_remove),
+			 ztest_unit_test(test_rpl_find),
+			 ztest_unit_test(test_rpl_reindex),
+			 ztest_unit_test(test_rpl_stale_slot),
+			 ztest_unit_test(test_rpl_replay));
+	ztest_run_test_suite(mesh_lookup);
+}
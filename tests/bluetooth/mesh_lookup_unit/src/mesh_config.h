@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define CONFIG_BT_MESH 1
+#define CONFIG_BT_MESH_MSG_CACHE_SIZE 8
+#define CONFIG_BT_MESH_CRPL 8
+#define CONFIG_BT_MESH_SUBNET_COUNT 1
+#define CONFIG_BT_MESH_APP_KEY_COUNT 1
+#define CONFIG_BT_MESH_MODEL_KEY_COUNT 1
+#define CONFIG_BT_MESH_MODEL_GROUP_COUNT 1
+#define CONFIG_BT_MESH_ADV_BUF_COUNT 6
+#define CONFIG_BT_MESH_IVU_DIVIDER 4
+#define CONFIG_BT_MESH_TX_SEG_MAX 3
+#define CONFIG_BT_MESH_TX_SEG_MSG_COUNT 1
+#define CONFIG_BT_MESH_RX_SEG_MSG_COUNT 1
+#define CONFIG_BT_MESH_RX_SDU_MAX 36
+#define CONFIG_BT_LOG_LEVEL 1
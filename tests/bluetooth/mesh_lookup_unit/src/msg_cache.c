@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <ztest.h>
+
+#include "mesh_config.h"
+#include "mesh/net.c"
+
+/*
+ * Unit test of the network message cache hash table, see msg_cache_add(),
+ * msg_cache_remove() and msg_cache_find(). Hashes are picked by their
+ * home slot in the table to build clusters of colliding entries, some
+ * wrapping around the end of the table, and the table is checked after
+ * every change.
+ */
+
+#define TABLE_SIZE ARRAY_SIZE(msg_cache_table)
+#define CACHE_SIZE CONFIG_BT_MESH_MSG_CACHE_SIZE
+
+/* Get the n-th hash, counting from 0, that has the given home slot */
+static u64_t hash_at(u32_t slot, u32_t n)
+{
+	u64_t hash;
+
+	for (hash = 1U;; hash++) {
+		if (msg_cache_slot(hash) == slot && n-- == 0U) {
+			return hash;
+		}
+	}
+}
+
+/* Every entry must be reachable from its home slot without crossing an
+ * empty slot, and every cached hash must have exactly one entry.
+ */
+static void check_table(void)
+{
+	u32_t entries = 0U, cached = 0U;
+	u32_t i, j;
+
+	for (i = 0U; i < TABLE_SIZE; i++) {
+		if (!msg_cache_table[i]) {
+			continue;
+		}
+
+		zassert_true(msg_cache_table[i] <= CACHE_SIZE, "bad entry");
+		entries++;
+
+		for (j = msg_cache_slot(msg_cache[msg_cache_table[i] - 1]);
+		     j != i; j = (j + 1) % TABLE_SIZE) {
+			zassert_true(msg_cache_table[j],
+				     "hole between slot %u and entry at %u",
+				     j, i);
+		}
+	}
+
+	for (i = 0U; i < CACHE_SIZE; i++) {
+		if (msg_cache[i]) {
+			zassert_true(msg_cache_find(msg_cache[i]),
+				     "cached hash %u not found", i);
+			cached++;
+		}
+	}
+
+	zassert_equal(entries, cached, "table and ring differ");
+}
+
+/* Add the hashes one by one, checking that only the last CACHE_SIZE of
+ * them are found.
+ */
+static void add_and_check(const u64_t *hashes, u32_t count)
+{
+	u32_t i, j;
+
+	for (i = 0U; i < count; i++) {
+		zassert_false(msg_cache_find(hashes[i]), "not added yet");
+		msg_cache_add(hashes[i]);
+		check_table();
+
+		for (j = 0U; j <= i; j++) {
+			zassert_equal(msg_cache_find(hashes[j]),
+				      i - j < CACHE_SIZE,
+				      "hash %u wrong after adding %u", j, i);
+		}
+	}
+}
+
+void test_msg_cache_cluster(void)
+{
+	u64_t hashes[3 * CACHE_SIZE];
+	u32_t i;
+
+	msg_cache_clear();
+
+	/* The cache is filled with one cluster, the others have to be
+	 * shifted back when the entry at its home slot is replaced by one
+	 * with another home slot.
+	 */
+	for (i = 0U; i < ARRAY_SIZE(hashes); i++) {
+		hashes[i] = hash_at(i < CACHE_SIZE ? 3 : TABLE_SIZE - 4, i);
+	}
+
+	add_and_check(hashes, ARRAY_SIZE(hashes));
+}
+
+void test_msg_cache_wrap(void)
+{
+	u64_t hashes[4 * CACHE_SIZE];
+	u32_t i;
+
+	msg_cache_clear();
+
+	/* Clusters at the end and the start of the table run into each
+	 * other and wrap around.
+	 */
+	for (i = 0U; i < ARRAY_SIZE(hashes); i++) {
+		switch (i % 3) {
+		case 0:
+			hashes[i] = hash_at(TABLE_SIZE - 1, i);
+			break;
+		case 1:
+			hashes[i] = hash_at(0, i);
+			break;
+		default:
+			hashes[i] = hash_at(TABLE_SIZE - 2, i);
+			break;
+		}
+	}
+
+	add_and_check(hashes, ARRAY_SIZE(hashes));
+}
+
+void test_msg_cache_remove(void)
+{
+	u64_t hashes[3];
+	u16_t idx[3];
+	u32_t i;
+
+	msg_cache_clear();
+
+	for (i = 0U; i < ARRAY_SIZE(hashes); i++) {
+		hashes[i] = hash_at(TABLE_SIZE - 1, i);
+		idx[i] = msg_cache_add(hashes[i]);
+	}
+
+	/* The rejected message is the last added one */
+	msg_cache_remove(idx[2]);
+	check_table();
+	zassert_true(msg_cache_find(hashes[0]), "first lost");
+	zassert_true(msg_cache_find(hashes[1]), "second lost");
+	zassert_false(msg_cache_find(hashes[2]), "removed still found");
+
+	/* Its entry is reused */
+	zassert_equal(msg_cache_add(hashes[2]), idx[2], "entry not reused");
+	check_table();
+	zassert_true(msg_cache_find(hashes[2]), "added again not found");
+
+	/* Removing from the middle of the cluster keeps the others */
+	msg_cache_remove(idx[0]);
+	check_table();
+	zassert_false(msg_cache_find(hashes[0]), "removed still found");
+	zassert_true(msg_cache_find(hashes[1]), "second lost");
+	zassert_true(msg_cache_find(hashes[2]), "third lost");
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <ztest.h>
+
+#include "mesh_config.h"
+#include "mesh/transport.c"
+
+/*
+ * Unit test of the replay protection list index, see bt_mesh_rpl_find(),
+ * bt_mesh_rpl_alloc(), bt_mesh_rpl_reindex() and is_replay(). Source
+ * addresses are picked by their home slot in the index so that they
+ * collide.
+ */
+
+/* Get the n-th unicast address, counting from 0, with the given slot */
+static u16_t src_at(u32_t slot, u32_t n)
+{
+	u16_t src;
+
+	for (src = 1U; src < 0x8000; src++) {
+		if (rpl_slot(src) == slot && n-- == 0U) {
+			return src;
+		}
+	}
+
+	zassert_unreachable("no address for slot %u", slot);
+	return 0;
+}
+
+static void fill_rpl(u16_t *srcs)
+{
+	u32_t i;
+
+	bt_mesh_rpl_clear();
+
+	for (i = 0U; i < CONFIG_BT_MESH_CRPL; i++) {
+		srcs[i] = src_at(ARRAY_SIZE(rpl_index) - 1, i);
+		zassert_not_null(bt_mesh_rpl_alloc(srcs[i]), "RPL full");
+	}
+}
+
+static void check_found(const u16_t *srcs, u32_t count)
+{
+	struct bt_mesh_rpl *rpl;
+	u32_t i;
+
+	for (i = 0U; i < count; i++) {
+		rpl = bt_mesh_rpl_find(srcs[i]);
+		zassert_not_null(rpl, "source %u not found", i);
+		zassert_equal(rpl->src, srcs[i], "wrong entry");
+	}
+}
+
+void test_rpl_find(void)
+{
+	u16_t srcs[CONFIG_BT_MESH_CRPL];
+
+	fill_rpl(srcs);
+	check_found(srcs, ARRAY_SIZE(srcs));
+
+	zassert_is_null(bt_mesh_rpl_find(src_at(ARRAY_SIZE(rpl_index) - 1,
+						CONFIG_BT_MESH_CRPL)),
+			"unknown source found");
+	zassert_is_null(bt_mesh_rpl_alloc(0x7fff), "allocated when full");
+
+	bt_mesh_rpl_clear();
+	zassert_is_null(bt_mesh_rpl_find(srcs[0]), "found after clear");
+}
+
+void test_rpl_reindex(void)
+{
+	u16_t srcs[CONFIG_BT_MESH_CRPL];
+	u16_t src;
+
+	fill_rpl(srcs);
+
+	/* Remove entries as bt_mesh_rpl_reset() does */
+	bt_mesh.rpl[0].src = 0U;
+	bt_mesh.rpl[2].src = 0U;
+	bt_mesh_rpl_reindex();
+
+	zassert_is_null(bt_mesh_rpl_find(srcs[0]), "removed found");
+	zassert_is_null(bt_mesh_rpl_find(srcs[2]), "removed found");
+	check_found(&srcs[3], ARRAY_SIZE(srcs) - 3);
+	check_found(&srcs[1], 1);
+
+	src = src_at(ARRAY_SIZE(rpl_index) - 1, CONFIG_BT_MESH_CRPL);
+	zassert_equal(bt_mesh_rpl_alloc(src), &bt_mesh.rpl[0],
+		      "free entry not reused");
+	check_found(&src, 1);
+	check_found(&srcs[3], ARRAY_SIZE(srcs) - 3);
+}
+
+void test_rpl_stale_slot(void)
+{
+	u16_t srcs[CONFIG_BT_MESH_CRPL];
+	u16_t src;
+
+	fill_rpl(srcs);
+
+	/* An entry removed without reindexing leaves a stale slot, which
+	 * lookups must skip and a new entry may take over.
+	 */
+	bt_mesh.rpl[1].src = 0U;
+	check_found(&srcs[2], ARRAY_SIZE(srcs) - 2);
+
+	src = src_at(ARRAY_SIZE(rpl_index) - 1, CONFIG_BT_MESH_CRPL);
+	zassert_equal(bt_mesh_rpl_alloc(src), &bt_mesh.rpl[1],
+		      "free entry not reused");
+	check_found(&src, 1);
+	check_found(&srcs[0], 1);
+	check_found(&srcs[2], ARRAY_SIZE(srcs) - 2);
+}
+
+void test_rpl_replay(void)
+{
+	struct bt_mesh_net_rx rx = {
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = 1,
+		.seq = 10,
+	};
+	u32_t i;
+
+	bt_mesh_rpl_clear();
+
+	for (i = 0U; i < CONFIG_BT_MESH_CRPL; i++) {
+		rx.ctx.addr = src_at(0, i);
+		zassert_false(is_replay(&rx, NULL), "new source replayed");
+	}
+
+	for (i = 0U; i < CONFIG_BT_MESH_CRPL; i++) {
+		rx.ctx.addr = src_at(0, i);
+		rx.seq = 10;
+		zassert_true(is_replay(&rx, NULL), "replay not detected");
+		rx.seq = 11;
+		zassert_false(is_replay(&rx, NULL), "newer seq replayed");
+		zassert_true(is_replay(&rx, NULL), "replay not detected");
+	}
+
+	/* No room for another source */
+	rx.ctx.addr = src_at(0, CONFIG_BT_MESH_CRPL);
+	zassert_true(is_replay(&rx, NULL), "accepted with full RPL");
+}
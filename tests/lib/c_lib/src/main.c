@@ -293,6 +293,129 @@ void test_memcmp(void)
 	zassert_true((ret != 0), "memcmp 5");
 }
 
+/* Buffers of the alignment tests, with room for all offsets and lengths
+ * and guard bytes around the copies.
+ */
+#define ALIGN_MAX_OFFSET 8
+#define ALIGN_MAX_LEN 40
+#define ALIGN_BUFSIZE (2 * ALIGN_MAX_OFFSET + ALIGN_MAX_LEN)
+
+static unsigned char align_src[ALIGN_BUFSIZE] __aligned(8);
+static unsigned char align_dst[ALIGN_BUFSIZE] __aligned(8);
+static unsigned char align_ref[ALIGN_BUFSIZE] __aligned(8);
+
+static void align_fill(void)
+{
+	for (int i = 0; i < ALIGN_BUFSIZE; i++) {
+		align_src[i] = i + 1;
+		align_dst[i] = 0xee;
+		align_ref[i] = 0xee;
+	}
+}
+
+static void align_copy_ref(int d_off, const unsigned char *src, int n)
+{
+	for (int i = 0; i < n; i++) {
+		align_ref[d_off + i] = src[i];
+	}
+}
+
+/**
+ *
+ * @brief Test memory copy for all source and destination alignments
+ *
+ */
+
+void test_memcpy_align(void)
+{
+	for (int so = 0; so < ALIGN_MAX_OFFSET; so++) {
+		for (int d_off = 0; d_off < ALIGN_MAX_OFFSET; d_off++) {
+			for (int n = 0; n <= ALIGN_MAX_LEN; n++) {
+				align_fill();
+				align_copy_ref(d_off, &align_src[so], n);
+
+				zassert_equal_ptr(memcpy(&align_dst[d_off],
+							 &align_src[so], n),
+						  &align_dst[d_off], "memcpy");
+				zassert_mem_equal(align_dst, align_ref,
+						  ALIGN_BUFSIZE,
+						  "memcpy %d from %d to %d",
+						  n, so, d_off);
+			}
+		}
+	}
+}
+
+/**
+ *
+ * @brief Test overlapping memory moves in both directions
+ *
+ */
+
+void test_memmove_align(void)
+{
+	for (int so = 0; so < 2 * ALIGN_MAX_OFFSET; so++) {
+		for (int d_off = 0; d_off < 2 * ALIGN_MAX_OFFSET; d_off++) {
+			for (int n = 0; n <= ALIGN_MAX_LEN; n++) {
+				align_fill();
+				memcpy(align_ref, align_src, ALIGN_BUFSIZE);
+				align_copy_ref(d_off, &align_src[so], n);
+
+				memmove(&align_src[d_off], &align_src[so], n);
+				zassert_mem_equal(align_src, align_ref,
+						  ALIGN_BUFSIZE,
+						  "memmove %d from %d to %d",
+						  n, so, d_off);
+			}
+		}
+	}
+}
+
+/**
+ *
+ * @brief Test string and memory scanning for all alignments
+ *
+ */
+
+void test_str_align(void)
+{
+	char *s1 = (char *)align_src;
+	char *s2 = (char *)align_dst;
+
+	for (int so = 0; so < ALIGN_MAX_OFFSET; so++) {
+		for (int n = 0; n <= ALIGN_MAX_LEN; n++) {
+			align_fill();
+			align_src[so + n] = '\0';
+
+			zassert_equal(strlen(&s1[so]), n, "strlen %d at %d",
+				      n, so);
+			zassert_equal_ptr(memchr(&s1[so], 0, ALIGN_MAX_LEN + 1),
+					  &s1[so + n], "memchr %d at %d",
+					  n, so);
+			zassert_is_null(memchr(&s1[so], 0, n),
+					"memchr %d at %d", n, so);
+
+			for (int d_off = 0; d_off < ALIGN_MAX_OFFSET; d_off++) {
+				memcpy(&s2[d_off], &s1[so], n + 1);
+				zassert_equal(strcmp(&s1[so], &s2[d_off]), 0,
+					      "strcmp %d", n);
+				zassert_equal(memcmp(&s1[so], &s2[d_off], n), 0,
+					      "memcmp %d", n);
+
+				if (n == 0) {
+					continue;
+				}
+
+				s2[d_off + n - 1]++;
+				zassert_true(strcmp(&s1[so], &s2[d_off]) < 0,
+					     "strcmp %d", n);
+				zassert_true(memcmp(&s1[so], &s2[d_off], n) < 0,
+					     "memcmp %d", n);
+			}
+		}
+	}
+}
+
 /**
  *
  * @brief Test binary search function
@@ -335,6 +458,9 @@ void test_main(void)
 			 ztest_unit_test(test_strlen),
 			 ztest_unit_test(test_strcmp),
 			 ztest_unit_test(test_strxspn),
+			 ztest_unit_test(test_memcpy_align),
+			 ztest_unit_test(test_memmove_align),
+			 ztest_unit_test(test_str_align),
 			 ztest_unit_test(test_bsearch)
 			 );
 	ztest_run_test_suite(test_c_lib);
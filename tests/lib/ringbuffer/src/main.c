@@ -34,6 +34,8 @@ LOG_MODULE_REGISTER(test);
  *   -# ring_buf_space_get
  *   -# ring_buf_item_put
  *   -# ring_buf_item_get
+ *   -# ring_buf_spsc_put/get and claim/commit
+ *   -# ring_buf_mpsc_put/get and claim/commit
  * @}
  */
 
@@ -443,6 +445,179 @@ void test_reset(void)
 	zassert_true(granted == RINGBUFFER_SIZE - 1, NULL);
 }
 
+RING_BUF_SPSC_DECLARE_POW2(spsc_buf, 6);
+
+static void spsc_isr_put(void *p)
+{
+	u8_t data[] = { 4, 5, 6, 7 };
+
+	zassert_equal(ring_buf_spsc_put(&spsc_buf, data, sizeof(data)),
+		      sizeof(data), NULL);
+}
+
+void test_spsc_put_get(void)
+{
+	u8_t indata[BIT(6) + 8];
+	u8_t outdata[BIT(6) + 8];
+	u8_t *claimed;
+	u32_t len;
+
+	for (int i = 0; i < sizeof(indata); i++) {
+		indata[i] = i;
+	}
+
+	zassert_equal(ring_buf_spsc_space_get(&spsc_buf), BIT(6), NULL);
+
+	/* All bytes of the buffer can be used */
+	zassert_equal(ring_buf_spsc_put(&spsc_buf, indata, sizeof(indata)),
+		      BIT(6), NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc_buf), 0, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc_buf, outdata, 10), 10, NULL);
+	zassert_mem_equal(outdata, indata, 10, NULL);
+
+	/* Data written across the end of the buffer reads back in order */
+	zassert_equal(ring_buf_spsc_put(&spsc_buf, &indata[BIT(6)], 8), 8,
+		      NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc_buf, outdata, sizeof(outdata)),
+		      BIT(6) - 2, NULL);
+	zassert_mem_equal(outdata, &indata[10], BIT(6) - 2, NULL);
+	zassert_equal(ring_buf_spsc_used_get(&spsc_buf), 0, NULL);
+
+	/* Claims are contiguous and stop at the end of the buffer */
+	len = ring_buf_spsc_put_claim(&spsc_buf, &claimed, BIT(6));
+	zassert_equal(len, BIT(6) - 8, NULL);
+	zassert_equal(ring_buf_spsc_put_claim(&spsc_buf, &claimed, BIT(6)),
+		      len, "claiming again must return the same area");
+	(void)memset(claimed, 0xaa, len);
+	zassert_equal(ring_buf_spsc_put_commit(&spsc_buf, BIT(6) + 1),
+		      -EINVAL, NULL);
+	zassert_equal(ring_buf_spsc_put_commit(&spsc_buf, len), 0, NULL);
+
+	/* An ISR producer feeding a thread consumer */
+	irq_offload(spsc_isr_put, NULL);
+
+	len = ring_buf_spsc_get_claim(&spsc_buf, &claimed, BIT(6));
+	zassert_equal(len, BIT(6) - 8, NULL);
+	zassert_equal(claimed[0], 0xaa, NULL);
+	zassert_equal(ring_buf_spsc_get_commit(&spsc_buf, BIT(6)), -EINVAL,
+		      NULL);
+	zassert_equal(ring_buf_spsc_get_commit(&spsc_buf, len), 0, NULL);
+
+	len = ring_buf_spsc_get_claim(&spsc_buf, &claimed, BIT(6));
+	zassert_equal(len, 4, NULL);
+	zassert_equal(claimed[0], 4, NULL);
+	zassert_equal(claimed[3], 7, NULL);
+	zassert_equal(ring_buf_spsc_get_commit(&spsc_buf, len), 0, NULL);
+	zassert_equal(ring_buf_spsc_used_get(&spsc_buf), 0, NULL);
+}
+
+#define MPSC_RECORDS 4
+
+struct mpsc_record {
+	u32_t id;
+	u16_t value;
+};
+
+RING_BUF_MPSC_DECLARE_POW2(mpsc_buf, sizeof(struct mpsc_record), 2);
+
+static void mpsc_isr_put(void *p)
+{
+	struct mpsc_record rec = { .id = POINTER_TO_UINT(p), .value = 0xbeef };
+
+	zassert_equal(ring_buf_mpsc_put(&mpsc_buf, &rec), 0, NULL);
+}
+
+void test_mpsc_put_get(void)
+{
+	struct mpsc_record rec, *claimed;
+	u32_t id;
+
+	zassert_equal(ring_buf_mpsc_get(&mpsc_buf, &rec), -EAGAIN, NULL);
+
+	for (id = 0; id < MPSC_RECORDS; id++) {
+		rec.id = id;
+		zassert_equal(ring_buf_mpsc_put(&mpsc_buf, &rec), 0, NULL);
+	}
+	zassert_is_null(ring_buf_mpsc_put_claim(&mpsc_buf), "not full");
+
+	for (id = 0; id < MPSC_RECORDS; id++) {
+		zassert_equal(ring_buf_mpsc_get(&mpsc_buf, &rec), 0, NULL);
+		zassert_equal(rec.id, id, NULL);
+	}
+	zassert_equal(ring_buf_mpsc_get(&mpsc_buf, &rec), -EAGAIN, NULL);
+
+	/* A record reserved by a thread that gets preempted by an ISR
+	 * producer holds back the ISR's record until it is committed.
+	 */
+	claimed = ring_buf_mpsc_put_claim(&mpsc_buf);
+	zassert_not_null(claimed, NULL);
+
+	irq_offload(mpsc_isr_put, UINT_TO_POINTER(100));
+	zassert_is_null(ring_buf_mpsc_get_claim(&mpsc_buf), NULL);
+
+	claimed->id = 99;
+	ring_buf_mpsc_put_commit(&mpsc_buf, claimed);
+
+	claimed = ring_buf_mpsc_get_claim(&mpsc_buf);
+	zassert_not_null(claimed, NULL);
+	zassert_equal(claimed->id, 99, NULL);
+	zassert_equal_ptr(ring_buf_mpsc_get_claim(&mpsc_buf), claimed,
+			  "claiming again must return the same record");
+	ring_buf_mpsc_get_commit(&mpsc_buf);
+
+	zassert_equal(ring_buf_mpsc_get(&mpsc_buf, &rec), 0, NULL);
+	zassert_equal(rec.id, 100, NULL);
+	zassert_equal(rec.value, 0xbeef, NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc_buf, &rec), -EAGAIN, NULL);
+}
+
+#define STREAM_SIZE 4096
+#define STREAM_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_DEFINE(producer_stack, STREAM_STACK_SIZE);
+static struct k_thread producer_thread;
+
+static void spsc_producer(void *p1, void *p2, void *p3)
+{
+	u32_t sent = 0;
+	u8_t *data;
+	u32_t len;
+
+	while (sent < STREAM_SIZE) {
+		len = ring_buf_spsc_put_claim(&spsc_buf, &data, 7);
+		for (u32_t i = 0; i < len; i++) {
+			data[i] = (u8_t)(sent + i);
+		}
+		ring_buf_spsc_put_commit(&spsc_buf, len);
+		sent += len;
+		k_yield();
+	}
+}
+
+void test_spsc_stream(void)
+{
+	u32_t received = 0;
+	u8_t data[5];
+	u32_t len;
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_create(&producer_thread, producer_stack,
+			K_THREAD_STACK_SIZEOF(producer_stack), spsc_producer,
+			NULL, NULL, NULL, prio, 0, K_NO_WAIT);
+
+	while (received < STREAM_SIZE) {
+		len = ring_buf_spsc_get(&spsc_buf, data, sizeof(data));
+		for (u32_t i = 0; i < len; i++) {
+			zassert_equal(data[i], (u8_t)(received + i),
+				      "wrong byte at %u", received + i);
+		}
+		received += len;
+		k_yield();
+	}
+
+	k_thread_abort(&producer_thread);
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -461,7 +636,10 @@ void test_main(void)
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_capacity),
-			 ztest_unit_test(test_reset)
+			 ztest_unit_test(test_reset),
+			 ztest_unit_test(test_spsc_put_get),
+			 ztest_unit_test(test_spsc_stream),
+			 ztest_unit_test(test_mpsc_put_get)
 			 );
 	ztest_run_test_suite(test_ringbuffer_api);
 }
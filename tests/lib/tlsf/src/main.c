@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/tlsf.h>
+
+#define HEAP_SIZE	8192
+#define N_SLOTS		64
+#define N_OPS		4000
+
+static char __aligned(8) heap_mem[HEAP_SIZE];
+static struct sys_tlsf heap;
+
+static struct {
+	u8_t *mem;
+	size_t size;
+	u8_t fill;
+} slots[N_SLOTS];
+
+static u32_t rand_state = 1U;
+
+static u32_t pseudo_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+
+	return rand_state >> 16;
+}
+
+static void slot_fill(int i)
+{
+	(void)memset(slots[i].mem, slots[i].fill, slots[i].size);
+}
+
+static void slot_check(int i, size_t size)
+{
+	for (size_t j = 0; j < size; j++) {
+		zassert_equal(slots[i].mem[j], slots[i].fill,
+			      "slot %d corrupted at %u", i, (u32_t)j);
+	}
+}
+
+static void test_tlsf_alloc_free(void)
+{
+	struct sys_tlsf_stats initial, stats;
+	void *a, *b, *c;
+
+	sys_tlsf_init(&heap, heap_mem, sizeof(heap_mem));
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+
+	sys_tlsf_stats_get(&heap, &initial);
+	zassert_equal(initial.allocated_bytes, 0, NULL);
+	zassert_equal(initial.free_bytes, initial.max_free_block, NULL);
+	zassert_true(initial.free_bytes > HEAP_SIZE * 3 / 4,
+		     "too much control overhead");
+
+	zassert_is_null(sys_tlsf_alloc(&heap, 0), NULL);
+	zassert_is_null(sys_tlsf_alloc(&heap, HEAP_SIZE), NULL);
+
+	a = sys_tlsf_alloc(&heap, 1);
+	b = sys_tlsf_alloc(&heap, 100);
+	c = sys_tlsf_alloc(&heap, 1000);
+	zassert_not_null(a, NULL);
+	zassert_not_null(b, NULL);
+	zassert_not_null(c, NULL);
+	zassert_false((uintptr_t)a % (2 * sizeof(void *)), NULL);
+	zassert_false((uintptr_t)b % (2 * sizeof(void *)), NULL);
+	zassert_false((uintptr_t)c % (2 * sizeof(void *)), NULL);
+	zassert_true(sys_tlsf_owns(&heap, a), NULL);
+	zassert_false(sys_tlsf_owns(&heap, &heap), NULL);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+
+	/* Small allocations only round up to two words plus the header */
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_true(stats.allocated_bytes <= 1101 + 3 * 4 * sizeof(void *),
+		     "allocated %u bytes", (u32_t)stats.allocated_bytes);
+
+	/* Freeing in any order merges everything back into one block */
+	sys_tlsf_free(&heap, b);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+	sys_tlsf_free(&heap, a);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+	sys_tlsf_free(&heap, c);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+	sys_tlsf_free(&heap, NULL);
+
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_equal(stats.free_bytes, initial.free_bytes, NULL);
+	zassert_equal(stats.max_free_block, initial.max_free_block, NULL);
+
+	/* Exhausting the heap with small blocks uses all of it */
+	for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+		slots[i].mem = sys_tlsf_alloc(&heap, HEAP_SIZE / N_SLOTS / 2);
+		zassert_not_null(slots[i].mem, NULL);
+	}
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+	for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+		sys_tlsf_free(&heap, slots[i].mem);
+		slots[i].mem = NULL;
+	}
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+}
+
+static void test_tlsf_realloc(void)
+{
+	u8_t *a, *b, *moved;
+
+	sys_tlsf_init(&heap, heap_mem, sizeof(heap_mem));
+
+	a = sys_tlsf_realloc(&heap, NULL, 64);
+	zassert_not_null(a, NULL);
+	b = sys_tlsf_alloc(&heap, 64);
+	zassert_not_null(b, NULL);
+	(void)memset(a, 0xa5, 64);
+
+	/* Shrinking is done in place */
+	zassert_equal_ptr(sys_tlsf_realloc(&heap, a, 16), a, NULL);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+
+	/* Growing into the space just released is done in place too */
+	zassert_equal_ptr(sys_tlsf_realloc(&heap, a, 40), a, NULL);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+
+	/* Growing past the next allocation moves the contents */
+	moved = sys_tlsf_realloc(&heap, a, 512);
+	zassert_not_null(moved, NULL);
+	zassert_not_equal(moved, a, NULL);
+	for (int i = 0; i < 16; i++) {
+		zassert_equal(moved[i], 0xa5, NULL);
+	}
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+
+	/* A failing realloc leaves the memory untouched */
+	zassert_is_null(sys_tlsf_realloc(&heap, moved, HEAP_SIZE), NULL);
+	zassert_equal(moved[0], 0xa5, NULL);
+
+	/* The free rest of the heap follows the moved allocation, so it
+	 * grows in place.
+	 */
+	zassert_equal_ptr(sys_tlsf_realloc(&heap, moved, 2048), moved, NULL);
+	zassert_equal(moved[15], 0xa5, NULL);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+
+	zassert_is_null(sys_tlsf_realloc(&heap, b, 0), NULL);
+	sys_tlsf_free(&heap, moved);
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+}
+
+static void test_tlsf_random(void)
+{
+	struct sys_tlsf_stats initial, stats;
+	int i;
+
+	sys_tlsf_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_tlsf_stats_get(&heap, &initial);
+	(void)memset(slots, 0, sizeof(slots));
+
+	for (int op = 0; op < N_OPS; op++) {
+		size_t size = 1 + pseudo_rand() % 300;
+		void *mem;
+
+		i = pseudo_rand() % N_SLOTS;
+
+		if (slots[i].mem == NULL) {
+			slots[i].mem = sys_tlsf_alloc(&heap, size);
+			if (slots[i].mem != NULL) {
+				slots[i].size = size;
+				slots[i].fill = op;
+				slot_fill(i);
+			}
+		} else if (pseudo_rand() % 2) {
+			slot_check(i, slots[i].size);
+			mem = sys_tlsf_realloc(&heap, slots[i].mem, size);
+			if (mem != NULL) {
+				slots[i].mem = mem;
+				slot_check(i, MIN(size, slots[i].size));
+				slots[i].size = size;
+				slot_fill(i);
+			}
+		} else {
+			slot_check(i, slots[i].size);
+			sys_tlsf_free(&heap, slots[i].mem);
+			slots[i].mem = NULL;
+		}
+
+		zassert_true(sys_tlsf_validate(&heap), "invalid at op %d", op);
+	}
+
+	for (i = 0; i < N_SLOTS; i++) {
+		if (slots[i].mem != NULL) {
+			slot_check(i, slots[i].size);
+			sys_tlsf_free(&heap, slots[i].mem);
+		}
+	}
+
+	zassert_true(sys_tlsf_validate(&heap), NULL);
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_equal(stats.max_free_block, initial.max_free_block, NULL);
+	zassert_equal(stats.allocated_bytes, 0, NULL);
+}
+
+K_MEM_POOL_DEFINE(test_pool, 64, 256, 2, 4);
+
+static void test_k_malloc_tlsf(void)
+{
+	struct k_queue queue;
+	char *a, *b;
+	int data;
+
+	a = k_malloc(100);
+	zassert_not_null(a, NULL);
+	(void)memset(a, 0x5a, 100);
+
+	a = k_realloc(a, 1000);
+	zassert_not_null(a, NULL);
+	zassert_equal(a[99], 0x5a, NULL);
+
+	b = k_calloc(10, 100);
+	zassert_not_null(b, NULL);
+	zassert_equal(b[999], 0, NULL);
+
+	k_free(a);
+	k_free(b);
+	zassert_is_null(k_realloc(NULL, 0), NULL);
+
+	/* k_realloc() and k_free() still handle memory pool blocks */
+	a = k_mem_pool_malloc(&test_pool, 20);
+	zassert_not_null(a, NULL);
+	(void)memset(a, 0x33, 20);
+	a = k_realloc(a, 200);
+	zassert_not_null(a, NULL);
+	zassert_equal(a[19], 0x33, NULL);
+	k_free(a);
+
+	/* The system pool assigned to threads is the TLSF heap */
+	k_thread_system_pool_assign(k_current_get());
+	k_queue_init(&queue);
+	zassert_equal(k_queue_alloc_append(&queue, &data), 0, NULL);
+	zassert_equal_ptr(k_queue_get(&queue, K_NO_WAIT), &data, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tlsf,
+			 ztest_unit_test(test_tlsf_alloc_free),
+			 ztest_unit_test(test_tlsf_realloc),
+			 ztest_unit_test(test_tlsf_random),
+			 ztest_unit_test(test_k_malloc_tlsf));
+
+	ztest_run_test_suite(tlsf);
+}
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Connection demultiplexing tests.
+ *
+ * Checks that net_conn_input() picks the same handler whether or not the
+ * connection hash table (CONFIG_NET_CONN_HASH) is used, and measures the
+ * per packet demultiplexing cost against the number of registered
+ * connection handlers.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CONN_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+#include <net/udp.h>
+
+#include "ipv6.h"
+#include "udp_internal.h"
+#include "connection.h"
+
+#define PEER_PORT	5555
+#define OTHER_PORT	6666
+#define LISTEN_PORT	4242
+
+#define CONNECTED_COUNT	16
+#define BIND_COUNT	40
+
+#define MAX_CONN_COUNT	64
+#define ITERATIONS	1000
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static u8_t payload[] = { 'f', 'o', 'o', 'b', 'a', 'r' };
+
+static struct net_if *iface;
+static void *matched;
+static int match_count;
+
+static int dummy_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int dummy_send(struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_iface_api = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(conn_demux_test, "conn_demux_test", dummy_dev_init, NULL,
+		NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_iface_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+/* The packet stays owned by the test so that it can be fed again. */
+static enum net_verdict record_match(struct net_conn *conn,
+				     struct net_pkt *pkt,
+				     union net_ip_header *ip_hdr,
+				     union net_proto_header *proto_hdr,
+				     void *user_data)
+{
+	matched = user_data;
+	match_count++;
+
+	return NET_OK;
+}
+
+struct test_pkt {
+	struct net_pkt *pkt;
+	union net_ip_header ip_hdr;
+	union net_proto_header proto_hdr;
+};
+
+static void test_pkt_build(struct test_pkt *tp, const struct in6_addr *src,
+			   u16_t src_port, u16_t dst_port)
+{
+	tp->pkt = net_pkt_alloc_with_buffer(iface, sizeof(payload), AF_INET6,
+					    IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(tp->pkt, "Cannot allocate packet");
+
+	zassert_equal(net_ipv6_create(tp->pkt, src, &my_addr), 0,
+		      "Cannot create IPv6 header");
+	zassert_equal(net_udp_create(tp->pkt, htons(src_port),
+				     htons(dst_port)), 0,
+		      "Cannot create UDP header");
+	zassert_equal(net_pkt_write(tp->pkt, payload, sizeof(payload)), 0,
+		      "Cannot write payload");
+
+	net_pkt_cursor_init(tp->pkt);
+
+	tp->ip_hdr.ipv6 = NET_IPV6_HDR(tp->pkt);
+	tp->proto_hdr.udp = (struct net_udp_hdr *)(tp->pkt->buffer->data +
+						   sizeof(struct net_ipv6_hdr));
+}
+
+static void *demux(const struct in6_addr *src, u16_t src_port, u16_t dst_port)
+{
+	struct test_pkt tp;
+	enum net_verdict verdict;
+
+	test_pkt_build(&tp, src, src_port, dst_port);
+
+	matched = NULL;
+	match_count = 0;
+
+	verdict = net_conn_input(tp.pkt, &tp.ip_hdr, IPPROTO_UDP,
+				 &tp.proto_hdr);
+	zassert_equal(verdict, NET_OK, "Packet not delivered");
+	zassert_equal(match_count, 1, "Packet delivered %d times",
+		      match_count);
+
+	net_pkt_unref(tp.pkt);
+
+	return matched;
+}
+
+static void sockaddr_set(struct sockaddr_in6 *addr, const struct in6_addr *a)
+{
+	(void)memset(addr, 0, sizeof(*addr));
+	addr->sin6_family = AF_INET6;
+	net_ipaddr_copy(&addr->sin6_addr, a);
+}
+
+static struct net_conn_handle *conn_register(const struct sockaddr_in6 *remote,
+					     const struct sockaddr_in6 *local,
+					     u16_t remote_port,
+					     u16_t local_port,
+					     void *user_data)
+{
+	struct net_conn_handle *handle;
+	int ret;
+
+	ret = net_conn_register(IPPROTO_UDP, AF_INET6,
+				(const struct sockaddr *)remote,
+				(const struct sockaddr *)local,
+				remote_port, local_port, record_match,
+				user_data, &handle);
+	zassert_equal(ret, 0, "Cannot register handler (%d)", ret);
+
+	return handle;
+}
+
+static void test_init(void)
+{
+	iface = net_if_get_default();
+	zassert_not_null(iface, "No interface");
+}
+
+static void test_demux_rank(void)
+{
+	struct net_conn_handle *any, *listener, *bound, *connected;
+	struct sockaddr_in6 local, remote;
+	static int tag_any, tag_listener, tag_bound, tag_connected;
+	struct in6_addr other_addr;
+
+	net_ipaddr_copy(&other_addr, &peer_addr);
+	other_addr.s6_addr[15] = 0x3;
+
+	sockaddr_set(&local, &my_addr);
+	sockaddr_set(&remote, &peer_addr);
+
+	any = conn_register(NULL, NULL, 0, 0, &tag_any);
+	listener = conn_register(NULL, NULL, 0, LISTEN_PORT, &tag_listener);
+	bound = conn_register(NULL, &local, 0, LISTEN_PORT, &tag_bound);
+	connected = conn_register(&remote, NULL, PEER_PORT, LISTEN_PORT,
+				  &tag_connected);
+
+	/* The connected handler is the newest one and specifies a remote
+	 * port, so it is not overridden by the higher ranked bound one.
+	 */
+	zassert_equal_ptr(demux(&peer_addr, PEER_PORT, LISTEN_PORT),
+			  &tag_connected, "Wrong handler for peer");
+	zassert_equal_ptr(demux(&peer_addr, OTHER_PORT, LISTEN_PORT),
+			  &tag_bound, "Wrong handler for peer port");
+	zassert_equal_ptr(demux(&other_addr, PEER_PORT, LISTEN_PORT),
+			  &tag_bound, "Wrong handler for other peer");
+	zassert_equal_ptr(demux(&peer_addr, PEER_PORT, LISTEN_PORT + 1),
+			  &tag_any, "Wrong handler for other port");
+
+	zassert_equal(net_conn_unregister(bound), 0, "Cannot unregister");
+
+	zassert_equal_ptr(demux(&other_addr, PEER_PORT, LISTEN_PORT),
+			  &tag_listener, "Wrong handler after unregister");
+
+	zassert_equal(net_conn_unregister(connected), 0, "Cannot unregister");
+
+	zassert_equal_ptr(demux(&peer_addr, PEER_PORT, LISTEN_PORT),
+			  &tag_listener, "Wrong handler after unregister");
+
+	zassert_equal(net_conn_unregister(listener), 0, "Cannot unregister");
+	zassert_equal(net_conn_unregister(any), 0, "Cannot unregister");
+}
+
+static void test_demux_many(void)
+{
+	static struct net_conn_handle *handles[CONNECTED_COUNT + BIND_COUNT];
+	static int tags[CONNECTED_COUNT + BIND_COUNT];
+	static int tag_listener;
+	struct net_conn_handle *listener;
+	struct sockaddr_in6 remote;
+	struct in6_addr addr;
+	int i;
+
+	listener = conn_register(NULL, NULL, 0, LISTEN_PORT, &tag_listener);
+
+	for (i = 0; i < CONNECTED_COUNT; i++) {
+		sockaddr_set(&remote, &peer_addr);
+		remote.sin6_addr.s6_addr[15] = 0x10 + i;
+
+		handles[i] = conn_register(&remote, NULL, PEER_PORT + i,
+					   LISTEN_PORT, &tags[i]);
+	}
+
+	for (i = CONNECTED_COUNT; i < ARRAY_SIZE(handles); i++) {
+		handles[i] = conn_register(NULL, NULL, 0, 5000 + i, &tags[i]);
+	}
+
+	for (i = 0; i < CONNECTED_COUNT; i++) {
+		net_ipaddr_copy(&addr, &peer_addr);
+		addr.s6_addr[15] = 0x10 + i;
+
+		zassert_equal_ptr(demux(&addr, PEER_PORT + i, LISTEN_PORT),
+				  &tags[i], "Wrong handler for peer %d", i);
+		zassert_equal_ptr(demux(&addr, PEER_PORT + i + 1,
+					LISTEN_PORT),
+				  &tag_listener, "Wrong handler for peer %d",
+				  i);
+	}
+
+	for (i = CONNECTED_COUNT; i < ARRAY_SIZE(handles); i++) {
+		zassert_equal_ptr(demux(&peer_addr, PEER_PORT, 5000 + i),
+				  &tags[i], "Wrong handler for port %d",
+				  5000 + i);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(handles); i++) {
+		zassert_equal(net_conn_unregister(handles[i]), 0,
+			      "Cannot unregister");
+	}
+
+	zassert_equal(net_conn_unregister(listener), 0, "Cannot unregister");
+}
+
+static void test_demux_cost(void)
+{
+	static struct net_conn_handle *handles[MAX_CONN_COUNT];
+	static const int counts[] = { 1, 8, 16, 32, 64 };
+	struct test_pkt tp;
+	u32_t start, cycles;
+	int registered = 0;
+	int i, j;
+
+	/* Packets go to the oldest handler, the last one found by a
+	 * linear walk of the connection list.
+	 */
+	test_pkt_build(&tp, &peer_addr, PEER_PORT, 7000);
+
+	TC_PRINT("connections  cycles/packet\n");
+
+	for (i = 0; i < ARRAY_SIZE(counts); i++) {
+		while (registered < counts[i]) {
+			handles[registered] = conn_register(NULL, NULL, 0,
+							    7000 + registered,
+							    NULL);
+			registered++;
+		}
+
+		match_count = 0;
+
+		start = k_cycle_get_32();
+
+		for (j = 0; j < ITERATIONS; j++) {
+			net_conn_input(tp.pkt, &tp.ip_hdr, IPPROTO_UDP,
+				       &tp.proto_hdr);
+		}
+
+		cycles = k_cycle_get_32() - start;
+
+		zassert_equal(match_count, ITERATIONS, "Packets not delivered");
+
+		TC_PRINT("%11d  %13u\n", counts[i], cycles / ITERATIONS);
+	}
+
+	for (i = 0; i < registered; i++) {
+		net_conn_unregister(handles[i]);
+	}
+
+	net_pkt_unref(tp.pkt);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_conn_demux,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_demux_rank),
+			 ztest_unit_test(test_demux_many),
+			 ztest_unit_test(test_demux_cost));
+
+	ztest_run_test_suite(net_conn_demux);
+}
@@ -1454,6 +1454,250 @@ done:
 	return result;
 }
 
+/* Number of options in the find options test packet */
+#define FIND_OPTIONS_NUM 5
+
+static int verify_find_options(const struct coap_packet *cpkt)
+{
+	struct coap_option options[4];
+	int count;
+
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Make sure the lookups below take the path this build is meant
+	 * to cover: the index if all options fit, the fallback otherwise.
+	 */
+	if (cpkt->opt_idx_overflow !=
+	    (CONFIG_COAP_OPTION_INDEX_SIZE < FIND_OPTIONS_NUM)) {
+		TC_PRINT("Unexpected option index overflow state\n");
+		return TC_FAIL;
+	}
+#endif
+
+	count = coap_find_options(cpkt, COAP_OPTION_URI_PATH, options, 4);
+	if (count != 2) {
+		TC_PRINT("Unexpected number of path options\n");
+		return TC_FAIL;
+	}
+
+	if (options[0].len != 1U || memcmp(options[0].value, "a", 1) ||
+	    options[1].len != 2U || memcmp(options[1].value, "bb", 2)) {
+		TC_PRINT("Path options don't match the reference\n");
+		return TC_FAIL;
+	}
+
+	count = coap_find_options(cpkt, COAP_OPTION_URI_QUERY, options, 4);
+	if (count != 2) {
+		TC_PRINT("Unexpected number of query options\n");
+		return TC_FAIL;
+	}
+
+	if (options[0].len != 3U || memcmp(options[0].value, "x=1", 3) ||
+	    options[1].len != 3U || memcmp(options[1].value, "y=2", 3)) {
+		TC_PRINT("Query options don't match the reference\n");
+		return TC_FAIL;
+	}
+
+	count = coap_find_options(cpkt, COAP_OPTION_URI_QUERY, options, 1);
+	if (count != 1 || memcmp(options[0].value, "x=1", 3)) {
+		TC_PRINT("Query option lookup overran the vector\n");
+		return TC_FAIL;
+	}
+
+	count = coap_find_options(cpkt, COAP_OPTION_CONTENT_FORMAT,
+				  options, 4);
+	if (count != 1 || coap_option_value_to_int(&options[0]) != 42U) {
+		TC_PRINT("Content format option doesn't match\n");
+		return TC_FAIL;
+	}
+
+	count = coap_find_options(cpkt, COAP_OPTION_ETAG, options, 4);
+	if (count != 0) {
+		TC_PRINT("There shouldn't be any ETAG option in the packet\n");
+		return TC_FAIL;
+	}
+
+	count = coap_find_options(cpkt, COAP_OPTION_SIZE1, options, 4);
+	if (count != 0) {
+		TC_PRINT("There shouldn't be any SIZE1 option in the packet\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_find_options(void)
+{
+	struct coap_packet cpkt;
+	u8_t payload[] = "payload";
+	u8_t *data;
+	int result = TC_FAIL;
+	int r;
+
+	data = (u8_t *)k_malloc(COAP_BUF_SIZE);
+	if (!data) {
+		TC_PRINT("Unable to allocate memory for req");
+		goto done;
+	}
+
+	r = coap_packet_init(&cpkt, data, COAP_BUF_SIZE, 1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_POST,
+			     coap_next_id());
+	if (r < 0) {
+		TC_PRINT("Could not initialize packet\n");
+		goto done;
+	}
+
+	if (coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+				      "a", 1) < 0 ||
+	    coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+				      "bb", 2) < 0 ||
+	    coap_append_option_int(&cpkt, COAP_OPTION_CONTENT_FORMAT,
+				   42) < 0 ||
+	    coap_packet_append_option(&cpkt, COAP_OPTION_URI_QUERY,
+				      "x=1", 3) < 0 ||
+	    coap_packet_append_option(&cpkt, COAP_OPTION_URI_QUERY,
+				      "y=2", 3) < 0 ||
+	    coap_packet_append_payload_marker(&cpkt) < 0 ||
+	    coap_packet_append_payload(&cpkt, payload,
+				       sizeof(payload)) < 0) {
+		TC_PRINT("Could not build packet\n");
+		goto done;
+	}
+
+	TC_PRINT("Finding options in built packet\n");
+	if (verify_find_options(&cpkt) != TC_PASS) {
+		goto done;
+	}
+
+	r = coap_packet_parse(&cpkt, data, cpkt.offset, NULL, 0);
+	if (r < 0) {
+		TC_PRINT("Could not parse packet\n");
+		goto done;
+	}
+
+	TC_PRINT("Finding options in parsed packet\n");
+	if (verify_find_options(&cpkt) != TC_PASS) {
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	k_free(data);
+
+	TC_END_RESULT(result);
+
+	return result;
+}
+
+static struct coap_resource *dispatched;
+
+static int dispatch_get(struct coap_resource *resource,
+			struct coap_packet *request,
+			struct sockaddr *addr, socklen_t addr_len)
+{
+	dispatched = resource;
+
+	return 0;
+}
+
+static const char * const dispatch_a_path[] = { "a", NULL };
+static const char * const dispatch_ab_path[] = { "a", "b", NULL };
+static const char * const dispatch_b_path[] = { "b", NULL };
+static const char * const dispatch_ba_path[] = { "ba", NULL };
+
+static struct coap_resource dispatch_resources[] = {
+	{ .path = dispatch_a_path, .get = dispatch_get },
+	{ .path = dispatch_ab_path, .get = dispatch_get },
+	{ .path = dispatch_b_path, .get = dispatch_get },
+	{ .path = dispatch_ba_path, .get = dispatch_get },
+	{ },
+};
+
+static int dispatch(const char * const *path, struct coap_resource **res)
+{
+	struct coap_option options[4] = {};
+	struct coap_packet req;
+	u8_t data[32];
+	int r;
+
+	r = coap_packet_init(&req, data, sizeof(data), 1, COAP_TYPE_CON,
+			     0, NULL, COAP_METHOD_GET, coap_next_id());
+	if (r < 0) {
+		return r;
+	}
+
+	for (; *path; path++) {
+		r = coap_packet_append_option(&req, COAP_OPTION_URI_PATH,
+					      *path, strlen(*path));
+		if (r < 0) {
+			return r;
+		}
+	}
+
+	r = coap_packet_parse(&req, data, req.offset, options,
+			      ARRAY_SIZE(options));
+	if (r < 0) {
+		return r;
+	}
+
+	dispatched = NULL;
+	r = coap_handle_request(&req, dispatch_resources, options,
+				ARRAY_SIZE(options),
+				(struct sockaddr *) &dummy_addr,
+				sizeof(dummy_addr));
+	*res = dispatched;
+
+	return r;
+}
+
+static int test_resource_dispatch(void)
+{
+	static const char * const b_a_path[] = { "b", "a", NULL };
+	static const char * const empty_path[] = { NULL };
+	struct coap_resource *res;
+	int result = TC_FAIL;
+	int i;
+
+	/* Twice, the second time with the resource hashes cached */
+	for (i = 0; i < 2; i++) {
+		if (dispatch(dispatch_a_path, &res) < 0 ||
+		    res != &dispatch_resources[0]) {
+			TC_PRINT("Resource 'a' not dispatched\n");
+			goto done;
+		}
+
+		if (dispatch(dispatch_ab_path, &res) < 0 ||
+		    res != &dispatch_resources[1]) {
+			TC_PRINT("Resource 'a/b' not dispatched\n");
+			goto done;
+		}
+
+		if (dispatch(dispatch_ba_path, &res) < 0 ||
+		    res != &dispatch_resources[3]) {
+			TC_PRINT("Resource 'ba' not dispatched\n");
+			goto done;
+		}
+
+		if (dispatch(b_a_path, &res) != -ENOENT || res) {
+			TC_PRINT("Resource 'b/a' should not exist\n");
+			goto done;
+		}
+
+		if (dispatch(empty_path, &res) != -ENOENT || res) {
+			TC_PRINT("Empty path should not match\n");
+			goto done;
+		}
+	}
+
+	result = TC_PASS;
+
+done:
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 static const struct {
 	const char *name;
 	int (*func)(void);
@@ -1476,6 +1720,8 @@ static const struct {
 	{ "Test retransmission", test_retransmit_second_round, },
 	{ "Test observer server", test_observer_server, },
 	{ "Test observer client", test_observer_client, },
+	{ "Test find options", test_find_options, },
+	{ "Test resource dispatch", test_resource_dispatch, },
 };
 
 void main(void)
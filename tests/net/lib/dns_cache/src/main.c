@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <net/socket.h>
+#include <net/net_if.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+#include <net/dns_resolve.h>
+
+#include "dns_cache.h"
+
+#define NAME "www.zephyr.test"
+#define NX_NAME "nx.zephyr.test"
+
+#define DNS_PORT 53
+#define DNS_TIMEOUT K_MSEC(1000)
+
+#define RCODE_NXDOMAIN 3
+
+static int srv_sock;
+static struct k_sem done;
+static enum dns_resolve_status result_status;
+static struct in_addr result_addrs[DNS_CACHE_ADDRS];
+static int result_count;
+
+static void dns_cb(enum dns_resolve_status status, struct dns_addrinfo *info,
+		   void *user_data)
+{
+	if (status == DNS_EAI_INPROGRESS) {
+		if (result_count < ARRAY_SIZE(result_addrs)) {
+			result_addrs[result_count] =
+				net_sin(&info->ai_addr)->sin_addr;
+		}
+
+		result_count++;
+		return;
+	}
+
+	result_status = status;
+	k_sem_give(&done);
+}
+
+static void query(const char *name)
+{
+	int ret;
+
+	result_count = 0;
+
+	ret = dns_get_addr_info(name, DNS_QUERY_TYPE_A, NULL, dns_cb, NULL,
+				DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot start query (%d)", ret);
+}
+
+/* Answers the pending query with n A records 192.0.2.10, 192.0.2.11... */
+static void server_reply(u8_t rcode, u32_t ttl, int n)
+{
+	struct sockaddr_in from;
+	socklen_t fromlen = sizeof(from);
+	u8_t buf[256];
+	ssize_t len;
+	int i;
+
+	len = recvfrom(srv_sock, buf, sizeof(buf), 0,
+		       (struct sockaddr *)&from, &fromlen);
+	zassert_true(len > 12, "No query received");
+
+	/* QR, RD and RA set, the question is kept as is */
+	buf[2] = 0x81;
+	buf[3] = 0x80 | rcode;
+	buf[6] = 0U;
+	buf[7] = n;
+
+	for (i = 0; i < n; i++) {
+		u8_t rr[] = {
+			0xc0, 0x0c,		/* Name, pointer to question */
+			0x00, 0x01,		/* Type A */
+			0x00, 0x01,		/* Class IN */
+			ttl >> 24, ttl >> 16, ttl >> 8, ttl,
+			0x00, 0x04,		/* Data length */
+			192, 0, 2, 10 + i,
+		};
+
+		zassert_true(len + sizeof(rr) <= sizeof(buf), "Overflow");
+		memcpy(buf + len, rr, sizeof(rr));
+		len += sizeof(rr);
+	}
+
+	zassert_equal(sendto(srv_sock, buf, len, 0, (struct sockaddr *)&from,
+			     fromlen), len, "Cannot send reply");
+}
+
+static void server_no_query(void)
+{
+	u8_t buf[64];
+
+	zassert_equal(recv(srv_sock, buf, sizeof(buf), MSG_DONTWAIT), -1,
+		      "Query sent to the server");
+	zassert_equal(errno, EAGAIN, "Wrong errno");
+}
+
+static void check_result(enum dns_resolve_status status, int count)
+{
+	int i;
+
+	zassert_equal(k_sem_take(&done, K_MSEC(1000)), 0, "No result");
+	zassert_equal(result_status, status, "Wrong status %d",
+		      result_status);
+	zassert_equal(result_count, count, "Wrong address count");
+
+	for (i = 0; i < count; i++) {
+		zassert_equal(result_addrs[i].s4_addr[3], 10 + i,
+			      "Wrong address");
+	}
+}
+
+static struct net_stats_dns get_stats(void)
+{
+	struct net_stats_dns stats;
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_DNS, NULL, &stats,
+		       sizeof(stats));
+	zassert_equal(ret, 0, "Cannot get DNS statistics");
+
+	return stats;
+}
+
+static void test_init(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(DNS_PORT),
+	};
+
+	k_sem_init(&done, 0, 1);
+
+	srv_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(srv_sock >= 0, "Cannot create socket");
+	zassert_equal(bind(srv_sock, (struct sockaddr *)&addr, sizeof(addr)),
+		      0, "Cannot bind");
+}
+
+static void test_positive(void)
+{
+	struct net_stats_dns stats = get_stats();
+
+	query(NAME);
+	server_reply(0, 1, 2);
+	check_result(DNS_EAI_ALLDONE, 2);
+
+	/* Answered from the cache without a server round trip */
+	query(NAME);
+	check_result(DNS_EAI_ALLDONE, 2);
+	server_no_query();
+
+	zassert_equal(get_stats().cache_hit, stats.cache_hit + 1,
+		      "Hit not counted");
+	zassert_equal(get_stats().cache_miss, stats.cache_miss + 1,
+		      "Miss not counted");
+
+	/* The TTL expired */
+	k_sleep(K_MSEC(1100));
+
+	query(NAME);
+	server_reply(0, 300, 1);
+	check_result(DNS_EAI_ALLDONE, 1);
+
+	query(NAME);
+	check_result(DNS_EAI_ALLDONE, 1);
+	server_no_query();
+}
+
+static void test_negative(void)
+{
+	query(NX_NAME);
+	server_reply(RCODE_NXDOMAIN, 0, 0);
+	check_result(DNS_EAI_NODATA, 0);
+
+	query(NX_NAME);
+	check_result(DNS_EAI_NODATA, 0);
+	server_no_query();
+
+	/* CONFIG_DNS_RESOLVER_CACHE_NEG_TTL */
+	k_sleep(K_MSEC(1100));
+
+	query(NX_NAME);
+	server_reply(RCODE_NXDOMAIN, 0, 0);
+	check_result(DNS_EAI_NODATA, 0);
+}
+
+static void test_flush_on_iface_event(void)
+{
+	struct net_if *iface = net_if_get_default();
+
+	query(NAME);
+	check_result(DNS_EAI_ALLDONE, 1);
+	server_no_query();
+
+	net_if_down(iface);
+	net_if_up(iface);
+
+	/* Let the management thread deliver the events */
+	k_sleep(K_MSEC(100));
+
+	query(NAME);
+	server_reply(0, 300, 2);
+	check_result(DNS_EAI_ALLDONE, 2);
+
+	dns_resolve_cache_flush();
+
+	query(NAME);
+	server_reply(0, 300, 1);
+	check_result(DNS_EAI_ALLDONE, 1);
+}
+
+static void test_lru_eviction(void)
+{
+	struct dns_addrinfo info[DNS_CACHE_ADDRS];
+	u8_t addr[1][DNS_CACHE_ADDR_LEN] = { { 192, 0, 2, 10 } };
+	u32_t evicted = get_stats().cache_evict;
+	char name[16];
+	int i;
+
+	dns_resolve_cache_flush();
+
+	/* Keep using the first name while filling the cache, the second one
+	 * is then the least recently used entry.
+	 */
+	for (i = 0; get_stats().cache_evict == evicted; i++) {
+		zassert_true(i < 100, "Nothing was evicted");
+
+		snprintk(name, sizeof(name), "host%d", i);
+		dns_cache_add(name, DNS_QUERY_TYPE_A, addr, 1, 300);
+
+		zassert_equal(dns_cache_find("host0", DNS_QUERY_TYPE_A, info),
+			      1, "Recently used entry evicted");
+	}
+
+	zassert_true(i > 2, "Cache too small");
+	zassert_equal(dns_cache_find("host1", DNS_QUERY_TYPE_A, info),
+		      -ENOENT, "Least recently used entry not evicted");
+	zassert_equal(dns_cache_find("host2", DNS_QUERY_TYPE_A, info), 1,
+		      "Wrong entry evicted");
+	zassert_equal(dns_cache_find("HOST0", DNS_QUERY_TYPE_A, info), 1,
+		      "Names are not case insensitive");
+	zassert_equal(info[0].ai_family, AF_INET, "Wrong family");
+	zassert_equal(dns_cache_find("host0", DNS_QUERY_TYPE_AAAA, info),
+		      -ENOENT, "Query type ignored");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(dns_cache,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_positive),
+			 ztest_unit_test(test_negative),
+			 ztest_unit_test(test_flush_on_iface_event),
+			 ztest_unit_test(test_lru_eviction));
+
+	ztest_run_test_suite(dns_cache);
+}
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/coap.h>
+#include <net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+#define TEMP_INSTANCES CONFIG_LWM2M_IPSO_TEMP_SENSOR_INSTANCE_COUNT
+#define TEMP_OBJ_ID 3303
+#define LIGHT_OBJ_ID 3311
+
+#define SERVER_PORT 5683
+
+/* Longer than the minimum period plus an engine service interval */
+#define NOTIFY_WAIT_MS 2500
+
+static char server_url[] = "coap://" CONFIG_NET_CONFIG_MY_IPV4_ADDR ":5683";
+
+static struct lwm2m_ctx client;
+static struct sockaddr_in client_addr;
+static int server_sock;
+
+static u8_t temp_token[] = { 0x33, 0x03 };
+static u8_t light_token[] = { 0x33, 0x11 };
+
+static u8_t rx_buf[512];
+static u8_t tx_buf[64];
+
+static void set_temp(char *pathstr, s32_t val)
+{
+	float32_value_t value = { .val1 = val };
+
+	zassert_equal(lwm2m_engine_set_float32(pathstr, &value), 0,
+		      "set %s failed", pathstr);
+}
+
+/* Receive a message from the client within timeout ms, ACK it if needed */
+static int server_recv(struct coap_packet *msg, int timeout)
+{
+	struct pollfd fds = { .fd = server_sock, .events = POLLIN };
+	struct coap_packet ack;
+	ssize_t len;
+
+	if (poll(&fds, 1, timeout) <= 0) {
+		return -EAGAIN;
+	}
+
+	len = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_true(len > 0, "recv failed");
+	zassert_equal(coap_packet_parse(msg, rx_buf, len, NULL, 0), 0,
+		      "invalid message");
+
+	if (coap_header_get_type(msg) == COAP_TYPE_CON) {
+		zassert_equal(coap_packet_init(&ack, tx_buf, sizeof(tx_buf),
+					       1, COAP_TYPE_ACK, 0, NULL,
+					       COAP_CODE_EMPTY,
+					       coap_header_get_id(msg)),
+			      0, "ACK init failed");
+		zassert_equal(sendto(server_sock, ack.data, ack.offset, 0,
+				     (struct sockaddr *)&client_addr,
+				     sizeof(client_addr)),
+			      ack.offset, "ACK send failed");
+	}
+
+	return 0;
+}
+
+/* Check the next message is a notification for the token */
+static void expect_notify(const u8_t *token)
+{
+	struct coap_option observe;
+	struct coap_packet msg;
+	u8_t tkn[8];
+
+	zassert_equal(server_recv(&msg, NOTIFY_WAIT_MS), 0, "no notify");
+	zassert_equal(coap_header_get_code(&msg),
+		      COAP_RESPONSE_CODE_CONTENT, "not a notify");
+	zassert_equal(coap_find_options(&msg, COAP_OPTION_OBSERVE,
+					&observe, 1), 1, "no observe option");
+	zassert_equal(coap_header_get_token(&msg, tkn), 2, "bad token");
+	zassert_mem_equal(tkn, token, 2, "notify for wrong observation");
+}
+
+static void expect_no_notify(void)
+{
+	struct coap_packet msg;
+
+	zassert_equal(server_recv(&msg, NOTIFY_WAIT_MS), -EAGAIN,
+		      "unexpected notify");
+}
+
+static void observe(u8_t *token, const char *const *path, int count)
+{
+	struct coap_packet request;
+	int i;
+
+	zassert_equal(coap_packet_init(&request, tx_buf, sizeof(tx_buf), 1,
+				       COAP_TYPE_CON, 2, token,
+				       COAP_METHOD_GET, coap_next_id()),
+		      0, "request init failed");
+	zassert_equal(coap_append_option_int(&request, COAP_OPTION_OBSERVE,
+					     0), 0, "observe option failed");
+	for (i = 0; i < count; i++) {
+		zassert_equal(coap_packet_append_option(&request,
+						COAP_OPTION_URI_PATH,
+						path[i], strlen(path[i])),
+			      0, "path option failed");
+	}
+
+	zassert_equal(sendto(server_sock, request.data, request.offset, 0,
+			     (struct sockaddr *)&client_addr,
+			     sizeof(client_addr)),
+		      request.offset, "request send failed");
+
+	/* The current value comes in the response */
+	expect_notify(token);
+}
+
+static void test_engine_lookup(void)
+{
+	float32_value_t value;
+	char pathstr[16];
+	int i;
+
+	for (i = 0; i < TEMP_INSTANCES; i++) {
+		snprintk(pathstr, sizeof(pathstr), "%u/%d", TEMP_OBJ_ID, i);
+		zassert_equal(lwm2m_engine_create_obj_inst(pathstr), 0,
+			      "create %s failed", pathstr);
+	}
+
+	for (i = 0; i < TEMP_INSTANCES; i++) {
+		snprintk(pathstr, sizeof(pathstr), "%u/%d/5700",
+			 TEMP_OBJ_ID, i);
+		set_temp(pathstr, 100 + i);
+	}
+
+	zassert_equal(lwm2m_delete_obj_inst(TEMP_OBJ_ID, 1), 0,
+		      "delete failed");
+	zassert_true(lwm2m_engine_get_float32("3303/1/5700", &value) < 0,
+		     "deleted instance found");
+
+	/* The other instances still resolve to their own resources */
+	for (i = 0; i < TEMP_INSTANCES; i++) {
+		if (i == 1) {
+			continue;
+		}
+
+		snprintk(pathstr, sizeof(pathstr), "%u/%d/5700",
+			 TEMP_OBJ_ID, i);
+		zassert_equal(lwm2m_engine_get_float32(pathstr, &value), 0,
+			      "get %s failed", pathstr);
+		zassert_equal(value.val1, 100 + i, "wrong instance");
+	}
+
+	zassert_equal(lwm2m_engine_create_obj_inst("3303/1"), 0,
+		      "create again failed");
+	zassert_true(lwm2m_engine_create_obj_inst("3303/1") < 0,
+		     "duplicate instance created");
+	zassert_true(lwm2m_engine_get_float32("3304/0/5700", &value) < 0,
+		     "unknown object found");
+
+	zassert_equal(lwm2m_engine_create_obj_inst("3311/0"), 0,
+		      "create 3311/0 failed");
+}
+
+static void test_engine_observe(void)
+{
+	static const char *const temp_path[] = { "3303", "0" };
+	static const char *const light_path[] = { "3311", "0", "5850" };
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	socklen_t addrlen = sizeof(client_addr);
+
+	zassert_equal(inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+				&addr.sin_addr), 1, "inet_pton failed");
+	server_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_sock >= 0, "socket failed");
+	zassert_equal(bind(server_sock, (struct sockaddr *)&addr,
+			   sizeof(addr)), 0, "bind failed");
+
+	zassert_equal(lwm2m_engine_set_string("0/0/0", server_url), 0,
+		      "set server URL failed");
+	client.sec_obj_inst = 0;
+	zassert_equal(lwm2m_engine_start(&client), 0, "engine start failed");
+
+	/* Requests go to the port the engine socket was bound to */
+	zassert_equal(getsockname(client.sock_fd,
+				  (struct sockaddr *)&client_addr, &addrlen),
+		      0, "getsockname failed");
+	client_addr.sin_addr = addr.sin_addr;
+
+	observe(temp_token, temp_path, ARRAY_SIZE(temp_path));
+	observe(light_token, light_path, ARRAY_SIZE(light_path));
+}
+
+static void test_notify(void)
+{
+	/* Changes made in the millisecond of the last report are not new */
+	k_sleep(K_MSEC(10));
+	set_temp("3303/0/5700", 10);
+	expect_notify(temp_token);
+	expect_no_notify();
+}
+
+static void test_notify_batch(void)
+{
+	zassert_equal(lwm2m_engine_notify_batch_begin(TEMP_OBJ_ID), 0,
+		      "batch begin failed");
+	set_temp("3303/0/5700", 20);
+	expect_no_notify();
+	set_temp("3303/0/5601", 5);
+	zassert_equal(lwm2m_engine_notify_batch_end(TEMP_OBJ_ID), 0,
+		      "batch end failed");
+
+	/* Both changes in a single notify */
+	expect_notify(temp_token);
+	expect_no_notify();
+}
+
+static void test_notify_batch_nested(void)
+{
+	zassert_equal(lwm2m_engine_notify_batch_begin(TEMP_OBJ_ID), 0,
+		      "batch begin failed");
+	zassert_equal(lwm2m_engine_notify_batch_begin(TEMP_OBJ_ID), 0,
+		      "nested batch begin failed");
+	set_temp("3303/0/5700", 30);
+	zassert_equal(lwm2m_engine_notify_batch_end(TEMP_OBJ_ID), 0,
+		      "nested batch end failed");
+	expect_no_notify();
+
+	zassert_equal(lwm2m_engine_notify_batch_end(TEMP_OBJ_ID), 0,
+		      "batch end failed");
+	expect_notify(temp_token);
+	expect_no_notify();
+}
+
+static void test_notify_batch_scope(void)
+{
+	zassert_equal(lwm2m_engine_notify_batch_begin(TEMP_OBJ_ID), 0,
+		      "batch begin failed");
+	set_temp("3303/0/5700", 40);
+
+	/* Another object is not held back by the batch */
+	zassert_equal(lwm2m_engine_set_bool("3311/0/5850", true), 0,
+		      "set 3311/0/5850 failed");
+	expect_notify(light_token);
+	expect_no_notify();
+
+	zassert_equal(lwm2m_engine_notify_batch_end(TEMP_OBJ_ID), 0,
+		      "batch end failed");
+	expect_notify(temp_token);
+
+	zassert_equal(lwm2m_engine_notify_batch_begin(3304), -ENOENT,
+		      "batch begun on unknown object");
+	zassert_equal(lwm2m_engine_notify_batch_end(3304), -ENOENT,
+		      "batch ended on unknown object");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine,
+			 ztest_unit_test(test_engine_lookup),
+			 ztest_unit_test(test_engine_observe),
+			 ztest_unit_test(test_notify),
+			 ztest_unit_test(test_notify_batch),
+			 ztest_unit_test(test_notify_batch_nested),
+			 ztest_unit_test(test_notify_batch_scope));
+
+	ztest_run_test_suite(lwm2m_engine);
+}
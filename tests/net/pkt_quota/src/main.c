@@ -0,0 +1,447 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_PKT_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+
+#include <ztest.h>
+
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/net_pkt_quota.h>
+#include <net/net_context.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+#include <net/dummy.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "icmpv4.h"
+#include "ipv6.h"
+#include "icmpv6.h"
+#include "udp_internal.h"
+
+#define PORT 4242
+#define CONTEXT_RX_MAX 4
+#define IFACE_RESERVED 2
+#define SMALL_PAYLOAD 8
+/* Takes several of the CONFIG_NET_BUF_DATA_SIZE buffers */
+#define LARGE_PAYLOAD 200
+#define WAIT_TIME K_SECONDS(1)
+
+static struct in_addr my_addr1 = { { { 192, 0, 2, 1 } } };
+static struct in_addr my_addr2 = { { { 198, 51, 100, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in6_addr my_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static struct net_if *iface1;
+static struct net_if *iface2;
+static struct net_context *udp_ctx;
+
+/* Received UDP packets are kept here, like in a socket that is
+ * never read.
+ */
+static struct net_pkt *held[CONFIG_NET_PKT_RX_COUNT];
+static int held_count;
+
+static struct k_sem echo_reply;
+static struct k_sem neighbor_adv;
+
+struct dummy_context {
+	u8_t mac_addr[6];
+};
+
+static struct dummy_context dummy_ctx1;
+static struct dummy_context dummy_ctx2;
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	struct device *dev = net_if_get_device(iface);
+	struct dummy_context *ctx = dev->driver_data;
+
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	ctx->mac_addr[0] = 0x00;
+	ctx->mac_addr[1] = 0x00;
+	ctx->mac_addr[2] = 0x5E;
+	ctx->mac_addr[3] = 0x00;
+	ctx->mac_addr[4] = 0x53;
+	ctx->mac_addr[5] = ctx == &dummy_ctx1 ? 1 : 2;
+
+	net_if_set_link_addr(iface, ctx->mac_addr, sizeof(ctx->mac_addr),
+			     NET_LINK_DUMMY);
+}
+
+static int dummy_send(struct device *dev, struct net_pkt *pkt)
+{
+	u8_t *data = pkt->buffer->data;
+
+	if ((data[0] & 0xf0) == 0x40 &&
+	    pkt->buffer->len > sizeof(struct net_ipv4_hdr) &&
+	    NET_IPV4_HDR(pkt)->proto == IPPROTO_ICMP &&
+	    data[sizeof(struct net_ipv4_hdr)] == NET_ICMPV4_ECHO_REPLY) {
+		k_sem_give(&echo_reply);
+	}
+
+	if ((data[0] & 0xf0) == 0x60 &&
+	    pkt->buffer->len > sizeof(struct net_ipv6_hdr) &&
+	    NET_IPV6_HDR(pkt)->nexthdr == IPPROTO_ICMPV6 &&
+	    data[sizeof(struct net_ipv6_hdr)] == NET_ICMPV6_NA) {
+		k_sem_give(&neighbor_adv);
+	}
+
+	return 0;
+}
+
+static int dummy_init(struct device *dev)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_api_funcs = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT_INSTANCE(pkt_quota_test1, "pkt_quota_test1", iface1,
+			 dummy_init, &dummy_ctx1, NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &dummy_api_funcs, DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+NET_DEVICE_INIT_INSTANCE(pkt_quota_test2, "pkt_quota_test2", iface2,
+			 dummy_init, &dummy_ctx2, NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &dummy_api_funcs, DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static void udp_received(struct net_context *context,
+			 struct net_pkt *pkt,
+			 union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr,
+			 int status,
+			 void *user_data)
+{
+	if (!pkt) {
+		return;
+	}
+
+	zassert_true(held_count < ARRAY_SIZE(held), "Too many packets");
+
+	held[held_count++] = pkt;
+}
+
+static void release_held(void)
+{
+	while (held_count) {
+		net_pkt_unref(held[--held_count]);
+	}
+}
+
+static struct net_stats_pkt_quota get_stats(struct net_if *iface)
+{
+	struct net_stats_pkt_quota stats;
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_PKT_QUOTA, iface,
+		       &stats, sizeof(stats));
+	zassert_equal(ret, 0, "Cannot get stats (%d)", ret);
+
+	return stats;
+}
+
+static void test_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+	struct net_if_addr *ifaddr;
+	int ret;
+
+	k_sem_init(&echo_reply, 0, UINT_MAX);
+	k_sem_init(&neighbor_adv, 0, UINT_MAX);
+
+	iface1 = net_if_get_by_index(1);
+	iface2 = net_if_get_by_index(2);
+	zassert_not_null(iface1, "Interface 1");
+	zassert_not_null(iface2, "Interface 2");
+
+	ifaddr = net_if_ipv4_addr_add(iface1, &my_addr1, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "addr1");
+
+	ifaddr = net_if_ipv4_addr_add(iface2, &my_addr2, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "addr2");
+
+	ifaddr = net_if_ipv6_addr_add(iface1, &my_addr6, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "addr6");
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &udp_ctx);
+	zassert_equal(ret, 0, "Cannot get UDP context (%d)", ret);
+
+	ret = net_context_bind(udp_ctx, (struct sockaddr *)&addr,
+			       sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind UDP context (%d)", ret);
+
+	ret = net_context_recv(udp_ctx, udp_received, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Cannot receive on UDP context (%d)", ret);
+}
+
+static int recv_udp(struct net_if *iface, const struct in_addr *dst,
+		    size_t len)
+{
+	static const u8_t payload[LARGE_PAYLOAD];
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, len, AF_INET,
+					   IPPROTO_UDP, K_NO_WAIT);
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	if (net_ipv4_create(pkt, &peer_addr, dst) ||
+	    net_udp_create(pkt, htons(PORT), htons(PORT)) ||
+	    net_pkt_write(pkt, payload, len)) {
+		zassert_true(false, "Cannot create UDP packet");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	ret = net_recv_data(iface, pkt);
+	if (ret < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return ret;
+}
+
+static int recv_echo_request(struct net_if *iface, const struct in_addr *dst)
+{
+	struct net_icmp_hdr icmp_hdr = {
+		.type = NET_ICMPV4_ECHO_REQUEST,
+	};
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(icmp_hdr) +
+					   sizeof(struct net_icmpv4_echo_req),
+					   AF_INET, IPPROTO_ICMP, K_NO_WAIT);
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	if (net_ipv4_create(pkt, &peer_addr, dst) ||
+	    net_pkt_write(pkt, &icmp_hdr, sizeof(icmp_hdr)) ||
+	    net_pkt_write_be16(pkt, 1) ||
+	    net_pkt_write_be16(pkt, 1)) {
+		zassert_true(false, "Cannot create echo request");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_ICMP);
+
+	ret = net_recv_data(iface, pkt);
+	if (ret < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return ret;
+}
+
+/* A neighbor solicitation for my_addr6, answered with an advertisement */
+static int recv_neighbor_solicitation(struct net_if *iface)
+{
+	struct net_icmpv6_ns_hdr ns_hdr = { 0 };
+	const u8_t llao[] = { NET_ICMPV6_ND_OPT_SLLAO, 1,
+			      0x00, 0x00, 0x5E, 0x00, 0x53, 0xFE };
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(struct net_icmp_hdr) +
+					   sizeof(ns_hdr) + sizeof(llao),
+					   AF_INET6, IPPROTO_ICMPV6, K_NO_WAIT);
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	net_pkt_set_ipv6_hop_limit(pkt, NET_IPV6_ND_HOP_LIMIT);
+	net_ipaddr_copy(&ns_hdr.tgt, &my_addr6);
+
+	if (net_ipv6_create(pkt, &peer_addr6, &my_addr6) ||
+	    net_icmpv6_create(pkt, NET_ICMPV6_NS, 0) ||
+	    net_pkt_write(pkt, &ns_hdr, sizeof(ns_hdr)) ||
+	    net_pkt_write(pkt, llao, sizeof(llao))) {
+		zassert_true(false, "Cannot create neighbor solicitation");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv6_finalize(pkt, IPPROTO_ICMPV6);
+
+	ret = net_recv_data(iface, pkt);
+	if (ret < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return ret;
+}
+
+/* Send far more packets than the RX slab has while nobody reads them,
+ * return how many were accepted.
+ */
+static int flood(struct net_if *iface, const struct in_addr *dst,
+		 size_t len)
+{
+	int accepted = 0;
+	int i;
+
+	for (i = 0; i < 3 * CONFIG_NET_PKT_RX_COUNT; i++) {
+		if (recv_udp(iface, dst, len) == 0) {
+			accepted++;
+		}
+
+		k_sleep(K_MSEC(10));
+	}
+
+	return accepted;
+}
+
+static void test_context_rx_max(void)
+{
+	int ret;
+
+	ret = net_pkt_quota_set(net_context_pkt_quota(udp_ctx, true), 0,
+				CONTEXT_RX_MAX);
+	zassert_equal(ret, 0, "Cannot set context quota (%d)", ret);
+
+	/* The context must not take more than its share */
+	(void)flood(iface1, &my_addr1, SMALL_PAYLOAD);
+
+	zassert_equal(held_count, CONTEXT_RX_MAX,
+		      "Context holds %d packets", held_count);
+	zassert_true(get_stats(iface1).cap_drop > 0, "No packet dropped");
+
+	/* The stack must still be able to answer */
+	ret = recv_echo_request(iface1, &my_addr1);
+	zassert_equal(ret, 0, "Cannot receive echo request (%d)", ret);
+
+	zassert_equal(k_sem_take(&echo_reply, WAIT_TIME), 0,
+		      "No echo reply");
+
+	release_held();
+
+	ret = net_pkt_quota_set(net_context_pkt_quota(udp_ctx, true), 0, 0);
+	zassert_equal(ret, 0, "Cannot reset context quota (%d)", ret);
+}
+
+static void test_iface_reserved(void)
+{
+	int count, ret, i;
+
+	ret = net_pkt_quota_set(net_if_pkt_quota(iface2, true),
+				IFACE_RESERVED, 0);
+	zassert_equal(ret, 0, "Cannot set interface quota (%d)", ret);
+
+	ret = net_pkt_quota_set(net_if_pkt_quota(iface1, true),
+				CONFIG_NET_PKT_RX_COUNT, 0);
+	zassert_equal(ret, -ENOMEM, "Slab reserved twice");
+
+	/* Interface 1 may only keep what is reserved neither for
+	 * interface 2 nor for network control traffic.
+	 */
+	count = flood(iface1, &my_addr1, SMALL_PAYLOAD);
+	zassert_equal(count, CONFIG_NET_PKT_RX_COUNT - IFACE_RESERVED -
+		      CONFIG_NET_PKT_QUOTA_NC_RESERVED,
+		      "Interface 1 got %d packets", count);
+	zassert_true(get_stats(iface1).reserve_drop > 0, "No packet dropped");
+
+	for (i = 0; i < IFACE_RESERVED; i++) {
+		ret = recv_udp(iface2, &my_addr2, SMALL_PAYLOAD);
+		zassert_equal(ret, 0, "Interface 2 got no packet (%d)", ret);
+		k_sleep(K_MSEC(10));
+	}
+
+	zassert_equal(held_count, count + IFACE_RESERVED,
+		      "Context holds %d packets", held_count);
+
+	release_held();
+
+	ret = net_pkt_quota_set(net_if_pkt_quota(iface2, true), 0, 0);
+	zassert_equal(ret, 0, "Cannot reset interface quota (%d)", ret);
+
+	/* With the reservation gone interface 2 can be flooded too */
+	count = flood(iface2, &my_addr2, SMALL_PAYLOAD);
+	zassert_equal(count, CONFIG_NET_PKT_RX_COUNT -
+		      CONFIG_NET_PKT_QUOTA_NC_RESERVED,
+		      "Interface 2 got %d packets", count);
+
+	release_held();
+}
+
+static void test_nc_reserved(void)
+{
+	struct net_pkt_quota *nc_quota;
+	int ret;
+
+	nc_quota = net_tc_pkt_quota(net_rx_priority2tc(NET_PRIORITY_NC),
+				    true);
+	zassert_not_null(nc_quota, "No network control class");
+
+	/* Packets that each take several buffers run out of buffers
+	 * before they run out of packets, control traffic must still
+	 * find both.
+	 */
+	zassert_true(flood(iface1, &my_addr1, LARGE_PAYLOAD) > 0,
+		     "Flood not received");
+	zassert_true(get_stats(iface1).reserve_drop > 0, "No packet dropped");
+
+	ret = recv_neighbor_solicitation(iface1);
+	zassert_equal(ret, 0, "Cannot receive solicitation (%d)", ret);
+
+	zassert_equal(k_sem_take(&neighbor_adv, WAIT_TIME), 0,
+		      "No neighbor advertisement");
+
+	release_held();
+
+	/* Without the reservation the flood takes everything */
+	ret = net_pkt_quota_set(nc_quota, 0, 0);
+	zassert_equal(ret, 0, "Cannot reset class quota (%d)", ret);
+
+	(void)flood(iface1, &my_addr1, LARGE_PAYLOAD);
+
+	ret = recv_neighbor_solicitation(iface1);
+	zassert_true(ret < 0 || k_sem_take(&neighbor_adv, WAIT_TIME) < 0,
+		     "Neighbor advertisement without a reservation");
+
+	release_held();
+
+	ret = net_pkt_quota_set(nc_quota, CONFIG_NET_PKT_QUOTA_NC_RESERVED, 0);
+	zassert_equal(ret, 0, "Cannot restore class quota (%d)", ret);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_pkt_quota_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_context_rx_max),
+			 ztest_unit_test(test_iface_reserved),
+			 ztest_unit_test(test_nc_reserved));
+
+	ztest_run_test_suite(net_pkt_quota_test);
+}
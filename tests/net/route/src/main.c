@@ -468,6 +468,47 @@ static void route_del_many(void)
 	}
 }
 
+static void route_lookup_longest_prefix(void)
+{
+	struct in6_addr prefix_64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0 } } };
+	struct net_route_entry *host, *route_112, *route_64;
+
+	host = net_route_add(my_iface, &dest_addresses[0], 128, &peer_addr);
+	zassert_not_null(host, "Host route add failed");
+
+	route_112 = net_route_add(my_iface, &generic_addr, 112, &peer_addr);
+	zassert_not_null(route_112, "/112 route add failed");
+
+	route_64 = net_route_add(my_iface, &prefix_64, 64, &peer_addr);
+	zassert_not_null(route_64, "/64 route add failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addresses[0]), host,
+			  "Host route not found");
+	zassert_equal_ptr(net_route_lookup(NULL, &dest_addresses[1]),
+			  route_112, "/112 route not found");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route_64,
+			  "/64 route not found");
+	zassert_is_null(net_route_lookup(my_iface, &ll_addr),
+			"Route found for link local address");
+	zassert_is_null(net_route_lookup(peer_iface, &dest_addresses[0]),
+			"Route found on other interface");
+
+	zassert_false(net_route_del(route_112), "/112 route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addresses[1]),
+			  route_64, "Lookup did not fall back to /64 route");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addresses[0]), host,
+			  "Host route lost");
+
+	zassert_false(net_route_del(host), "Host route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addresses[0]),
+			  route_64, "Lookup did not fall back to /64 route");
+
+	zassert_false(net_route_del(route_64), "/64 route del failed");
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Route found after delete");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -487,6 +528,7 @@ void test_main(void)
 			ztest_unit_test(route_del_nexthop_again),
 			ztest_unit_test(populate_nbr_cache),
 			ztest_unit_test(route_add_many),
-			ztest_unit_test(route_del_many));
+			ztest_unit_test(route_del_many),
+			ztest_unit_test(route_lookup_longest_prefix));
 	ztest_run_test_suite(test_route);
 }
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2020 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <net/net_pkt.h>
+
+#include "../../socket_helpers.h"
+
+#define CLIENT_PORT 9898
+#define SERVER_PORT 4242
+
+#define BATCH 8
+#define ROUNDS 100
+#define DGRAM_SIZE 64
+
+/* More than 128 bytes, to use >1 net_buf. */
+#define TEST_STR_LONG \
+	"The Zephyr Project, a Linux Foundation hosted Collaboration " \
+	"Project, is an open source collaborative effort uniting leaders " \
+	"from across the industry to build a best-in-breed small, scalable, " \
+	"real-time operating system (RTOS) optimized for resource-" \
+	"constrained devices, across multiple architectures."
+
+static int c_sock;
+static int s_sock;
+static struct sockaddr_in c_addr;
+static struct sockaddr_in s_addr;
+
+static u8_t tx_data[BATCH][DGRAM_SIZE];
+static u8_t rx_data[BATCH][DGRAM_SIZE];
+static struct iovec tx_iov[BATCH];
+static struct iovec rx_iov[BATCH];
+static struct sockaddr_in rx_addr[BATCH];
+static struct mmsghdr tx_msgs[BATCH];
+static struct mmsghdr rx_msgs[BATCH];
+
+static void open_socks(void)
+{
+	int rv;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	rv = bind(c_sock, (struct sockaddr *)&c_addr, sizeof(c_addr));
+	zassert_equal(rv, 0, "client bind failed");
+	rv = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(rv, 0, "server bind failed");
+}
+
+static void close_socks(void)
+{
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+static void prepare_msgs(size_t len)
+{
+	for (int i = 0; i < BATCH; i++) {
+		(void)memset(tx_data[i], 'a' + i, sizeof(tx_data[i]));
+		tx_iov[i].iov_base = tx_data[i];
+		tx_iov[i].iov_len = len;
+		(void)memset(&tx_msgs[i], 0, sizeof(tx_msgs[i]));
+		tx_msgs[i].msg_hdr.msg_name = &s_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(s_addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+
+		rx_iov[i].iov_base = rx_data[i];
+		rx_iov[i].iov_len = sizeof(rx_data[i]);
+		(void)memset(&rx_msgs[i], 0, sizeof(rx_msgs[i]));
+		rx_msgs[i].msg_hdr.msg_name = &rx_addr[i];
+		rx_msgs[i].msg_hdr.msg_namelen = sizeof(rx_addr[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+/* Receive until n messages arrived, recvmmsg() only waits for one */
+static void recv_all(int n)
+{
+	int got = 0;
+	int rv;
+
+	while (got < n) {
+		rv = recvmmsg(s_sock, &rx_msgs[got], n - got, 0);
+		zassert_true(rv > 0, "recvmmsg failed (%d)", errno);
+		got += rv;
+	}
+}
+
+static void test_v4_sendmmsg_recvmmsg(void)
+{
+	struct iovec scatter[2];
+	u8_t head[3], tail[8];
+	int rv;
+
+	open_socks();
+	prepare_msgs(DGRAM_SIZE);
+
+	for (int i = 0; i < BATCH; i++) {
+		tx_iov[i].iov_len = 10 + i;
+	}
+
+	rv = sendmmsg(c_sock, tx_msgs, BATCH, 0);
+	zassert_equal(rv, BATCH, "sendmmsg failed (%d)", errno);
+
+	for (int i = 0; i < BATCH; i++) {
+		zassert_equal(tx_msgs[i].msg_len, 10 + i, "wrong sent length");
+	}
+
+	recv_all(BATCH);
+
+	for (int i = 0; i < BATCH; i++) {
+		zassert_equal(rx_msgs[i].msg_len, 10 + i, "wrong length");
+		zassert_mem_equal(rx_data[i], tx_data[i], 10 + i,
+				  "wrong data");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_namelen,
+			      sizeof(struct sockaddr_in), "wrong addrlen");
+		zassert_equal(rx_addr[i].sin_port, c_addr.sin_port,
+			      "wrong source port");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_flags, 0, "wrong flags");
+	}
+
+	/* Nothing is left */
+	rv = recvmmsg(s_sock, rx_msgs, BATCH, MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg should fail");
+	zassert_equal(errno, EAGAIN, "wrong errno");
+
+	/* A datagram is scattered over the buffers and truncated */
+	rv = sendmmsg(c_sock, tx_msgs, 1, 0);
+	zassert_equal(rv, 1, "sendmmsg failed (%d)", errno);
+
+	scatter[0].iov_base = head;
+	scatter[0].iov_len = sizeof(head);
+	scatter[1].iov_base = tail;
+	scatter[1].iov_len = 5;
+	rx_msgs[0].msg_hdr.msg_iov = scatter;
+	rx_msgs[0].msg_hdr.msg_iovlen = ARRAY_SIZE(scatter);
+	rx_msgs[0].msg_hdr.msg_name = NULL;
+
+	rv = recvmmsg(s_sock, rx_msgs, 1, 0);
+	zassert_equal(rv, 1, "recvmmsg failed (%d)", errno);
+	zassert_equal(rx_msgs[0].msg_len, 8, "wrong length");
+	zassert_equal(rx_msgs[0].msg_hdr.msg_flags, MSG_TRUNC,
+		      "not truncated");
+	zassert_mem_equal(head, tx_data[0], sizeof(head), "wrong data");
+	zassert_mem_equal(tail, tx_data[0], 5, "wrong data");
+
+	close_socks();
+}
+
+static void test_v4_recv_loan(void)
+{
+	struct k_mem_slab *slab;
+	struct sockaddr_in addr;
+	socklen_t addrlen = sizeof(addr);
+	struct zsock_loan loan;
+	struct iovec iov[8];
+	static u8_t buf[sizeof(TEST_STR_LONG)];
+	size_t len = 0;
+	u32_t free_pkts;
+	ssize_t rv;
+	int n;
+
+	open_socks();
+
+	rv = sendto(c_sock, TEST_STR_LONG, strlen(TEST_STR_LONG), 0,
+		    (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(rv, strlen(TEST_STR_LONG), "sendto failed");
+
+	rv = zsock_recv_loan(s_sock, &loan, 0,
+			     (struct sockaddr *)&addr, &addrlen);
+	zassert_equal(rv, strlen(TEST_STR_LONG), "recv_loan failed");
+	zassert_equal(loan.len, rv, "wrong loan length");
+	zassert_equal(addrlen, sizeof(addr), "wrong addrlen");
+	zassert_equal(addr.sin_port, c_addr.sin_port, "wrong source port");
+
+	/* The payload spans several network buffers */
+	n = zsock_loan_iov(&loan, iov, ARRAY_SIZE(iov));
+	zassert_true(n > 1, "payload in one fragment");
+	zassert_equal(zsock_loan_iov(&loan, iov, 1), 1, "wrong iov count");
+
+	n = zsock_loan_iov(&loan, iov, ARRAY_SIZE(iov));
+	for (int i = 0; i < n; i++) {
+		zassert_true(len + iov[i].iov_len <= sizeof(buf), "overflow");
+		memcpy(buf + len, iov[i].iov_base, iov[i].iov_len);
+		len += iov[i].iov_len;
+	}
+
+	zassert_equal(len, strlen(TEST_STR_LONG), "wrong iov length");
+	zassert_mem_equal(buf, TEST_STR_LONG, len, "wrong data");
+
+	/* The packet goes back to its slab on release only */
+	slab = loan.pkt->slab;
+	free_pkts = k_mem_slab_num_free_get(slab);
+	zsock_loan_release(&loan);
+	zassert_equal(k_mem_slab_num_free_get(slab), free_pkts + 1,
+		      "packet not released");
+	zassert_is_null(loan.pkt, "loan not cleared");
+	zsock_loan_release(&loan);
+
+	rv = zsock_recv_loan(s_sock, &loan, MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(rv, -1, "recv_loan should fail");
+	zassert_equal(errno, EAGAIN, "wrong errno");
+
+	rv = zsock_recv_loan(s_sock, &loan, MSG_PEEK, NULL, NULL);
+	zassert_equal(rv, -1, "recv_loan should fail");
+	zassert_equal(errno, EOPNOTSUPP, "wrong errno");
+
+	close_socks();
+}
+
+static u32_t per_dgram(u32_t start)
+{
+	return (k_cycle_get_32() - start) / (ROUNDS * BATCH);
+}
+
+/* Moves ROUNDS * BATCH datagrams over the loopback with each receive
+ * API and prints the average cycles per datagram.
+ */
+static void test_v4_throughput(void)
+{
+	struct zsock_loan loan;
+	u32_t copy, mmsg, loaned;
+	u32_t start;
+	ssize_t rv;
+
+	open_socks();
+	prepare_msgs(DGRAM_SIZE);
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < BATCH; i++) {
+			rv = sendto(c_sock, tx_data[i], DGRAM_SIZE, 0,
+				    (struct sockaddr *)&s_addr,
+				    sizeof(s_addr));
+			zassert_equal(rv, DGRAM_SIZE, "sendto failed");
+		}
+
+		for (int i = 0; i < BATCH; i++) {
+			rv = recvfrom(s_sock, rx_data[i], DGRAM_SIZE, 0,
+				      NULL, NULL);
+			zassert_equal(rv, DGRAM_SIZE, "recvfrom failed");
+		}
+	}
+	copy = per_dgram(start);
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < ROUNDS; r++) {
+		rv = sendmmsg(c_sock, tx_msgs, BATCH, 0);
+		zassert_equal(rv, BATCH, "sendmmsg failed");
+		recv_all(BATCH);
+	}
+	mmsg = per_dgram(start);
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < ROUNDS; r++) {
+		rv = sendmmsg(c_sock, tx_msgs, BATCH, 0);
+		zassert_equal(rv, BATCH, "sendmmsg failed");
+
+		for (int i = 0; i < BATCH; i++) {
+			rv = zsock_recv_loan(s_sock, &loan, 0, NULL, NULL);
+			zassert_equal(rv, DGRAM_SIZE, "recv_loan failed");
+			zsock_loan_release(&loan);
+		}
+	}
+	loaned = per_dgram(start);
+
+	TC_PRINT("cycles per %d byte datagram: sendto/recvfrom %u "
+		 "sendmmsg/recvmmsg %u sendmmsg/loan %u\n",
+		 DGRAM_SIZE, copy, mmsg, loaned);
+
+	close_socks();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_mmsg,
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg),
+			 ztest_unit_test(test_v4_recv_loan),
+			 ztest_unit_test(test_v4_throughput));
+
+	ztest_run_test_suite(socket_mmsg);
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <disk/disk_access.h>
+
+#define DISK_NAME "CNT"
+#define RAM_DISK_NAME CONFIG_DISK_RAM_VOLUME_NAME
+#define SECTOR_SIZE 512
+
+#define CACHE_SECTORS CONFIG_DISK_ACCESS_CACHE_SECTORS
+#define IO_SECTORS CONFIG_DISK_ACCESS_CACHE_IO_SECTORS
+
+static u32_t reads, writes, last_count;
+static u8_t buf[IO_SECTORS * SECTOR_SIZE];
+
+/* Counts the operations reaching the disk, the RAM disk behind it is not
+ * initialized through disk_access_init() so it is not cached itself.
+ */
+static int cnt_read(struct disk_info *disk, u8_t *data_buf,
+		    u32_t start_sector, u32_t num_sector)
+{
+	reads++;
+	last_count = num_sector;
+
+	return disk_access_read(RAM_DISK_NAME, data_buf, start_sector,
+				num_sector);
+}
+
+static int cnt_write(struct disk_info *disk, const u8_t *data_buf,
+		     u32_t start_sector, u32_t num_sector)
+{
+	writes++;
+	last_count = num_sector;
+
+	return disk_access_write(RAM_DISK_NAME, data_buf, start_sector,
+				 num_sector);
+}
+
+static int cnt_ioctl(struct disk_info *disk, u8_t cmd, void *buff)
+{
+	return disk_access_ioctl(RAM_DISK_NAME, cmd, buff);
+}
+
+static int cnt_status(struct disk_info *disk)
+{
+	return disk_access_status(RAM_DISK_NAME);
+}
+
+static const struct disk_operations cnt_ops = {
+	.init = cnt_status,
+	.status = cnt_status,
+	.read = cnt_read,
+	.write = cnt_write,
+	.ioctl = cnt_ioctl,
+};
+
+static struct disk_info cnt_disk = {
+	.name = DISK_NAME,
+	.ops = &cnt_ops,
+};
+
+static void fill(u8_t *data, u32_t sector, u8_t tag)
+{
+	memset(data, tag, SECTOR_SIZE);
+	memcpy(data, &sector, sizeof(sector));
+}
+
+static void check(const u8_t *data, u32_t sector, u8_t tag)
+{
+	u8_t expected[SECTOR_SIZE];
+
+	fill(expected, sector, tag);
+	zassert_mem_equal(data, expected, SECTOR_SIZE,
+			  "Wrong data in sector %u", sector);
+}
+
+/* Writes directly to the RAM disk, behind the back of the cache */
+static void backing_fill(u32_t sector, u32_t count, u8_t tag)
+{
+	u8_t data[SECTOR_SIZE];
+
+	for (u32_t i = 0; i < count; i++) {
+		fill(data, sector + i, tag);
+		disk_access_write(RAM_DISK_NAME, data, sector + i, 1);
+	}
+}
+
+static void backing_check(u32_t sector, u8_t tag)
+{
+	u8_t data[SECTOR_SIZE];
+
+	disk_access_read(RAM_DISK_NAME, data, sector, 1);
+	check(data, sector, tag);
+}
+
+static void reset_counts(void)
+{
+	reads = 0U;
+	writes = 0U;
+}
+
+static void test_init(void)
+{
+	zassert_equal(disk_access_register(&cnt_disk), 0, "Register failed");
+	zassert_equal(disk_access_init(DISK_NAME), 0, "Init failed");
+}
+
+static void test_read_ahead(void)
+{
+	backing_fill(0, 2 * IO_SECTORS, 0xa0);
+	reset_counts();
+
+	/* A first read is not known to be sequential */
+	zassert_equal(disk_access_read(DISK_NAME, buf, 0, 1), 0, NULL);
+	check(buf, 0, 0xa0);
+	zassert_equal(reads, 1, "Read ahead on a random read");
+	zassert_equal(last_count, 1, "Read ahead on a random read");
+
+	/* Continuing reads the following sectors at once */
+	for (u32_t i = 1; i <= IO_SECTORS; i++) {
+		zassert_equal(disk_access_read(DISK_NAME, buf, i, 1), 0, NULL);
+		check(buf, i, 0xa0);
+	}
+
+	zassert_equal(reads, 2, "Sectors not read ahead");
+	zassert_equal(last_count, IO_SECTORS, "Wrong read ahead size");
+
+	/* Reading again is served from the cache */
+	zassert_equal(disk_access_read(DISK_NAME, buf, 0, 4), 0, NULL);
+	check(buf + 3 * SECTOR_SIZE, 3, 0xa0);
+	zassert_equal(reads, 2, "Cached sectors read again");
+}
+
+static void test_write_back(void)
+{
+	const u32_t start = 100;
+
+	backing_fill(start, 4, 0xb0);
+	reset_counts();
+
+	for (u32_t i = 0; i < 4; i++) {
+		fill(buf, start + i, 0xb1);
+		zassert_equal(disk_access_write(DISK_NAME, buf, start + i, 1),
+			      0, NULL);
+	}
+
+	zassert_equal(writes, 0, "Written through");
+	backing_check(start, 0xb0);
+
+	/* The cached data is the current one */
+	zassert_equal(disk_access_read(DISK_NAME, buf, start + 2, 1), 0,
+		      NULL);
+	check(buf, start + 2, 0xb1);
+	zassert_equal(reads, 0, "Dirty sector read from the disk");
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, "Sync failed");
+	zassert_equal(writes, 1, "Contiguous sectors not written at once");
+	zassert_equal(last_count, 4, "Wrong write back size");
+
+	for (u32_t i = 0; i < 4; i++) {
+		backing_check(start + i, 0xb1);
+	}
+
+	/* Nothing left to write back */
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, "Sync failed");
+	zassert_equal(writes, 1, "Clean sectors written back");
+}
+
+static void test_eviction(void)
+{
+	const u32_t dirty = 120;
+
+	fill(buf, dirty, 0xc1);
+	zassert_equal(disk_access_write(DISK_NAME, buf, dirty, 1), 0, NULL);
+	reset_counts();
+
+	/* Random reads of other sectors push the dirty one out */
+	for (u32_t i = 0; i < CACHE_SECTORS; i++) {
+		zassert_equal(disk_access_read(DISK_NAME, buf, 140 + 2 * i, 1),
+			      0, NULL);
+	}
+
+	zassert_equal(writes, 1, "Evicted sector not written back");
+	backing_check(dirty, 0xc1);
+
+	zassert_equal(disk_access_read(DISK_NAME, buf, dirty, 1), 0, NULL);
+	check(buf, dirty, 0xc1);
+}
+
+static void test_large_transfer(void)
+{
+	const u32_t start = 60;
+
+	/* Cache one of the sectors, then overwrite it with a large write */
+	fill(buf, start + 1, 0xd0);
+	zassert_equal(disk_access_write(DISK_NAME, buf, start + 1, 1), 0,
+		      NULL);
+
+	for (u32_t i = 0; i < IO_SECTORS; i++) {
+		fill(buf + i * SECTOR_SIZE, start + i, 0xd1);
+	}
+
+	reset_counts();
+	zassert_equal(disk_access_write(DISK_NAME, buf, start, IO_SECTORS), 0,
+		      NULL);
+	zassert_equal(writes, 1, "Large write not passed through");
+	backing_check(start + IO_SECTORS - 1, 0xd1);
+
+	/* The cached copy was updated and is clean */
+	zassert_equal(disk_access_read(DISK_NAME, buf, start + 1, 1), 0,
+		      NULL);
+	check(buf, start + 1, 0xd1);
+	zassert_equal(reads, 0, "Cached sector dropped");
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, "Sync failed");
+	zassert_equal(writes, 1, "Stale sector written back");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(disk_cache,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_read_ahead),
+			 ztest_unit_test(test_write_back),
+			 ztest_unit_test(test_eviction),
+			 ztest_unit_test(test_large_transfer));
+
+	ztest_run_test_suite(disk_cache);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Buffered file access and nested mount points:
+ * * fs_open_buffered
+ * * read/write/seek/tell through the file buffer
+ * * longest prefix mount point lookup
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include "testfs_tests.h"
+#include "testfs_lfs.h"
+
+#define RECORD_SIZE 10
+#define RECORD_NUM 50
+#define BUFFER_SIZE 64
+
+static const char *nested_mnt = "/sml/nested";
+
+static void fill_record(u8_t *rec, unsigned int idx)
+{
+	for (unsigned int i = 0; i < RECORD_SIZE; i++) {
+		rec[i] = (u8_t)(idx + i);
+	}
+}
+
+static int write_records(const struct fs_mount_t *mp)
+{
+	struct testfs_path path;
+	struct fs_file_t file;
+	u8_t rec[RECORD_SIZE];
+
+	TC_PRINT("buffered append of small records\n");
+
+	zassert_equal(fs_open_buffered(&file,
+				       testfs_path_init(&path, mp,
+							"records",
+							TESTFS_PATH_END),
+				       BUFFER_SIZE),
+		      0,
+		      "open buffered failed");
+
+	for (unsigned int i = 0; i < RECORD_NUM; i++) {
+		fill_record(rec, i);
+		zassert_equal(fs_write(&file, rec, sizeof(rec)), sizeof(rec),
+			      "write record failed");
+		zassert_equal(fs_tell(&file), (i + 1) * sizeof(rec),
+			      "tell after write failed");
+	}
+
+	zassert_equal(fs_sync(&file), 0,
+		      "sync failed");
+	zassert_equal(fs_tell(&file), RECORD_NUM * RECORD_SIZE,
+		      "tell after sync failed");
+
+	zassert_equal(fs_close(&file), 0,
+		      "close failed");
+
+	return TC_PASS;
+}
+
+static int verify_records(const struct fs_mount_t *mp, bool buffered)
+{
+	struct testfs_path path;
+	struct fs_file_t file;
+	u8_t rec[RECORD_SIZE];
+	u8_t exp[RECORD_SIZE];
+
+	TC_PRINT("%s read of small records\n",
+		 buffered ? "buffered" : "unbuffered");
+
+	testfs_path_init(&path, mp, "records", TESTFS_PATH_END);
+	if (buffered) {
+		zassert_equal(fs_open_buffered(&file, path.path, BUFFER_SIZE),
+			      0,
+			      "open buffered failed");
+	} else {
+		zassert_equal(fs_open(&file, path.path), 0,
+			      "open failed");
+	}
+
+	for (unsigned int i = 0; i < RECORD_NUM; i++) {
+		fill_record(exp, i);
+		zassert_equal(fs_read(&file, rec, sizeof(rec)), sizeof(rec),
+			      "read record failed");
+		zassert_equal(memcmp(rec, exp, sizeof(rec)), 0,
+			      "record content mismatch");
+		zassert_equal(fs_tell(&file), (i + 1) * sizeof(rec),
+			      "tell after read failed");
+	}
+
+	zassert_equal(fs_read(&file, rec, sizeof(rec)), 0,
+		      "read past end failed");
+
+	zassert_equal(fs_close(&file), 0,
+		      "close failed");
+
+	return TC_PASS;
+}
+
+static int mixed_access(const struct fs_mount_t *mp)
+{
+	struct testfs_path path;
+	struct fs_file_t file;
+	u8_t rec[RECORD_SIZE];
+	u8_t exp[RECORD_SIZE];
+
+	TC_PRINT("buffered seek and update of records\n");
+
+	zassert_equal(fs_open_buffered(&file,
+				       testfs_path_init(&path, mp,
+							"records",
+							TESTFS_PATH_END),
+				       BUFFER_SIZE),
+		      0,
+		      "open buffered failed");
+
+	/* Read a record, then overwrite the one following it */
+	zassert_equal(fs_seek(&file, 3 * RECORD_SIZE, FS_SEEK_SET), 0,
+		      "seek failed");
+	zassert_equal(fs_read(&file, rec, sizeof(rec)), sizeof(rec),
+		      "read record failed");
+	fill_record(exp, 3);
+	zassert_equal(memcmp(rec, exp, sizeof(rec)), 0,
+		      "record content mismatch");
+	zassert_equal(fs_tell(&file), 4 * RECORD_SIZE,
+		      "tell after read failed");
+
+	fill_record(rec, 100);
+	zassert_equal(fs_write(&file, rec, sizeof(rec)), sizeof(rec),
+		      "update record failed");
+	zassert_equal(fs_tell(&file), 5 * RECORD_SIZE,
+		      "tell after update failed");
+
+	/* Reading back flushes the update */
+	zassert_equal(fs_read(&file, rec, sizeof(rec)), sizeof(rec),
+		      "read record failed");
+	fill_record(exp, 5);
+	zassert_equal(memcmp(rec, exp, sizeof(rec)), 0,
+		      "record after update mismatch");
+
+	zassert_equal(fs_seek(&file, -2 * RECORD_SIZE, FS_SEEK_CUR), 0,
+		      "seek back failed");
+	zassert_equal(fs_read(&file, rec, sizeof(rec)), sizeof(rec),
+		      "read updated record failed");
+	fill_record(exp, 100);
+	zassert_equal(memcmp(rec, exp, sizeof(rec)), 0,
+		      "updated record mismatch");
+
+	/* Restore the record for the unbuffered check */
+	zassert_equal(fs_seek(&file, 4 * RECORD_SIZE, FS_SEEK_SET), 0,
+		      "seek failed");
+	fill_record(rec, 4);
+	zassert_equal(fs_write(&file, rec, sizeof(rec)), sizeof(rec),
+		      "restore record failed");
+
+	zassert_equal(fs_close(&file), 0,
+		      "close failed");
+
+	return TC_PASS;
+}
+
+void test_lfs_buffered(void)
+{
+	struct fs_mount_t *mp = &testfs_small_mnt;
+
+	zassert_equal(testfs_lfs_wipe_partition(mp),
+		      TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(fs_mount(mp), 0,
+		      "mount small failed");
+
+	zassert_equal(write_records(mp), TC_PASS,
+		      "write records failed");
+	zassert_equal(verify_records(mp, false), TC_PASS,
+		      "unbuffered verify failed");
+	zassert_equal(verify_records(mp, true), TC_PASS,
+		      "buffered verify failed");
+	zassert_equal(mixed_access(mp), TC_PASS,
+		      "mixed access failed");
+	zassert_equal(verify_records(mp, false), TC_PASS,
+		      "verify after update failed");
+
+	zassert_equal(fs_unmount(mp), 0,
+		      "unmount small failed");
+}
+
+void test_lfs_nested_mount(void)
+{
+	struct fs_mount_t *outer = &testfs_small_mnt;
+	struct fs_mount_t *inner = &testfs_medium_mnt;
+	const char *inner_mnt = inner->mnt_point;
+	struct testfs_path path;
+	struct fs_file_t file;
+	struct fs_dirent stat;
+
+	zassert_equal(testfs_lfs_wipe_partition(outer),
+		      TC_PASS,
+		      "failed to wipe small partition");
+	zassert_equal(testfs_lfs_wipe_partition(inner),
+		      TC_PASS,
+		      "failed to wipe medium partition");
+
+	/* Mount the inner file system first so list order does not help */
+	inner->mnt_point = nested_mnt;
+	zassert_equal(fs_mount(inner), 0,
+		      "mount nested failed");
+	zassert_equal(fs_mount(outer), 0,
+		      "mount small failed");
+
+	zassert_equal(fs_open(&file,
+			      testfs_path_init(&path, inner,
+					       "file",
+					       TESTFS_PATH_END)),
+		      0,
+		      "open in nested failed");
+	zassert_equal(fs_close(&file), 0,
+		      "close in nested failed");
+
+	zassert_equal(fs_stat(path.path, &stat), 0,
+		      "stat in nested failed");
+
+	zassert_equal(fs_unmount(inner), 0,
+		      "unmount nested failed");
+	inner->mnt_point = inner_mnt;
+
+	/* The same path now resolves in the outer file system */
+	zassert_equal(fs_stat(path.path, &stat), -ENOENT,
+		      "stat in outer found nested file");
+
+	/* Nest again below the mounted outer file system, then remove the
+	 * outer one first: the nested mount point must stay reachable.
+	 */
+	inner->mnt_point = nested_mnt;
+	zassert_equal(fs_mount(inner), 0,
+		      "mount nested failed");
+	zassert_equal(fs_stat(path.path, &stat), 0,
+		      "stat in nested failed");
+
+	zassert_equal(fs_unmount(outer), 0,
+		      "unmount small failed");
+	zassert_equal(fs_stat(path.path, &stat), 0,
+		      "stat in nested failed without outer");
+	zassert_equal(fs_stat(outer->mnt_point, &stat), -ENOENT,
+		      "outer still mounted");
+
+	zassert_equal(fs_unmount(inner), 0,
+		      "unmount nested failed");
+	inner->mnt_point = inner_mnt;
+}
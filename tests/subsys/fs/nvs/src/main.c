@@ -596,6 +596,95 @@ void test_delete(void)
 		     " any footprint in the storage");
 }
 
+static int flash_sim_read_calls_find(struct stats_hdr *hdr, void *arg,
+				     const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		u32_t **flash_read_stat = (u32_t **) arg;
+		*flash_read_stat = (u32_t *)((u8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+#define BENCH_COLD_ID_COUNT	32
+#define BENCH_HOT_ID		BENCH_COLD_ID_COUNT
+#define BENCH_FILL_STEP		128
+#define BENCH_FILL_STEPS	8
+
+/*
+ * Read latency against fill level: a set of cold entries is written once,
+ * after which a single hot entry is rewritten to fill the file system. At
+ * every fill level all cold entries are read back while counting cycles and
+ * flash reads per nvs_read(). Without CONFIG_NVS_LOOKUP_CACHE both grow with
+ * the number of ATEs written after the cold entries, with the lookup cache
+ * enabled they stay constant. Without the cache a lookup can still never
+ * read more ATEs than the file system holds.
+ */
+void test_nvs_read_latency(void)
+{
+	int err;
+	ssize_t len;
+	u32_t data, start, cycles, reads, reads_max;
+	u32_t *flash_read_stat = NULL;
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	stats_walk(sim_stats, flash_sim_read_calls_find, &flash_read_stat);
+	zassert_true(flash_read_stat != NULL, "flash_read_calls not found");
+
+	/* every ATE, the close ATEs of each sector and the data */
+	reads_max = fs.sector_count * fs.sector_size / sizeof(struct nvs_ate) +
+		    2 * fs.sector_count + 1;
+
+	for (u16_t id = 0; id < BENCH_COLD_ID_COUNT; id++) {
+		data = id;
+		len = nvs_write(&fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	TC_PRINT("NVS read latency (lookup cache %s)\n",
+		 IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE) ? "enabled" : "disabled");
+	TC_PRINT("ATEs written   cycles/read  flash rd/read\n");
+
+	for (u32_t step = 0; step <= BENCH_FILL_STEPS; step++) {
+		reads = *flash_read_stat;
+		start = k_cycle_get_32();
+
+		for (u16_t id = 0; id < BENCH_COLD_ID_COUNT; id++) {
+			len = nvs_read(&fs, id, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_read unexpected failure: %d", len);
+			zassert_equal(data, id, "unexpected data read");
+		}
+
+		cycles = k_cycle_get_32() - start;
+		reads = *flash_read_stat - reads;
+
+		TC_PRINT("%12u %13u %14u\n",
+			 BENCH_COLD_ID_COUNT + step * BENCH_FILL_STEP,
+			 cycles / BENCH_COLD_ID_COUNT,
+			 reads / BENCH_COLD_ID_COUNT);
+
+		zassert_true(reads / BENCH_COLD_ID_COUNT <= reads_max,
+			     "%u flash reads per nvs_read(), expected at most %u",
+			     reads / BENCH_COLD_ID_COUNT, reads_max);
+
+		/* With the lookup cache the first fill level is the worst */
+		if (IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE) && step == 0) {
+			reads_max = reads / BENCH_COLD_ID_COUNT;
+		}
+
+		for (u32_t i = 0; i < BENCH_FILL_STEP; i++) {
+			data = i;
+			len = nvs_write(&fs, BENCH_HOT_ID, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_write failed: %d", len);
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -615,7 +704,9 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(test_nvs_full_sector,
 				 setup, teardown),
 			 ztest_unit_test_setup_teardown(test_delete, setup,
-				 teardown)
+				 teardown),
+			 ztest_unit_test_setup_teardown(test_nvs_read_latency,
+				 setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
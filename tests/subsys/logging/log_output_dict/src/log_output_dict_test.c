@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test dictionary format log output
+ */
+
+#include <logging/log.h>
+#include <logging/log_output.h>
+
+#include <tc_util.h>
+#include <stdbool.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+#define LOG_MODULE_NAME test
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#define TIMESTAMP 0x12345678
+
+static u8_t mock_buffer[512];
+static u8_t log_output_buf[8];
+static u32_t mock_len;
+
+static u8_t exp_buffer[512];
+static u32_t exp_len;
+
+static const struct log_msg_ids src_level = {
+	.level = LOG_LEVEL_WRN,
+	.source_id = 5,
+	.domain_id = 1,
+};
+
+static void setup(void)
+{
+	mock_len = 0U;
+	exp_len = 0U;
+}
+
+static void teardown(void)
+{
+
+}
+
+static int mock_output_func(u8_t *buf, size_t size, void *ctx)
+{
+	memcpy(&mock_buffer[mock_len], buf, size);
+	mock_len += size;
+
+	return size;
+}
+
+LOG_OUTPUT_DEFINE(log_output, mock_output_func,
+		  log_output_buf, sizeof(log_output_buf));
+
+static void exp_add(const void *data, size_t len)
+{
+	memcpy(&exp_buffer[exp_len], data, len);
+	exp_len += len;
+}
+
+static void exp_hdr_add(u8_t type)
+{
+	u8_t sync[] = { 0xA5, 0x5A };
+	u8_t ctrl = type | (LOG_LEVEL_WRN << 2) | (1 << 5);
+	u16_t source_id = 5;
+	u32_t timestamp = TIMESTAMP;
+
+	exp_add(sync, sizeof(sync));
+	exp_add(&ctrl, sizeof(ctrl));
+	exp_add(&source_id, sizeof(source_id));
+	exp_add(&timestamp, sizeof(timestamp));
+}
+
+/* Adds the argument words, their number first */
+static void exp_args_add(const void *words, size_t len)
+{
+	u8_t nwords = len / sizeof(log_arg_t);
+
+	exp_add(&nwords, sizeof(nwords));
+	exp_add(words, len);
+}
+
+static void validate_output(void)
+{
+	zassert_equal(exp_len, mock_len, "Unexpected record length");
+	zassert_mem_equal(exp_buffer, mock_buffer, mock_len,
+			  "Unexpected record");
+}
+
+static void log_output_string_varg(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+
+	log_output_string(&log_output, src_level, TIMESTAMP, fmt, ap,
+			  LOG_OUTPUT_FLAG_FORMAT_DICT);
+
+	va_end(ap);
+}
+
+void test_log_output_dict_string(void)
+{
+	static const char fmt[] = "abc %d %-*s %lld %p %.2f";
+	const char *str = "efg";
+	const void *ptr = &log_output;
+	long long ll = 0x123456789LL;
+	double dbl = 1.25;
+	struct {
+		log_arg_t head[3];
+		long long ll;
+		log_arg_t ptr;
+		double dbl;
+	} __packed args = {
+		.head = { (log_arg_t)-1, (log_arg_t)5, (log_arg_t)str },
+		.ll = ll,
+		.ptr = (log_arg_t)ptr,
+		.dbl = dbl,
+	};
+	const char *fmt_addr = fmt;
+
+	log_output_string_varg(fmt, -1, 5, str, ll, ptr, dbl);
+
+	/* 64-bit values are not truncated to a 32-bit log_arg_t */
+	exp_hdr_add(0);
+	exp_add(&fmt_addr, sizeof(fmt_addr));
+	exp_args_add(&args, sizeof(args));
+	exp_add(str, strlen(str) + 1);
+
+	validate_output();
+}
+
+void test_log_output_dict_msg(void)
+{
+	static const char fmt[] = "%s %%s %x %lld %llu %f";
+	const char *str = "efg";
+	struct {
+		log_arg_t head[2];
+		s64_t lld;
+		u64_t llu;
+		double dbl;
+	} __packed args = {
+		.head = { (log_arg_t)str, (log_arg_t)0xabc },
+		.lld = -2,
+		.llu = (log_arg_t)-2,
+		.dbl = 7.0,
+	};
+	log_arg_t msg_args[] = {
+		(log_arg_t)str, 0xabc, (log_arg_t)-2, (log_arg_t)-2, 7
+	};
+	const char *fmt_addr = fmt;
+	struct log_msg *msg;
+
+	/* A message holds single words, 64-bit conversions are widened */
+	msg = log_msg_create_n(fmt, msg_args, ARRAY_SIZE(msg_args));
+	zassert_not_null(msg, "Message allocation failed");
+
+	msg->hdr.ids = src_level;
+	msg->hdr.timestamp = TIMESTAMP;
+
+	log_output_msg_process(&log_output, msg, LOG_OUTPUT_FLAG_FORMAT_DICT);
+	log_msg_put(msg);
+
+	exp_hdr_add(0);
+	exp_add(&fmt_addr, sizeof(fmt_addr));
+	exp_args_add(&args, sizeof(args));
+	exp_add(str, strlen(str) + 1);
+
+	validate_output();
+}
+
+void test_log_output_dict_hexdump(void)
+{
+	static const char metadata[] = "data";
+	const char *metadata_addr = metadata;
+	u8_t data[40];
+	u16_t length = sizeof(data);
+	struct log_msg *msg;
+
+	for (int i = 0; i < sizeof(data); i++) {
+		data[i] = i;
+	}
+
+	log_output_hexdump(&log_output, src_level, TIMESTAMP, metadata,
+			   data, sizeof(data), LOG_OUTPUT_FLAG_FORMAT_DICT);
+
+	exp_hdr_add(1);
+	exp_add(&metadata_addr, sizeof(metadata_addr));
+	exp_add(&length, sizeof(length));
+	exp_add(data, sizeof(data));
+
+	validate_output();
+
+	/* Same record from a message spanning several chunks */
+	mock_len = 0U;
+
+	msg = log_msg_hexdump_create(metadata, data, sizeof(data));
+	zassert_not_null(msg, "Message allocation failed");
+
+	msg->hdr.ids = src_level;
+	msg->hdr.timestamp = TIMESTAMP;
+
+	log_output_msg_process(&log_output, msg, LOG_OUTPUT_FLAG_FORMAT_DICT);
+	log_msg_put(msg);
+
+	validate_output();
+}
+
+void test_log_output_dict_dropped(void)
+{
+	u8_t hdr[] = { 0xA5, 0x5A, 2 };
+	u32_t cnt = 1234;
+
+	log_output_dropped_dict_process(&log_output, cnt);
+
+	exp_add(hdr, sizeof(hdr));
+	exp_add(&cnt, sizeof(cnt));
+
+	validate_output();
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_log_output_dict,
+		ztest_unit_test_setup_teardown(test_log_output_dict_string,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_log_output_dict_msg,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_log_output_dict_hexdump,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_log_output_dict_dropped,
+					       setup, teardown)
+		);
+	ztest_run_test_suite(test_log_output_dict);
+}
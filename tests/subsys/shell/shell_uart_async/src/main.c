@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Shell UART backend and tty over the asynchronous UART API
+ *
+ * The shell runs on one device of an emulated UART pair, the test talks to
+ * it through a tty on the other device.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <shell/shell.h>
+#include <console/tty.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart_loopback.h"
+
+#define PASTE_CMD "loop_cnt\n"
+#define PASTE_CMD_CNT 300
+#define PASTE_SIZE (PASTE_CMD_CNT * (sizeof(PASTE_CMD) - 1))
+
+#define WRITER_STACK_SIZE 1024
+#define WRITER_PRIORITY 5
+
+static struct tty_serial tty;
+static u8_t tty_rxbuf[256];
+static u8_t tty_txbuf[256];
+static char rx_log[512];
+static size_t rx_log_len;
+static char paste[PASTE_SIZE];
+static volatile u32_t cmd_cnt;
+static s64_t cmd_last_time;
+
+K_THREAD_STACK_DEFINE(writer_stack, WRITER_STACK_SIZE);
+static struct k_thread writer_thread;
+static K_SEM_DEFINE(writer_done, 0, 1);
+
+static int cmd_loop_cnt(const struct shell *shell, size_t argc, char **argv)
+{
+	cmd_cnt++;
+	cmd_last_time = k_uptime_get();
+
+	return 0;
+}
+
+static int cmd_loop_sum(const struct shell *shell, size_t argc, char **argv)
+{
+	long sum = 0;
+
+	for (size_t i = 1; i < argc; i++) {
+		sum += strtol(argv[i], NULL, 10);
+	}
+
+	shell_print(shell, "sum %ld", sum);
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(loop_cnt, NULL, "Count calls.", cmd_loop_cnt);
+SHELL_CMD_REGISTER(loop_sum, NULL, "Sum arguments.", cmd_loop_sum);
+
+static void tty_send(const void *data, size_t len)
+{
+	zassert_equal(tty_write(&tty, data, len), len, "tty write failed");
+}
+
+/* Reads shell output until it contains the given string or nothing is
+ * received for the read timeout. Output is kept in rx_log.
+ */
+static bool tty_expect(const char *str)
+{
+	ssize_t len;
+
+	rx_log_len = 0;
+
+	while (true) {
+		len = tty_read(&tty, &rx_log[rx_log_len],
+			       sizeof(rx_log) - rx_log_len - 1);
+		if (len <= 0) {
+			return false;
+		}
+
+		rx_log_len += len;
+		rx_log[rx_log_len] = '\0';
+		if (strstr(rx_log, str)) {
+			return true;
+		}
+
+		if (rx_log_len == sizeof(rx_log) - 1) {
+			rx_log_len = 0;
+		}
+	}
+}
+
+static void drain(void)
+{
+	u8_t buf[64];
+
+	while (tty_read(&tty, buf, sizeof(buf)) > 0) {
+	}
+}
+
+static void test_shell_uart_async_setup(void)
+{
+	struct device *dev = device_get_binding(UART_LOOP_B_NAME);
+
+	zassert_not_null(dev, "No loopback device");
+	zassert_equal(tty_init(&tty, dev), 0, "tty init failed");
+	zassert_equal(tty_set_tx_buf(&tty, tty_txbuf, sizeof(tty_txbuf)), 0,
+		      "tty TX buffer failed");
+	zassert_equal(tty_set_rx_buf(&tty, tty_rxbuf, sizeof(tty_rxbuf)), 0,
+		      "tty RX buffer failed");
+	tty_set_rx_timeout(&tty, 50);
+
+	/* Prompt printed by the shell on startup. */
+	drain();
+}
+
+static void test_shell_uart_async_cmd(void)
+{
+	static const char cmd[] = "loop_sum 1 2 3\n";
+
+	tty_send(cmd, sizeof(cmd) - 1);
+	zassert_true(tty_expect("sum 6"), "Unexpected output: %s", rx_log);
+	drain();
+
+	zassert_equal(uart_loop_overruns(device_get_binding(UART_LOOP_A_NAME)),
+		      0, "Shell lost input");
+	zassert_equal(uart_loop_overruns(device_get_binding(UART_LOOP_B_NAME)),
+		      0, "tty lost input");
+}
+
+/* A line error stops tty reception in the middle of an RX buffer half while
+ * the other half is already queued. Reception must resume right after the
+ * data received so far, or tty_read() would return stale buffer content.
+ */
+static void test_shell_uart_async_rx_error(void)
+{
+	static const char cmd1[] = "loop_sum 1 2 3\n";
+	static const char cmd2[] = "loop_sum 4 5 6\n";
+	struct device *dev = device_get_binding(UART_LOOP_B_NAME);
+
+	/* Leave the first reply unread in the current half. */
+	tty_send(cmd1, sizeof(cmd1) - 1);
+	k_sleep(K_MSEC(50));
+
+	uart_loop_rx_error(dev);
+	k_sleep(K_MSEC(10));
+
+	tty_send(cmd2, sizeof(cmd2) - 1);
+	zassert_true(tty_expect("sum 15"), "Unexpected output: %s", rx_log);
+	zassert_not_null(strstr(rx_log, "sum 6"), "Lost output: %s", rx_log);
+	zassert_true(strstr(rx_log, "sum 6") < strstr(rx_log, "sum 15"),
+		     "Output out of order: %s", rx_log);
+	drain();
+
+	zassert_equal(uart_loop_overruns(dev), 0, "tty lost input");
+}
+
+static void writer(void *p1, void *p2, void *p3)
+{
+	tty_send(paste, PASTE_SIZE);
+	k_sem_give(&writer_done);
+}
+
+/* A script is pasted at full line rate; every command must be executed and
+ * the shell must keep up with the emulated baudrate.
+ */
+static void test_shell_uart_async_paste(void)
+{
+	static const char echo_off[] = "shell echo off\n";
+	u32_t bytes_per_sec;
+	u32_t max_ms;
+	s64_t start;
+	u32_t ms;
+
+	for (int i = 0; i < PASTE_CMD_CNT; i++) {
+		memcpy(&paste[i * (sizeof(PASTE_CMD) - 1)], PASTE_CMD,
+		       sizeof(PASTE_CMD) - 1);
+	}
+
+	/* Echo would double the traffic from the shell. */
+	tty_send(echo_off, sizeof(echo_off) - 1);
+	drain();
+
+	cmd_cnt = 0U;
+	start = k_uptime_get();
+
+	k_thread_create(&writer_thread, writer_stack,
+			K_THREAD_STACK_SIZEOF(writer_stack), writer,
+			NULL, NULL, NULL, WRITER_PRIORITY, 0, K_NO_WAIT);
+
+	while (cmd_cnt < PASTE_CMD_CNT && k_uptime_get() - start < 2000) {
+		drain();
+	}
+
+	ms = cmd_last_time - start;
+	zassert_equal(k_sem_take(&writer_done, K_NO_WAIT), 0,
+		      "Paste not sent");
+	drain();
+
+	zassert_equal(cmd_cnt, PASTE_CMD_CNT, "%u of %u commands executed",
+		      cmd_cnt, PASTE_CMD_CNT);
+	zassert_equal(uart_loop_overruns(device_get_binding(UART_LOOP_A_NAME)),
+		      0, "Shell lost input");
+
+	bytes_per_sec = PASTE_SIZE * 1000U / MAX(ms, 1);
+	TC_PRINT("%u bytes in %u ms: %u bytes/s (line rate %u bytes/s)\n",
+		 (u32_t)PASTE_SIZE, ms, bytes_per_sec,
+		 CONFIG_UART_LOOPBACK_BYTES_PER_TICK * 1000U);
+
+	/* Allow for the gaps between tty TX transfers. */
+	max_ms = PASTE_SIZE / CONFIG_UART_LOOPBACK_BYTES_PER_TICK * 5U / 4U;
+	zassert_true(ms <= max_ms, "Shell too slow: %u ms", ms);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(shell_uart_async,
+			 ztest_unit_test(test_shell_uart_async_setup),
+			 ztest_unit_test(test_shell_uart_async_cmd),
+			 ztest_unit_test(test_shell_uart_async_rx_error),
+			 ztest_unit_test(test_shell_uart_async_paste));
+
+	ztest_run_test_suite(shell_uart_async);
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Pair of cross connected UART devices implementing the asynchronous UART
+ * API. Data is moved between the devices from a timer, at a fixed number of
+ * bytes per tick, emulating DMA transfers at a given baudrate. Bytes which
+ * arrive while the receiver has no buffer are counted as overruns. A line
+ * error can be injected to stop reception in the middle of a buffer.
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <drivers/uart.h>
+#include "uart_loopback.h"
+
+struct uart_loop_data {
+	struct device *peer;
+	uart_callback_t callback;
+	void *user_data;
+
+	const u8_t *tx_buf;
+	size_t tx_len;
+	size_t tx_pos;
+
+	u8_t *rx_buf;
+	size_t rx_len;
+	size_t rx_offset;
+	size_t rx_pos;
+	u8_t *rx_next_buf;
+	size_t rx_next_len;
+	bool rx_enabled;
+	bool rx_req;
+	bool rx_disable_req;
+	bool rx_error_req;
+
+	u32_t overruns;
+};
+
+static struct k_timer loop_timer;
+static bool loop_running;
+
+static void loop_event(struct device *dev, struct uart_event *evt)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	if (data->callback) {
+		data->callback(evt, data->user_data);
+	}
+}
+
+static void loop_rx_rdy(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	struct uart_event evt = {
+		.type = UART_RX_RDY,
+		.data.rx.buf = data->rx_buf,
+		.data.rx.offset = data->rx_offset,
+		.data.rx.len = data->rx_pos - data->rx_offset,
+	};
+
+	if (evt.data.rx.len) {
+		data->rx_offset = data->rx_pos;
+		loop_event(dev, &evt);
+	}
+}
+
+static void loop_rx_release(struct device *dev, bool disable)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	struct uart_event evt = {
+		.type = UART_RX_BUF_RELEASED,
+		.data.rx_buf.buf = data->rx_buf,
+	};
+
+	loop_event(dev, &evt);
+
+	if (data->rx_next_buf && !disable) {
+		data->rx_buf = data->rx_next_buf;
+		data->rx_len = data->rx_next_len;
+		data->rx_offset = 0;
+		data->rx_pos = 0;
+		data->rx_next_buf = NULL;
+		evt.type = UART_RX_BUF_REQUEST;
+		loop_event(dev, &evt);
+		return;
+	}
+
+	if (data->rx_next_buf) {
+		evt.data.rx_buf.buf = data->rx_next_buf;
+		data->rx_next_buf = NULL;
+		loop_event(dev, &evt);
+	}
+
+	data->rx_enabled = false;
+	evt.type = UART_RX_DISABLED;
+	loop_event(dev, &evt);
+}
+
+static void loop_rx_byte(struct device *dev, u8_t c)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	if (!data->rx_enabled) {
+		data->overruns++;
+		return;
+	}
+
+	data->rx_buf[data->rx_pos++] = c;
+
+	if (data->rx_pos == data->rx_len) {
+		loop_rx_rdy(dev);
+		loop_rx_release(dev, false);
+	}
+}
+
+static void loop_rx_process(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	struct uart_event evt = {
+		.type = UART_RX_BUF_REQUEST,
+	};
+
+	if (data->rx_error_req && data->rx_enabled) {
+		struct uart_event stop_evt = {
+			.type = UART_RX_STOPPED,
+			.data.rx_stop.reason = UART_ERROR_FRAMING,
+		};
+
+		data->rx_error_req = false;
+		loop_rx_rdy(dev);
+		loop_event(dev, &stop_evt);
+		loop_rx_release(dev, true);
+		return;
+	}
+
+	if (data->rx_disable_req) {
+		data->rx_disable_req = false;
+		loop_rx_rdy(dev);
+		loop_rx_release(dev, true);
+		return;
+	}
+
+	if (data->rx_req) {
+		data->rx_req = false;
+		loop_event(dev, &evt);
+	}
+}
+
+static void loop_tx_process(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	struct uart_event evt = {
+		.type = UART_TX_DONE,
+	};
+	size_t len;
+
+	if (!data->tx_buf) {
+		return;
+	}
+
+	len = MIN(data->tx_len - data->tx_pos,
+		  CONFIG_UART_LOOPBACK_BYTES_PER_TICK);
+
+	while (len--) {
+		loop_rx_byte(data->peer, data->tx_buf[data->tx_pos++]);
+	}
+
+	if (data->tx_pos == data->tx_len) {
+		evt.data.tx.buf = data->tx_buf;
+		evt.data.tx.len = data->tx_len;
+		data->tx_buf = NULL;
+		loop_event(dev, &evt);
+	}
+}
+
+static void loop_timer_handler(struct k_timer *timer)
+{
+	struct device *devs[] = {
+		device_get_binding(UART_LOOP_A_NAME),
+		device_get_binding(UART_LOOP_B_NAME),
+	};
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(devs); i++) {
+		loop_rx_process(devs[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(devs); i++) {
+		loop_tx_process(devs[i]);
+	}
+
+	/* Receiver is idle for the rest of the tick: report data received so
+	 * far, as a driver would on RX timeout.
+	 */
+	for (i = 0; i < ARRAY_SIZE(devs); i++) {
+		struct uart_loop_data *data = devs[i]->driver_data;
+
+		if (data->rx_enabled) {
+			loop_rx_rdy(devs[i]);
+		}
+	}
+}
+
+static void loop_start(void)
+{
+	if (!loop_running) {
+		loop_running = true;
+		k_timer_start(&loop_timer, K_MSEC(1), K_MSEC(1));
+	}
+}
+
+static int loop_callback_set(struct device *dev, uart_callback_t callback,
+			     void *user_data)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	data->callback = callback;
+	data->user_data = user_data;
+
+	return 0;
+}
+
+static int loop_tx(struct device *dev, const u8_t *buf, size_t len,
+		   s32_t timeout)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	unsigned int key = irq_lock();
+
+	if (data->tx_buf) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	data->tx_buf = buf;
+	data->tx_len = len;
+	data->tx_pos = 0;
+	loop_start();
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int loop_tx_abort(struct device *dev)
+{
+	return -ENOTSUP;
+}
+
+static int loop_rx_enable(struct device *dev, u8_t *buf, size_t len,
+			  s32_t timeout)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	unsigned int key = irq_lock();
+
+	if (data->rx_enabled) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	data->rx_buf = buf;
+	data->rx_len = len;
+	data->rx_offset = 0;
+	data->rx_pos = 0;
+	data->rx_next_buf = NULL;
+	data->rx_enabled = true;
+	data->rx_req = true;
+	loop_start();
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int loop_rx_buf_rsp(struct device *dev, u8_t *buf, size_t len)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	unsigned int key = irq_lock();
+	int err = 0;
+
+	if (!data->rx_enabled || data->rx_next_buf) {
+		err = -EBUSY;
+	} else {
+		data->rx_next_buf = buf;
+		data->rx_next_len = len;
+	}
+
+	irq_unlock(key);
+
+	return err;
+}
+
+static int loop_rx_disable(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	if (!data->rx_enabled) {
+		return -EFAULT;
+	}
+
+	data->rx_disable_req = true;
+
+	return 0;
+}
+
+static int loop_poll_in(struct device *dev, unsigned char *c)
+{
+	return -1;
+}
+
+static void loop_poll_out(struct device *dev, unsigned char c)
+{
+	struct uart_loop_data *data = dev->driver_data;
+	unsigned int key = irq_lock();
+
+	/* Polled output bypasses the emulated baudrate. */
+	loop_rx_byte(data->peer, c);
+	irq_unlock(key);
+}
+
+u32_t uart_loop_overruns(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	return data->overruns;
+}
+
+void uart_loop_rx_error(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	data->rx_error_req = true;
+}
+
+static const struct uart_driver_api loop_api = {
+	.callback_set = loop_callback_set,
+	.tx = loop_tx,
+	.tx_abort = loop_tx_abort,
+	.rx_enable = loop_rx_enable,
+	.rx_buf_rsp = loop_rx_buf_rsp,
+	.rx_disable = loop_rx_disable,
+	.poll_in = loop_poll_in,
+	.poll_out = loop_poll_out,
+};
+
+static struct uart_loop_data loop_data_a;
+static struct uart_loop_data loop_data_b;
+
+static int loop_init(struct device *dev)
+{
+	struct uart_loop_data *data = dev->driver_data;
+
+	data->peer = device_get_binding((data == &loop_data_a) ?
+				UART_LOOP_B_NAME : UART_LOOP_A_NAME);
+	k_timer_init(&loop_timer, loop_timer_handler, NULL);
+
+	return 0;
+}
+
+DEVICE_AND_API_INIT(uart_loop_a, UART_LOOP_A_NAME, loop_init, &loop_data_a,
+		    NULL, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &loop_api);
+
+DEVICE_AND_API_INIT(uart_loop_b, UART_LOOP_B_NAME, loop_init, &loop_data_b,
+		    NULL, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &loop_api);
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __UART_LOOPBACK_H__
+#define __UART_LOOPBACK_H__
+
+#include <device.h>
+
+#define UART_LOOP_A_NAME "UART_LOOP_A"
+#define UART_LOOP_B_NAME "UART_LOOP_B"
+
+/* Number of bytes lost by the device because no RX buffer was available. */
+u32_t uart_loop_overruns(struct device *dev);
+
+/* Stop reception of the device on the next tick as on a line error. */
+void uart_loop_rx_error(struct device *dev);
+
+#endif /* __UART_LOOPBACK_H__ */
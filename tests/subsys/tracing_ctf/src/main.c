@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <tracing_core.h>
+#include <tracing_backend.h>
+
+#define CAPTURE_SIZE 8192
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WORKERS (CONFIG_MP_NUM_CPUS + 1)
+#define ITERATIONS 200
+
+static u8_t capture[CAPTURE_SIZE];
+static u32_t capture_len;
+static atomic_t capturing;
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, WORKERS, STACK_SIZE);
+static struct k_thread worker_threads[WORKERS];
+static K_SEM_DEFINE(workers_done, 0, WORKERS);
+
+static void custom_init(void)
+{
+}
+
+/* Runs in the tracing thread, the only one giving data to the backend */
+static void custom_output(const struct tracing_backend *backend,
+			  u8_t *data, u32_t length)
+{
+	if (!atomic_get(&capturing)) {
+		return;
+	}
+
+	if (length > sizeof(capture) - capture_len) {
+		atomic_clear(&capturing);
+		return;
+	}
+
+	memcpy(&capture[capture_len], data, length);
+	capture_len += length;
+}
+
+const struct tracing_backend_api tracing_backend_custom_api = {
+	.init = custom_init,
+	.output = custom_output
+};
+
+TRACING_BACKEND_DEFINE(tracing_backend_custom, tracing_backend_custom_api);
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		sys_trace_void(SYS_TRACE_ID_SEMA_GIVE);
+		k_busy_wait(10);
+		k_yield();
+	}
+
+	k_sem_give(&workers_done);
+}
+
+static void capture_events(void)
+{
+	capture_len = 0U;
+	atomic_set(&capturing, 1);
+
+	for (int i = 0; i < WORKERS; i++) {
+		k_thread_create(&worker_threads[i], worker_stacks[i],
+				STACK_SIZE, worker, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < WORKERS; i++) {
+		k_sem_take(&workers_done, K_FOREVER);
+	}
+
+	/* Let the tracing thread output what is left */
+	k_sleep(K_MSEC(4 * CONFIG_TRACING_THREAD_WAIT_THRESHOLD));
+	atomic_clear(&capturing);
+	k_sleep(K_MSEC(4 * CONFIG_TRACING_THREAD_WAIT_THRESHOLD));
+}
+
+static bool cycles_before(u32_t a, u32_t b)
+{
+	return (s32_t)(b - a) >= 0;
+}
+
+/**
+ * @brief Test that packets are per CPU and chain their timestamps
+ *
+ * @details Each packet must be of the one stream, carry its CPU as the
+ * instance of that stream, begin where the previous packet of the CPU
+ * ended and hold events timestamped within its bounds. On SMP, all
+ * CPUs must have output packets.
+ */
+static void test_packets_per_cpu(void)
+{
+	struct tracing_packet_header header;
+	u32_t end[CONFIG_MP_NUM_CPUS];
+	u32_t packets[CONFIG_MP_NUM_CPUS] = { 0 };
+	u32_t offset = 0U;
+	u32_t length, tstamp;
+
+	capture_events();
+	zassert_true(capture_len > sizeof(header), "nothing captured");
+
+	/* The capture may end in the middle of a packet */
+	while (capture_len - offset >= sizeof(header)) {
+		memcpy(&header, &capture[offset], sizeof(header));
+
+		zassert_equal(header.magic, TRACING_PACKET_MAGIC,
+			      "bad magic at %u", offset);
+		zassert_equal(header.stream_id, TRACING_PACKET_STREAM_ID,
+			      "bad stream id");
+		zassert_true(header.cpu_id < CONFIG_MP_NUM_CPUS, "bad cpu");
+		zassert_equal(header.stream_instance_id, header.cpu_id,
+			      "stream instance is not the cpu");
+		zassert_equal(header.content_size, header.packet_size,
+			      "padded packet");
+		zassert_true(header.packet_size >= sizeof(header) * 8U,
+			     "packet smaller than its header");
+		zassert_true(cycles_before(header.timestamp_begin,
+					   header.timestamp_end),
+			     "packet ends before it begins");
+
+		if (packets[header.cpu_id] != 0U) {
+			zassert_equal(header.timestamp_begin,
+				      end[header.cpu_id],
+				      "packet does not follow the previous");
+		}
+		end[header.cpu_id] = header.timestamp_end;
+		packets[header.cpu_id]++;
+
+		length = header.packet_size / 8U;
+		if (capture_len - offset < length) {
+			break;
+		}
+
+		/* Events begin with their timestamp */
+		if (length >= sizeof(header) + sizeof(tstamp)) {
+			memcpy(&tstamp, &capture[offset + sizeof(header)],
+			       sizeof(tstamp));
+			zassert_true(cycles_before(header.timestamp_begin,
+						   tstamp) &&
+				     cycles_before(tstamp,
+						   header.timestamp_end),
+				     "event outside of its packet");
+		}
+
+		offset += length;
+	}
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		zassert_true(packets[cpu] > 0U, "no packet from cpu %d", cpu);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tracing_ctf,
+			 ztest_unit_test(test_packets_per_cpu));
+	ztest_run_test_suite(tracing_ctf);
+}
@@ -17,10 +17,21 @@ void test_crc32_ieee(void)
 	u8_t test1[] = { 'A' };
 	u8_t test2[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
 	u8_t test3[] = { 'Z', 'e', 'p', 'h', 'y', 'r' };
+	const char test4[] = "_The quick brown fox jumps over the lazy dog";
+	const u8_t *test4_unaligned = (const u8_t *)test4 + 1;
+	size_t test4_len = sizeof(test4) - 2;
+	u32_t crc;
 
 	zassert_equal(crc32_ieee(test1, sizeof(test1)), 0xD3D99E8B, NULL);
 	zassert_equal(crc32_ieee(test2, sizeof(test2)), 0xCBF43926, NULL);
 	zassert_equal(crc32_ieee(test3, sizeof(test3)), 0x20089AA4, NULL);
+	zassert_equal(crc32_ieee(test4_unaligned, test4_len), 0x414FA339,
+		      NULL);
+
+	/* Splitting the input over several updates gives the same result */
+	crc = crc32_ieee_update(0, test4_unaligned, 13);
+	crc = crc32_ieee_update(crc, test4_unaligned + 13, test4_len - 13);
+	zassert_equal(crc, 0x414FA339, NULL);
 }
 
 void test_crc16(void)
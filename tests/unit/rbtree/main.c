@@ -89,14 +89,24 @@ void visit_node(struct rbnode *node, void *cookie)
  */
 static int last_black_height;
 
-void check_rbnode(struct rbnode *node, int blacks_above)
+/* Deepest node seen during check_rb(), the root being at depth 1 */
+static int max_depth_seen;
+
+void check_rbnode(struct rbnode *node, int blacks_above, int depth)
 {
 	int side, bheight = blacks_above + z_rb_is_black(node);
 
+	if (depth > max_depth_seen) {
+		max_depth_seen = depth;
+	}
+
 	for (side = 0; side < 2; side++) {
 		struct rbnode *ch = z_rb_child(node, side);
 
 		if (ch) {
+#ifdef CONFIG_RBTREE_PARENT_POINTERS
+			_CHECK(ch->parent == node);
+#endif
 			/* Basic tree requirement */
 			if (side == 0) {
 				_CHECK(node_lessthan(ch, node));
@@ -108,7 +118,7 @@ void check_rbnode(struct rbnode *node, int blacks_above)
 			_CHECK(z_rb_is_black(node) || z_rb_is_black(ch));
 
 			/* Recurse */
-			check_rbnode(ch, bheight);
+			check_rbnode(ch, bheight, depth + 1);
 		} else {
 			/* All leaf nodes must be at the same black height */
 			if (last_black_height) {
@@ -122,11 +132,19 @@ void check_rbnode(struct rbnode *node, int blacks_above)
 void check_rb(void)
 {
 	last_black_height = 0;
+	max_depth_seen = 0;
 
 	_CHECK(tree.root);
 	_CHECK(z_rb_is_black(tree.root));
+#ifdef CONFIG_RBTREE_PARENT_POINTERS
+	_CHECK(tree.root->parent == NULL);
+#endif
 
-	check_rbnode(tree.root, 0);
+	check_rbnode(tree.root, 0, 1);
+
+	/* Stacks for modifying and walking the tree are that deep */
+	_CHECK(tree.max_depth == 2 * last_black_height);
+	_CHECK(max_depth_seen <= tree.max_depth);
 }
 
 /* First validates the external API behavior via a walk, then checks
@@ -174,8 +192,14 @@ void _check_tree(int size, int use_foreach)
 
 	_CHECK(ni == nwalked);
 
+	/* The cached minimum is the first node in order */
+	_CHECK(rb_get_min(&tree) == (nwalked ? walked_nodes[0] : NULL));
+	_CHECK(rb_get_min(&tree) == z_rb_get_minmax(&tree, 0));
+
 	if (tree.root) {
 		check_rb();
+	} else {
+		_CHECK(tree.max_depth == 0);
 	}
 }
 